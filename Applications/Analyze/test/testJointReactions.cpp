@@ -49,6 +49,45 @@ int main()
             "DoublePendulum3D failed");
         cout << "DoublePendulum3D passed" << endl;
 
+        // Ranges of states analyzed on separate threads give the same loads.
+        AnalyzeTool analyzeParallel("DoublePendulum3D_Setup_JointReaction.xml");
+        analyzeParallel.setNumThreads(3);
+        analyzeParallel.run();
+        Storage resultParallel("DoublePendulum3D_JointReaction_ReactionLoads.sto");
+        ASSERT(resultParallel.getSize() == result2.getSize());
+        CHECK_STORAGE_AGAINST_STANDARD(resultParallel, standard2,
+            std::vector<double>(standard2.getSmallestNumberOfStates(), 1e-5), __FILE__, __LINE__,
+            "DoublePendulum3D with 3 threads failed");
+        cout << "DoublePendulum3D with 3 threads passed" << endl;
+
+        // So do kinematics.
+        {
+            AnalyzeTool setup("DoublePendulum3D_Setup_JointReaction.xml", false);
+            setup.updAnalysisSet().adoptAndAppend(new Kinematics());
+            setup.updAnalysisSet().adoptAndAppend(new BodyKinematics());
+            setup.print("DoublePendulum3D_Setup_Kinematics.xml");
+        }
+        AnalyzeTool analyzeKinematics("DoublePendulum3D_Setup_Kinematics.xml");
+        analyzeKinematics.setName("DoublePendulum3D_serial");
+        analyzeKinematics.run();
+        AnalyzeTool analyzeKinematicsParallel(
+                "DoublePendulum3D_Setup_Kinematics.xml");
+        analyzeKinematicsParallel.setName("DoublePendulum3D_parallel");
+        analyzeKinematicsParallel.setNumThreads(3);
+        analyzeKinematicsParallel.run();
+        for (const string suffix : {"_Kinematics_q.sto", "_Kinematics_u.sto",
+                    "_BodyKinematics_pos_global.sto",
+                    "_BodyKinematics_vel_global.sto"}) {
+            Storage serial("DoublePendulum3D_serial" + suffix),
+                parallel("DoublePendulum3D_parallel" + suffix);
+            ASSERT(parallel.getSize() == serial.getSize());
+            CHECK_STORAGE_AGAINST_STANDARD(parallel, serial,
+                std::vector<double>(serial.getSmallestNumberOfStates(), 1e-10),
+                __FILE__, __LINE__, "DoublePendulum3D" + suffix +
+                " with 3 threads failed");
+        }
+        cout << "DoublePendulum3D kinematics with 3 threads passed" << endl;
+
         AnalyzeTool analyze3("SinglePin_Setup_JointReaction_FrameKeyword.xml");
         analyze.run();
         Storage result3("SinglePin_JointReaction_ReactionLoads.sto"),
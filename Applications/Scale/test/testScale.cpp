@@ -52,6 +52,9 @@ using std::cout; using std::endl;
 
 void scaleGait2354();
 void scaleGait2354_GUI(bool useMarkerPlacement);
+// Test scaling several subjects at once from one generic model, and placing
+// markers by solving each frame of the static trial.
+void scaleGait2354Batch();
 void scaleModelWithLigament();
 bool compareStdScaleToComputed(const ScaleSet& std, const ScaleSet& comp);
 
@@ -66,6 +69,7 @@ int main()
     try {
         scaleGait2354();
         scaleGait2354_GUI(false);
+        scaleGait2354Batch();
         scaleModelWithLigament();
         scalePhysicalOffsetFrames();
         scaleJointsAndConstraints();
@@ -257,6 +261,51 @@ void scaleGait2354_GUI(bool useMarkerPlacement)
                            "std_subject01_simbody.osim", 1.0e-6);
 }
 
+void scaleGait2354Batch()
+{
+    ScaleTool subject("subject01_Setup_Scale.xml");
+    const std::string setupFilePath = subject.getPathToSubject();
+
+    // Place the markers from each frame of the static trial, and ignore
+    // outlying frames in the measurements.
+    ScaleTool eachFrame(subject);
+    eachFrame.setPathToSubject(setupFilePath);
+    eachFrame.setName("subject01_each_frame");
+    eachFrame.updMarkerPlacer().setSolveEachFrame(true);
+    eachFrame.updMarkerPlacer().setNumThreads(2);
+    eachFrame.updModelScaler().setOutlierThreshold(3.0);
+
+    Model genericModel(setupFilePath +
+            subject.getGenericModelMaker().getModelFileName());
+    const auto models = ScaleTool::runBatch(genericModel,
+            {&subject, &eachFrame, &subject}, 3);
+    ASSERT(models.size() == 3);
+    for (const auto& model : models) ASSERT(model != nullptr);
+
+    // The batch gives the same model as run().
+    models[0]->print(setupFilePath + "subject01_batch.osim");
+    compareModelToStandard(setupFilePath + "subject01_batch.osim",
+                           "std_subject01_simbody.osim", 1.0e-6);
+
+    // The subject is scaled the same way each time it is processed, and the
+    // markers placed from each frame are close to those placed from the
+    // average of the frames.
+    const MarkerSet& markers = models[0]->getMarkerSet();
+    for (int i = 0; i < markers.getSize(); ++i) {
+        const std::string& name = markers[i].getName();
+        const SimTK::Vec3& location = markers[i].get_location();
+        ASSERT_EQUAL(location,
+                models[2]->getMarkerSet().get(name).get_location(), 1e-12,
+                __FILE__, __LINE__,
+                "Marker '" + name + "' differs between batch subjects.");
+        ASSERT_EQUAL(location,
+                models[1]->getMarkerSet().get(name).get_location(), 1e-2,
+                __FILE__, __LINE__,
+                "Marker '" + name + "' placed from each frame is too far "
+                "from its placement from the average of the frames.");
+    }
+}
+
 void scaleModelWithLigament()
 {
     // SET OUTPUT FORMATTING
@@ -23,6 +23,7 @@
 
 #include "opensim-cmd_info.h"
 #include "opensim-cmd_print-xml.h"
+#include "opensim-cmd_run-pipeline.h"
 #include "opensim-cmd_run-tool.h"
 #include "opensim-cmd_update-file.h"
 #include "opensim-cmd_viz.h"
@@ -52,11 +53,12 @@ Options:
   -V, --version  Show the version number.
 
 Available commands:
-  run-tool     Run a tool (e.g., Inverse Kinematics) from an XML setup file.
-  print-xml    Print a template XML file for a Tool or class.
-  info         Show description of properties in an OpenSim class.
-  update-file  Update an .xml file (.osim or setup) to this version's format.
-  viz          Show a model, motion, or data with the Simbody Visualizer.
+  run-tool      Run a tool (e.g., Inverse Kinematics) from an XML setup file.
+  run-pipeline  Run IK, ID and Analyze for a batch of trials.
+  print-xml     Print a template XML file for a Tool or class.
+  info          Show description of properties in an OpenSim class.
+  update-file   Update an .xml file (.osim or setup) to this version's format.
+  viz           Show a model, motion, or data with the Simbody Visualizer.
 
   Pass -h or --help to any of these commands to learn how to use them.
 
@@ -94,6 +96,7 @@ int main(int argc, const char** argv) {
 
     commands["print-xml"] = print_xml;
     commands["run-tool"] = run_tool;
+    commands["run-pipeline"] = run_pipeline;
     commands["info"] = info;
     commands["update-file"] = update_file;
     commands["viz"] = viz;
@@ -0,0 +1,96 @@
+#ifndef OPENSIM_CMD_RUN_PIPELINE_H_
+#define OPENSIM_CMD_RUN_PIPELINE_H_
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  opensim-cmd_run-pipeline.h                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <iostream>
+
+#include <docopt.h>
+#include "parse_arguments.h"
+
+static const char HELP_RUN_PIPELINE[] =
+R"(Run IK, ID and Analyze (e.g., Static Optimization) for a batch of trials.
+
+Usage:
+  opensim-cmd [options]... run-pipeline <setup-xml-file>...
+  opensim-cmd run-pipeline -h | --help
+
+Options:
+  -L <path>, --library <path>  Load a plugin.
+  -o <level>, --log <level>  Logging level.
+  -j <n>, --threads <n>  Number of threads [default: 1].
+
+Description:
+  Provide three setup files per trial, in this order: the setup files of
+  InverseKinematicsTool, InverseDynamicsTool and AnalyzeTool. Pass - in
+  place of the Inverse Dynamics or Analyze setup file to skip that stage.
+
+  The coordinates solved by Inverse Kinematics are passed to the other tools
+  in memory, so the coordinates_file of the Inverse Dynamics and Analyze
+  setup files is not read. The stages of different trials overlap: while
+  Inverse Dynamics runs for one trial, Inverse Kinematics can run for the
+  next. The stages are run by the number of threads given with --threads (0
+  uses the number of cores). The time spent in each stage is reported at the
+  end.
+
+  Use `opensim-cmd print-xml` to generate template setup files.
+
+Examples:
+  opensim-cmd run-pipeline walk1_ik.xml walk1_id.xml walk1_so.xml
+  opensim-cmd run-pipeline -j 4 walk1_ik.xml walk1_id.xml walk1_so.xml
+                                walk2_ik.xml walk2_id.xml walk2_so.xml
+  opensim-cmd run-pipeline --threads=2 walk1_ik.xml - walk1_so.xml
+                                       walk2_ik.xml - walk2_so.xml
+)";
+
+int run_pipeline(int argc, const char** argv) {
+
+    using namespace OpenSim;
+
+    std::map<std::string, docopt::value> args = OpenSim::parse_arguments(
+            HELP_RUN_PIPELINE, { argv + 1, argv + argc },
+            true); // show help if requested
+
+    const auto setupFiles = args["<setup-xml-file>"].asStringList();
+    if (setupFiles.size() % 3 != 0) {
+        throw Exception("Expected three setup files per trial (Inverse "
+                "Kinematics, Inverse Dynamics and Analyze), but got " +
+                std::to_string(setupFiles.size()) + " files.");
+    }
+    auto optional = [](const std::string& setupFile) -> std::string {
+        return setupFile == "-" ? "" : setupFile;
+    };
+
+    ToolPipeline pipeline((int)args["--threads"].asLong());
+    for (size_t i = 0; i < setupFiles.size(); i += 3) {
+        ToolPipeline::Trial trial;
+        trial.inverseKinematicsSetupFile = setupFiles[i];
+        trial.inverseDynamicsSetupFile = optional(setupFiles[i + 1]);
+        trial.analyzeSetupFile = optional(setupFiles[i + 2]);
+        pipeline.addTrial(trial);
+    }
+    pipeline.run();
+    pipeline.printTimingReport();
+    return EXIT_SUCCESS;
+}
+
+#endif // OPENSIM_CMD_RUN_PIPELINE_H_
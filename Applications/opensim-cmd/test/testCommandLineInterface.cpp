@@ -349,6 +349,35 @@ void testRunTool() {
     testLoadPluginLibraries("run-tool");
 }
 
+void testRunPipeline() {
+    // Help.
+    // =====
+    {
+        StartsWith output("Run IK, ID and Analyze ");
+        testCommand("run-pipeline -h", EXIT_SUCCESS, output);
+        testCommand("run-pipeline -help", EXIT_SUCCESS, output);
+    }
+
+    // Error messages.
+    // ===============
+    testCommand("run-pipeline", EXIT_FAILURE,
+            ContainsSubstring("Arguments did not match expected patterns"));
+    testCommand("run-pipeline x.xml y.xml", EXIT_FAILURE,
+            ContainsSubstring("Expected three setup files per trial"));
+    testCommand("run-pipeline -j 2 x.xml - -", EXIT_FAILURE,
+            ContainsSubstring("Setup file 'x.xml' does not exist."));
+    // The setup file from print-xml does not have a model.
+    testCommand("print-xml ik testrunpipeline_ik_setup.xml", EXIT_SUCCESS,
+            ContainsSubstring("Printing 'testrunpipeline_ik_setup.xml'.\n"));
+    testCommand("run-pipeline testrunpipeline_ik_setup.xml - -", EXIT_FAILURE,
+            std::regex(RE_ANY + "(No model filename was provided)" + RE_ANY +
+                       "(The inverse kinematics stage of trial 0)" + RE_ANY));
+
+    // Library option.
+    // ===============
+    testLoadPluginLibraries("run-pipeline");
+}
+
 void testPrintXML() {
     // Help.
     // =====
@@ -494,6 +523,7 @@ int main() {
     SimTK_START_TEST("testCommandLineInterface");
         SimTK_SUBTEST(testNoCommand);
         SimTK_SUBTEST(testRunTool);
+        SimTK_SUBTEST(testRunPipeline);
         SimTK_SUBTEST(testPrintXML);
         SimTK_SUBTEST(testInfo);
         SimTK_SUBTEST(testUpdateFile);
@@ -394,6 +394,8 @@ DATATABLE_CLONE(double, SimTK::Rotation_<double>)
 
 %include <OpenSim/Common/DataAdapter.h>
 %include <OpenSim/Common/ExperimentalSensor.h>
+// std::function is not wrapped.
+%ignore OpenSim::IMUDataReader::readBlocks;
 %include <OpenSim/Common/IMUDataReader.h>
 %include <OpenSim/Common/XsensDataReaderSettings.h>
 %include <OpenSim/Common/XsensDataReader.h>
@@ -27,6 +27,7 @@
 //=============================================================================
 #include "BodyKinematics.h"
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/KinematicsSnapshot.h>
 
 using namespace OpenSim;
 using namespace std;
@@ -263,6 +264,12 @@ allocateStorage()
     _pStore = new Storage(1000,"Positions");
     _pStore->setDescription(getDescription());
     _pStore->setColumnLabels(getColumnLabels());
+
+    // LIST OF STORAGES
+    _storageList.setSize(0);
+    _storageList.append(_aStore);
+    _storageList.append(_vStore);
+    _storageList.append(_pStore);
 }
 
 
@@ -276,6 +283,7 @@ allocateStorage()
 void BodyKinematics::
 deleteStorage()
 {
+    _storageList.setSize(0);
     if(_aStore!=NULL) { delete _aStore;  _aStore=NULL; }
     if(_vStore!=NULL) { delete _vStore;  _vStore=NULL; }
     if(_pStore!=NULL) { delete _pStore;  _pStore=NULL; }
@@ -443,16 +451,20 @@ getExpressResultsInLocalFrame()
 int BodyKinematics::
 record(const SimTK::State& s)
 {
+    // Use the kinematics shared by the analysis set, if any. Otherwise,
+    // realize to Acceleration first since we'll ask for Accelerations.
+    const KinematicsSnapshot* shared = getKinematicsSnapshot(s);
+    KinematicsSnapshot local;
+    if(shared==NULL) {
+        _model->getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
+        local.update(*_model, s);
+    }
+    const KinematicsSnapshot& snapshot = shared!=NULL ? *shared : local;
 
-    // Realize to Acceleration first since we'll ask for Accelerations 
-    _model->getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
     // VARIABLES
     SimTK::Vec3 vec,angVec;
     double Mass = 0.0;
 
-    // GROUND BODY
-    const Ground &ground = _model->getGround();
-
     // POSITION
     BodySet& bs = _model->updBodySet();
 
@@ -460,8 +472,8 @@ record(const SimTK::State& s)
         Body& body = bs.get(_bodyIndices[i]);
         const SimTK::Vec3& com = body.get_mass_center();
         // GET POSITIONS AND EULER ANGLES
-        vec = body.findStationLocationInGround(s, com);
-        angVec = body.getTransformInGround(s).R().convertRotationToBodyFixedXYZ();
+        vec = snapshot.findStationLocationInGround(body, com);
+        angVec = snapshot.getTransformInGround(body).R().convertRotationToBodyFixedXYZ();
 
         // CONVERT TO DEGREES?
         if(getInDegrees()) {
@@ -481,7 +493,7 @@ record(const SimTK::State& s)
         for(int i=0;i<bs.getSize();i++) {
             Body& body = bs.get(i);
             const SimTK::Vec3& com = body.get_mass_center();
-            vec = body.findStationLocationInGround(s, com);
+            vec = snapshot.findStationLocationInGround(body, com);
             // ADD TO WHOLE BODY MASS
             Mass += body.get_mass();
             rP[0] += body.get_mass() * vec[0];
@@ -504,11 +516,11 @@ record(const SimTK::State& s)
         Body& body = bs.get(_bodyIndices[i]);
         const SimTK::Vec3& com = body.get_mass_center();
         // GET VELOCITIES AND ANGULAR VELOCITIES
-        vec = body.findStationVelocityInGround(s, com);
-        angVec = body.getVelocityInGround(s)[0];
+        vec = snapshot.findStationVelocityInGround(body, com);
+        angVec = snapshot.getVelocityInGround(body)[0];
         if (_expressInLocalFrame) {
-            vec = ground.expressVectorInAnotherFrame(s, vec, body);
-            angVec = ground.expressVectorInAnotherFrame(s, angVec, body);
+            vec = snapshot.expressVectorInFrame(body, vec);
+            angVec = snapshot.expressVectorInFrame(body, angVec);
         }
 
         // CONVERT TO DEGREES?
@@ -529,7 +541,7 @@ record(const SimTK::State& s)
         for(int i=0;i<bs.getSize();i++) {
             Body& body = bs.get(i);
             const SimTK::Vec3& com = body.get_mass_center();
-            vec = body.findStationVelocityInGround(s, com);
+            vec = snapshot.findStationVelocityInGround(body, com);
             rV[0] += body.get_mass() * vec[0];
             rV[1] += body.get_mass() * vec[1];
             rV[2] += body.get_mass() * vec[2];
@@ -551,11 +563,11 @@ record(const SimTK::State& s)
         const SimTK::Vec3& com = body.get_mass_center();
 
         // GET ACCELERATIONS AND ANGULAR ACCELERATIONS
-        vec = body.findStationAccelerationInGround(s, com);
-        angVec = body.getAccelerationInGround(s)[0];
+        vec = snapshot.findStationAccelerationInGround(body, com);
+        angVec = snapshot.getAccelerationInGround(body)[0];
         if(_expressInLocalFrame) {
-            vec = ground.expressVectorInAnotherFrame(s, vec, body);
-            angVec = ground.expressVectorInAnotherFrame(s, angVec, body);
+            vec = snapshot.expressVectorInFrame(body, vec);
+            angVec = snapshot.expressVectorInFrame(body, angVec);
         }
 
         // CONVERT TO DEGREES?
@@ -576,7 +588,7 @@ record(const SimTK::State& s)
         for(int i=0;i<bs.getSize();i++) {
             Body& body = bs.get(i);
             const SimTK::Vec3& com = body.get_mass_center();
-            vec = body.findStationAccelerationInGround(s, com);
+            vec = snapshot.findStationAccelerationInGround(body, com);
             rA[0] += body.get_mass() * vec[0];
             rA[1] += body.get_mass() * vec[1];
             rA[2] += body.get_mass() * vec[2];
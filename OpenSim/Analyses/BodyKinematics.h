@@ -113,6 +113,9 @@ public:
 
 
     void setModel(Model& aModel) override;
+    SimTK::Stage getRequiredStage() const override
+    {   return SimTK::Stage::Acceleration; }
+    bool getRecordsStatesIndependently() const override { return true; }
     //--------------------------------------------------------------------------
     // ANALYSIS
     //--------------------------------------------------------------------------
@@ -27,8 +27,12 @@
 #include <OpenSim/Common/IO.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/ExternalForce.h>
+#include <OpenSim/Actuators/CoordinateActuator.h>
 #include "InducedAccelerations.h"
 
+#include <atomic>
+#include <thread>
+
 using namespace OpenSim;
 using namespace std;
 
@@ -36,6 +40,9 @@ using namespace std;
 // CONSTANTS
 //=============================================================================
 #define CENTER_OF_MASS_NAME string("center_of_mass")
+// With more than one thread, the number of states per thread that are queued
+// before they are recorded together.
+#define NUM_FRAMES_PER_THREAD 64
 
 //=============================================================================
 // CONSTRUCTOR(S) AND DESTRUCTOR
@@ -68,7 +75,8 @@ InducedAccelerations::InducedAccelerations(Model *aModel) :
     _constraintSet((ConstraintSet&)_constraintSetProp.getValueObj()),
     _forceThreshold(_forceThresholdProp.getValueDbl()),
     _computePotentialsOnly(_computePotentialsOnlyProp.getValueBool()),
-    _reportConstraintReactions(_reportConstraintReactionsProp.getValueBool())
+    _reportConstraintReactions(_reportConstraintReactionsProp.getValueBool()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     // make sure members point to NULL if not valid. 
     setNull();
@@ -96,7 +104,8 @@ InducedAccelerations::InducedAccelerations(const std::string &aFileName):
     _constraintSet((ConstraintSet&)_constraintSetProp.getValueObj()),
     _forceThreshold(_forceThresholdProp.getValueDbl()),
     _computePotentialsOnly(_computePotentialsOnlyProp.getValueBool()),
-    _reportConstraintReactions(_reportConstraintReactionsProp.getValueBool())
+    _reportConstraintReactions(_reportConstraintReactionsProp.getValueBool()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
 
@@ -120,7 +129,8 @@ InducedAccelerations::InducedAccelerations(const InducedAccelerations &aInducedA
     _constraintSet((ConstraintSet&)_constraintSetProp.getValueObj()),
     _forceThreshold(_forceThresholdProp.getValueDbl()),
     _computePotentialsOnly(_computePotentialsOnlyProp.getValueBool()),
-    _reportConstraintReactions(_reportConstraintReactionsProp.getValueBool())
+    _reportConstraintReactions(_reportConstraintReactionsProp.getValueBool()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
     // COPY TYPE AND NAME
@@ -152,6 +162,7 @@ operator=(const InducedAccelerations &aInducedAccelerations)
     _forceThreshold = aInducedAccelerations._forceThreshold;
     _computePotentialsOnly = aInducedAccelerations._computePotentialsOnly;
     _reportConstraintReactions = aInducedAccelerations._reportConstraintReactions;
+    _numThreads = aInducedAccelerations._numThreads;
     _includeCOM = aInducedAccelerations._includeCOM;
     return(*this);
 }
@@ -171,6 +182,8 @@ void InducedAccelerations::setNull()
     _bodyNames[0] = CENTER_OF_MASS_NAME;
     _computePotentialsOnly = false;
     _reportConstraintReactions = false;
+    _numThreads = 1;
+    _solveContributorsTogether = false;
     // Analysis does not own contents of these sets
     _coordSet.setMemoryOwner(false);
     _bodySet.setMemoryOwner(false);
@@ -213,6 +226,11 @@ void InducedAccelerations::setupProperties()
     _reportConstraintReactionsProp.setName("report_constraint_reactions");
     _reportConstraintReactionsProp.setComment("Report individual contributions to constraint reactions in addition to accelerations.");
     _propertySet.append(&_reportConstraintReactionsProp);
+
+    _numThreadsProp.setName("num_threads");
+    _numThreadsProp.setComment("Number of threads over which the times are distributed, each with its own copy of the model. "
+        "With more than one thread, the states are queued and recorded in batches. A value less than 1 uses the number of cores.");
+    _propertySet.append(&_numThreadsProp);
 }
 
 //=============================================================================
@@ -541,6 +559,13 @@ int InducedAccelerations::record(const SimTK::State& s)
 
     // Cycle through the force contributors to the system acceleration
     for(int c=0; c< _contributors.getSize(); c++){          
+        // The contributors after the total share the constraints that the
+        // total enforces.
+        if(_solveContributorsTogether && _contributors[c] != "total"){
+            recordContributorsTogether(s, s_analysis, c);
+            break;
+        }
+
         //cout << "Solving for contributor: " << _contributors[c] << endl;
         // Need to be at the dynamics stage to disable a force
         _model->getMultibodySystem().realize(s_analysis, SimTK::Stage::Dynamics);
@@ -823,6 +848,7 @@ void InducedAccelerations::initialize(const SimTK::State& s)
     _gravity = _model->getGravity();
 
     /*SimTK::State &s_analysis =*/_model->initSystem();
+    _solveContributorsTogether = canSolveContributorsTogether();
 
     // UPDATE VARIABLES IN THIS CLASS
     constructDescription();
@@ -845,6 +871,12 @@ int InducedAccelerations::begin(const SimTK::State &s)
 {
     if(!proceed()) return(0);
 
+    // The workers copy the model before initialize() changes it.
+    _workers.clear();
+    _frames.clear();
+    if(_numThreads != 1) createWorkers(s);
+    _frames.reserve(NUM_FRAMES_PER_THREAD * _workers.size());
+
     initialize(s);
 
     // RESET STORAGES
@@ -876,8 +908,17 @@ int InducedAccelerations::begin(const SimTK::State &s)
  */
 int InducedAccelerations::step(const SimTK::State &s, int stepNumber)
 {
-    if(proceed(stepNumber) && getOn())
-        record(s);
+    if(proceed(stepNumber) && getOn()) {
+        if(!_workers.empty()) {
+            // Record the queued states in batches, so that the memory they
+            // take does not grow with the length of the run.
+            _frames.push_back(s);
+            if(_frames.size() >= NUM_FRAMES_PER_THREAD * _workers.size())
+                recordFramesInParallel();
+        }
+        else
+            record(s);
+    }
 
     return(0);
 }
@@ -897,12 +938,348 @@ int InducedAccelerations::end(const SimTK::State &s)
 {
     if(!proceed()) return(0);
 
-    record(s);
+    if(!_workers.empty()) {
+        _frames.push_back(s);
+        recordFramesInParallel();
+    }
+    else
+        record(s);
 
     return(0);
 }
 
 
+//_____________________________________________________________________________
+/**
+ * Whether the accelerations induced by the actuators, gravity and velocity
+ * can be solved for from the forces of each contributor. This requires the
+ * forces of each actuator to be known from its actuation, no prescribed
+ * motion, and no reporting of the constraint reactions, which are computed
+ * by the constraints from a realized State.
+ */
+bool InducedAccelerations::canSolveContributorsTogether() const
+{
+    if(_reportConstraintReactions) return false;
+
+    const SimTK::SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+    for(SimTK::MobilizedBodyIndex mbx(0); mbx<matter.getNumBodies(); ++mbx){
+        if(matter.getMobilizedBody(mbx).hasMotion()) return false;
+    }
+
+    const Set<Actuator>& actuators = _model->getActuators();
+    for(int f=0; f<actuators.getSize(); f++){
+        const Actuator& actuator = actuators.get(f);
+        if(dynamic_cast<const CoordinateActuator*>(&actuator)) continue;
+        // Subclasses of PathActuator other than muscles may apply forces
+        // other than the tension along the path.
+        if(dynamic_cast<const Muscle*>(&actuator) ||
+                actuator.getConcreteClassName() == "PathActuator") continue;
+        return false;
+    }
+    return true;
+}
+
+namespace {
+// The acceleration of a station on a body, given the spatial acceleration of
+// the body, as MobilizedBody::findStationAccelerationInGround() computes it
+// from a State realized to the Acceleration stage.
+SimTK::Vec3 calcStationAcceleration(const SimTK::State& s,
+        const SimTK::MobilizedBody& mobod, const SimTK::SpatialVec& A_GB,
+        const SimTK::Vec3& station)
+{
+    const SimTK::Vec3 p_G = mobod.getBodyRotation(s) * station;
+    const SimTK::Vec3& w_GB = mobod.getBodyAngularVelocity(s);
+    return A_GB[1] + A_GB[0] % p_G + w_GB % (w_GB % p_G);
+}
+}
+
+//_____________________________________________________________________________
+/**
+ * Record the accelerations induced by the contributors from
+ * firstContributor on, which are actuators, gravity and velocity.
+ *
+ * The accelerations satisfy M udot + ~G lambda = f and G udot + b = 0, in
+ * which only the applied forces f and the bias b depend on the contributor.
+ * So (G M^-1 ~G) is factored once, and udot is solved for from the forces of
+ * each contributor. The forces are those of a State in which all forces are
+ * applied: the forces of an actuator follow from its actuation, and the
+ * forces applied in every contributor (such as passive forces) are the
+ * total forces less those of the actuators and gravity.
+ *
+ * @param s State of the model at this time.
+ * @param s_analysis State with the constraints of the analysis enforced.
+ * @param firstContributor Index of the first contributor to record.
+ */
+void InducedAccelerations::recordContributorsTogether(const SimTK::State& s,
+        const SimTK::State& s_analysis, int firstContributor)
+{
+    const SimTK::MultibodySystem& system = _model->getMultibodySystem();
+    const SimTK::SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+    const SimTK::Force::Gravity& gravity = _model->getGravityForce();
+    const Set<Actuator>& actuators = _model->getActuators();
+    int na = actuators.getSize();
+    int nu = _model->getNumSpeeds();
+    int nb = matter.getNumBodies();
+
+    // Apply gravity and all actuators, which are set up as for the
+    // contributors of the actuators.
+    SimTK::State s_zero = s_analysis;
+    gravity.enable(s_zero);
+    for(int f=0; f<na; f++){
+        ScalarActuator* act =
+                dynamic_cast<ScalarActuator*>(&_model->updActuators().get(f));
+        act->setAppliesForce(s_zero, true);
+        act->overrideActuation(s_zero, false);
+        Muscle *muscle = dynamic_cast<Muscle *>(act);
+        if(muscle && _computePotentialsOnly){
+            muscle->overrideActuation(s_zero, true);
+            muscle->setOverrideActuation(s_zero, 1.0);
+        }
+    }
+    // The actuators and gravity induce accelerations at zero velocity.
+    s_zero.setQ(s.getQ());
+    s_zero.setU(SimTK::Vector(nu, 0.0));
+    s_zero.setZ(s.getZ());
+    system.realize(s_zero, SimTK::Stage::Dynamics);
+    SimTK::State s_velocity = s_zero;
+    s_velocity.setU(s.getU());
+    system.realize(s_velocity, SimTK::Stage::Dynamics);
+
+    // Forces of each actuator at zero velocity, of gravity, and of the
+    // forces applied in every contributor at zero and nonzero velocity.
+    std::vector<SimTK::Vector> actuatorMobilityForces(na);
+    std::vector<SimTK::Vector_<SimTK::SpatialVec>> actuatorBodyForces(na);
+    SimTK::Vector gravityMobilityForces;
+    SimTK::Vector_<SimTK::SpatialVec> gravityBodyForces;
+    SimTK::Vector_<SimTK::Vec3> particleForces;
+    gravity.calcForceContribution(s_zero, gravityBodyForces, particleForces,
+            gravityMobilityForces);
+    SimTK::Vector otherMobilityForces[2];
+    SimTK::Vector_<SimTK::SpatialVec> otherBodyForces[2];
+    SimTK::Vector mobilityForces(nu);
+    SimTK::Vector_<SimTK::SpatialVec> bodyForces(nb);
+    for(int v=0; v<2; v++){
+        const SimTK::State& state = v==0 ? s_zero : s_velocity;
+        otherMobilityForces[v] =
+                system.getMobilityForces(state, SimTK::Stage::Dynamics);
+        otherBodyForces[v] =
+                system.getRigidBodyForces(state, SimTK::Stage::Dynamics);
+        otherMobilityForces[v] -= gravityMobilityForces;
+        otherBodyForces[v] -= gravityBodyForces;
+        for(int f=0; f<na; f++){
+            const Actuator& actuator = actuators.get(f);
+            const double actuation =
+                    dynamic_cast<const ScalarActuator&>(actuator).getActuation(state);
+            mobilityForces.setToZero();
+            bodyForces.setToZero();
+            const CoordinateActuator* coordActuator =
+                    dynamic_cast<const CoordinateActuator*>(&actuator);
+            if(coordActuator){
+                const Coordinate* coord = coordActuator->getCoordinate();
+                matter.addInMobilityForce(state, coord->getBodyIndex(),
+                        SimTK::MobilizerUIndex(coord->getMobilizerQIndex()),
+                        actuation, mobilityForces);
+            }
+            else{
+                dynamic_cast<const PathActuator&>(actuator).getGeometryPath()
+                        .addInEquivalentForces(state, actuation, bodyForces,
+                                mobilityForces);
+            }
+            otherMobilityForces[v] -= mobilityForces;
+            otherBodyForces[v] -= bodyForces;
+            if(v==0){
+                actuatorMobilityForces[f] = mobilityForces;
+                actuatorBodyForces[f] = bodyForces;
+            }
+        }
+    }
+
+    // Factor the constrained equations of motion.
+    matter.realizeArticulatedBodyInertias(s_zero);
+    matter.realizeArticulatedBodyInertias(s_velocity);
+    int nm = s_zero.getNMultipliers();
+    SimTK::Matrix G, MInvGt(nu, nm);
+    SimTK::FactorQTZ GMInvGt;
+    SimTK::Vector bias[2];
+    SimTK::Vector udot(nu), lambda;
+    if(nm>0){
+        matter.calcG(s_zero, G);
+        SimTK::Vector g(nu);
+        for(int i=0; i<nm; i++){
+            g = ~G[i];
+            matter.multiplyByMInv(s_zero, g, udot);
+            MInvGt(i) = udot;
+        }
+        GMInvGt.factor(G * MInvGt);
+        matter.calcBiasForAccelerationConstraints(s_zero, bias[0]);
+        matter.calcBiasForAccelerationConstraints(s_velocity, bias[1]);
+    }
+
+    SimTK::Vector_<SimTK::SpatialVec> A_GB(nb);
+    for(int c=firstContributor; c<_contributors.getSize(); c++){
+        int v = 0;
+        if(_contributors[c] == "gravity"){
+            mobilityForces = otherMobilityForces[0] + gravityMobilityForces;
+            bodyForces = otherBodyForces[0] + gravityBodyForces;
+        }
+        else if(_contributors[c] == "velocity"){
+            v = 1;
+            mobilityForces = otherMobilityForces[1];
+            bodyForces = otherBodyForces[1];
+        }
+        else{
+            int ai = actuators.getIndex(_contributors[c]);
+            if(ai<0)
+                throw Exception("InducedAcceleration: ERR- Could not find actuator '"+_contributors[c],__FILE__,__LINE__);
+            mobilityForces = otherMobilityForces[0] + actuatorMobilityForces[ai];
+            bodyForces = otherBodyForces[0] + actuatorBodyForces[ai];
+        }
+        const SimTK::State& state = v==0 ? s_zero : s_velocity;
+
+        matter.calcAccelerationIgnoringConstraints(state, mobilityForces,
+                bodyForces, udot, A_GB);
+        if(nm>0){
+            GMInvGt.solve(G * udot + bias[v], lambda);
+            udot -= MInvGt * lambda;
+            matter.calcBodyAccelerationFromUDot(state, udot, A_GB);
+        }
+        appendInducedAccelerations(state, udot, A_GB);
+    }
+}
+
+//_____________________________________________________________________________
+/**
+ * Append the accelerations of the coordinates, bodies and center of mass,
+ * given the generalized accelerations and the spatial accelerations of the
+ * bodies, to the work arrays.
+ */
+void InducedAccelerations::appendInducedAccelerations(const SimTK::State& s,
+        const SimTK::Vector& udot,
+        const SimTK::Vector_<SimTK::SpatialVec>& A_GB)
+{
+    const SimTK::SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+
+    for(int i=0;i<_coordSet.getSize();i++) {
+        const Coordinate& coord = _coordSet.get(i);
+        const SimTK::MobilizedBody& mobod =
+                matter.getMobilizedBody(coord.getBodyIndex());
+        double acc = udot[mobod.getFirstUIndex(s) + coord.getMobilizerQIndex()];
+        if(getInDegrees()) 
+            acc *= SimTK_RADIAN_TO_DEGREE;  
+        _coordIndAccs[i]->append(1, &acc);
+    }
+
+    for(int i=0;i<_bodySet.getSize();i++) {
+        const Body& body = _bodySet.get(i);
+        const SimTK::MobilizedBodyIndex mbx = body.getMobilizedBodyIndex();
+        SimTK::Vec3 vec = calcStationAcceleration(s,
+                matter.getMobilizedBody(mbx), A_GB[mbx], body.get_mass_center());
+        SimTK::Vec3 angVec = A_GB[mbx][0];
+        if(getInDegrees()) 
+            angVec *= SimTK_RADIAN_TO_DEGREE;   
+        _bodyIndAccs[i]->append(3, &vec[0]);
+        _bodyIndAccs[i]->append(3, &angVec[0]);
+    }
+
+    if(_includeCOM){
+        // As SimbodyMatterSubsystem::calcSystemMassCenterAccelerationInGround().
+        double mass = 0;
+        SimTK::Vec3 vec(0);
+        for(SimTK::MobilizedBodyIndex mbx(1); mbx<matter.getNumBodies(); ++mbx){
+            const SimTK::MobilizedBody& mobod = matter.getMobilizedBody(mbx);
+            const SimTK::MassProperties& massProps =
+                    mobod.getBodyMassProperties(s);
+            mass += massProps.getMass();
+            vec += massProps.getMass() * calcStationAcceleration(s, mobod,
+                    A_GB[mbx], massProps.getMassCenter());
+        }
+        vec /= mass;
+        _comIndAccs.append(3, &vec[0]);
+    }
+}
+
+//_____________________________________________________________________________
+/**
+ * Create the workers that record the times on separate threads, each a copy
+ * of this analysis with its own copy of the model.
+ */
+void InducedAccelerations::createWorkers(const SimTK::State& s)
+{
+    int numThreads = _numThreads;
+    if(numThreads < 1)
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    if(numThreads == 1) return;
+    for(int i=0; i<numThreads; i++){
+        std::unique_ptr<InducedAccelerations> worker(
+                new InducedAccelerations(*this));
+        worker->setNumThreads(1);
+        worker->setModel(*_model);
+        worker->initialize(s);
+        _workers.push_back(std::move(worker));
+    }
+}
+
+//_____________________________________________________________________________
+/**
+ * Record the queued times on the threads of the workers, and append the
+ * results to the storages of this analysis in order of time.
+ */
+void InducedAccelerations::recordFramesInParallel()
+{
+    const int nf = (int)_frames.size();
+    const int numThreads = std::min((int)_workers.size(), nf);
+    // The results of each time, in the order of the storages.
+    std::vector<std::vector<StateVector>> results(nf);
+    std::atomic<int> nextFrame(0);
+    std::vector<std::exception_ptr> errors(numThreads);
+    auto recordFrames = [&](int ithread) {
+        try {
+            InducedAccelerations& worker = *_workers[ithread];
+            while(true){
+                const int i = nextFrame++;
+                if(i >= nf) break;
+                worker.record(_frames[i]);
+                for(int j=0; j<worker._storeInducedAccelerations.getSize(); j++){
+                    Storage* store = worker._storeInducedAccelerations[j];
+                    results[i].push_back(*store->getLastStateVector());
+                    store->reset(0);
+                }
+                if(worker._reportConstraintReactions){
+                    Storage* store = worker._storeConstraintReactions;
+                    results[i].push_back(*store->getLastStateVector());
+                    store->reset(0);
+                }
+            }
+        } catch (...) {
+            errors[ithread] = std::current_exception();
+            // Stop the other threads early.
+            nextFrame = nf;
+        }
+    };
+    std::vector<std::thread> threads;
+    for(int ithread=1; ithread<numThreads; ithread++)
+        threads.emplace_back(recordFrames, ithread);
+    if(numThreads > 0) recordFrames(0);
+    for(auto& thread : threads) thread.join();
+    _frames.clear();
+    for(const auto& error : errors)
+        if(error) std::rethrow_exception(error);
+
+    for(int i=0; i<nf; i++){
+        int k = 0;
+        for(int j=0; j<_storeInducedAccelerations.getSize(); j++, k++){
+            StateVector& row = results[i][k];
+            _storeInducedAccelerations[j]->append(row.getTime(),
+                    row.getSize(), &row.getData()[0]);
+        }
+        if(_reportConstraintReactions){
+            StateVector& row = results[i][k];
+            _storeConstraintReactions->append(row.getTime(), row.getSize(),
+                    &row.getData()[0]);
+        }
+    }
+}
+
 
 
 //=============================================================================
@@ -33,6 +33,9 @@
 // Header to define analysis (DLL) interface
 #include "osimAnalysesDLL.h"
 
+#include <memory>
+#include <vector>
+
 namespace OpenSim { 
 
 class Model;
@@ -59,6 +62,15 @@ class ExternalForce;
  * The ConstraintSet supplied must have the same number constraints as
  * external forces AND apply to the same bodies with respect to ground.
  *
+ * All contributors at a time share the configuration of the model, so when
+ * the actuators are CoordinateActuator%s or path actuators (muscles) and
+ * constraint reactions are not reported, the constrained equations of motion
+ * are factored once per time and the accelerations induced by each
+ * contributor are solved for from its forces. Otherwise, the model is
+ * realized to the Acceleration stage for each contributor. Either way, the
+ * results agree to within roundoff. The times can also be distributed over
+ * several threads (see setNumThreads()).
+ *
  * @author Ajay Seth
  */
 class OSIMANALYSES_API InducedAccelerations : public Analysis {
@@ -102,6 +114,11 @@ protected:
     PropertyBool _reportConstraintReactionsProp;
     bool &_reportConstraintReactions;
 
+    /** Number of threads over which the times after the first are
+        distributed, each with its own copy of the model. */
+    PropertyInt _numThreadsProp;
+    int &_numThreads;
+
     /** Storages for recording induced accelerations for specified coordinates and/or bodies. */
     Array<Storage *> _storeInducedAccelerations;
     Storage* _storeConstraintReactions;
@@ -123,6 +140,16 @@ protected:
     // Hold the actual model gravity since we will be changing it back and forth from 0
     SimTK::Vec3 _gravity;
 
+    // Whether the accelerations induced by the actuators, gravity and
+    // velocity can be solved for together (see recordContributorsTogether()).
+    bool _solveContributorsTogether;
+
+    // Copies of this analysis, each with its own copy of the model, that
+    // record the times on separate threads, and the queued states at those
+    // times that have not been recorded yet.
+    std::vector<std::unique_ptr<InducedAccelerations>> _workers;
+    std::vector<SimTK::State> _frames;
+
 
 //=============================================================================
 // METHODS
@@ -186,6 +213,17 @@ public:
     //-------------------------------------------------------------------------
     void setModel(Model &aModel) override;
 
+    /** %Set the number of threads over which the times are distributed. With
+     * more than one thread, each thread has its own copy of the model, and
+     * the states passed to step() are copied and queued. Once 64 states per
+     * thread are queued, and at end(), the queued states are recorded on the
+     * threads together and their results appended in order of time. The
+     * queue thus holds at most 64 states per thread, however long the run.
+     * If numThreads is less than 1, the number of cores is used. The
+     * default is 1. */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
+
     //-------------------------------------------------------------------------
     // INTEGRATION
     //-------------------------------------------------------------------------
@@ -208,6 +246,14 @@ public:
 protected:
     //========================== Internal Methods =============================
     int record(const SimTK::State& s);
+    void recordContributorsTogether(const SimTK::State& s,
+            const SimTK::State& s_analysis, int firstContributor);
+    void appendInducedAccelerations(const SimTK::State& s,
+            const SimTK::Vector& udot,
+            const SimTK::Vector_<SimTK::SpatialVec>& A_GB);
+    bool canSolveContributorsTogether() const;
+    void createWorkers(const SimTK::State& s);
+    void recordFramesInParallel();
     void constructDescription();
     void assembleContributors();
     Array<std::string> constructColumnLabelsForCoordinate();
@@ -27,6 +27,7 @@
 //=============================================================================
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/Actuator.h>
+#include <OpenSim/Simulation/Model/KinematicsSnapshot.h>
 #include "JointReaction.h"
 
 using namespace OpenSim;
@@ -169,6 +170,7 @@ setNull()
 
     _storeActuation = NULL;
 
+    _storageList.append(&_storeReactionLoads);
 }
 //_____________________________________________________________________________
 /**
@@ -546,10 +548,13 @@ int JointReaction::
 record(const SimTK::State& s)
 {
     /** if a forces file is specified replace the computed actuation with the 
-        forces from storage.*/
-    SimTK::State s_analysis = s;
-
-    _model->updMultibodySystem().realize(s_analysis, s.getSystemStage());
+        forces from storage, in a copy of the state.*/
+    SimTK::State s_overridden;
+    if(_useForceStorage){
+        s_overridden = s;
+        _model->updMultibodySystem().realize(s_overridden, s.getSystemStage());
+    }
+    const SimTK::State& s_analysis = _useForceStorage ? s_overridden : s;
     if(_useForceStorage){
         const auto& actuatorSet = _model->getActuators();
         int nA = actuatorSet.getSize();
@@ -568,16 +573,24 @@ record(const SimTK::State& s)
             }
             const ScalarActuator* act = dynamic_cast<const ScalarActuator*>(&actuatorSet[actuatorIndex]);
             if (act){
-                act->overrideActuation(s_analysis, true);
-                act->setOverrideActuation(s_analysis, forces[storageIndex]);
+                act->overrideActuation(s_overridden, true);
+                act->setOverrideActuation(s_overridden, forces[storageIndex]);
             }
         }
     }
-    // VARIABLES
-    const Ground& ground = _model->getGround();
-
     _model->realizeAcceleration(s_analysis);
 
+    // The frames are positioned as in s, so their transforms can be taken
+    // from the kinematics shared by the analysis set, if any.
+    const KinematicsSnapshot* snapshot = getKinematicsSnapshot(s);
+    auto findTransformInGround = [&](const Frame& frame) {
+        const PhysicalFrame* physicalFrame =
+                dynamic_cast<const PhysicalFrame*>(&frame);
+        if(snapshot && physicalFrame)
+            return snapshot->getTransformInGround(*physicalFrame);
+        return frame.getTransformInGround(s_analysis);
+    };
+
     /* retrieved desired joint reactions, convert to desired bodies, and convert
     *  to desired reference frames*/
     int numOutputJoints = _reactionList.getSize();
@@ -586,6 +599,7 @@ record(const SimTK::State& s)
         JointReactionKey currentKey = _reactionList[i];
         const Joint& joint = *currentKey.joint;
         const Frame& expressedInBody = *currentKey.expressedInFrame;
+        const Transform X_GE = findTransformInGround(expressedInBody);
         SpatialVec jointReaction;
         Vec3 pointOfApplication;
         
@@ -595,24 +609,22 @@ record(const SimTK::State& s)
 
             // find the point of application in immediate parent frame, then
             // transform to the base frame of the parent (expressedInBody)
-            Vec3 parentLocationInGlobal = joint.getParentFrame().getTransformInGround(s_analysis).p();
-            pointOfApplication = 
-                ground.findStationLocationInAnotherFrame(s_analysis, parentLocationInGlobal, expressedInBody);
+            Vec3 parentLocationInGlobal = findTransformInGround(joint.getParentFrame()).p();
+            pointOfApplication = ~X_GE * parentLocationInGlobal;
         }
         else{
             jointReaction = joint.calcReactionOnChildExpressedInGround(s_analysis);
 
             // find the point of application in immediate child frame, then
             // transform to the base frame of the child (expressedInBody)
-            Vec3 childLocationInGlobal = joint.getChildFrame().getTransformInGround(s_analysis).p();
-            pointOfApplication =
-                ground.findStationLocationInAnotherFrame(s_analysis, childLocationInGlobal, expressedInBody);
+            Vec3 childLocationInGlobal = findTransformInGround(joint.getChildFrame()).p();
+            pointOfApplication = ~X_GE * childLocationInGlobal;
         }
 
         // transform SpatialVec of reaction forces and moments to the
         // requested base frame (expressedInBody)
-        Vec3 force = ground.expressVectorInAnotherFrame(s_analysis, jointReaction[1], expressedInBody);
-        Vec3 moment = ground.expressVectorInAnotherFrame(s_analysis, jointReaction[0], expressedInBody);
+        Vec3 force = ~X_GE.R() * jointReaction[1];
+        Vec3 moment = ~X_GE.R() * jointReaction[0];
 
         /* place results in the truncated loads vectors*/
         forcesVec[i] = force;
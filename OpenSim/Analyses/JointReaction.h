@@ -166,6 +166,13 @@ public:
     // GET AND SET
     //-------------------------------------------------------------------------
     void setModel(Model& aModel) override;
+    SimTK::Stage getRequiredStage() const override
+    {   return SimTK::Stage::Acceleration; }
+    /** False if actuation is read from a forces file, since begin() reads
+     * it relative to the working directory, which AnalyzeTool does not
+     * hold while it analyzes ranges of states on separate threads. */
+    bool getRecordsStatesIndependently() const override
+    {   return _forcesFileName == ""; }
 
     // Property accessors
     /** Public accessors for the forcesFileName property */
@@ -94,6 +94,11 @@ public:
 
     // MODEL
     void setModel(Model& aModel) override;
+    SimTK::Stage getRequiredStage() const override {
+        return _recordAccelerations ? SimTK::Stage::Acceleration
+                                    : SimTK::Stage::Velocity;
+    }
+    bool getRecordsStatesIndependently() const override { return true; }
 
     void setRecordAccelerations(bool aRecordAccelerations) { _recordAccelerations = aRecordAccelerations; } // TODO: re-allocate storage or delete storage
 
@@ -27,6 +27,7 @@
 //=============================================================================
 #include <string>
 #include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/KinematicsSnapshot.h>
 #include "PointKinematics.h"
 
 
@@ -274,6 +275,12 @@ allocateStorage()
     _pStore = new Storage(1000,"PointPosition");
     _pStore->setDescription(getDescription());
     _pStore->setColumnLabels(getColumnLabels());
+
+    // LIST OF STORAGES
+    _storageList.setSize(0);
+    _storageList.append(_aStore);
+    _storageList.append(_vStore);
+    _storageList.append(_pStore);
 }
 
 
@@ -287,6 +294,7 @@ allocateStorage()
 void PointKinematics::
 deleteStorage()
 {
+    _storageList.setSize(0);
     if(_aStore!=NULL) { delete _aStore;  _aStore=NULL; }
     if(_vStore!=NULL) { delete _vStore;  _vStore=NULL; }
     if(_pStore!=NULL) { delete _pStore;  _pStore=NULL; }
@@ -522,6 +530,30 @@ record(const SimTK::State& s)
     SimTK::Vec3 vec;
 
     const double& time = s.getTime();
+
+    // Use the kinematics shared by the analysis set, if any.
+    const KinematicsSnapshot* snapshot = getKinematicsSnapshot(s);
+    if(snapshot!=NULL) {
+        vec = snapshot->findStationLocationInGround(*_body, _point);
+        if(_relativeToBody) {
+            vec = ~snapshot->getTransformInGround(*_relativeToBody) * vec;
+        }
+        _pStore->append(time, vec);
+
+        vec = snapshot->findStationVelocityInGround(*_body, _point);
+        if(_relativeToBody) {
+            vec = snapshot->expressVectorInFrame(*_relativeToBody, vec);
+        }
+        _vStore->append(time, vec);
+
+        vec = snapshot->findStationAccelerationInGround(*_body, _point);
+        if(_relativeToBody) {
+            vec = snapshot->expressVectorInFrame(*_relativeToBody, vec);
+        }
+        _aStore->append(time, vec);
+        return(0);
+    }
+
     const Ground& ground = _model->getGround();
 
     // POSITION
@@ -133,6 +133,9 @@ public:
     const std::string &getPointName();
     // MODEL
     void setModel(Model& aModel) override;
+    SimTK::Stage getRequiredStage() const override
+    {   return SimTK::Stage::Acceleration; }
+    bool getRecordsStatesIndependently() const override { return true; }
     
     // STORAGE
     void setStorageCapacityIncrements(int aIncrement);
@@ -0,0 +1,178 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  testInducedAccelerations.cpp                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Tests:
+// 1. InducedAccelerations gives the same accelerations of the coordinates,
+//    bodies and center of mass whether it realizes the model for each
+//    contributor, solves for the contributors together, or records the times
+//    on several threads. The model (arm26) has muscles, CoordinateActuators
+//    driven by a controller, and a constraint.
+
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Actuators/CoordinateActuator.h>
+#include <OpenSim/Analyses/InducedAccelerations.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+namespace {
+// Gives access to the settings and results of the analysis.
+class InducedAccelerationsResults : public InducedAccelerations {
+public:
+    InducedAccelerationsResults(Model& model, bool reportConstraintReactions,
+            int numThreads) : InducedAccelerations(&model) {
+        _coordNames.setSize(1);
+        _coordNames[0] = "all";
+        _bodyNames.setSize(3);
+        _bodyNames[0] = "r_humerus";
+        _bodyNames[1] = "r_ulna_radius_hand";
+        _bodyNames[2] = "center_of_mass";
+        _reportConstraintReactions = reportConstraintReactions;
+        setNumThreads(numThreads);
+    }
+    const Array<Storage*>& getStorages() const {
+        return _storeInducedAccelerations;
+    }
+};
+
+// The coupler makes the elbow angle 0.5 times the shoulder angle plus 0.8.
+Model* constructArm() {
+    std::unique_ptr<Model> arm{new Model("arm26.osim")};
+    auto* controller = new PrescribedController();
+    int i = 0;
+    for (const std::string coordinate : {"r_shoulder_elev", "r_elbow_flex"}) {
+        auto* actuator = new CoordinateActuator(coordinate);
+        actuator->setName(coordinate + "_actuator");
+        actuator->setOptimalForce(10.0);
+        arm->addForce(actuator);
+        controller->addActuator(*actuator);
+        controller->prescribeControlForActuator(
+                actuator->getName(), new Constant(0.5 - 0.8 * i++));
+    }
+    arm->addController(controller);
+
+    auto* coupler = new CoordinateCouplerConstraint();
+    coupler->setName("elbow_coupler");
+    Array<std::string> independentCoordinates;
+    independentCoordinates.append("r_shoulder_elev");
+    coupler->setIndependentCoordinateNames(independentCoordinates);
+    coupler->setDependentCoordinateName("r_elbow_flex");
+    coupler->setFunction(LinearFunction(0.5, 0.8));
+    arm->addConstraint(coupler);
+    return arm.release();
+}
+
+// Run the analysis over states that satisfy the coupler, with muscles in
+// equilibrium at different activations.
+void runAnalysis(Model& arm, InducedAccelerations& analysis) {
+    SimTK::State state = arm.initSystem();
+    const Coordinate& shoulder = arm.getCoordinateSet().get("r_shoulder_elev");
+    const Coordinate& elbow = arm.getCoordinateSet().get("r_elbow_flex");
+    const auto& muscles = arm.getMuscles();
+    const int numTimes = 11;
+    for (int i = 0; i < numTimes; ++i) {
+        const double time = 0.1 * i;
+        state.setTime(time);
+        const double q = 0.2 + 0.6 * std::sin(time);
+        const double u = 0.6 * std::cos(time);
+        shoulder.setValue(state, q, false);
+        shoulder.setSpeedValue(state, u);
+        elbow.setValue(state, 0.5 * q + 0.8, false);
+        elbow.setSpeedValue(state, 0.5 * u);
+        for (int m = 0; m < muscles.getSize(); ++m) {
+            muscles[m].setActivation(state, 0.1 + 0.05 * m + 0.2 * time);
+        }
+        arm.equilibrateMuscles(state);
+
+        if (i == 0) analysis.begin(state);
+        else if (i < numTimes - 1) analysis.step(state, i);
+        else analysis.end(state);
+    }
+}
+
+void compareStorages(const Array<Storage*>& expected,
+        const Array<Storage*>& actual, const std::string& description) {
+    ASSERT(expected.getSize() == actual.getSize());
+    for (int s = 0; s < expected.getSize(); ++s) {
+        const Storage& a = *expected[s];
+        const Storage& b = *actual[s];
+        const std::string message = description + ": " + a.getName();
+        ASSERT(a.getName() == b.getName(), __FILE__, __LINE__, message);
+        ASSERT(a.getColumnLabels() == b.getColumnLabels(), __FILE__, __LINE__,
+                message);
+        ASSERT(a.getSize() == b.getSize(), __FILE__, __LINE__, message);
+        for (int i = 0; i < a.getSize(); ++i) {
+            const StateVector& rowA = *a.getStateVector(i);
+            const StateVector& rowB = *b.getStateVector(i);
+            ASSERT_EQUAL(rowA.getTime(), rowB.getTime(), 0.0, __FILE__,
+                    __LINE__, message);
+            ASSERT(rowA.getSize() == rowB.getSize(), __FILE__, __LINE__,
+                    message);
+            for (int j = 0; j < rowA.getSize(); ++j) {
+                const double value = rowA.getData()[j];
+                ASSERT_EQUAL(value, rowB.getData()[j],
+                        1e-8 * std::max(1.0, std::abs(value)), __FILE__,
+                        __LINE__, message);
+            }
+        }
+    }
+}
+} // anonymous namespace
+
+void testContributorsAndThreadsAgree() {
+    std::unique_ptr<Model> arm{constructArm()};
+
+    // Reporting the constraint reactions realizes the model for each
+    // contributor.
+    InducedAccelerationsResults perContributor(*arm, true, 1);
+    runAnalysis(*arm, perContributor);
+    ASSERT(perContributor.getStorages().getSize() == 5);
+    ASSERT(perContributor.getStorages()[0]->getSize() == 11);
+
+    InducedAccelerationsResults together(*arm, false, 1);
+    runAnalysis(*arm, together);
+    compareStorages(perContributor.getStorages(), together.getStorages(),
+            "Contributors solved together");
+
+    InducedAccelerationsResults threads(*arm, false, 3);
+    runAnalysis(*arm, threads);
+    compareStorages(perContributor.getStorages(), threads.getStorages(),
+            "Times recorded on 3 threads");
+
+    InducedAccelerationsResults perContributorThreads(*arm, true, 3);
+    runAnalysis(*arm, perContributorThreads);
+    compareStorages(perContributor.getStorages(),
+            perContributorThreads.getStorages(),
+            "Contributors realized on 3 threads");
+}
+
+int main() {
+    try {
+        testContributorsAndThreadsAgree();
+    } catch (const std::exception& e) {
+        log_error("testInducedAccelerations failed: {}", e.what());
+        return 1;
+    }
+    log_info("testInducedAccelerations passed.");
+    return 0;
+}
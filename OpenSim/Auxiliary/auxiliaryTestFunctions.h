@@ -27,6 +27,7 @@
 #include <OpenSim/Common/Function.h>
 #include <OpenSim/Common/LinearFunction.h>
 #include <OpenSim/Common/PropertyObjArray.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
 #include "getRSS.h"
 
 #include <fstream>
@@ -180,6 +181,24 @@ void CHECK_STORAGE_AGAINST_STANDARD(const OpenSim::Storage& result,
     }
 }
 
+/**
+ * Check that two tables have the same times and exactly the same data, e.g.,
+ * when the same file is read in different ways.
+ */
+template <typename T>
+void ASSERT_SAME_DATA(const OpenSim::TimeSeriesTable_<T>& expected,
+        const OpenSim::TimeSeriesTable_<T>& found) {
+    ASSERT(expected.getNumRows() == found.getNumRows());
+    ASSERT(expected.getNumColumns() == found.getNumColumns());
+    for (int i = 0; i < (int)expected.getNumRows(); ++i) {
+        ASSERT(expected.getIndependentColumn()[i] ==
+                found.getIndependentColumn()[i]);
+        for (int j = 0; j < (int)expected.getNumColumns(); ++j) {
+            ASSERT(expected.getMatrix()(i, j) == found.getMatrix()(i, j));
+        }
+    }
+}
+
 // Informed by googletest.
 #define ASSERT_THROW(EXPECTED_EXCEPTION, STATEMENT) \
 do { \
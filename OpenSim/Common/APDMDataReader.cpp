@@ -26,8 +26,8 @@ APDMDataReader* APDMDataReader::clone() const {
     return new APDMDataReader{*this};
 }
 
-DataAdapter::OutputTables 
-APDMDataReader::extendRead(const std::string& fileName) const {
+void APDMDataReader::extendReadBlocks(const std::string& fileName,
+        int blockSize, const BlockSink& sink) const {
 
     OPENSIM_THROW_IF(fileName.empty(),
         EmptyFileName);
@@ -50,15 +50,6 @@ APDMDataReader::extendRead(const std::string& fileName) const {
     std::vector<int>  orientationsIndex;
 
     int n_imus = _settings.getProperty_ExperimentalSensors().size();
-    int last_size = 1024;
-    // Will read data into pre-allocated Matrices in-memory rather than appendRow
-    // on the fly which copies the whole table on every call.
-    SimTK::Matrix_<SimTK::Quaternion> rotationsData{ last_size, n_imus };
-    SimTK::Matrix_<SimTK::Vec3> linearAccelerationData{ last_size, n_imus };
-    SimTK::Matrix_<SimTK::Vec3> magneticHeadingData{ last_size, n_imus };
-    SimTK::Matrix_<SimTK::Vec3> angularVelocityData{ last_size, n_imus };
-    std::vector<double> times;
-    times.resize(last_size);
     // We support two formats, they contain similar data but headers are different
     std::string line;
     // Line 1
@@ -131,62 +122,81 @@ APDMDataReader::extendRead(const std::string& fileName) const {
     // Line 4, Units unused
     std::getline(in_stream, line);
 
-    // For all tables, will create row, stitch values from different sensors then append
-    bool done = false;
-    double time = 0.0;
-    double timeIncrement = 1 / dataRate;
-    int rowNumber = 0;
-    while (!done){
-        // Make vectors one per table
-        TimeSeriesTableQuaternion::RowVector
-            orientation_row_vector{ n_imus, SimTK::Quaternion() };
-        TimeSeriesTableVec3::RowVector
-            accel_row_vector{ n_imus, SimTK::Vec3(SimTK::NaN) };
-        TimeSeriesTableVec3::RowVector
-            magneto_row_vector{ n_imus, SimTK::Vec3(SimTK::NaN) };
-        TimeSeriesTableVec3::RowVector
-            gyro_row_vector{ n_imus, SimTK::Vec3(SimTK::NaN) };
-        std::vector<std::string> nextRow = FileAdapter::getNextLine(in_stream, ",");
-        if (nextRow.empty()) {
-            done = true;
-            break;
-        }
-        // Cycle through the imus collating values
+    // Will read data into pre-allocated Matrices in-memory rather than appendRow
+    // on the fly which copies the whole table on every call. The Matrices grow
+    // up to the block size.
+    int last_size = std::min(1024, blockSize);
+    SimTK::Matrix_<SimTK::Quaternion> rotationsData{ last_size, n_imus };
+    SimTK::Matrix_<SimTK::Vec3> linearAccelerationData{
+            foundLinearAccelerationData ? last_size : 0, n_imus };
+    SimTK::Matrix_<SimTK::Vec3> magneticHeadingData{
+            foundMagneticHeadingData ? last_size : 0, n_imus };
+    SimTK::Matrix_<SimTK::Vec3> angularVelocityData{
+            foundAngularVelocityData ? last_size : 0, n_imus };
+    std::vector<double> times;
+
+    // Parse one line into a row of the Matrices, collating the values of the
+    // imus.
+    auto parseRow = [&](const std::string& line, std::vector<int>& fields,
+            int rowNumber) {
+        findFieldStarts(line, ",", fields);
         for (int imu_index = 0; imu_index < n_imus; ++imu_index) {
-            // parse gyro info from in_stream
-           if (foundLinearAccelerationData)
-                accel_row_vector[imu_index] = SimTK::Vec3(std::stod(nextRow[accIndex[imu_index]]),
-                    std::stod(nextRow[accIndex[imu_index] + 1]), std::stod(nextRow[accIndex[imu_index] + 2]));
+            if (foundLinearAccelerationData)
+                linearAccelerationData(rowNumber, imu_index) = SimTK::Vec3(
+                        parseField(line, fields, accIndex[imu_index]),
+                        parseField(line, fields, accIndex[imu_index] + 1),
+                        parseField(line, fields, accIndex[imu_index] + 2));
             if (foundMagneticHeadingData)
-                magneto_row_vector[imu_index] = SimTK::Vec3(std::stod(nextRow[magIndex[imu_index]]),
-                    std::stod(nextRow[magIndex[imu_index] + 1]), std::stod(nextRow[magIndex[imu_index] + 2]));
+                magneticHeadingData(rowNumber, imu_index) = SimTK::Vec3(
+                        parseField(line, fields, magIndex[imu_index]),
+                        parseField(line, fields, magIndex[imu_index] + 1),
+                        parseField(line, fields, magIndex[imu_index] + 2));
             if (foundAngularVelocityData)
-                gyro_row_vector[imu_index] = SimTK::Vec3(std::stod(nextRow[gyroIndex[imu_index]]),
-                    std::stod(nextRow[gyroIndex[imu_index] + 1]), std::stod(nextRow[gyroIndex[imu_index] + 2]));
+                angularVelocityData(rowNumber, imu_index) = SimTK::Vec3(
+                        parseField(line, fields, gyroIndex[imu_index]),
+                        parseField(line, fields, gyroIndex[imu_index] + 1),
+                        parseField(line, fields, gyroIndex[imu_index] + 2));
             // Create Quaternion from values in file, assume order in file W, X, Y, Z
-            orientation_row_vector[imu_index] = 
-                SimTK::Quaternion(std::stod(nextRow[orientationsIndex[imu_index]]),
-                    std::stod(nextRow[orientationsIndex[imu_index] + 1]),
-                    std::stod(nextRow[orientationsIndex[imu_index] + 2]),
-                    std::stod(nextRow[orientationsIndex[imu_index] + 3]));
+            rotationsData(rowNumber, imu_index) = SimTK::Quaternion(
+                    parseField(line, fields, orientationsIndex[imu_index]),
+                    parseField(line, fields, orientationsIndex[imu_index] + 1),
+                    parseField(line, fields, orientationsIndex[imu_index] + 2),
+                    parseField(line, fields, orientationsIndex[imu_index] + 3));
         }
-        // append to the tables
-        times[rowNumber] = time;
-        if (foundLinearAccelerationData) 
-            linearAccelerationData[rowNumber] =  accel_row_vector;
-        if (foundMagneticHeadingData) 
-            magneticHeadingData[rowNumber] = magneto_row_vector;
-        if (foundAngularVelocityData) 
-            angularVelocityData[rowNumber] = gyro_row_vector;
-        rotationsData[rowNumber] = orientation_row_vector;
-        // We could get some indication of time from file or generate time based on rate
-        // Here we use the latter mechanism.
-        time += timeIncrement;
-        rowNumber++;
-        if (std::remainder(rowNumber, last_size) == 0) {
-            // resize all Data/Matrices, double the size  while keeping data
-            int newSize = last_size*2;
-            times.resize(newSize);
+    };
+
+    // Lines are read in batches, and the lines of a batch are parsed in
+    // chunks on separate threads, straight into their rows.
+    const int chunkSize = 256;
+    std::vector<std::string> lines(16 * chunkSize);
+    bool done = false;
+    double time = 0.0;
+    double timeIncrement = 1 / dataRate;
+    int rowNumber = 0;
+    bool firstBlock = true;
+    while (!done) {
+        int numLines = 0;
+        const int maxLines = std::min((int)lines.size(), blockSize - rowNumber);
+        while (numLines < maxLines) {
+            std::string& line = lines[numLines];
+            if (!std::getline(in_stream, line)) {
+                done = true;
+                break;
+            }
+            // Get rid of the extra \r if parsing a file with CRLF line endings.
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) {
+                done = true;
+                break;
+            }
+            ++numLines;
+        }
+        if (rowNumber + numLines > last_size) {
+            // resize all Data/Matrices, double the size while keeping data
+            int newSize = last_size;
+            while (newSize < rowNumber + numLines)
+                newSize = (int)std::min((long long)newSize * 2,
+                        (long long)blockSize);
             // Repeat for Data matrices in use
             if (foundLinearAccelerationData) linearAccelerationData.resizeKeep(newSize, n_imus);
             if (foundMagneticHeadingData) magneticHeadingData.resizeKeep(newSize, n_imus);
@@ -194,23 +204,46 @@ APDMDataReader::extendRead(const std::string& fileName) const {
             rotationsData.resizeKeep(newSize, n_imus);
             last_size = newSize;
         }
+        const int numChunks = (numLines + chunkSize - 1) / chunkSize;
+        runInParallel(numChunks, [&](int chunk) {
+            std::vector<int> fields;
+            const int first = chunk * chunkSize;
+            const int last = std::min(numLines, first + chunkSize);
+            for (int i = first; i < last; ++i) {
+                parseRow(lines[i], fields, rowNumber + i);
+            }
+        });
+        // We could get some indication of time from file or generate time
+        // based on rate. Here we use the latter mechanism.
+        for (int i = 0; i < numLines; ++i) {
+            times.push_back(time);
+            time += timeIncrement;
+        }
+        rowNumber += numLines;
+        if (rowNumber < blockSize && !done) continue;
+
+        // The previous block may have ended with the data.
+        if (rowNumber == 0 && !firstBlock) break;
+        firstBlock = false;
+        // Trim Matrices in use to actual data and move into tables, or size
+        // 0 for empty
+        if (rowNumber < last_size) {
+            if (foundLinearAccelerationData) linearAccelerationData.resizeKeep(rowNumber, n_imus);
+            if (foundMagneticHeadingData) magneticHeadingData.resizeKeep(rowNumber, n_imus);
+            if (foundAngularVelocityData) angularVelocityData.resizeKeep(rowNumber, n_imus);
+            rotationsData.resizeKeep(rowNumber, n_imus);
+            last_size = rowNumber;
+        }
+        // Now create the tables from matrices
+        // Create 4 tables for Rotations, LinearAccelerations, AngularVelocity, MagneticHeading
+        // Tables could be empty if data is not present in file(s)
+        DataAdapter::OutputTables tables = createTablesFromMatrices(dataRate,
+                labels, times, rotationsData, linearAccelerationData,
+                magneticHeadingData, angularVelocityData);
+        if (!sink(tables)) break;
+        times.clear();
+        rowNumber = 0;
     }
-    // Trim Matrices in use to actual data and move into tables
-    times.resize(rowNumber);
-    // Repeat for Data matrices in use and create Tables from them or size 0 for empty
-    linearAccelerationData.resizeKeep(foundLinearAccelerationData? rowNumber : 0,
-        n_imus);
-    magneticHeadingData.resizeKeep(foundMagneticHeadingData? rowNumber : 0,
-            n_imus);
-    angularVelocityData.resizeKeep(foundAngularVelocityData? rowNumber :0,
-        n_imus);
-    rotationsData.resizeKeep(rowNumber, n_imus);
-    // Now create the tables from matrices
-    // Create 4 tables for Rotations, LinearAccelerations, AngularVelocity, MagneticHeading
-    // Tables could be empty if data is not present in file(s)
-    DataAdapter::OutputTables tables = createTablesFromMatrices(dataRate, labels, times,
-        rotationsData, linearAccelerationData, magneticHeadingData, angularVelocityData);
-    return tables;
 }
 
 void APDMDataReader::find_start_column(std::vector<std::string> tokens,
@@ -68,10 +68,13 @@ protected:
     - one for MagneticHeading data, 
     - one for AngularVelocity data. 
     - Barometer and Temperature data is ignored for now
+    The lines of the file are parsed in chunks on separate threads (see
+    setNumThreads()).
      
      @see IMUDataReader class for utilities to extract/access specific table(s)
     */
-    DataAdapter::OutputTables extendRead(const std::string& fileName) const override;
+    void extendReadBlocks(const std::string& fileName, int blockSize,
+            const BlockSink& sink) const override;
 
     /** Implements writing functionality, not implemented.                         */
     virtual void extendWrite(const DataAdapter::InputTables& tables,
@@ -26,6 +26,7 @@
 #include "PiecewiseLinearFunction.h"
 #include "STOFileAdapter.h"
 #include "TimeSeriesTable.h"
+#include <algorithm>
 #include <chrono>
 #include <ctime>
 #include <iomanip>
@@ -183,3 +184,41 @@ SimTK::Real OpenSim::solveBisection(
     }
     return midpoint;
 }
+
+double OpenSim::calcMedian(std::vector<double> values) {
+    values.erase(std::remove_if(values.begin(), values.end(),
+                         [](double value) { return SimTK::isNaN(value); }),
+            values.end());
+    if (values.empty()) return SimTK::NaN;
+    const size_t half = values.size() / 2;
+    std::nth_element(values.begin(), values.begin() + half, values.end());
+    const double upper = values[half];
+    if (values.size() % 2) return upper;
+    const double lower =
+            *std::max_element(values.begin(), values.begin() + half);
+    return 0.5 * (lower + upper);
+}
+
+std::vector<bool> OpenSim::findInliers(
+        const std::vector<double>& values, double threshold) {
+    std::vector<bool> inliers(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        inliers[i] = !SimTK::isNaN(values[i]);
+    }
+    if (threshold < 0) return inliers;
+
+    const double median = calcMedian(values);
+    std::vector<double> deviations(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        deviations[i] = std::abs(values[i] - median);
+    }
+    const double medianDeviation = calcMedian(deviations);
+    // More than half of the values are equal, so their spread cannot be
+    // estimated; do not reject any value.
+    if (medianDeviation == 0) return inliers;
+    const double maxDeviation = threshold * 1.4826 * medianDeviation;
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (inliers[i] && deviations[i] > maxDeviation) inliers[i] = false;
+    }
+    return inliers;
+}
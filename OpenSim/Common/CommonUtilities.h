@@ -29,6 +29,7 @@
 #include <memory>
 #include <mutex>
 #include <stack>
+#include <vector>
 #include <condition_variable>
 
 #include <SimTKcommon/internal/BigMatrix.h>
@@ -124,6 +125,28 @@ SimTK::Real solveBisection(std::function<double(const double&)> calcResidual,
         double left, double right, const double& tolerance = 1e-6,
         int maxIterations = 1000);
 
+#ifndef SWIG
+/// The median of the values that are not NaN, or NaN if all of the values
+/// are NaN (or there are none).
+/// @ingroup commonutil
+OSIMCOMMON_API
+double calcMedian(std::vector<double> values);
+
+/// Find the values that are not outliers. A value is an inlier if it is not
+/// NaN and its distance from the median of the values is at most `threshold`
+/// times the scaled median absolute deviation (1.4826 times the median of the
+/// distances of the values from their median, which estimates the standard
+/// deviation of normally distributed values). If `threshold` is negative, or
+/// if the median absolute deviation is 0 (more than half of the values are
+/// equal, so that any other value would be rejected), only NaN values are
+/// outliers.
+/// @returns Whether each value is an inlier.
+/// @ingroup commonutil
+OSIMCOMMON_API
+std::vector<bool> findInliers(const std::vector<double>& values,
+        double threshold);
+#endif
+
 /// This class lets you store objects of a single type for reuse by multiple
 /// threads, ensuring threadsafe access to each of those objects.
 /// @ingroup commonutil
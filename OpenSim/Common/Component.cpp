@@ -79,29 +79,38 @@ public:
     {   return this->getValueZero(); }
 
     void realizeMeasureTopologyVirtual(SimTK::State& s) const override final
-    {   _Component.extendRealizeTopology(s); }
+    {   OPENSIM_INSTRUMENT_SCOPE(_Component, RealizeTopology);
+        _Component.extendRealizeTopology(s); }
     void realizeMeasureModelVirtual(SimTK::State& s) const override final
-    {   _Component.extendRealizeModel(s); }
+    {   OPENSIM_INSTRUMENT_SCOPE(_Component, RealizeModel);
+        _Component.extendRealizeModel(s); }
     void realizeMeasureInstanceVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeInstance(s); }
+    {   OPENSIM_INSTRUMENT_SCOPE(_Component, RealizeInstance);
+        _Component.extendRealizeInstance(s); }
     void realizeMeasureTimeVirtual(const SimTK::State& s) const override final
-    {   _Component.extendRealizeTime(s); }
+    {   OPENSIM_INSTRUMENT_SCOPE(_Component, RealizeTime);
+        _Component.extendRealizeTime(s); }
     void realizeMeasurePositionVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizePosition(s); }
+    {   OPENSIM_INSTRUMENT_SCOPE(_Component, RealizePosition);
+        _Component.extendRealizePosition(s); }
     void realizeMeasureVelocityVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeVelocity(s); }
+    {   OPENSIM_INSTRUMENT_SCOPE(_Component, RealizeVelocity);
+        _Component.extendRealizeVelocity(s); }
     void realizeMeasureDynamicsVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeDynamics(s); }
+    {   OPENSIM_INSTRUMENT_SCOPE(_Component, RealizeDynamics);
+        _Component.extendRealizeDynamics(s); }
     void realizeMeasureAccelerationVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeAcceleration(s); }
+    {   OPENSIM_INSTRUMENT_SCOPE(_Component, RealizeAcceleration);
+        _Component.extendRealizeAcceleration(s); }
     void realizeMeasureReportVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeReport(s); }
+    {   OPENSIM_INSTRUMENT_SCOPE(_Component, RealizeReport);
+        _Component.extendRealizeReport(s); }
 
 private:
     const Component& _Component;
@@ -394,6 +403,13 @@ void Component::addToSystem(SimTK::MultibodySystem& system) const
     extendAddToSystemAfterSubcomponents(system);
 }
 
+// The name of the cache variable that holds the value of a memoized Output.
+// The colon ensures the name does not clash with user-defined cache variables.
+static std::string getMemoizedOutputCacheVariableName(
+        const std::string& outputName) {
+    return "memoized_output:" + outputName;
+}
+
 // Base class implementation of virtual method.
 // Every Component owns an underlying SimTK::Measure 
 // which is a ComponentMeasure<T> and is added to the System's default
@@ -421,6 +437,16 @@ void Component::baseAddToSystem(SimTK::MultibodySystem& system) const
     // making realize() calls, and add it to the system's default subsystem. 
     ComponentMeasure<double> mcMeasure(system.updDefaultSubsystem(), *this);
     mutableThis->_simTKcomponentIndex = mcMeasure.getSubsystemMeasureIndex();
+
+    // Memoized Outputs store their values in cache variables.
+    for (const auto& kv : _outputsTable) {
+        const AbstractOutput& output = *kv.second;
+        if (!output.isMemoized()) continue;
+        _namedCacheVariables.emplace(
+                getMemoizedOutputCacheVariableName(output.getName()),
+                StoredCacheVariable{output.createMemoizedValue(),
+                                    output.getDependsOnStage()});
+    }
 }
 
 void Component::componentsAddToSystem(SimTK::MultibodySystem& system) const
@@ -817,6 +843,28 @@ Array<std::string> Component::getStateVariableNames() const
     return stateNames;
 }
 
+// Get the names of discrete variables maintained by the Component and its
+// subcomponents.
+Array<std::string> Component::getDiscreteVariableNames() const
+{
+    // Must have already called initSystem.
+    OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
+
+    Array<std::string> names;
+    const auto appendNames = [&names](const Component& comp) {
+        std::string pathName = comp.getAbsolutePathString();
+        if (pathName.back() != '/') pathName += "/";
+        for (const auto& kv : comp._namedDiscreteVariableInfo) {
+            names.append(pathName + kv.first);
+        }
+    };
+    appendNames(*this);
+    for (auto& comp : getComponentList<Component>()) {
+        appendNames(comp);
+    }
+    return names;
+}
+
 // Get the value of a state variable allocated by this Component.
 double Component::
     getStateVariableValue(const SimTK::State& s, const std::string& name) const
@@ -1032,6 +1080,36 @@ getDiscreteVariableValue(const SimTK::State& s, const std::string& name) const
     }
 }
 
+// Get the value of a discrete variable allocated by this Component or one of
+// its subcomponents, by path.
+double Component::
+getDiscreteVariableValue(const SimTK::State& s, const ComponentPath& path) const
+{
+    // Must have already called initSystem.
+    OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
+
+    return traverseToDiscreteVariableOwner(path).getDiscreteVariableValue(s,
+            path.getComponentName());
+}
+
+// Find the component that allocated the discrete variable with the given path.
+const Component& Component::
+traverseToDiscreteVariableOwner(const ComponentPath& path) const
+{
+    if (path.getNumPathLevels() == 1) return *this;
+    const Component* owner =
+            traversePathToComponent<Component>(path.getParentPath());
+    if (!owner) {
+        std::stringstream msg;
+        msg << "Component::traverseToDiscreteVariableOwner: ERR- no component "
+            << "owns a discrete variable with path '" << path.toString()
+            << "' in component '" << getName() << "' of type "
+            << getConcreteClassName();
+        throw Exception(msg.str(),__FILE__,__LINE__);
+    }
+    return *owner;
+}
+
 // Set the value of a discrete variable allocated by this Component by name.
 void Component::
 setDiscreteVariableValue(SimTK::State& s, const std::string& name, double value) const
@@ -1056,6 +1134,19 @@ setDiscreteVariableValue(SimTK::State& s, const std::string& name, double value)
     }
 }
 
+// Set the value of a discrete variable allocated by this Component or one of
+// its subcomponents, by path.
+void Component::
+setDiscreteVariableValue(SimTK::State& s, const ComponentPath& path,
+        double value) const
+{
+    // Must have already called initSystem.
+    OPENSIM_THROW_IF_FRMOBJ(!hasSystem(), ComponentHasNoSystem);
+
+    traverseToDiscreteVariableOwner(path).setDiscreteVariableValue(s,
+            path.getComponentName(), value);
+}
+
 SimTK::CacheEntryIndex Component::getCacheVariableIndex(const std::string& name) const
 {
     auto it = this->_namedCacheVariables.find(name);
@@ -1079,6 +1170,7 @@ bool Component::isCacheVariableValid(const SimTK::State& state, const std::strin
 
 void Component::markCacheVariableValid(const SimTK::State& state, const std::string& name) const
 {
+    OPENSIM_INSTRUMENT_COUNT(*this, CacheVariableUpdate);
     const SimTK::DefaultSystemSubsystem& subsystem = this->getDefaultSubsystem();
     const SimTK::CacheEntryIndex idx = this->getCacheVariableIndex(name);
     subsystem.markCacheValueRealized(state, idx);
@@ -1502,6 +1594,15 @@ void Component::extendRealizeTopology(SimTK::State& s) const
             cv.maybeUninitIndex = subSys.allocateLazyCacheEntry(s, cv.dependsOnStage, cv.value->clone());
         }
     }
+
+    // Tell memoized Outputs where their values are stored.
+    for (const auto& kv : _outputsTable) {
+        const AbstractOutput& output = *kv.second;
+        if (!output.isMemoized()) continue;
+        output.setMemoizedCacheEntry(subSys.getMySubsystemIndex(),
+                getCacheVariableIndex(
+                    getMemoizedOutputCacheVariableName(output.getName())));
+    }
 }
 
 
@@ -1517,7 +1618,10 @@ void Component::extendRealizeAcceleration(const SimTK::State& s) const
         const SimTK::Subsystem& subSys = getDefaultSubsystem();
 
         // evaluate and set component state derivative values (in cache) 
-        computeStateVariableDerivatives(s);
+        {
+            OPENSIM_INSTRUMENT_SCOPE(*this, ComputeStateVariableDerivatives);
+            computeStateVariableDerivatives(s);
+        }
     
         std::map<std::string, StateVariableInfo>::const_iterator it;
 
@@ -44,6 +44,7 @@
 // INCLUDES
 #include "ComponentList.h"
 #include "ComponentPath.h"
+#include "Instrumentation.h"
 #include "Logger.h"
 #include "OpenSim/Common/Array.h"
 #include "OpenSim/Common/ComponentOutput.h"
@@ -860,6 +861,17 @@ public:
      */
     Array<std::string> getStateVariableNames() const;
 
+    /**
+     * Get the names of the discrete variables (see addDiscreteVariable())
+     * maintained by the Component and its subcomponents, as absolute paths
+     * (e.g., `/forceset/soleus/override_value`). These paths can be passed to
+     * the ComponentPath overloads of getDiscreteVariableValue() and
+     * setDiscreteVariableValue().
+     * @throws ComponentHasNoSystem if this Component has not been added to a
+     *         System (i.e., if initSystem has not been called)
+     */
+    Array<std::string> getDiscreteVariableNames() const;
+
 
     /** @name Component Socket Access methods
         Access Sockets of this component by name. */
@@ -1380,6 +1392,20 @@ public:
     double getDiscreteVariableValue(const SimTK::State& state,
                                     const std::string& name) const;
 
+    /**
+     * Get the value of a discrete variable allocated by this Component or one
+     * of its subcomponents, by its path (e.g.,
+     * `forceset/soleus/override_value`); see getDiscreteVariableNames().
+     *
+     * @param state   the State from which to get the value
+     * @param path    path to the discrete variable of interest
+     * @return value  the discrete variable value
+     * @throws ComponentHasNoSystem if this Component has not been added to a
+     *         System (i.e., if initSystem has not been called)
+     */
+    double getDiscreteVariableValue(const SimTK::State& state,
+                                    const ComponentPath& path) const;
+
     /**
      * %Set the value of a discrete variable allocated by this Component by name.
      *
@@ -1392,6 +1418,19 @@ public:
     void setDiscreteVariableValue(SimTK::State& state, const std::string& name,
                                   double value) const;
 
+    /**
+     * %Set the value of a discrete variable allocated by this Component or one
+     * of its subcomponents, by its path; see getDiscreteVariableNames().
+     *
+     * @param state  the State for which to set the value
+     * @param path   path to the discrete variable
+     * @param value  the value to set
+     * @throws ComponentHasNoSystem if this Component has not been added to a
+     *         System (i.e., if initSystem has not been called)
+     */
+    void setDiscreteVariableValue(SimTK::State& state, const ComponentPath& path,
+                                  double value) const;
+
     /**
      * A cache variable containing a value of type T.
      *
@@ -1614,6 +1653,7 @@ private:
         T& currentVal = SimTK::Value<T>::downcast(valWrapper).upd();
         currentVal = std::move(value);
         subsystem.markCacheValueRealized(state, idx);
+        OPENSIM_INSTRUMENT_COUNT(*this, CacheVariableUpdate);
     }
 
 public:
@@ -1816,6 +1856,7 @@ public:
         const SimTK::DefaultSystemSubsystem& subsystem = this->getDefaultSubsystem();
         const SimTK::CacheEntryIndex idx = this->getCacheVariableIndex(cv);
         subsystem.markCacheValueRealized(state, idx);
+        OPENSIM_INSTRUMENT_COUNT(*this, CacheVariableUpdate);
     }
 
     /**
@@ -2657,6 +2698,15 @@ public:
      */
     const StateVariable* traverseToStateVariable(
             const ComponentPath& path) const;
+
+    /**
+     * Get the Component that allocated the discrete variable with the given
+     * path (e.g., `forceset/soleus/override_value`); this Component if the
+     * path is only a name. The variable itself is not looked up.
+     * @throws Exception if the Component does not exist.
+     */
+    const Component& traverseToDiscreteVariableOwner(
+            const ComponentPath& path) const;
 #endif
 
     /// @name Access to the owning component (advanced).
@@ -2789,6 +2839,22 @@ protected:
         };
         return constructOutput<T>(name, outputFunc, dependsOn);
     }
+    /** Construct an output whose value is stored in a cache variable that
+    is allocated automatically and depends on stage `dependsOn`; see
+    #OpenSim_DECLARE_MEMOIZED_OUTPUT. The requirements on the member function
+    are the same as for constructOutput(). */
+    template <typename T, typename CompType = Component>
+    bool constructMemoizedOutput(const std::string& name,
+            T (CompType::*const memFunc)(const SimTK::State&) const,
+            const SimTK::Stage& dependsOn = SimTK::Stage::Acceleration) {
+        OPENSIM_THROW_IF(dependsOn > SimTK::Stage::Report, Exception,
+            "Cannot memoize output '" + name + "' of " +
+            getConcreteClassName() + " because it depends on stage " +
+            dependsOn.getName() + ".");
+        constructOutput<T, CompType>(name, memFunc, dependsOn);
+        _outputsTable[name]->_isMemoized = true;
+        return true;
+    }
     /** Construct an output that can have multiple channels. You add Channels
     to this Output in extendFinalizeFromProperties() using
     AbstractOutput::addChannel(). The member function
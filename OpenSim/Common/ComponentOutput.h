@@ -34,9 +34,11 @@
 #include "Exception.h"
 #include "Object.h"
 
+#include <atomic>
 #include <functional>
 #include <map>
 
+#include <SimTKcommon/internal/ResetOnCopy.h>
 #include <SimTKcommon/internal/Stage.h>
 #include <SimTKcommon/internal/State.h>
 
@@ -104,7 +106,16 @@ public:
     AbstractOutput(const std::string& name, SimTK::Stage dependsOnStage,
                    bool isList) :
         name(name), dependsOnStage(dependsOnStage), _isList(isList) {}
-    AbstractOutput(const AbstractOutput& other) = default;
+    // The counters are atomic, so the copy is spelled out.
+    AbstractOutput(const AbstractOutput& other) :
+        _owner(other._owner),
+        _memoizedSubsystemIndex(other._memoizedSubsystemIndex),
+        _memoizedCacheEntryIndex(other._memoizedCacheEntryIndex),
+        _numMemoizedHits(other.getNumMemoizedHits()),
+        _numMemoizedMisses(other.getNumMemoizedMisses()),
+        name(other.name), dependsOnStage(other.dependsOnStage),
+        _numSigFigs(other._numSigFigs), _isList(other._isList),
+        _isMemoized(other._isMemoized) {}
     virtual ~AbstractOutput() = default;
 
     /** Output's name */
@@ -145,6 +156,30 @@ public:
     void         setNumberOfSignificantDigits(unsigned int numSigFigs) 
     { _numSigFigs = numSigFigs; }
 
+    /** @name Memoization
+    A memoized Output (see #OpenSim_DECLARE_MEMOIZED_OUTPUT) stores its value
+    in a cache variable of the owning Component, so that the value is computed
+    at most once until the State changes at or below the Output's
+    dependsOnStage. The counters may be updated by several threads that
+    evaluate this Output at once. */
+    /// @{
+    /** Is the value of this Output stored in a cache variable? */
+    bool isMemoized() const { return _isMemoized; }
+    /** The number of times the value was taken from the cache. */
+    long long getNumMemoizedHits() const {
+        return _numMemoizedHits.load(std::memory_order_relaxed);
+    }
+    /** The number of times the value was computed and stored in the cache. */
+    long long getNumMemoizedMisses() const {
+        return _numMemoizedMisses.load(std::memory_order_relaxed);
+    }
+    /** %Set the hit and miss counts to zero. */
+    void resetMemoizationCounts() const {
+        _numMemoizedHits.store(0, std::memory_order_relaxed);
+        _numMemoizedMisses.store(0, std::memory_order_relaxed);
+    }
+    /// @}
+
 protected:
 
     // Set the component that contains this Output.
@@ -152,13 +187,30 @@ protected:
         _owner.reset(&owner);
     }
 
+    // Create a cache variable value that can hold the value of this Output.
+    virtual SimTK::AbstractValue* createMemoizedValue() const = 0;
+
+    // Set the location of the cache entry holding the value of a memoized
+    // Output; done by the owning Component when realizing Topology.
+    void setMemoizedCacheEntry(SimTK::SubsystemIndex subsystemIndex,
+            SimTK::CacheEntryIndex cacheEntryIndex) const {
+        _memoizedSubsystemIndex = subsystemIndex;
+        _memoizedCacheEntryIndex = cacheEntryIndex;
+    }
+
     SimTK::ReferencePtr<const Component> _owner;
 
+    mutable SimTK::ResetOnCopy<SimTK::SubsystemIndex> _memoizedSubsystemIndex;
+    mutable SimTK::ResetOnCopy<SimTK::CacheEntryIndex> _memoizedCacheEntryIndex;
+    mutable std::atomic<long long> _numMemoizedHits{0};
+    mutable std::atomic<long long> _numMemoizedMisses{0};
+
 private:
     std::string name;
     SimTK::Stage dependsOnStage;
     unsigned int _numSigFigs = 8;
     bool _isList = false;
+    bool _isMemoized = false;
 
     // For calling setOwner().
     friend Component;
@@ -289,8 +341,7 @@ public:
                     state.getSystemStage(), getDependsOnStage(),
                     "Output::getValue(state)");
         }
-        _outputFcn(_owner.get(), state, "", _result);
-        return _result;
+        return evaluate(state, "", _result);
     }
     
     std::string getTypeName() const override {
@@ -311,6 +362,40 @@ public:
     Output<T>* clone() const override { return new Output(*this); }
     SimTK_DOWNCAST(Output, AbstractOutput);
 
+protected:
+    SimTK::AbstractValue* createMemoizedValue() const override {
+        return new SimTK::Value<T>();
+    }
+
+private:
+    // Invoke the output function. If this Output is memoized, the value is
+    // only computed if the cache entry is not valid; otherwise, the value is
+    // computed into `result`.
+    const T& evaluate(const SimTK::State& state, const std::string& channel,
+            T& result) const {
+        if (_memoizedCacheEntryIndex.isValid() &&
+                state.getSystemStage() >= getDependsOnStage()) {
+            if (state.isCacheValueRealized(_memoizedSubsystemIndex,
+                        _memoizedCacheEntryIndex)) {
+                _numMemoizedHits.fetch_add(1, std::memory_order_relaxed);
+                return SimTK::Value<T>::downcast(state.getCacheEntry(
+                        _memoizedSubsystemIndex, _memoizedCacheEntryIndex))
+                        .get();
+            }
+            T& value = SimTK::Value<T>::updDowncast(state.updCacheEntry(
+                    _memoizedSubsystemIndex, _memoizedCacheEntryIndex)).upd();
+            _outputFcn(_owner.get(), state, channel, value);
+            state.markCacheValueRealized(_memoizedSubsystemIndex,
+                    _memoizedCacheEntryIndex);
+            _numMemoizedMisses.fetch_add(1, std::memory_order_relaxed);
+            return value;
+        }
+        _outputFcn(_owner.get(), state, channel, result);
+        return result;
+    }
+
+public:
+
     /** For use in python/java/MATLAB bindings. */
     // This method exists for consistency with Object's safeDownCast.
     static Output<T>* safeDownCast(AbstractOutput* parent) {
@@ -339,8 +424,7 @@ public:
      : _output(output), _channelName(channelName) {}
     const T& getValue(const SimTK::State& state) const {
         // Must cache, since we're returning a reference.
-        _output->_outputFcn(_output->_owner.get(), state, _channelName, _result);
-        return _result;
+        return _output->evaluate(state, _channelName, _result);
     }
     const Output<T>& getOutput() const { return _output.getRef(); }
     const std::string& getChannelName() const override {
@@ -420,6 +504,46 @@ private:
         this->template constructOutput<T>(#oname, &Self::func, ostage)      \
     };                                                                      \
     /** @endcond                                                         */
+
+/**
+ * Create an output whose value is stored in an automatically allocated cache
+ * variable of this component, so that the member function is invoked at most
+ * once until the State changes at or below stage `ostage`; subsequent
+ * requests for the value (e.g., by multiple reporters, Inputs, or Moco goals)
+ * return the stored value. Use this instead of #OpenSim_DECLARE_OUTPUT for
+ * expensive outputs that are requested several times per realization. The
+ * requirements on `func` are the same as for #OpenSim_DECLARE_OUTPUT, except
+ * that `func` must return the value by value, and `ostage` must not be
+ * SimTK::Stage::Infinity. Use AbstractOutput::getNumMemoizedHits() to see how
+ * often the stored value was used.
+ *
+ * @code{.cpp}
+ * class MyComponent : public Component {
+ * public:
+ *     OpenSim_DECLARE_MEMOIZED_OUTPUT(power, double, computePower,
+ *             SimTK::Stage::Velocity);
+ *     ...
+ * };
+ * @endcode
+ *
+ * @see Component::constructMemoizedOutput()
+ * @relates OpenSim::Output
+ */
+#define OpenSim_DECLARE_MEMOIZED_OUTPUT(oname, T, func, ostage)             \
+    /** @name Outputs                                                    */ \
+    /** @{                                                               */ \
+    /** Provides the value of func##() and is available at stage ostage. */ \
+    /** The value is stored in a cache variable.                         */ \
+    /** This output was generated with the                               */ \
+    /** #OpenSim_DECLARE_MEMOIZED_OUTPUT macro.                          */ \
+    OpenSim_DOXYGEN_Q_PROPERTY(T, oname)                                    \
+    /** @}                                                               */ \
+    /** @cond                                                            */ \
+    bool _has_output_##oname {                                              \
+        this->template constructMemoizedOutput<T>(#oname, &Self::func,      \
+                ostage)                                                     \
+    };                                                                      \
+    /** @endcond                                                         */
     
 /**
  * Create a list output for a member function of this component. A list output
@@ -58,7 +58,8 @@ public:
 
 private:
     double _timeStamp;
-    SimTK::RowVectorView_<U> _data;
+    // The entry owns a copy of the data.
+    SimTK::RowVector_<U> _data;
 };
 /**
  * DataQueue is a wrapper around the std::queue customized to handle data 
@@ -66,6 +67,8 @@ private:
  * subset of operations needed for this use case. 
  * Synchronization is experimental as of now. Client is responsible for 
  * making sure order is preserved.
+ * Each entry is allocated and the queue takes a lock; for data pushed at a
+ * high rate, use DataRingBuffer_ instead.
  * timestamp is required to pass in data so that clients can enforce order,
  * however timestamp is not used/order-enforced internally.
  */
@@ -86,7 +89,7 @@ public:
         m_data_queue = other.m_data_queue;
     };
     DataQueue_(DataQueue_&& other){ 
-        m_data_queue = other.m_data_queue;
+        m_data_queue = std::move(other.m_data_queue);
     };
     DataQueue_& operator=(const DataQueue_& other) { 
         m_data_queue = other.m_data_queue;
@@ -98,9 +101,9 @@ public:
     //--------------------------------------------------------------------------
     // push data and associated timestamp to the end of the queue
     void push_back(const double time, const SimTK::RowVectorView_<T>& data) { 
-        SimTK::RowVector_<T>* deepCopy = new SimTK::RowVector_<T>(data);
+        DataQueueEntry_<T> entry(time, data);
         std::unique_lock<std::mutex> mlock(m_mutex);
-        m_data_queue.push(DataQueueEntry_<T>(time, *deepCopy));
+        m_data_queue.push(std::move(entry));
         mlock.unlock();     // unlock before notificiation to minimize mutex con
         m_cond.notify_one(); 
     }
@@ -108,7 +111,7 @@ public:
     void pop_front(double& time, SimTK::RowVector_<T>& data) { 
         std::unique_lock<std::mutex> mlock(m_mutex);
         while (m_data_queue.empty()) { m_cond.wait(mlock); }
-        DataQueueEntry_<SimTK::Rotation> frontEntry = m_data_queue.front();
+        DataQueueEntry_<T> frontEntry = std::move(m_data_queue.front());
         m_data_queue.pop();
         mlock.unlock(); 
         time = frontEntry.getTimeStamp();
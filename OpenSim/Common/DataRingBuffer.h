@@ -0,0 +1,393 @@
+#ifndef OPENSIM_DATA_RING_BUFFER_H_
+#define OPENSIM_DATA_RING_BUFFER_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  DataRingBuffer.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+#include "Exception.h"
+#include <SimTKcommon.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <thread>
+
+namespace OpenSim {
+
+/**
+ * A queue of timestamped rows of data, all with the same number of elements,
+ * for passing samples between threads that run at different rates, such as
+ * a thread that receives live IMU data and an InverseKinematicsSolver. It
+ * replaces DataQueue_ where rows are pushed at a high rate.
+ *
+ * The buffer holds at most a fixed number of rows (its capacity), and all
+ * of its memory is allocated by allocate() (or the constructor that takes
+ * the capacity): pushing and popping rows only copies the values. No locks
+ * are taken. Each slot of the buffer has a sequence number that tells
+ * producers whether the slot is free and consumers whether it holds a row
+ * (D. Vyukov's bounded queue), and producers and consumers claim a slot by
+ * incrementing their position with a compare-and-swap. Any number of
+ * threads may push and pop concurrently; with a single producer and a
+ * single consumer, the claims never contend. The rows from one producer are
+ * popped in the order they were pushed.
+ *
+ * What push_back() does when the buffer is full is set by the
+ * OverflowPolicy. The timestamps are not used by the buffer; clients are
+ * responsible for pushing the rows in order.
+ *
+ * allocate(), copying and assignment are not thread-safe: the buffer must
+ * not be used by other threads during these operations.
+ */
+template <class T> class DataRingBuffer_ {
+public:
+    /** What push_back() does with a row when the buffer is full. */
+    enum class OverflowPolicy {
+        /// The producer waits until a consumer has made room. No rows are
+        /// lost.
+        Block,
+        /// The new row is discarded and counted; see getNumDropped().
+        DropNewest,
+        /// The oldest row in the buffer is discarded and counted to make
+        /// room for the new row, so that the buffer holds the most recent
+        /// rows.
+        DropOldest,
+        /// push_back() throws an Exception.
+        Throw
+    };
+
+    //--------------------------------------------------------------------------
+    // CONSTRUCTION
+    //--------------------------------------------------------------------------
+    /** Create a buffer without memory; call allocate() before using it. */
+    DataRingBuffer_() = default;
+
+    /** Create a buffer that holds up to `capacity` rows of `rowWidth`
+     * elements. See allocate(). */
+    DataRingBuffer_(int capacity, int rowWidth,
+            OverflowPolicy policy = OverflowPolicy::Block) {
+        allocate(capacity, rowWidth, policy);
+    }
+
+    /** The copy has the same capacity, row width and overflow policy, and
+     * holds the same rows. */
+    DataRingBuffer_(const DataRingBuffer_& other) { copyFrom(other); }
+    /** The new buffer takes the memory and the rows of `other`, which is
+     * left without memory, as if it had not been allocated. Neither buffer
+     * may be used by other threads meanwhile. */
+    DataRingBuffer_(DataRingBuffer_&& other) noexcept { moveFrom(other); }
+    DataRingBuffer_& operator=(const DataRingBuffer_& other) {
+        if (this != &other) copyFrom(other);
+        return *this;
+    }
+    DataRingBuffer_& operator=(DataRingBuffer_&& other) noexcept {
+        if (this != &other) moveFrom(other);
+        return *this;
+    }
+
+    /** Allocate the memory for up to `capacity` rows (rounded up to a power
+     * of 2, and at least 2) of `rowWidth` elements, discarding any rows in
+     * the buffer.
+     * @throws Exception if the capacity or the row width is not positive. */
+    void allocate(int capacity, int rowWidth,
+            OverflowPolicy policy = OverflowPolicy::Block) {
+        OPENSIM_THROW_IF(capacity <= 0, Exception,
+                "Expected a positive capacity, but got {}.", capacity);
+        OPENSIM_THROW_IF(rowWidth <= 0, Exception,
+                "Expected a positive row width, but got {}.", rowWidth);
+        size_t roundedCapacity = 2;
+        while (roundedCapacity < static_cast<size_t>(capacity))
+            roundedCapacity *= 2;
+
+        m_capacity = roundedCapacity;
+        m_rowWidth = rowWidth;
+        m_policy = policy;
+        m_times.reset(new double[m_capacity]);
+        m_rows.reset(new T[m_capacity * m_rowWidth]);
+        m_sequences.reset(new std::atomic<size_t>[m_capacity]);
+        for (size_t i = 0; i < m_capacity; ++i)
+            m_sequences[i].store(i, std::memory_order_relaxed);
+        m_pushPosition.store(0, std::memory_order_relaxed);
+        m_popPosition.store(0, std::memory_order_relaxed);
+        m_numDropped.store(0, std::memory_order_relaxed);
+        m_allocated.store(true, std::memory_order_release);
+    }
+
+    //--------------------------------------------------------------------------
+    // ACCESSORS
+    //--------------------------------------------------------------------------
+    /** Whether allocate() has been called. Until then, the buffer is empty
+     * and rows cannot be pushed. */
+    bool isAllocated() const {
+        return m_allocated.load(std::memory_order_acquire);
+    }
+    int getCapacity() const { return static_cast<int>(m_capacity); }
+    int getRowWidth() const { return m_rowWidth; }
+    OverflowPolicy getOverflowPolicy() const { return m_policy; }
+    /** The number of rows discarded with OverflowPolicy::DropNewest or
+     * OverflowPolicy::DropOldest since the buffer was allocated. */
+    long long getNumDropped() const {
+        return m_numDropped.load(std::memory_order_relaxed);
+    }
+    /** The number of rows in the buffer. This is only a snapshot if other
+     * threads are pushing or popping. */
+    int getSize() const {
+        if (!isAllocated()) return 0;
+        const size_t pop = m_popPosition.load(std::memory_order_acquire);
+        const size_t push = m_pushPosition.load(std::memory_order_acquire);
+        return push > pop ? static_cast<int>(push - pop) : 0;
+    }
+    bool isEmpty() const { return getSize() == 0; }
+
+    //--------------------------------------------------------------------------
+    // PRODUCER INTERFACE
+    //--------------------------------------------------------------------------
+    /** Copy a row and its timestamp to the end of the buffer. If the buffer
+     * is full, what happens depends on the OverflowPolicy.
+     * @returns false if the row was discarded (OverflowPolicy::DropNewest).
+     * @throws Exception if the buffer is not allocated, the row does not
+     *     have getRowWidth() elements, or the buffer is full with
+     *     OverflowPolicy::Throw. */
+    bool push_back(double time, const SimTK::RowVectorView_<T>& data) {
+        OPENSIM_THROW_IF(data.size() != m_rowWidth, Exception,
+                "Expected a row with {} elements, but got {}.", m_rowWidth,
+                data.size());
+        return pushRow(time, [&data](T* row, int width) {
+            for (int i = 0; i < width; ++i) row[i] = data[i];
+        });
+    }
+    /** Same as above. */
+    bool push_back(double time, const SimTK::RowVector_<T>& data) {
+        return push_back(time, data.getAsRowVectorView());
+    }
+    /** Same as above, for a row given as an array of getRowWidth()
+     * elements. */
+    bool push_back(double time, const T* data) {
+        return pushRow(time, [data](T* row, int width) {
+            for (int i = 0; i < width; ++i) row[i] = data[i];
+        });
+    }
+
+    //--------------------------------------------------------------------------
+    // CONSUMER INTERFACE
+    //--------------------------------------------------------------------------
+    /** Pop the row at the front of the buffer and its timestamp, waiting
+     * until a row is available. `data` is resized to getRowWidth(), which
+     * only allocates memory if it has a different size. */
+    void pop_front(double& time, SimTK::RowVector_<T>& data) {
+        int numWaits = 0;
+        while (!try_pop_front(time, data)) waitForOtherThreads(numWaits);
+    }
+    /** Wait until a row is available, then pass it to `function` and pop
+     * it, as for drain(). This avoids copying the row to a RowVector_. */
+    template <class F> void pop_front(F&& function) {
+        int numWaits = 0;
+        while (drain(function, 1) == 0) waitForOtherThreads(numWaits);
+    }
+    /** Pop the row at the front of the buffer and its timestamp, if there is
+     * one, without waiting.
+     * @returns false if the buffer is empty. */
+    bool try_pop_front(double& time, SimTK::RowVector_<T>& data) {
+        return popRow([&](double rowTime, const T* row, int width) {
+            time = rowTime;
+            data.resize(width);
+            for (int i = 0; i < width; ++i) data[i] = row[i];
+        });
+    }
+    /** Pass up to `maxRows` rows at the front of the buffer, in order, to
+     * `function`, and pop them. The rows are not copied: `function` is
+     * invoked as `function(time, row)` with a pointer to the getRowWidth()
+     * elements of the row in the buffer, which is only valid during the
+     * call. Rows pushed during the call may also be passed.
+     * @returns The number of rows popped. */
+    template <class F>
+    int drain(F&& function, int maxRows = std::numeric_limits<int>::max()) {
+        int numRows = 0;
+        while (numRows < maxRows &&
+                popRow([&function](double rowTime, const T* row, int) {
+                    function(rowTime, row);
+                })) {
+            ++numRows;
+        }
+        return numRows;
+    }
+
+private:
+    static void waitForOtherThreads(int& numWaits) {
+        // Yield briefly in case the other thread is about to finish, then
+        // sleep so that a long wait does not occupy a core.
+        if (++numWaits < 64)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    // Claim the slot at the push position, let `write` fill in the row, and
+    // hand the slot to the consumers.
+    template <class W> bool pushRow(double time, W&& write) {
+        OPENSIM_THROW_IF(!isAllocated(), Exception,
+                "Cannot push a row before the buffer is allocated.");
+        const size_t mask = m_capacity - 1;
+        int numWaits = 0;
+        size_t position = m_pushPosition.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& sequence = m_sequences[position & mask];
+            const auto difference = static_cast<std::ptrdiff_t>(
+                    sequence.load(std::memory_order_acquire) - position);
+            if (difference == 0) {
+                // The slot is free; claim it.
+                if (m_pushPosition.compare_exchange_weak(position,
+                            position + 1, std::memory_order_relaxed))
+                    break;
+            } else if (difference < 0) {
+                // The slot still holds a row (or a consumer is reading it):
+                // the buffer is full.
+                switch (m_policy) {
+                case OverflowPolicy::Block:
+                    waitForOtherThreads(numWaits);
+                    break;
+                case OverflowPolicy::DropNewest:
+                    m_numDropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                case OverflowPolicy::DropOldest:
+                    if (popRow([](double, const T*, int) {}))
+                        m_numDropped.fetch_add(1, std::memory_order_relaxed);
+                    else
+                        waitForOtherThreads(numWaits);
+                    break;
+                case OverflowPolicy::Throw:
+                    OPENSIM_THROW(Exception, "The buffer is full ({} rows).",
+                            m_capacity);
+                }
+                position = m_pushPosition.load(std::memory_order_relaxed);
+            } else {
+                // Another producer claimed the slot.
+                position = m_pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        const size_t slot = position & mask;
+        m_times[slot] = time;
+        write(&m_rows[slot * m_rowWidth], m_rowWidth);
+        m_sequences[slot].store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Claim the slot at the pop position, if it holds a row, let `read` use
+    // the row, and hand the slot back to the producers.
+    template <class R> bool popRow(R&& read) {
+        if (!isAllocated()) return false;
+        const size_t mask = m_capacity - 1;
+        size_t position = m_popPosition.load(std::memory_order_relaxed);
+        for (;;) {
+            auto& sequence = m_sequences[position & mask];
+            const auto difference = static_cast<std::ptrdiff_t>(
+                    sequence.load(std::memory_order_acquire) - (position + 1));
+            if (difference == 0) {
+                // The slot holds a row; claim it.
+                if (m_popPosition.compare_exchange_weak(position,
+                            position + 1, std::memory_order_relaxed))
+                    break;
+            } else if (difference < 0) {
+                // The slot is free (or a producer is writing it): the buffer
+                // is empty.
+                return false;
+            } else {
+                // Another consumer claimed the slot.
+                position = m_popPosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        const size_t slot = position & mask;
+        try {
+            read(m_times[slot], &m_rows[slot * m_rowWidth], m_rowWidth);
+        } catch (...) {
+            m_sequences[slot].store(position + m_capacity,
+                    std::memory_order_release);
+            throw;
+        }
+        m_sequences[slot].store(position + m_capacity,
+                std::memory_order_release);
+        return true;
+    }
+
+    void copyFrom(const DataRingBuffer_& other) {
+        if (!other.isAllocated()) {
+            m_allocated.store(false, std::memory_order_release);
+            return;
+        }
+        allocate(other.getCapacity(), other.m_rowWidth, other.m_policy);
+        const size_t mask = m_capacity - 1;
+        const size_t pop = other.m_popPosition.load(std::memory_order_acquire);
+        const size_t push = other.m_pushPosition.load(std::memory_order_acquire);
+        for (size_t position = pop; position < push; ++position) {
+            const size_t slot = position & mask;
+            push_back(other.m_times[slot], &other.m_rows[slot * m_rowWidth]);
+        }
+        m_numDropped.store(other.getNumDropped(), std::memory_order_relaxed);
+    }
+
+    void moveFrom(DataRingBuffer_& other) noexcept {
+        m_capacity = other.m_capacity;
+        m_rowWidth = other.m_rowWidth;
+        m_policy = other.m_policy;
+        m_times = std::move(other.m_times);
+        m_rows = std::move(other.m_rows);
+        m_sequences = std::move(other.m_sequences);
+        m_numDropped.store(other.getNumDropped(), std::memory_order_relaxed);
+        m_pushPosition.store(
+                other.m_pushPosition.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+        m_popPosition.store(
+                other.m_popPosition.load(std::memory_order_relaxed),
+                std::memory_order_relaxed);
+        m_allocated.store(other.isAllocated(), std::memory_order_release);
+
+        other.m_capacity = 0;
+        other.m_rowWidth = 0;
+        other.m_numDropped.store(0, std::memory_order_relaxed);
+        other.m_pushPosition.store(0, std::memory_order_relaxed);
+        other.m_popPosition.store(0, std::memory_order_relaxed);
+        other.m_allocated.store(false, std::memory_order_release);
+    }
+
+    size_t m_capacity = 0;
+    int m_rowWidth = 0;
+    OverflowPolicy m_policy = OverflowPolicy::Block;
+    std::unique_ptr<double[]> m_times;
+    std::unique_ptr<T[]> m_rows;
+    std::unique_ptr<std::atomic<size_t>[]> m_sequences;
+    std::atomic<bool> m_allocated{false};
+    std::atomic<long long> m_numDropped{0};
+    // The push and pop positions are on separate cache lines so that the
+    // producer and the consumer do not invalidate each other's cache.
+    char m_padding0[64];
+    std::atomic<size_t> m_pushPosition{0};
+    char m_padding1[64];
+    std::atomic<size_t> m_popPosition{0};
+    char m_padding2[64];
+
+//=============================================================================
+};  // END of class templatized DataRingBuffer_<T>
+//=============================================================================
+}
+
+#endif // OPENSIM_DATA_RING_BUFFER_H_
@@ -0,0 +1,279 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  FunctionSetEvaluator.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "PiecewiseCubicTable.h"
+
+#include "FunctionSetEvaluator.h"
+
+#include "Constant.h"
+#include "FunctionSet.h"
+#include "GCVSpline.h"
+#include "gcvspl.h"
+
+#include <algorithm>
+
+using namespace OpenSim;
+
+FunctionSetEvaluator::FunctionSetEvaluator(const FunctionSet& functions) :
+        m_numFunctions(functions.getSize()) {
+    const SimTK::Vector arg(1, 0.0);
+    std::vector<std::vector<const GCVSpline*>> groupSplines;
+    for (int i = 0; i < m_numFunctions; ++i) {
+        const Function& function = functions.get(i);
+        if (const auto* constant = dynamic_cast<const Constant*>(&function)) {
+            m_constantIndices.push_back(i);
+            m_constantValues.push_back(constant->getValue());
+            continue;
+        }
+        // Create the underlying SimTK::Function now; Function creates it
+        // lazily on first evaluation, which is not thread safe. For a
+        // GCVSpline, this also computes the coefficients.
+        function.calcValue(arg);
+        const auto* spline = dynamic_cast<const GCVSpline*>(&function);
+        if (!spline || spline->getSize() < 2 * spline->getHalfOrder()) {
+            m_otherIndices.push_back(i);
+            m_otherFunctions.push_back(&function);
+            continue;
+        }
+        const Array<double>& x = spline->getX();
+        auto group = std::find_if(m_splineGroups.begin(), m_splineGroups.end(),
+                [&](const SplineGroup& g) {
+                    return g.halfOrder == spline->getHalfOrder() &&
+                           (int)g.knots.size() == x.getSize() &&
+                           std::equal(g.knots.begin(), g.knots.end(), x.get());
+                });
+        if (group == m_splineGroups.end()) {
+            m_splineGroups.emplace_back();
+            groupSplines.emplace_back();
+            group = m_splineGroups.end() - 1;
+            group->halfOrder = spline->getHalfOrder();
+            group->knots.assign(x.get(), x.get() + x.getSize());
+        }
+        group->functionIndices.push_back(i);
+        groupSplines[group - m_splineGroups.begin()].push_back(spline);
+    }
+
+    size_t tableauSize = 0;
+    size_t resultSize = 0;
+    for (size_t ig = 0; ig < m_splineGroups.size(); ++ig) {
+        SplineGroup& group = m_splineGroups[ig];
+        const int numSplines = (int)group.functionIndices.size();
+        const int numKnots = (int)group.knots.size();
+        group.coefficients.resize(numKnots * numSplines);
+        for (int c = 0; c < numSplines; ++c) {
+            const Array<double>& coefficients =
+                    groupSplines[ig][c]->getCoefficients();
+            for (int j = 0; j < numKnots; ++j) {
+                group.coefficients[j * numSplines + c] = coefficients[j];
+            }
+        }
+        tableauSize = std::max(tableauSize,
+                (size_t)(2 * group.halfOrder * numSplines));
+        resultSize = std::max(resultSize, (size_t)numSplines);
+    }
+    m_tableau.resize(tableauSize);
+    m_result.resize(resultSize);
+}
+
+void FunctionSetEvaluator::calcValuesAndDerivatives(double time,
+        double* values, double* firstDerivatives, double* secondDerivatives) {
+    double* const outputs[3] = {values, firstDerivatives, secondDerivatives};
+
+    for (SplineGroup& group : m_splineGroups) {
+        search((int)group.knots.size(), group.knots.data(), time,
+                &group.interval);
+        const int numSplines = (int)group.functionIndices.size();
+        for (int order = 0; order < 3; ++order) {
+            double* output = outputs[order];
+            if (!output) continue;
+            calcSplineDerivatives(group, order, time, group.interval);
+            for (int c = 0; c < numSplines; ++c) {
+                output[group.functionIndices[c]] = m_result[c];
+            }
+        }
+    }
+
+    for (size_t i = 0; i < m_constantIndices.size(); ++i) {
+        const int index = m_constantIndices[i];
+        values[index] = m_constantValues[i];
+        if (firstDerivatives) firstDerivatives[index] = 0;
+        if (secondDerivatives) secondDerivatives[index] = 0;
+    }
+
+    if (m_otherFunctions.empty()) return;
+    static const std::vector<int> first{0};
+    static const std::vector<int> second{0, 0};
+    const SimTK::Vector arg(1, time);
+    for (size_t i = 0; i < m_otherFunctions.size(); ++i) {
+        const int index = m_otherIndices[i];
+        const Function& function = *m_otherFunctions[i];
+        values[index] = function.calcValue(arg);
+        if (firstDerivatives) {
+            firstDerivatives[index] = function.calcDerivative(first, arg);
+        }
+        if (secondDerivatives) {
+            secondDerivatives[index] = function.calcDerivative(second, arg);
+        }
+    }
+}
+
+// This is splder() of gcvspl.c (see there for the algorithm and its
+// reference) with the interval already found and each operation on the
+// tableau applied to all splines of the group; the operations are done in the
+// same order, with the same rounding, as in splder(). Row r of the tableau,
+// q(r + 1) in splder(), holds one value per spline.
+void FunctionSetEvaluator::calcSplineDerivatives(const SplineGroup& group,
+        int derivOrder, double time, int interval) {
+    const int ns = (int)group.functionIndices.size();
+    const int m = group.halfOrder;
+    const int n = (int)group.knots.size();
+    const double* x = group.knots.data();
+    const double* coefficients = group.coefficients.data();
+    double* result = m_result.data();
+    const int l = interval;
+    const int ider = derivOrder;
+    auto q = [&](int r) { return m_tableau.data() + (r - 1) * ns; };
+
+    // Derivatives of order 2m or higher are zero.
+    const int m2 = 2 * m;
+    const int k = m2 - ider;
+    if (k < 1) {
+        std::fill(result, result + ns, 0.0);
+        return;
+    }
+
+    // Initialize the first row of the B-spline coefficients tableau.
+    const double tt = time;
+    const int mp1 = m + 1;
+    const int npm = n + m;
+    const int m2m1 = m2 - 1;
+    const int k1 = k - 1;
+    const int nk = n - k;
+    const int lk = l - k;
+    const int lk1 = lk + 1;
+    int jl = l + 1;
+    const int ju = l + m2;
+    int ii = n - m2;
+    int ml = -l;
+    for (int j = jl; j <= ju; ++j) {
+        double* qj = q(j + ml);
+        if (j >= mp1 && j <= npm) {
+            const double* cj = coefficients + (j - m - 1) * ns;
+            std::copy(cj, cj + ns, qj);
+        } else {
+            std::fill(qj, qj + ns, 0.0);
+        }
+    }
+
+    // Differences of the B-spline coefficients, for the derivatives.
+    if (ider > 0) {
+        jl -= m2;
+        ml += m2;
+        for (int i = 1; i <= ider; ++i) {
+            ++jl;
+            ++ii;
+            const int j1 = std::max(1, jl);
+            const int j2 = std::min(l, ii);
+            const int mi = m2 - i;
+            int j = j2 + 1;
+            for (int jin = j1; jin <= j2; ++jin) {
+                --j;
+                const int jm = ml + j;
+                const double dx = x[j + mi - 1] - x[j - 1];
+                double* qa = q(jm);
+                const double* qb = q(jm - 1);
+                for (int c = 0; c < ns; ++c) qa[c] = (qa[c] - qb[c]) / dx;
+            }
+            if (jl < 1) {
+                j = ml + 1;
+                for (int jin = i + 1; jin <= ml; ++jin) {
+                    --j;
+                    double* qa = q(j);
+                    const double* qb = q(j - 1);
+                    for (int c = 0; c < ns; ++c) qa[c] = -qb[c];
+                }
+            }
+        }
+        for (int j = 1; j <= k; ++j) {
+            const double* qb = q(j + ider);
+            std::copy(qb, qb + ns, q(j));
+        }
+    }
+
+    // The lower half of the evaluation tableau.
+    for (int i = 1; i <= k1; ++i) {
+        const int nki = nk + i;
+        int ir = k;
+        int jj = l;
+        const int ki = k - i;
+
+        // Right-hand splines.
+        for (int j = nki + 1; j <= l; ++j) {
+            const double dt = tt - x[jj - 1];
+            double* qa = q(ir);
+            const double* qb = q(ir - 1);
+            for (int c = 0; c < ns; ++c) qa[c] = qb[c] + dt * qa[c];
+            --jj;
+            --ir;
+        }
+
+        // Middle B-splines.
+        const int lk1i = lk1 + i;
+        const int j1 = std::max(1, lk1i);
+        const int j2 = std::min(l, nki);
+        for (int j = j1; j <= j2; ++j) {
+            const double xjki = x[jj + ki - 1];
+            const double dt = xjki - tt;
+            const double dx = xjki - x[jj - 1];
+            double* qa = q(ir);
+            const double* qb = q(ir - 1);
+            for (int c = 0; c < ns; ++c) {
+                const double z = qa[c];
+                qa[c] = z + dt * (qb[c] - z) / dx;
+            }
+            --ir;
+            --jj;
+        }
+
+        // Left-hand B-splines.
+        if (lk1i <= 0) {
+            jj = ki;
+            for (int j = 1; j <= 1 - lk1i; ++j) {
+                const double dt = x[jj - 1] - tt;
+                double* qa = q(ir);
+                const double* qb = q(ir - 1);
+                for (int c = 0; c < ns; ++c) qa[c] = qa[c] + dt * qb[c];
+                --jj;
+                --ir;
+            }
+        }
+    }
+
+    // Multiply by the factorial of the derivative order.
+    const double* qk = q(k);
+    std::copy(qk, qk + ns, result);
+    if (ider > 0) {
+        for (int j = k; j <= m2m1; ++j) {
+            for (int c = 0; c < ns; ++c) result[c] *= j;
+        }
+    }
+}
@@ -0,0 +1,99 @@
+#ifndef OPENSIM_FUNCTION_SET_EVALUATOR_H_
+#define OPENSIM_FUNCTION_SET_EVALUATOR_H_
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  FunctionSetEvaluator.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <vector>
+
+namespace OpenSim {
+
+class Function;
+class FunctionSet;
+
+/**
+ * Evaluate the values and the first and second derivatives of all the
+ * single-argument functions of a FunctionSet at one time, as for the
+ * coordinate functions of inverse dynamics.
+ *
+ * GCVSpline%s that have the same knots and order, as the splines that
+ * GCVSplineSet fits to the columns of a Storage, are evaluated together: the
+ * interval containing the time is searched once, and the evaluation tableau of
+ * splder() in gcvspl.c is computed for all splines at once, with the
+ * coefficients of the splines stored contiguously. Constant functions have
+ * zero derivatives, and other functions are evaluated with calcValue() and
+ * calcDerivative().
+ *
+ * The results agree with FunctionSet::evaluate() to within roundoff. An
+ * evaluator has work space, so a thread must not use an evaluator that
+ * another thread is using; copy the evaluator for each thread instead.
+ */
+class OSIMCOMMON_API FunctionSetEvaluator {
+public:
+    FunctionSetEvaluator() = default;
+
+    /** Prepare to evaluate the functions of the set. The spline coefficients
+     * are copied, but the set must outlive the evaluator if it contains
+     * functions other than GCVSpline and Constant. */
+    explicit FunctionSetEvaluator(const FunctionSet& functions);
+
+    int getNumFunctions() const { return m_numFunctions; }
+
+    /** Evaluate the functions at the given time. Each of the arrays must
+     * have room for getNumFunctions() values; `firstDerivatives` and
+     * `secondDerivatives` may be null if they are not needed. */
+    void calcValuesAndDerivatives(double time, double* values,
+            double* firstDerivatives, double* secondDerivatives);
+
+private:
+    // GCVSplines with the same knots and half order.
+    struct SplineGroup {
+        int halfOrder = 0;
+        std::vector<double> knots;
+        std::vector<int> functionIndices;
+        // coefficients[j * numSplines + c] is coefficient j of spline c.
+        std::vector<double> coefficients;
+        // The interval found by the previous search, to speed up the next.
+        int interval = 0;
+    };
+
+    // Compute the derivative of order `derivOrder` of the splines of the
+    // group at `time`, which is in `interval`, into m_result.
+    void calcSplineDerivatives(const SplineGroup& group, int derivOrder,
+            double time, int interval);
+
+    int m_numFunctions = 0;
+    std::vector<SplineGroup> m_splineGroups;
+    std::vector<int> m_constantIndices;
+    std::vector<double> m_constantValues;
+    std::vector<int> m_otherIndices;
+    std::vector<const Function*> m_otherFunctions;
+
+    // Work space: the evaluation tableau (2 * halfOrder rows of one value per
+    // spline) and the results of a spline group.
+    std::vector<double> m_tableau;
+    std::vector<double> m_result;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_FUNCTION_SET_EVALUATOR_H_
@@ -1,4 +1,10 @@
 #include "IMUDataReader.h"
+#include "Exception.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <limits>
+#include <thread>
 
 namespace OpenSim {
 
@@ -48,4 +54,93 @@ namespace OpenSim {
         return tables;
 
     }
+
+    void IMUDataReader::readBlocks(const std::string& dataSourceSpecification,
+            int blockSize, const BlockSink& sink) const {
+        OPENSIM_THROW_IF(blockSize < 1, Exception,
+                "Expected a positive block size, but got {}.", blockSize);
+        extendReadBlocks(dataSourceSpecification, blockSize, sink);
+    }
+
+    DataAdapter::OutputTables IMUDataReader::extendRead(
+            const std::string& dataSourceSpecification) const {
+        DataAdapter::OutputTables tables;
+        extendReadBlocks(dataSourceSpecification,
+                std::numeric_limits<int>::max(),
+                [&tables](const DataAdapter::OutputTables& block) {
+                    tables = block;
+                    return true;
+                });
+        return tables;
+    }
+
+    void IMUDataReader::runInParallel(int numTasks,
+            const std::function<void(int index)>& task) const {
+        int numThreads = _numThreads;
+        if (numThreads < 1) {
+            numThreads =
+                    std::max(1, (int)std::thread::hardware_concurrency());
+        }
+        numThreads = std::max(1, std::min(numThreads, numTasks));
+
+        std::atomic<int> nextTask(0);
+        std::vector<std::exception_ptr> errors(numThreads);
+        auto runTasks = [&](int ithread) {
+            try {
+                while (true) {
+                    const int index = nextTask++;
+                    if (index >= numTasks) break;
+                    task(index);
+                }
+            } catch (...) {
+                errors[ithread] = std::current_exception();
+                // Stop the other threads early.
+                nextTask = numTasks;
+            }
+        };
+        std::vector<std::thread> threads;
+        for (int ithread = 1; ithread < numThreads; ++ithread) {
+            threads.emplace_back(runTasks, ithread);
+        }
+        runTasks(0);
+        for (auto& thread : threads) thread.join();
+        for (const auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+    }
+
+    void IMUDataReader::findFieldStarts(const std::string& line,
+            const char* delims, std::vector<int>& fieldStarts) {
+        fieldStarts.clear();
+        std::string::size_type start{0}, end{std::string::npos};
+        while ((end = line.find_first_of(delims, start)) !=
+                std::string::npos) {
+            fieldStarts.push_back(static_cast<int>(start));
+            start = end + 1;
+        }
+        // As tokenize(), ignore an empty field at the end of the line.
+        if (line.size() > start) {
+            fieldStarts.push_back(static_cast<int>(start));
+        }
+    }
+
+    double IMUDataReader::parseField(const std::string& line,
+            const std::vector<int>& fieldStarts, int field) {
+        OPENSIM_THROW_IF(field >= (int)fieldStarts.size(), Exception,
+                "Expected at least {} fields, but the line '{}' has {}.",
+                field + 1, line, fieldStarts.size());
+        const char* begin = line.c_str() + fieldStarts[field];
+        const char* fieldEnd =
+                field + 1 < (int)fieldStarts.size()
+                        ? line.c_str() + fieldStarts[field + 1] - 1
+                        : line.c_str() + line.size();
+        char* end = nullptr;
+        const double value = std::strtod(begin, &end);
+        // strtod() skips leading white space, which may include delimiters,
+        // so make sure the number is in this field.
+        OPENSIM_THROW_IF(end == begin || end > fieldEnd, Exception,
+                "Expected a number in field {} of the line '{}'.", field + 1,
+                line);
+        return value;
+    }
 }
@@ -25,6 +25,8 @@
 #include "TimeSeriesTable.h"
 #include "DataAdapter.h"
 
+#include <functional>
+
 /** @file
 * This file defines common base class for various IMU DataReader
 * classes that support different IMU providers
@@ -37,6 +39,12 @@ class OSIMCOMMON_API IMUDataReader : public DataAdapter {
 
 public:
     
+    /** The function to which readBlocks() passes each block of rows. The
+     * tables are as those returned by read(), but hold only the rows of the
+     * block. Return false to stop reading. */
+    typedef std::function<bool(const DataAdapter::OutputTables& block)>
+            BlockSink;
+
     IMUDataReader() = default;
     IMUDataReader(const IMUDataReader&)            = default;
     IMUDataReader(IMUDataReader&&)                 = default;
@@ -67,7 +75,50 @@ public:
     static const TimeSeriesTableVec3& getAngularVelocityTable(const DataAdapter::OutputTables& tables) {
         return dynamic_cast<const TimeSeriesTableVec3&>(*tables.at(AngularVelocity));
     }
+
+    /** Read the data from a dataSourceSpecification (as for read()) in
+     * blocks of at most blockSize rows, passing the tables of each block to
+     * sink, so that long recordings can be processed without holding all of
+     * the data in memory. The times of the rows continue from one block to
+     * the next. The sink is called at least once, with empty tables if there
+     * are no data. */
+    void readBlocks(const std::string& dataSourceSpecification,
+            int blockSize, const BlockSink& sink) const;
+
+    /** Set the number of threads used to parse the data. If numThreads is
+     * less than 1 (the default), the number of cores is used. */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
+
 protected:
+    /** Reads all of the data as one block with extendReadBlocks(). */
+    DataAdapter::OutputTables extendRead(
+            const std::string& dataSourceSpecification) const override;
+
+    /** Implements readBlocks() for the file format of the reader; blockSize
+     * is positive. */
+    virtual void extendReadBlocks(const std::string& dataSourceSpecification,
+            int blockSize, const BlockSink& sink) const = 0;
+
+    /** Call task(index) for each index in [0, numTasks) on up to
+     * getNumThreads() threads (including the calling thread). If a task
+     * throws, the remaining tasks are skipped and the exception is rethrown
+     * once all threads have stopped. */
+    void runInParallel(int numTasks,
+            const std::function<void(int index)>& task) const;
+
+    /** Find where each of the fields of line starts, splitting the line at
+     * each of the characters in delims in the same way as
+     * FileAdapter::tokenize(), but without copying the fields. */
+    static void findFieldStarts(const std::string& line,
+            const char* delims, std::vector<int>& fieldStarts);
+    /** Parse the number in a field of line as std::stod() does for the
+     * token of the field.
+     * @throws Exception if the line has too few fields or the field does not
+     *     start with a number. */
+    static double parseField(const std::string& line,
+            const std::vector<int>& fieldStarts, int field);
+
     /** create a map of names to TimeSeriesTables. MetaData contains dataRate.
      * The result can be passed to accessors above to get individual TimeSeriesTable(s)
      * If a matrix has nrows = 0 then an empty table is created.
@@ -78,6 +129,9 @@ protected:
         const SimTK::Matrix_<SimTK::Vec3>& linearAccelerationData, 
         const SimTK::Matrix_<SimTK::Vec3>& magneticHeadingData, 
         const SimTK::Matrix_<SimTK::Vec3>& angularVelocityData) const;
+
+private:
+    int _numThreads{0};
 };
 
 } // OpenSim namespace
@@ -691,10 +691,19 @@ void IO::eraseEmptyElements(std::vector<std::string>& list)
     }
 }
 
+namespace {
+// Held by the CwdChangers that change the working directory of the process.
+std::recursive_mutex& getCwdMutex() {
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+}
+
 IO::CwdChanger::CwdChanger() {
 }
 
 IO::CwdChanger::CwdChanger(const std::string& newDir) :
+    _lock{getCwdMutex()},
     _existingDir{getCwd()} {
 
     chDir(newDir);
@@ -725,6 +734,7 @@ IO::CwdChanger IO::CwdChanger::changeToParentOf(const std::string& path) {
 // `~CwdChanger` requires that `tmp._existingDir.empty() == true`; otherwise,
 // destruction of the temporary will cause a directory change.
 IO::CwdChanger::CwdChanger(IO::CwdChanger&& tmp) :
+    _lock{std::move(tmp._lock)},
     _existingDir{} {
 
     std::swap(this->_existingDir, tmp._existingDir);
@@ -733,16 +743,19 @@ IO::CwdChanger::CwdChanger(IO::CwdChanger&& tmp) :
 IO::CwdChanger& IO::CwdChanger::operator=(CwdChanger&& tmp) {
     this->_existingDir.clear();
     std::swap(this->_existingDir, tmp._existingDir);
+    this->_lock = std::move(tmp._lock);
     return *this;
 }
 
 void IO::CwdChanger::restore() {
-    chDir(_existingDir);
+    if (!_existingDir.empty()) chDir(_existingDir);
     _existingDir.clear();
+    if (_lock.owns_lock()) _lock.unlock();
 }
 
 void IO::CwdChanger::stay() noexcept {
     _existingDir.clear();
+    if (_lock.owns_lock()) _lock.unlock();
 }
 
 IO::CwdChanger::~CwdChanger() noexcept {
@@ -31,6 +31,7 @@
 // INCLUDES
 #include "osimCommonDLL.h"
 #include <fstream>
+#include <mutex>
 #include <vector>
 
 // DEFINES
@@ -142,8 +143,20 @@ public:
      *
      * - On destruction: switches the calling process's working directory
      *   back to its original directory.
+     *
+     * The working directory is shared by all threads of the process, so a
+     * CwdChanger that changes the directory holds a process-wide lock until
+     * it changes back (or stay() is called): threads that change the
+     * directory at the same time take turns. A thread must therefore not
+     * wait, while it holds such a CwdChanger, for another thread that
+     * changes the directory. Code that runs on several threads at once
+     * should use absolute file paths outside of a CwdChanger, and hold a
+     * CwdChanger only while it reads or writes files with relative names
+     * (not, e.g., while solving), so that other threads are not serialized
+     * behind it.
      */
     class OSIMCOMMON_API CwdChanger final {
+        std::unique_lock<std::recursive_mutex> _lock;
         std::string _existingDir;
 
         /**
@@ -200,7 +213,8 @@ public:
         /**
          * Release CwdChanger's control over the current working directory,
          * such that the CwdChanger instance does not attempt to change back
-         * to its original directory on destruction.
+         * to its original directory on destruction. This also releases the
+         * lock on the working directory.
          */
         void stay() noexcept;
 
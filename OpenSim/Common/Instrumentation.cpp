@@ -0,0 +1,362 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  Instrumentation.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "Instrumentation.h"
+
+#include "Component.h"
+#include "Exception.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+using namespace OpenSim;
+
+static const int NumCategories =
+        (int)Instrumentation::Category::NumCategories;
+
+namespace OpenSim {
+// Cumulative statistics for one component. The counters are atomic so that
+// multiple threads can record into the same component (e.g., when one model
+// is evaluated on several States concurrently).
+struct InstrumentationRecord {
+    InstrumentationRecord(const Component& component)
+            : path(component.getAbsolutePathString()),
+              type(component.getConcreteClassName()) {
+        for (int i = 0; i < NumCategories; ++i) {
+            counts[i].store(0, std::memory_order_relaxed);
+            nanoseconds[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    const std::string path;
+    const std::string type;
+    std::atomic<long long> counts[NumCategories];
+    std::atomic<long long> nanoseconds[NumCategories];
+};
+} // namespace OpenSim
+
+namespace {
+
+struct TraceEvent {
+    const InstrumentationRecord* record;
+    Instrumentation::Category category;
+    long long startTime;
+    long long duration;
+};
+
+// Trace events recorded by one thread. Only that thread appends events; the
+// mutex is only contended while exporting or resetting.
+struct ThreadTrace {
+    int threadIndex;
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+};
+
+struct InstrumentationRegistry {
+    std::atomic<bool> enabled{false};
+    std::atomic<bool> recordTraceEvents{false};
+    std::atomic<int> maxEventsPerThread{1000000};
+    // Incremented by reset() to invalidate the per-thread lookup caches.
+    std::atomic<unsigned long long> generation{0};
+    long long startTime = SimTK::realTimeInNs();
+
+    std::mutex mutex;
+    std::unordered_map<const Component*,
+            std::unique_ptr<InstrumentationRecord>> records;
+    std::vector<std::shared_ptr<ThreadTrace>> traces;
+};
+
+InstrumentationRegistry& getRegistry() {
+    static InstrumentationRegistry registry;
+    return registry;
+}
+
+// Avoids locking the registry's mutex for every instrumented call.
+struct ThreadLookupCache {
+    unsigned long long generation = (unsigned long long)-1;
+    std::unordered_map<const Component*, InstrumentationRecord*> records;
+};
+
+InstrumentationRecord& findOrCreateRecord(const Component& component) {
+    auto& registry = getRegistry();
+    thread_local ThreadLookupCache cache;
+    const auto generation = registry.generation.load();
+    if (cache.generation != generation) {
+        cache.records.clear();
+        cache.generation = generation;
+    }
+    auto it = cache.records.find(&component);
+    if (it != cache.records.end()) return *it->second;
+
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto& record = registry.records[&component];
+    if (!record) record.reset(new InstrumentationRecord(component));
+    cache.records[&component] = record.get();
+    return *record;
+}
+
+ThreadTrace& getThreadTrace() {
+    thread_local std::shared_ptr<ThreadTrace> trace;
+    if (!trace) {
+        auto& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        trace = std::make_shared<ThreadTrace>();
+        trace->threadIndex = (int)registry.traces.size();
+        registry.traces.push_back(trace);
+    }
+    return *trace;
+}
+
+// Escape a string for use in JSON.
+std::string escapeJSON(const std::string& s) {
+    std::string out;
+    out.reserve(s.size());
+    for (const char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+} // anonymous namespace
+
+bool Instrumentation::isCompiledIn() {
+#ifdef OPENSIM_WITH_INSTRUMENTATION
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Instrumentation::setEnabled(bool enabled) {
+    if (enabled && !isCompiledIn()) {
+        log_warn("Instrumentation is not available in this build of "
+                 "OpenSim; rebuild with OPENSIM_WITH_INSTRUMENTATION=ON.");
+    }
+    getRegistry().enabled = enabled;
+}
+
+bool Instrumentation::isEnabled() {
+    return getRegistry().enabled;
+}
+
+void Instrumentation::setRecordTraceEvents(bool record,
+        int maxEventsPerThread) {
+    OPENSIM_THROW_IF(maxEventsPerThread < 0, Exception,
+            "Expected maxEventsPerThread to be non-negative, but got {}.",
+            maxEventsPerThread);
+    auto& registry = getRegistry();
+    registry.maxEventsPerThread = maxEventsPerThread;
+    registry.recordTraceEvents = record;
+}
+
+bool Instrumentation::getRecordTraceEvents() {
+    return getRegistry().recordTraceEvents;
+}
+
+void Instrumentation::reset() {
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (auto& trace : registry.traces) {
+        std::lock_guard<std::mutex> traceLock(trace->mutex);
+        trace->events.clear();
+    }
+    registry.records.clear();
+    ++registry.generation;
+    registry.startTime = SimTK::realTimeInNs();
+}
+
+long long Instrumentation::getCallCount(
+        const Component& component, Category category) {
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.records.find(&component);
+    if (it == registry.records.end()) return 0;
+    return it->second->counts[(int)category];
+}
+
+double Instrumentation::getTotalTime(
+        const Component& component, Category category) {
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.records.find(&component);
+    if (it == registry.records.end()) return 0;
+    return SimTK::nsToSec(it->second->nanoseconds[(int)category]);
+}
+
+std::string Instrumentation::getCategoryName(Category category) {
+    switch (category) {
+    case Category::ComputeForce: return "computeForce";
+    case Category::ComputeControls: return "computeControls";
+    case Category::ComputeStateVariableDerivatives:
+        return "computeStateVariableDerivatives";
+    case Category::ComputePath: return "computePath";
+    case Category::ComputeLengtheningSpeed: return "computeLengtheningSpeed";
+    case Category::RealizeTopology: return "realizeTopology";
+    case Category::RealizeModel: return "realizeModel";
+    case Category::RealizeInstance: return "realizeInstance";
+    case Category::RealizeTime: return "realizeTime";
+    case Category::RealizePosition: return "realizePosition";
+    case Category::RealizeVelocity: return "realizeVelocity";
+    case Category::RealizeDynamics: return "realizeDynamics";
+    case Category::RealizeAcceleration: return "realizeAcceleration";
+    case Category::RealizeReport: return "realizeReport";
+    case Category::CacheVariableUpdate: return "cacheVariableUpdate";
+    default:
+        OPENSIM_THROW(Exception, "Internal error.");
+    }
+}
+
+std::string Instrumentation::getReport(int maxRows) {
+    struct Row {
+        const InstrumentationRecord* record;
+        int category;
+        long long count;
+        long long nanoseconds;
+    };
+    std::vector<Row> rows;
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (const auto& entry : registry.records) {
+        const auto& record = *entry.second;
+        for (int i = 0; i < NumCategories; ++i) {
+            const long long count = record.counts[i];
+            if (count == 0) continue;
+            rows.push_back({&record, i, count, record.nanoseconds[i]});
+        }
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        if (a.nanoseconds != b.nanoseconds) {
+            return a.nanoseconds > b.nanoseconds;
+        }
+        return a.count > b.count;
+    });
+    if (maxRows >= 0 && (int)rows.size() > maxRows) rows.resize(maxRows);
+
+    std::string report = fmt::format("{:<50} {:<32} {:<32} {:>12} {:>14} "
+            "{:>14}\n", "component", "type", "operation", "calls",
+            "total (ms)", "mean (us)");
+    for (const auto& row : rows) {
+        report += fmt::format("{:<50} {:<32} {:<32} {:>12} {:>14.3f} "
+                "{:>14.3f}\n",
+                row.record->path, row.record->type,
+                getCategoryName((Category)row.category), row.count,
+                1e-6 * row.nanoseconds,
+                1e-3 * row.nanoseconds / row.count);
+    }
+    return report;
+}
+
+void Instrumentation::printReport(int maxRows) {
+    log_cout("{}", getReport(maxRows));
+}
+
+void Instrumentation::writeChromeTrace(const std::string& filename) {
+    std::ofstream out(filename);
+    OPENSIM_THROW_IF(!out, Exception,
+            "Could not open file '{}' for writing.", filename);
+
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first = true;
+    const auto writeEvent = [&](const InstrumentationRecord& record,
+                                    int category, int threadIndex,
+                                    double startInUs, double durationInUs,
+                                    long long count) {
+        if (!first) out << ",\n";
+        first = false;
+        out << fmt::format("{{\"name\": \"{}\", \"cat\": \"{}\", "
+                           "\"ph\": \"X\", \"pid\": 0, \"tid\": {}, "
+                           "\"ts\": {:.3f}, \"dur\": {:.3f}, "
+                           "\"args\": {{\"type\": \"{}\", \"calls\": {}}}}}",
+                escapeJSON(record.path),
+                getCategoryName((Category)category), threadIndex, startInUs,
+                durationInUs, escapeJSON(record.type), count);
+    };
+
+    bool haveEvents = false;
+    for (auto& trace : registry.traces) {
+        std::lock_guard<std::mutex> traceLock(trace->mutex);
+        for (const auto& event : trace->events) {
+            haveEvents = true;
+            writeEvent(*event.record, (int)event.category,
+                    trace->threadIndex,
+                    1e-3 * (event.startTime - registry.startTime),
+                    1e-3 * event.duration, 1);
+        }
+    }
+    if (!haveEvents) {
+        // Lay out the cumulative statistics of each category back to back,
+        // so the viewer shows the share of time taken by each component.
+        for (int i = 0; i < NumCategories; ++i) {
+            double start = 0;
+            for (const auto& entry : registry.records) {
+                const auto& record = *entry.second;
+                const long long count = record.counts[i];
+                if (count == 0) continue;
+                const double duration = 1e-3 * record.nanoseconds[i];
+                writeEvent(record, i, i, start, duration, count);
+                start += duration;
+            }
+        }
+    }
+    out << "\n]}\n";
+}
+
+Instrumentation::ScopedTimer::ScopedTimer(
+        const Component& component, Category category)
+        : m_record(nullptr), m_category(category), m_startTime(0) {
+    if (!isEnabled()) return;
+    m_record = &findOrCreateRecord(component);
+    m_startTime = SimTK::realTimeInNs();
+}
+
+Instrumentation::ScopedTimer::~ScopedTimer() {
+    if (!m_record) return;
+    const long long duration = SimTK::realTimeInNs() - m_startTime;
+    const int index = (int)m_category;
+    m_record->counts[index].fetch_add(1, std::memory_order_relaxed);
+    m_record->nanoseconds[index].fetch_add(
+            duration, std::memory_order_relaxed);
+
+    auto& registry = getRegistry();
+    if (registry.recordTraceEvents.load(std::memory_order_relaxed)) {
+        auto& trace = getThreadTrace();
+        std::lock_guard<std::mutex> lock(trace.mutex);
+        if ((int)trace.events.size() < registry.maxEventsPerThread) {
+            trace.events.push_back(
+                    {m_record, m_category, m_startTime, duration});
+        }
+    }
+}
+
+void Instrumentation::incrementCount(
+        const Component& component, Category category) {
+    if (!isEnabled()) return;
+    findOrCreateRecord(component).counts[(int)category].fetch_add(
+            1, std::memory_order_relaxed);
+}
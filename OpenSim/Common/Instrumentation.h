@@ -0,0 +1,171 @@
+#ifndef OPENSIM_INSTRUMENTATION_H_
+#define OPENSIM_INSTRUMENTATION_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  Instrumentation.h                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <string>
+
+namespace OpenSim {
+
+class Component;
+// Implementation detail of Instrumentation.
+struct InstrumentationRecord;
+
+/// This is a static class for measuring how much time each Component spends
+/// in the computationally expensive parts of a simulation (computing forces,
+/// controls, state variable derivatives, muscle paths, and realizing each
+/// Stage). Use it to find out which Force, Controller or GeometryPath makes a
+/// simulation slow without an external profiler.
+///
+/// Instrumentation is only available if OpenSim was built with the CMake
+/// option OPENSIM_WITH_INSTRUMENTATION; otherwise, the instrumentation points
+/// compile to nothing, nothing is recorded, and isCompiledIn() returns false.
+/// Even when compiled in, nothing is recorded until you call
+/// setEnabled(true).
+///
+/// @code
+/// Instrumentation::setEnabled(true);
+/// Manager manager(model, state);
+/// manager.integrate(1.0);
+/// Instrumentation::printReport();
+/// Instrumentation::writeChromeTrace("simulation_trace.json");
+/// @endcode
+///
+/// Times are wall-clock times and are inclusive: the time to realize
+/// Acceleration for a component includes the time to compute its state
+/// variable derivatives. Recording from multiple threads is supported. Do not
+/// invoke reset(), getReport() or writeChromeTrace() while other threads are
+/// recording. Statistics are associated with the address of each component,
+/// so invoke reset() before instrumenting a new model.
+class OSIMCOMMON_API Instrumentation {
+public:
+    Instrumentation() = delete;
+
+    /// The instrumented operations.
+    enum class Category {
+        ComputeForce = 0,
+        ComputeControls,
+        ComputeStateVariableDerivatives,
+        ComputePath,
+        ComputeLengtheningSpeed,
+        RealizeTopology,
+        RealizeModel,
+        RealizeInstance,
+        RealizeTime,
+        RealizePosition,
+        RealizeVelocity,
+        RealizeDynamics,
+        RealizeAcceleration,
+        RealizeReport,
+        /// Only the number of times a cache variable is marked valid (after
+        /// it has been recomputed) is recorded, not the time.
+        CacheVariableUpdate,
+        NumCategories
+    };
+
+    /// Whether OpenSim was built with OPENSIM_WITH_INSTRUMENTATION.
+    static bool isCompiledIn();
+
+    /// Start or stop recording. Recording is off by default.
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /// In addition to the cumulative statistics, record the start time and
+    /// duration of every instrumented call, for writeChromeTrace(). This
+    /// requires memory proportional to the number of calls, so each thread
+    /// records at most `maxEventsPerThread` events.
+    static void setRecordTraceEvents(bool record,
+            int maxEventsPerThread = 1000000);
+    static bool getRecordTraceEvents();
+
+    /// Discard everything that has been recorded.
+    static void reset();
+
+    /// The number of recorded calls of the given category for the given
+    /// component.
+    static long long getCallCount(
+            const Component& component, Category category);
+    /// The total recorded wall time, in seconds, of calls of the given
+    /// category for the given component.
+    static double getTotalTime(const Component& component, Category category);
+
+    /// A table with one row per component and category, sorted by total time
+    /// (descending), containing the number of calls, the total time, and the
+    /// mean time per call. Only the first `maxRows` rows are included; use -1
+    /// to include all rows.
+    static std::string getReport(int maxRows = 50);
+    /// Log the result of getReport() using log_cout().
+    static void printReport(int maxRows = 50);
+
+    /// Write the recorded trace events (see setRecordTraceEvents()) in the
+    /// Chrome Trace Event format, which can be viewed with chrome://tracing or
+    /// https://ui.perfetto.dev. If no events were recorded, the cumulative
+    /// statistics are written as one event per component and category.
+    static void writeChromeTrace(const std::string& filename);
+
+    /// The name of a Category (e.g., "computeForce").
+    static std::string getCategoryName(Category category);
+
+#ifndef SWIG
+    /// Records the time between its construction and destruction. Use the
+    /// OPENSIM_INSTRUMENT_SCOPE() macro instead of using this class directly.
+    class OSIMCOMMON_API ScopedTimer {
+    public:
+        ScopedTimer(const Component& component, Category category);
+        ~ScopedTimer();
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    private:
+        InstrumentationRecord* m_record;
+        Category m_category;
+        long long m_startTime;
+    };
+
+    /// Use the OPENSIM_INSTRUMENT_COUNT() macro instead of calling this
+    /// function directly.
+    static void incrementCount(const Component& component, Category category);
+#endif
+};
+
+} // namespace OpenSim
+
+/// @name Instrumentation points
+/// These macros compile to nothing unless OPENSIM_WITH_INSTRUMENTATION is
+/// defined. `category` is the name of an Instrumentation::Category.
+/// @{
+#ifdef OPENSIM_WITH_INSTRUMENTATION
+/// Record the time until the end of the enclosing scope.
+#define OPENSIM_INSTRUMENT_SCOPE(component, category)                        \
+    OpenSim::Instrumentation::ScopedTimer osimInstrumentationScopedTimer(   \
+            component, OpenSim::Instrumentation::Category::category)
+/// Record one call, without timing it.
+#define OPENSIM_INSTRUMENT_COUNT(component, category)                        \
+    OpenSim::Instrumentation::incrementCount(                               \
+            component, OpenSim::Instrumentation::Category::category)
+#else
+#define OPENSIM_INSTRUMENT_SCOPE(component, category)
+#define OPENSIM_INSTRUMENT_COUNT(component, category)
+#endif
+/// @}
+
+#endif // OPENSIM_INSTRUMENTATION_H_
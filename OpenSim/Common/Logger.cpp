@@ -28,6 +28,15 @@
 
 #include "spdlog/sinks/stdout_color_sinks.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
 using namespace OpenSim;
 
 static void initializeLogger(spdlog::logger& l, const char* pattern) {
@@ -104,23 +113,280 @@ spdlog::logger& Logger::getDefaultLogger() {
     return *defaultLogger;
 }
 
+namespace {
+
+// The sinks of the cout logger and of the default logger are kept in separate
+// lists because they are formatted differently.
+enum SinkListIndex { CoutSinks = 0, DefaultSinks = 1, NumSinkLists = 2 };
+
+// Background writer used in asynchronous mode. Loggers enqueue copies of their
+// messages into a bounded multi-producer/single-consumer ring buffer (Dmitry
+// Vyukov's bounded queue). Each slot carries a sequence number that tells
+// producers and the consumer whether the slot is free or filled, so enqueuing
+// takes no lock. Slots are allocated up front and their payload strings keep
+// their capacity, so steady-state logging does not allocate. The writer thread
+// drains the queue into the actual sinks and flushes them when the queue runs
+// empty.
+class AsyncLogWriter {
+public:
+    AsyncLogWriter(std::size_t capacity, Logger::AsyncOverflowPolicy policy,
+            std::atomic<long long>& numDropped)
+            : m_capacity(capacity), m_mask(capacity - 1),
+              m_slots(new Slot[capacity]), m_policy(policy),
+              m_numDropped(numDropped) {
+        for (std::size_t i = 0; i < m_capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_thread = std::thread(&AsyncLogWriter::run, this);
+    }
+
+    // Writes all remaining messages before returning.
+    ~AsyncLogWriter() {
+        {
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_stopRequested = true;
+        }
+        m_wakeCondition.notify_one();
+        m_thread.join();
+    }
+
+    void enqueue(SinkListIndex target, const spdlog::details::log_msg& msg) {
+        std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &m_slots[pos & m_mask];
+            const std::size_t seq =
+                    slot->sequence.load(std::memory_order_acquire);
+            const auto diff = (std::ptrdiff_t)seq - (std::ptrdiff_t)pos;
+            if (diff == 0) {
+                if (m_enqueuePos.compare_exchange_weak(
+                            pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // The queue is full.
+                if (m_policy == Logger::AsyncOverflowPolicy::Drop) {
+                    ++m_numDropped;
+                    return;
+                }
+                wakeWriter();
+                std::this_thread::yield();
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            } else {
+                // Another producer claimed this slot first.
+                pos = m_enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        new (&slot->message) spdlog::details::log_msg(msg);
+        slot->payload.assign(msg.payload.data(), msg.payload.size());
+        slot->target = target;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        // Pairs with the fence in run(); see the comment there.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_writerWaiting.load(std::memory_order_relaxed)) wakeWriter();
+    }
+
+    // Block until every message enqueued before this call has been written
+    // and the sinks have been flushed.
+    void waitUntilWritten() {
+        const std::size_t target = m_enqueuePos.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(m_flushedMutex);
+        m_flushRequested = true;
+        wakeWriter();
+        m_flushedCondition.wait(lock, [this, target] {
+            return m_numFlushed >= target;
+        });
+    }
+
+    // Access to the actual sinks requires holding getSinksMutex().
+    std::vector<spdlog::sink_ptr>& updSinks(SinkListIndex index) {
+        return m_sinks[index];
+    }
+    std::mutex& getSinksMutex() { return m_sinksMutex; }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        // The log_msg is copy-constructed in place when the slot is filled;
+        // it has no default constructor in every spdlog version we support.
+        typename std::aligned_storage<sizeof(spdlog::details::log_msg),
+                alignof(spdlog::details::log_msg)>::type message;
+        // The payload of the original message points to a temporary buffer,
+        // so it is copied here.
+        std::string payload;
+        SinkListIndex target;
+    };
+
+    void wakeWriter() {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.notify_one();
+    }
+
+    // Write the next message, if there is one. Only the writer thread
+    // invokes this function.
+    bool writeNext() {
+        Slot& slot = m_slots[m_dequeuePos & m_mask];
+        const std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if ((std::ptrdiff_t)seq - (std::ptrdiff_t)(m_dequeuePos + 1) < 0) {
+            return false;
+        }
+        auto* msg = reinterpret_cast<spdlog::details::log_msg*>(&slot.message);
+        msg->payload = spdlog::string_view_t(
+                slot.payload.data(), slot.payload.size());
+        for (auto& sink : m_sinks[slot.target]) {
+            if (!sink->should_log(msg->level)) continue;
+            try {
+                sink->log(*msg);
+            } catch (const std::exception& e) {
+                // We cannot log this error, since we are the logger.
+                std::cerr << "[*** LOG ERROR ***] " << e.what() << std::endl;
+            }
+        }
+        msg->~log_msg();
+        slot.sequence.store(m_dequeuePos + m_capacity,
+                std::memory_order_release);
+        ++m_dequeuePos;
+        return true;
+    }
+
+    void flushSinks() {
+        for (auto& sinks : m_sinks) {
+            for (auto& sink : sinks) {
+                try {
+                    sink->flush();
+                } catch (const std::exception& e) {
+                    std::cerr << "[*** LOG ERROR ***] " << e.what()
+                              << std::endl;
+                }
+            }
+        }
+    }
+
+    void run() {
+        for (;;) {
+            bool wroteMessages = false;
+            {
+                std::lock_guard<std::mutex> lock(m_sinksMutex);
+                while (writeNext()) wroteMessages = true;
+                // The queue ran empty; this is a good time to flush (the
+                // synchronous loggers flush after every message).
+                if (wroteMessages || m_flushRequested) flushSinks();
+            }
+            {
+                std::lock_guard<std::mutex> lock(m_flushedMutex);
+                m_numFlushed = m_dequeuePos;
+                m_flushRequested = false;
+            }
+            m_flushedCondition.notify_all();
+
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_writerWaiting.store(true, std::memory_order_relaxed);
+            // Either a producer sees m_writerWaiting and wakes us, or we see
+            // its message here; the fences rule out missing both.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const bool empty = !isNextSlotFilled();
+            if (empty && m_stopRequested) break;
+            if (empty && !m_flushRequested) {
+                // The timeout is only a safety net.
+                m_wakeCondition.wait_for(lock, std::chrono::milliseconds(100));
+            }
+            m_writerWaiting.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    bool isNextSlotFilled() const {
+        const Slot& slot = m_slots[m_dequeuePos & m_mask];
+        return slot.sequence.load(std::memory_order_acquire) ==
+               m_dequeuePos + 1;
+    }
+
+    const std::size_t m_capacity;
+    const std::size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+    const Logger::AsyncOverflowPolicy m_policy;
+    std::atomic<long long>& m_numDropped;
+
+    std::atomic<std::size_t> m_enqueuePos{0};
+    // Only accessed by the writer thread.
+    std::size_t m_dequeuePos = 0;
+
+    std::mutex m_sinksMutex;
+    std::vector<spdlog::sink_ptr> m_sinks[NumSinkLists];
+
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::atomic<bool> m_writerWaiting{false};
+    bool m_stopRequested = false;
+
+    std::mutex m_flushedMutex;
+    std::condition_variable m_flushedCondition;
+    std::size_t m_numFlushed = 0;
+    std::atomic<bool> m_flushRequested{false};
+
+    std::thread m_thread;
+};
+
+// In asynchronous mode, this is the only sink of each logger. It hands the
+// message to the writer thread, which forwards it to the actual sinks.
+class AsyncForwardingSink : public spdlog::sinks::sink {
+public:
+    AsyncForwardingSink(AsyncLogWriter& writer, SinkListIndex target)
+            : m_writer(writer), m_target(target) {}
+    void log(const spdlog::details::log_msg& msg) override {
+        m_writer.enqueue(m_target, msg);
+    }
+    // The writer thread flushes the actual sinks.
+    void flush() override {}
+    // The actual sinks keep their own formatters.
+    void set_pattern(const std::string&) override {}
+    void set_formatter(std::unique_ptr<spdlog::formatter>) override {}
+private:
+    AsyncLogWriter& m_writer;
+    const SinkListIndex m_target;
+};
+
+} // anonymous namespace
+
+static std::unique_ptr<AsyncLogWriter> asyncWriter = nullptr;
+
+static std::atomic<long long> numDroppedMessages{0};
+
+// Write any queued messages when the program exits. This object is destroyed
+// before the loggers above, since it is constructed after them.
+static struct AsyncLoggingShutdown {
+    ~AsyncLoggingShutdown() { Logger::disableAsync(); }
+} asyncLoggingShutdown;
+
 static void addSinkInternal(std::shared_ptr<spdlog::sinks::sink> sink) {
+    if (asyncWriter) {
+        std::lock_guard<std::mutex> lock(asyncWriter->getSinksMutex());
+        asyncWriter->updSinks(CoutSinks).push_back(sink);
+        asyncWriter->updSinks(DefaultSinks).push_back(sink);
+        return;
+    }
     coutLogger->sinks().push_back(sink);
     defaultLogger->sinks().push_back(sink);
 }
 
+static void removeSinkFromList(std::vector<spdlog::sink_ptr>& sinks,
+        const std::shared_ptr<spdlog::sinks::sink>& sink) {
+    auto new_end = std::remove(sinks.begin(), sinks.end(), sink);
+    sinks.erase(new_end, sinks.end());
+}
+
 static void removeSinkInternal(const std::shared_ptr<spdlog::sinks::sink> sink)
 {
-    {
-        auto& sinks = defaultLogger->sinks();
-        auto new_end = std::remove(sinks.begin(), sinks.end(), sink);
-        sinks.erase(new_end, sinks.end());
-    }
-    {
-        auto& sinks = coutLogger->sinks();
-        auto new_end = std::remove(sinks.begin(), sinks.end(), sink);
-        sinks.erase(new_end, sinks.end());
+    if (asyncWriter) {
+        // The sink should receive all messages logged before its removal.
+        asyncWriter->waitUntilWritten();
+        std::lock_guard<std::mutex> lock(asyncWriter->getSinksMutex());
+        removeSinkFromList(asyncWriter->updSinks(DefaultSinks), sink);
+        removeSinkFromList(asyncWriter->updSinks(CoutSinks), sink);
+        return;
     }
+    removeSinkFromList(defaultLogger->sinks(), sink);
+    removeSinkFromList(coutLogger->sinks(), sink);
 }
 
 void Logger::setLevel(Level level) {
@@ -273,4 +539,57 @@ void Logger::removeSink(const std::shared_ptr<LogSink> sink) {
     removeSinkInternal(std::static_pointer_cast<spdlog::sinks::sink>(sink));
 }
 
+void Logger::enableAsync(int queueCapacity, AsyncOverflowPolicy policy) {
+    OPENSIM_THROW_IF(queueCapacity < 1, Exception,
+            "Expected queueCapacity to be positive, but got {}.",
+            queueCapacity);
+    disableAsync();
+
+    // Create the log file now, rather than from the writer thread.
+    initFileLoggingAsNeeded();
+
+    std::size_t capacity = 2;
+    while (capacity < (std::size_t)queueCapacity) capacity *= 2;
+
+    numDroppedMessages = 0;
+    asyncWriter.reset(new AsyncLogWriter(capacity, policy, numDroppedMessages));
+    {
+        std::lock_guard<std::mutex> lock(asyncWriter->getSinksMutex());
+        asyncWriter->updSinks(CoutSinks) = coutLogger->sinks();
+        asyncWriter->updSinks(DefaultSinks) = defaultLogger->sinks();
+    }
+    coutLogger->sinks() = {std::make_shared<AsyncForwardingSink>(
+            *asyncWriter, CoutSinks)};
+    defaultLogger->sinks() = {std::make_shared<AsyncForwardingSink>(
+            *asyncWriter, DefaultSinks)};
+}
+
+void Logger::disableAsync() {
+    if (!asyncWriter) return;
+    asyncWriter->waitUntilWritten();
+    {
+        std::lock_guard<std::mutex> lock(asyncWriter->getSinksMutex());
+        coutLogger->sinks() = std::move(asyncWriter->updSinks(CoutSinks));
+        defaultLogger->sinks() =
+                std::move(asyncWriter->updSinks(DefaultSinks));
+    }
+    // Joins the writer thread.
+    asyncWriter.reset();
+}
 
+bool Logger::isAsync() {
+    return asyncWriter != nullptr;
+}
+
+long long Logger::getNumDroppedMessages() {
+    return numDroppedMessages;
+}
+
+void Logger::flush() {
+    if (asyncWriter) {
+        asyncWriter->waitUntilWritten();
+        return;
+    }
+    coutLogger->flush();
+    defaultLogger->flush();
+}
@@ -98,6 +98,17 @@ public:
     /// @endcode
     static bool shouldLog(Level level);
 
+    /// This enum lists what the asynchronous logger does with a message when
+    /// its queue is full (see enableAsync()).
+    enum class AsyncOverflowPolicy {
+        /// The logging thread waits until the background writer has made room
+        /// in the queue. No messages are lost.
+        Block,
+        /// The message is discarded and counted; see getNumDroppedMessages().
+        /// The logging thread never waits on the writer.
+        Drop
+    };
+
     /// @name Commands to log messages
     /// Use these functions instead of using spdlog directly.
     /// @{
@@ -182,6 +193,57 @@ public:
     /// @note This function is not thread-safe. Do not invoke this function
     /// concurrently, or concurrently with addLogFile() or addSink().
     static void removeSink(const std::shared_ptr<LogSink> sink);
+
+    /// @name Asynchronous logging
+    /// By default, each message is written to every sink (console, log file,
+    /// and any LogSink) on the thread that logs it, and the log file is flushed
+    /// after each message. In asynchronous mode, logging a message only
+    /// formats it and places it in a bounded, preallocated lock-free queue; a
+    /// background writer thread then forwards the message to the sinks and
+    /// flushes them whenever the queue runs empty. This removes sink I/O
+    /// (e.g., writing to a log file on a network drive) from the logging
+    /// thread. Messages from all threads are written in the order in which
+    /// they were enqueued. Sinks added with addFileSink() or addSink() while
+    /// asynchronous mode is enabled are also served by the writer thread, so
+    /// LogSink::sinkImpl() is invoked on the writer thread.
+    /// @{
+
+    /// Start logging asynchronously. Messages logged before this call have
+    /// already been written. If asynchronous logging is already enabled, it
+    /// is first disabled (draining the queue) and then enabled with the new
+    /// settings.
+    /// @param queueCapacity The maximum number of messages that can wait to
+    ///     be written; rounded up to a power of 2.
+    /// @param policy What to do when the queue is full.
+    /// @note This function is not thread-safe. Do not invoke this function
+    /// concurrently with logging or with any other function that modifies the
+    /// sinks.
+    static void enableAsync(int queueCapacity = 8192,
+            AsyncOverflowPolicy policy = AsyncOverflowPolicy::Block);
+
+    /// Write all queued messages, stop the background writer thread, and
+    /// resume logging synchronously. If asynchronous logging is not enabled,
+    /// this does nothing. This is invoked automatically when the program
+    /// exits, so queued messages are not lost at exit.
+    /// @note This function is not thread-safe. Do not invoke this function
+    /// concurrently with logging or with any other function that modifies the
+    /// sinks.
+    static void disableAsync();
+
+    /// Whether messages are currently logged asynchronously.
+    static bool isAsync();
+
+    /// The number of messages discarded because the queue was full, using
+    /// AsyncOverflowPolicy::Drop, since asynchronous logging was last enabled.
+    static long long getNumDroppedMessages();
+
+    /// Block until all messages logged so far have been written, then flush
+    /// all sinks. This is useful before reading the log file or the contents
+    /// of a StringLogSink while asynchronous logging is enabled. In
+    /// synchronous mode, this only flushes the sinks.
+    static void flush();
+
+    /// @}
 private:
     static spdlog::logger& getCoutLogger();
     static spdlog::logger& getDefaultLogger();
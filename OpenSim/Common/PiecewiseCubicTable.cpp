@@ -0,0 +1,132 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  PiecewiseCubicTable.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "PiecewiseCubicTable.h"
+
+#include "Exception.h"
+#include "Function.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace OpenSim;
+
+PiecewiseCubicTable::PiecewiseCubicTable(const std::vector<double>& knots,
+        const std::vector<const Function*>& functions) :
+        m_numColumns(static_cast<int>(functions.size())), m_knots(knots) {
+    const int numKnots = getNumKnots();
+    OPENSIM_THROW_IF(numKnots < 2, Exception,
+            "Expected at least 2 knots, but got {}.", numKnots);
+    const int numIntervals = numKnots - 1;
+    m_inverseSteps.resize(numIntervals);
+    for (int i = 0; i < numIntervals; ++i) {
+        const double step = m_knots[i + 1] - m_knots[i];
+        OPENSIM_THROW_IF(!(step > 0), Exception,
+                "Expected knots to be strictly increasing, but knot {} ({}) "
+                "is not greater than knot {} ({}).",
+                i + 1, m_knots[i + 1], i, m_knots[i]);
+        m_inverseSteps[i] = 1.0 / step;
+    }
+
+    // The interval containing a time is found directly if no knot deviates
+    // from a uniform grid by more than a fraction of a step.
+    const double uniformStep = (m_knots.back() - m_knots.front()) / numIntervals;
+    m_isUniform = true;
+    for (int i = 1; i < numIntervals; ++i) {
+        const double deviation =
+                std::abs(m_knots[i] - (m_knots.front() + i * uniformStep));
+        if (deviation > 0.25 * uniformStep) {
+            m_isUniform = false;
+            break;
+        }
+    }
+    m_inverseUniformStep = 1.0 / uniformStep;
+
+    // Fit the cubic polynomial through each function's values at 4 equally
+    // spaced times in each interval. This is exact if the function is a
+    // polynomial of degree 3 or less on the interval, which we verify at a
+    // fifth time.
+    m_coefficients.resize(4 * numIntervals * m_numColumns);
+    SimTK::Vector x(1);
+    for (int c = 0; c < m_numColumns; ++c) {
+        const Function& f = *functions[c];
+        for (int i = 0; i < numIntervals; ++i) {
+            const double t0 = m_knots[i];
+            const double step = m_knots[i + 1] - t0;
+            double fs[4];
+            for (int k = 0; k < 4; ++k) {
+                x[0] = k < 3 ? t0 + step * k / 3.0 : m_knots[i + 1];
+                fs[k] = f.calcValue(x);
+            }
+            double* a = &m_coefficients[4 * i * m_numColumns + c];
+            a[0] = fs[0];
+            a[m_numColumns] =
+                    0.5 * (-11 * fs[0] + 18 * fs[1] - 9 * fs[2] + 2 * fs[3]);
+            a[2 * m_numColumns] =
+                    0.5 * (18 * fs[0] - 45 * fs[1] + 36 * fs[2] - 9 * fs[3]);
+            a[3 * m_numColumns] =
+                    4.5 * (-fs[0] + 3 * fs[1] - 3 * fs[2] + fs[3]);
+
+            x[0] = t0 + 0.5 * step;
+            const double expected = f.calcValue(x);
+            const double s = 0.5;
+            const double actual = a[0] + s * (a[m_numColumns] +
+                    s * (a[2 * m_numColumns] + s * a[3 * m_numColumns]));
+            const double scale = std::max({1.0, std::abs(fs[0]),
+                    std::abs(fs[1]), std::abs(fs[2]), std::abs(fs[3])});
+            OPENSIM_THROW_IF(std::abs(actual - expected) > 1e-8 * scale,
+                    Exception,
+                    "Function '{}' is not a polynomial of degree 3 or less "
+                    "between times {} and {}.",
+                    f.getName(), t0, m_knots[i + 1]);
+        }
+    }
+}
+
+int PiecewiseCubicTable::findInterval(double time) const {
+    const int lastInterval = getNumKnots() - 2;
+    if (m_isUniform) {
+        // Start from the interval on the uniform grid, and correct for any
+        // deviation of the knots from the grid.
+        int i = static_cast<int>((time - m_knots.front()) * m_inverseUniformStep);
+        i = std::min(std::max(i, 0), lastInterval);
+        while (i > 0 && time < m_knots[i]) --i;
+        while (i < lastInterval && time > m_knots[i + 1]) ++i;
+        return i;
+    }
+    const auto it = std::upper_bound(m_knots.begin(), m_knots.end(), time);
+    const int i = static_cast<int>(it - m_knots.begin()) - 1;
+    return std::min(std::max(i, 0), lastInterval);
+}
+
+void PiecewiseCubicTable::calcValues(double time, int firstColumn,
+        int numColumns, double* values) const {
+    const int i = findInterval(time);
+    const double s = (time - m_knots[i]) * m_inverseSteps[i];
+    const double* a0 = &m_coefficients[4 * i * m_numColumns + firstColumn];
+    const double* a1 = a0 + m_numColumns;
+    const double* a2 = a1 + m_numColumns;
+    const double* a3 = a2 + m_numColumns;
+    for (int c = 0; c < numColumns; ++c) {
+        values[c] = a0[c] + s * (a1[c] + s * (a2[c] + s * a3[c]));
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef OPENSIM_PIECEWISE_CUBIC_TABLE_H_
+#define OPENSIM_PIECEWISE_CUBIC_TABLE_H_
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  PiecewiseCubicTable.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <vector>
+
+namespace OpenSim {
+
+class Function;
+
+/**
+ * A compiled form of a set of single-argument functions (the columns of the
+ * table) that are all polynomials of degree 3 or less between the
+ * consecutive values of a common, strictly increasing sequence of knots.
+ * Constant, PiecewiseLinearFunction, SimmSpline and GCVSpline (of degree 1 or
+ * 3) functions whose x values are the knots have this form.
+ *
+ * The coefficients of the polynomials of all columns are stored in a single
+ * array, grouped by interval, so that evaluating all columns at one time
+ * reads contiguous memory. If the knots are (nearly) uniformly spaced, as for
+ * data sampled at a fixed rate, the interval containing a time is found
+ * without a search. Use this class in place of the individual Function%s when many
+ * functions of the same data are evaluated repeatedly, as for ExternalLoads.
+ *
+ * The table is only defined between the first and last knots (see
+ * isInRange()); outside that range, evaluate the original functions.
+ */
+class OSIMCOMMON_API PiecewiseCubicTable {
+public:
+    PiecewiseCubicTable() = default;
+
+    /** Compile the given functions, which are evaluated at four times in
+     * each interval between the knots. The functions are not needed after
+     * construction.
+     * @throws Exception if there are fewer than 2 knots, the knots are not
+     *     strictly increasing, or a function is not a polynomial of degree 3
+     *     or less on each interval. */
+    PiecewiseCubicTable(const std::vector<double>& knots,
+            const std::vector<const Function*>& functions);
+
+    int getNumColumns() const { return m_numColumns; }
+    int getNumKnots() const { return static_cast<int>(m_knots.size()); }
+    /** Whether the knots are uniformly spaced, so that evaluation does not
+     * require a search. */
+    bool isUniform() const { return m_isUniform; }
+
+    /** Whether the table is defined at the given time (the time is between
+     * the first and last knots, inclusive). */
+    bool isInRange(double time) const {
+        return !m_knots.empty() && time >= m_knots.front() &&
+               time <= m_knots.back();
+    }
+
+    /** Evaluate all columns at the given time, which must be in range (see
+     * isInRange()). `values` must have room for getNumColumns() values. */
+    void calcValues(double time, double* values) const {
+        calcValues(time, 0, m_numColumns, values);
+    }
+    /** Evaluate the columns [firstColumn, firstColumn + numColumns) at the
+     * given time, which must be in range (see isInRange()). */
+    void calcValues(double time, int firstColumn, int numColumns,
+            double* values) const;
+
+private:
+    int findInterval(double time) const;
+
+    int m_numColumns = 0;
+    std::vector<double> m_knots;
+    bool m_isUniform = false;
+    double m_inverseUniformStep = 0;
+    // For interval i, m_coefficients[(4 * i + k) * m_numColumns + c] is the
+    // coefficient of s^k for column c, where s = (t - knot_i) / (knot_{i+1} -
+    // knot_i).
+    std::vector<double> m_coefficients;
+    std::vector<double> m_inverseSteps;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_PIECEWISE_CUBIC_TABLE_H_
@@ -115,6 +115,7 @@ void AbstractReporter::extendRealizeReport(const SimTK::State& state) const
 
 void AbstractReporter::report(const SimTK::State& s) const
 {
+    if (_reportingSuspended) return;
     implementReport(s);
 }
 
@@ -60,6 +60,14 @@ public:
     /** Report values given the state and top-level Component (e.g. Model) */
     void report(const SimTK::State& s) const;
 
+    /** While reporting is suspended, report() does nothing. The Manager
+    suspends the reporters of a model while a real-time integration is
+    behind schedule (see Manager::setRealTimeControlPeriod()). Copies of a
+    reporter are not suspended. */
+    void setReportingSuspended(bool suspended)
+    {   _reportingSuspended = suspended; }
+    bool isReportingSuspended() const { return _reportingSuspended; }
+
 protected:
     /** Default constructor sets up Reporter-level properties; can only be
     called from a derived class constructor. **/
@@ -89,6 +97,8 @@ private:
     void setNull();
     void constructProperties();
 
+    SimTK::ResetOnCopy<bool> _reportingSuspended;
+
 //=============================================================================
 };  // END of class AbstractReporter
 //=============================================================================
@@ -204,18 +214,12 @@ public:
 
 protected:
     void implementReport(const SimTK::State& state) const override {
-        const auto& input = this->template getInput<InputT>("inputs");
-        SimTK::RowVector_<ValueT> result;
-        result.resize(int(input.getNumConnectees()));
-
-        for (auto idx = 0u; idx < input.getNumConnectees(); ++idx) {
-              const auto& chan = input.getChannel(idx);
-              const auto& value = chan.getValue(state);
-              result[idx] = value;
+        for (int idx = 0; idx < _row.size(); ++idx) {
+            _row[idx] = _channels[idx]->getValue(state);
         }
         try {
             const_cast<Self*>(this)->_outputTable.appendRow(state.getTime(),
-                                                            result);
+                                                            _row);
         } catch(const InvalidTimestamp& exception) {
             OPENSIM_THROW(Exception,
                           "Attempting to update reporter with rows having "
@@ -230,10 +234,15 @@ protected:
 
         const auto& input = this->template getInput<InputT>("inputs");
 
+        // Cache the channels so that reporting does not need to look up the
+        // input, and allocate the row that reporting fills in.
+        _channels.clear();
         std::vector<std::string> labels;
         for (auto idx = 0u; idx < input.getNumConnectees(); ++idx) {
+            _channels.push_back(&input.getChannel(idx));
             labels.push_back( input.getLabel(idx) );
         }
+        _row.resize(static_cast<int>(_channels.size()));
         if (!labels.empty()) {
             const_cast<Self*>(this)->_outputTable.setColumnLabels(labels);
         } else {
@@ -246,6 +255,10 @@ protected:
     }
 
 private:
+    // The channels connected to the "inputs" input.
+    SimTK::ResetOnCopy<std::vector<const typename Input<InputT>::Channel*>>
+            _channels;
+    mutable SimTK::ResetOnCopy<SimTK::RowVector_<ValueT>> _row;
 
     // Hold the output values in a table with values as columns and time rows
     // We write to this table in const methods, but only because we ensure
@@ -41,7 +41,11 @@
 #include "StateVector.h"
 #include "TableUtilities.h"
 #include "TimeSeriesTable.h"
+#include <condition_variable>
+#include <deque>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 using namespace OpenSim;
 using namespace std;
@@ -142,6 +146,7 @@ const int Storage::LatestVersion = 1;
  */
 Storage::~Storage()
 {
+    closeStreamingOutput();
 }
 
 //=============================================================================
@@ -1451,6 +1456,9 @@ append(const StateVector &aStateVector,bool aCheckForDuplicateTime)
         aStateVector.print(_fp);
         fflush(_fp);
     }
+    // Keep the last row in memory; see setStreamingOutputFileName().
+    if (_streamWriter && _storage.getSize() > _streamingNumRowsPerBlock)
+        writeStreamingOutputBlock(_storage.getSize() - 1);
     return(_storage.getSize());
 }
 //_____________________________________________________________________________
@@ -1468,6 +1476,8 @@ append(const Array<StateVector> &aStorage)
 {
     for(int i=0; i<aStorage.getSize(); i++)
         _storage.append(aStorage[i]);
+    if (_streamWriter && _storage.getSize() > _streamingNumRowsPerBlock)
+        writeStreamingOutputBlock(_storage.getSize() - 1);
     return(_storage.getSize());
 }
 //_____________________________________________________________________________
@@ -2687,6 +2697,144 @@ setOutputFileName(const std::string& aFileName)
     // WRITE THE COLUMN LABELS
     writeColumnLabels(_fp);
 }
+
+//-----------------------------------------------------------------------------
+// STREAMING OUTPUT
+//-----------------------------------------------------------------------------
+/**
+ * Writes blocks of rows to a file on a background thread. At most
+ * MaxQueuedBlocks blocks wait to be written; a thread that appends rows
+ * faster than they can be written waits instead of using more memory.
+ */
+class Storage::StreamWriter {
+public:
+    /** The header line for the number of rows, padded so that it can be
+    rewritten in place as rows are written. */
+    static constexpr const char* NumRowsFormat = "nRows=%-10d\n";
+
+    StreamWriter(FILE* fp, long nRowsPosition) :
+            _fp(fp), _nRowsPosition(nRowsPosition),
+            _thread(&StreamWriter::run, this) {}
+
+    ~StreamWriter() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_all();
+        _thread.join();
+        fclose(_fp);
+    }
+
+    void write(std::vector<StateVector> block) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _condition.wait(lock,
+                [this] { return _blocks.size() < MaxQueuedBlocks; });
+        _blocks.push_back(std::move(block));
+        lock.unlock();
+        _condition.notify_all();
+    }
+
+private:
+    static const size_t MaxQueuedBlocks = 2;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true) {
+            _condition.wait(lock,
+                    [this] { return _stop || !_blocks.empty(); });
+            // Only stop once all queued blocks are written.
+            if (_blocks.empty()) return;
+            std::vector<StateVector> block = std::move(_blocks.front());
+            _blocks.pop_front();
+            lock.unlock();
+            _condition.notify_all();
+
+            for (const auto& row : block) row.print(_fp);
+            _numRows += static_cast<int>(block.size());
+            // Keep the file valid in case the program stops before the
+            // output is closed.
+            const long end = ftell(_fp);
+            fseek(_fp, _nRowsPosition, SEEK_SET);
+            fprintf(_fp, NumRowsFormat, _numRows);
+            fseek(_fp, end, SEEK_SET);
+            fflush(_fp);
+
+            lock.lock();
+        }
+    }
+
+    FILE* _fp;
+    const long _nRowsPosition;
+    int _numRows = 0;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<std::vector<StateVector>> _blocks;
+    bool _stop = false;
+    // Declared last so that the thread starts after the other members are
+    // initialized.
+    std::thread _thread;
+};
+
+void Storage::
+setStreamingOutputFileName(const std::string& aFileName, int aNumRowsPerBlock)
+{
+    OPENSIM_THROW_IF(isStreamingOutput(), Exception,
+            "Storage '{}' is already streaming its output to '{}'.",
+            getName(), _streamingOutputFileName);
+    OPENSIM_THROW_IF(aNumRowsPerBlock < 1, Exception,
+            "Expected the number of rows per block to be positive, but got "
+            "{}.", aNumRowsPerBlock);
+
+    // OPEN THE FILE
+    FILE* fp = IO::OpenFile(aFileName, "w");
+    OPENSIM_THROW_IF(fp == nullptr, Exception,
+            "Could not open file '{}'.", aFileName);
+
+    // WRITE THE HEADER
+    // This is the header written by writeHeader(), except that the number of
+    // rows is only known as the rows are written.
+    const int nc = _columnLabels.getSize() ? _columnLabels.getSize()
+                                           : getSmallestNumberOfStates() + 1;
+    fprintf(fp,"%s\n",getName().c_str());
+    fprintf(fp,"version=%d\n",LatestVersion);
+    const long nRowsPosition = ftell(fp);
+    fprintf(fp,StreamWriter::NumRowsFormat,0);
+    fprintf(fp,"nColumns=%d\n",nc);
+    fprintf(fp,"inDegrees=%s\n",(_inDegrees?"yes":"no"));
+    writeDescription(fp);
+    writeColumnLabels(fp);
+    fflush(fp);
+
+    _streamWriter.reset(new StreamWriter(fp, nRowsPosition));
+    _streamingOutputFileName = aFileName;
+    _streamingNumRowsPerBlock = aNumRowsPerBlock;
+
+    // WRITE THE EXISTING ROWS
+    if (_storage.getSize() > 1)
+        writeStreamingOutputBlock(_storage.getSize() - 1);
+}
+
+void Storage::
+closeStreamingOutput()
+{
+    if (!_streamWriter) return;
+    if (_storage.getSize() > 0) writeStreamingOutputBlock(_storage.getSize());
+    // Destroying the writer waits for all rows to be written.
+    _streamWriter.reset();
+}
+
+void Storage::
+writeStreamingOutputBlock(int aNumRows)
+{
+    std::vector<StateVector> block(aNumRows);
+    for (int i = 0; i < aNumRows; ++i) block[i] = _storage[i];
+    const int numRowsToKeep = _storage.getSize() - aNumRows;
+    for (int i = 0; i < numRowsToKeep; ++i) _storage[i] = _storage[aNumRows + i];
+    _storage.setSize(numRowsToKeep);
+    _lastI = 0;
+    _streamWriter->write(std::move(block));
+}
 //_____________________________________________________________________________
 /**
  * Print the contents of this storage instance to a file.
@@ -2874,6 +3022,12 @@ void Storage::printResult(const Storage* aStorage, const std::string& aName,
     }
     std::string name = (extension == "") ? (path + "/" + fileName + aExtension)
                                          : (path + "/" + fileName + extension);
+    if (!aStorage->getStreamingOutputFileName().empty()) {
+        // The rows are no longer in memory.
+        log_info("Not writing '{}' because its rows were written to '{}'.",
+                name, aStorage->getStreamingOutputFileName());
+        return;
+    }
     if(aDT<=0.0) aStorage->print(name);
     else aStorage->print(name,aDT);
 }
@@ -32,6 +32,8 @@
 #include "StorageInterface.h"
 #include "TimeSeriesTable.h"
 
+#include <memory>
+
 const int Storage_DEFAULT_CAPACITY = 256;
 //=============================================================================
 //=============================================================================
@@ -105,6 +107,15 @@ protected:
     /** Storage file version as written to the file */
     int _fileVersion = -1;
     static const int LatestVersion;
+
+#ifndef SWIG
+    /** Writes the rows of this storage to a file from a background thread;
+    see setStreamingOutputFileName(). */
+    class StreamWriter;
+    std::unique_ptr<StreamWriter> _streamWriter;
+#endif
+    std::string _streamingOutputFileName;
+    int _streamingNumRowsPerBlock = 0;
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -363,6 +374,35 @@ public:
     bool print(const std::string &aFileName,const std::string &aMode="w", const std::string& aComment="") const;
     int print(const std::string &aFileName,double aDT,const std::string &aMode="w") const;
     void setOutputFileName(const std::string& aFileName) override ;
+    /** Write the rows of this storage to the given file (in the format
+    written by print()) as they are appended, and remove the written rows
+    from memory. Rows are handed to a background thread in blocks of
+    `aNumRowsPerBlock` rows, so that writing does not slow down the
+    thread that appends the rows, and the memory used by the storage does
+    not grow with the number of rows appended. The rows already in the
+    storage are written first. The last appended row is kept in memory
+    until the output is closed (see closeStreamingOutput()), so that
+    getLastTime(), etc., and appending with aCheckForDuplicateTime still
+    work; any other access to the rows only sees the rows that have not yet
+    been written. The number of rows in the header of the file is updated
+    after each block, so the file is valid even if the program is stopped
+    before the output is closed.
+    @throws Exception if the storage is already streaming its output or
+    the file cannot be opened. */
+    void setStreamingOutputFileName(const std::string& aFileName,
+            int aNumRowsPerBlock = 1000);
+    /** Whether the rows of this storage are being written to a file; see
+    setStreamingOutputFileName(). */
+    bool isStreamingOutput() const { return _streamWriter != nullptr; }
+    /** The file the rows of this storage were (or are being) streamed to, or
+    an empty string if setStreamingOutputFileName() was not called. */
+    const std::string& getStreamingOutputFileName() const
+    {   return _streamingOutputFileName; }
+    /** Write all remaining rows to the streaming output file, wait until
+    they are written, and close the file. The storage is then empty. This
+    is done automatically when the storage is destroyed. Does nothing if
+    the storage is not streaming its output. */
+    void closeStreamingOutput();
     // convenience function for Analyses and DerivCallbacks
     static void printResult(const Storage *aStorage,const std::string &aName,
         const std::string &aDir,double aDT,const std::string &aExtension);
@@ -372,6 +412,7 @@ private:
     int writeSIMMHeader(FILE *rFP,double aDT=-1, const char*aComment=0) const;
     int writeDescription(FILE *rFP) const;
     int writeColumnLabels(FILE *rFP) const;
+    void writeStreamingOutputBlock(int aNumRows);
     int integrate(double aTI,double aTF,int aN,double *rArea,Storage *rStorage) const;
     int integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const;
 
@@ -94,6 +94,49 @@ int main() {
         quatFromTable = quatTableTyped.getRowAtIndex(numRows - 1)[0];
         quatFromFile = SimTK::Quaternion(0.979175344,0.00110321,-0.005109196,-0.202949069);
         ASSERT_EQUAL(quatFromTable, quatFromFile, tolerance);
+        // Reading in blocks gives the same rows, with continuing times, on
+        // any number of threads.
+        for (int numThreads : {1, 4}) {
+            reader.setNumThreads(numThreads);
+            int numBlockRows = 0;
+            int numBlocks = 0;
+            reader.readBlocks("imuData01.csv", 100,
+                    [&](const DataAdapter::OutputTables& block) {
+                        const auto& quatBlock =
+                                reader.getOrientationsTable(block);
+                        const auto& gyroBlock =
+                                reader.getAngularVelocityTable(block);
+                        ASSERT(quatBlock.getNumRows() <= 100);
+                        for (int i = 0; i < (int)quatBlock.getNumRows(); ++i) {
+                            const int row = numBlockRows + i;
+                            ASSERT(quatBlock.getIndependentColumn()[i] ==
+                                    quatTableTyped.getIndependentColumn()[row]);
+                            ASSERT(quatBlock.getRowAtIndex(i)[2] ==
+                                    quatTableTyped.getRowAtIndex(row)[2]);
+                            ASSERT(gyroBlock.getRowAtIndex(i)[1] ==
+                                    gyroTableTyped.getRowAtIndex(row)[1]);
+                        }
+                        numBlockRows += (int)quatBlock.getNumRows();
+                        ++numBlocks;
+                        return true;
+                    });
+            ASSERT(numBlockRows == 1024);
+            ASSERT(numBlocks == 11);
+            // The sink can stop the reading.
+            numBlocks = 0;
+            reader.readBlocks("imuData01.csv", 100,
+                    [&](const DataAdapter::OutputTables&) {
+                        return ++numBlocks < 2;
+                    });
+            ASSERT(numBlocks == 2);
+        }
+        reader.setNumThreads(4);
+        DataAdapter::OutputTables parallelTables = reader.read("imuData01.csv");
+        ASSERT_SAME_DATA(quatTableTyped,
+                reader.getOrientationsTable(parallelTables));
+        ASSERT_SAME_DATA(magTableTyped,
+                reader.getMagneticHeadingTable(parallelTables));
+
         // Now test new Fromat=7
         testAPDMFormat7();
         
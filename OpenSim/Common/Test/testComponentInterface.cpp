@@ -2537,6 +2537,83 @@ void testCacheVariableInterface() {
     }
 }
 
+void testMemoizedOutput() {
+    class Memo : public Component {
+        OpenSim_DECLARE_CONCRETE_OBJECT(Memo, Component);
+    public:
+        OpenSim_DECLARE_MEMOIZED_OUTPUT(out1, double, calcOut1,
+                SimTK::Stage::Time);
+        OpenSim_DECLARE_OUTPUT(out2, double, calcOut2, SimTK::Stage::Time);
+        double calcOut1(const SimTK::State& state) const {
+            ++numCalls1;
+            return 2 * state.getTime();
+        }
+        double calcOut2(const SimTK::State& state) const {
+            ++numCalls2;
+            return 3 * state.getTime();
+        }
+        mutable int numCalls1 = 0;
+        mutable int numCalls2 = 0;
+    };
+    class Consumer : public Component {
+        OpenSim_DECLARE_CONCRETE_OBJECT(Consumer, Component);
+    public:
+        OpenSim_DECLARE_INPUT(in1, double, SimTK::Stage::Time, "");
+    };
+
+    TheWorld world;
+    Memo* memo = new Memo(); memo->setName("memo");
+    Consumer* consumer = new Consumer(); consumer->setName("consumer");
+    world.add(memo);
+    world.add(consumer);
+    consumer->connectInput_in1(memo->getOutput("out1"));
+    MultibodySystem system;
+    world.connect();
+    world.buildUpSystem(system);
+
+    const auto& out1 = memo->getOutput("out1");
+    SimTK_TEST(out1.isMemoized());
+    SimTK_TEST(!memo->getOutput("out2").isMemoized());
+
+    State s = system.realizeTopology();
+    s.setTime(0.5);
+    system.realize(s, Stage::Model);
+    SimTK_TEST_MUST_THROW(memo->getOutputValue<double>(s, "out1"));
+
+    // The value is computed once per realization of the Time stage, whether
+    // it is requested through the Output or through an Input.
+    system.realize(s, Stage::Time);
+    for (int i = 0; i < 3; ++i) {
+        SimTK_TEST_EQ(memo->getOutputValue<double>(s, "out1"), 1.0);
+        SimTK_TEST_EQ(consumer->getInputValue<double>(s, "in1"), 1.0);
+        SimTK_TEST_EQ(memo->getOutputValue<double>(s, "out2"), 1.5);
+    }
+    SimTK_TEST(memo->numCalls1 == 1);
+    SimTK_TEST(memo->numCalls2 == 3);
+    SimTK_TEST(out1.getNumMemoizedMisses() == 1);
+    SimTK_TEST(out1.getNumMemoizedHits() == 5);
+    SimTK_TEST(memo->getOutput("out2").getNumMemoizedHits() == 0);
+
+    // Changing the time invalidates the value.
+    s.setTime(1.0);
+    system.realize(s, Stage::Time);
+    SimTK_TEST_EQ(consumer->getInputValue<double>(s, "in1"), 2.0);
+    SimTK_TEST_EQ(memo->getOutputValue<double>(s, "out1"), 2.0);
+    SimTK_TEST(memo->numCalls1 == 2);
+    SimTK_TEST(out1.getNumMemoizedMisses() == 2);
+
+    // Each State has its own value.
+    State s2 = s;
+    s2.setTime(2.0);
+    system.realize(s2, Stage::Time);
+    SimTK_TEST_EQ(memo->getOutputValue<double>(s2, "out1"), 4.0);
+    SimTK_TEST_EQ(memo->getOutputValue<double>(s, "out1"), 2.0);
+
+    out1.resetMemoizationCounts();
+    SimTK_TEST(out1.getNumMemoizedHits() == 0);
+    SimTK_TEST(out1.getNumMemoizedMisses() == 0);
+}
+
 int main() {
 
     //Register new types for testing deserialization
@@ -2577,6 +2654,7 @@ int main() {
 
         SimTK_SUBTEST(testFormattedDateTime);
         SimTK_SUBTEST(testCacheVariableInterface);
+        SimTK_SUBTEST(testMemoizedOutput);
 
     SimTK_END_TEST();
 }
@@ -0,0 +1,197 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testDataRingBuffer.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Common/DataRingBuffer.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include <OpenSim/Auxiliary/catch.hpp>
+
+using namespace OpenSim;
+
+typedef DataRingBuffer_<double> Buffer;
+
+namespace {
+void pushRows(Buffer& buffer, int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+        const double row[3] = {double(i), 2.0 * i, 3.0 * i};
+        buffer.push_back(i, row);
+    }
+}
+} // anonymous namespace
+
+TEST_CASE("DataRingBuffer single producer and consumer") {
+    // A small buffer makes the producer wait for the consumer.
+    Buffer buffer(8, 3);
+    CHECK(buffer.getCapacity() == 8);
+    CHECK(buffer.getRowWidth() == 3);
+    CHECK(buffer.isEmpty());
+
+    const int numRows = 20000;
+    std::thread producer(pushRows, std::ref(buffer), 0, numRows);
+
+    // Rows arrive in order and are not torn, whether they are popped one by
+    // one or drained.
+    int numPopped = 0;
+    bool inOrder = true;
+    SimTK::RowVector_<double> row;
+    double time;
+    while (numPopped < numRows / 2) {
+        buffer.pop_front(time, row);
+        inOrder = inOrder && time == numPopped && row[0] == numPopped &&
+                  row[1] == 2.0 * numPopped && row[2] == 3.0 * numPopped;
+        ++numPopped;
+    }
+    while (numPopped < numRows) {
+        buffer.drain([&](double t, const double* values) {
+            inOrder = inOrder && t == numPopped && values[0] == numPopped &&
+                      values[1] == 2.0 * numPopped &&
+                      values[2] == 3.0 * numPopped;
+            ++numPopped;
+        });
+    }
+    producer.join();
+    CHECK(inOrder);
+    CHECK(numPopped == numRows);
+    CHECK(buffer.isEmpty());
+    CHECK(buffer.getNumDropped() == 0);
+    CHECK_FALSE(buffer.try_pop_front(time, row));
+}
+
+TEST_CASE("DataRingBuffer overflow policies") {
+    SimTK::RowVector_<double> row;
+    double time;
+
+    SECTION("DropNewest") {
+        Buffer buffer(4, 3, Buffer::OverflowPolicy::DropNewest);
+        pushRows(buffer, 0, 6);
+        CHECK(buffer.getSize() == 4);
+        CHECK(buffer.getNumDropped() == 2);
+        std::vector<double> times;
+        buffer.drain([&](double t, const double*) { times.push_back(t); });
+        CHECK(times == std::vector<double>{0, 1, 2, 3});
+    }
+
+    SECTION("DropOldest") {
+        Buffer buffer(4, 3, Buffer::OverflowPolicy::DropOldest);
+        pushRows(buffer, 0, 6);
+        CHECK(buffer.getSize() == 4);
+        CHECK(buffer.getNumDropped() == 2);
+        // drain() stops after the given number of rows.
+        CHECK(buffer.drain([](double, const double*) {}, 1) == 1);
+        REQUIRE(buffer.try_pop_front(time, row));
+        CHECK(time == 3);
+        CHECK(row[1] == 6);
+    }
+
+    SECTION("Throw") {
+        Buffer buffer(4, 3, Buffer::OverflowPolicy::Throw);
+        pushRows(buffer, 0, 4);
+        CHECK_THROWS_AS(pushRows(buffer, 4, 5), Exception);
+        // The rows in the buffer are unaffected.
+        REQUIRE(buffer.try_pop_front(time, row));
+        CHECK(time == 0);
+        CHECK(buffer.getSize() == 3);
+    }
+}
+
+TEST_CASE("DataRingBuffer multiple producers and consumers") {
+    Buffer buffer(16, 3);
+    const int numProducers = 3;
+    const int numRowsPerProducer = 5000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < numProducers; ++p) {
+        threads.emplace_back(pushRows, std::ref(buffer),
+                p * numRowsPerProducer, (p + 1) * numRowsPerProducer);
+    }
+
+    // Each row is popped by exactly one consumer.
+    const int numRows = numProducers * numRowsPerProducer;
+    std::atomic<int> numPopped{0};
+    std::atomic<long long> sum{0};
+    for (int c = 0; c < 2; ++c) {
+        threads.emplace_back([&] {
+            SimTK::RowVector_<double> row;
+            double time;
+            while (numPopped.load() < numRows) {
+                if (buffer.try_pop_front(time, row)) {
+                    sum += static_cast<long long>(row[0]);
+                    ++numPopped;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    CHECK(numPopped.load() == numRows);
+    CHECK(sum.load() == static_cast<long long>(numRows) * (numRows - 1) / 2);
+}
+
+TEST_CASE("DataRingBuffer allocation and copying") {
+    Buffer buffer;
+    CHECK_FALSE(buffer.isAllocated());
+    CHECK(buffer.isEmpty());
+    const double row[3] = {1, 2, 3};
+    CHECK_THROWS_AS(buffer.push_back(0, row), Exception);
+
+    CHECK_THROWS_AS(buffer.allocate(0, 3), Exception);
+    CHECK_THROWS_AS(buffer.allocate(4, 0), Exception);
+    // The capacity is rounded up to a power of 2.
+    buffer.allocate(5, 3);
+    CHECK(buffer.getCapacity() == 8);
+    CHECK_THROWS_AS(buffer.push_back(0, SimTK::RowVector_<double>(2, 0.0)),
+            Exception);
+    buffer.push_back(0.5, SimTK::RowVector_<double>(3, 1.0));
+    buffer.push_back(1.5, row);
+
+    Buffer copy(buffer);
+    CHECK(copy.getCapacity() == 8);
+    CHECK(copy.getSize() == 2);
+    SimTK::RowVector_<double> copiedRow;
+    double time;
+    REQUIRE(copy.try_pop_front(time, copiedRow));
+    CHECK(time == 0.5);
+    CHECK(copiedRow[2] == 1.0);
+    // The original is not affected by popping from the copy.
+    CHECK(buffer.getSize() == 2);
+
+    // Moving takes the memory and the rows without copying them.
+    const double* firstRow = nullptr;
+    buffer.drain([&](double, const double* data) { firstRow = data; }, 1);
+    Buffer moved(std::move(buffer));
+    CHECK_FALSE(buffer.isAllocated());
+    CHECK(buffer.isEmpty());
+    CHECK(moved.getCapacity() == 8);
+    REQUIRE(moved.getSize() == 1);
+    moved.drain([&](double rowTime, const double* data) {
+        CHECK(rowTime == 1.5);
+        CHECK(data == firstRow + 3);
+    });
+    moved.push_back(2.5, row);
+    copy = std::move(moved);
+    CHECK_FALSE(moved.isAllocated());
+    CHECK(copy.getSize() == 1);
+}
@@ -24,6 +24,10 @@
 #include "ComponentsForTesting.h"
 
 #include <OpenSim/Common/CommonUtilities.h>
+#include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/GCVSpline.h>
+#include <OpenSim/Common/PiecewiseCubicTable.h>
+#include <OpenSim/Common/PiecewiseLinearFunction.h>
 #include <OpenSim/Common/MultivariatePolynomialFunction.h>
 #include <OpenSim/Common/Reporter.h>
 #include <OpenSim/Common/SignalGenerator.h>
@@ -92,6 +96,49 @@ TEST_CASE("Interpolate using PiecewiseLinearFunction") {
     SimTK_TEST(SimTK::isNaN(newY[3]));
 }
 
+TEST_CASE("PiecewiseCubicTable") {
+    for (const bool uniform : {true, false}) {
+        CAPTURE(uniform);
+        const int n = 50;
+        std::vector<double> x(n), y1(n), y2(n);
+        for (int i = 0; i < n; ++i) {
+            x[i] = uniform ? 0.01 * i : 0.01 * i + 0.004 * (i % 3);
+            y1[i] = std::sin(10 * x[i]);
+            y2[i] = std::exp(x[i]);
+        }
+        GCVSpline spline(3, n, x.data(), y1.data());
+        PiecewiseLinearFunction linear(n, x.data(), y2.data());
+        Constant constant(1.5);
+
+        PiecewiseCubicTable table(x, {&spline, &linear, &constant});
+        CHECK(table.getNumColumns() == 3);
+        CHECK(table.isUniform() == uniform);
+        CHECK(table.isInRange(x.front()));
+        CHECK(table.isInRange(x.back()));
+        CHECK(!table.isInRange(x.back() + 1e-6));
+
+        double values[3];
+        Vector arg(1);
+        for (int i = 0; i <= 1000; ++i) {
+            arg[0] = x.front() + i * (x.back() - x.front()) / 1000;
+            table.calcValues(arg[0], values);
+            CHECK(values[0] == Approx(spline.calcValue(arg)).margin(1e-10));
+            CHECK(values[1] == Approx(linear.calcValue(arg)).margin(1e-10));
+            CHECK(values[2] == Approx(1.5).margin(1e-10));
+
+            // Evaluate a subset of the columns.
+            table.calcValues(arg[0], 1, 1, values);
+            CHECK(values[0] == Approx(linear.calcValue(arg)).margin(1e-10));
+        }
+    }
+
+    // Functions that are not piecewise cubic are detected.
+    Sine sine(1.0, 100.0, 0, 0);
+    CHECK_THROWS_AS(PiecewiseCubicTable({0, 1}, {&sine}), Exception);
+    Constant constant(0);
+    CHECK_THROWS_AS(PiecewiseCubicTable({0, 1, 1}, {&constant}), Exception);
+}
+
 TEST_CASE("MultivariatePolynomialFunction") {
     SECTION("Input errors") {
         {
@@ -0,0 +1,100 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  testLogger.cpp                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Common/Exception.h>
+#include <OpenSim/Common/LogSink.h>
+#include <OpenSim/Common/Logger.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include <OpenSim/Auxiliary/catch.hpp>
+
+using namespace OpenSim;
+
+namespace {
+long long countLines(const std::string& s) {
+    return (long long)std::count(s.begin(), s.end(), '\n');
+}
+
+void logFromThreads(int numThreads, int numMessagesPerThread) {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([t, numMessagesPerThread] {
+            for (int i = 0; i < numMessagesPerThread; ++i) {
+                log_info("thread {} message {}", t, i);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+}
+} // anonymous namespace
+
+TEST_CASE("Logger asynchronous mode with blocking overflow policy") {
+    auto sink = std::make_shared<StringLogSink>();
+    Logger::addSink(sink);
+
+    // A small queue exercises the overflow policy.
+    Logger::enableAsync(16, Logger::AsyncOverflowPolicy::Block);
+    CHECK(Logger::isAsync());
+    logFromThreads(4, 2000);
+    Logger::flush();
+    CHECK(countLines(sink->getString()) == 4 * 2000);
+    CHECK(Logger::getNumDroppedMessages() == 0);
+
+    // Messages from one thread keep their order.
+    const auto& messages = sink->getString();
+    CHECK(messages.find("thread 0 message 1\n") <
+          messages.find("thread 0 message 1999\n"));
+
+    // Sinks added in asynchronous mode receive messages.
+    auto sink2 = std::make_shared<StringLogSink>();
+    Logger::addSink(sink2);
+    log_cout("cout message");
+    // Removing a sink first writes the queued messages to it.
+    Logger::removeSink(sink2);
+    CHECK(sink2->getString() == "cout message\n");
+
+    Logger::disableAsync();
+    CHECK_FALSE(Logger::isAsync());
+    sink->clear();
+    log_info("synchronous message");
+    CHECK(sink->getString() == "synchronous message\n");
+    Logger::removeSink(sink);
+}
+
+TEST_CASE("Logger asynchronous mode with dropping overflow policy") {
+    auto sink = std::make_shared<StringLogSink>();
+    Logger::addSink(sink);
+    Logger::enableAsync(4, Logger::AsyncOverflowPolicy::Drop);
+    logFromThreads(4, 2000);
+    Logger::flush();
+    // Every message is either written or counted as dropped.
+    CHECK(countLines(sink->getString()) + Logger::getNumDroppedMessages() ==
+            4 * 2000);
+    Logger::disableAsync();
+    Logger::removeSink(sink);
+
+    CHECK_THROWS_AS(Logger::enableAsync(0), Exception);
+}
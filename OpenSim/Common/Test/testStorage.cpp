@@ -170,6 +170,52 @@ void testStorageGetStateIndexBackwardsCompatibility() {
     // TODO: Put XML document version in Storage header.
 }
 
+void testStorageStreamingOutput() {
+    Storage sto;
+    Array<std::string> labels("", 3);
+    labels[0] = "time"; labels[1] = "a"; labels[2] = "b";
+    sto.setColumnLabels(labels);
+    const int numRows = 25;
+    const int numRowsPerBlock = 4;
+    auto row = [](double value) {
+        SimTK::Vector values(2);
+        values[0] = value;
+        values[1] = -value;
+        return values;
+    };
+    for (int i = 0; i < 3; ++i) sto.append(0.1 * i, row(i));
+    sto.setStreamingOutputFileName("testStorage_streaming.sto",
+            numRowsPerBlock);
+    SimTK_TEST(sto.isStreamingOutput());
+    SimTK_TEST_MUST_THROW_EXC(
+            sto.setStreamingOutputFileName("testStorage_streaming2.sto"),
+            Exception);
+    for (int i = 3; i < numRows; ++i) {
+        sto.append(0.1 * i, row(i));
+        // The written rows are removed from memory, except for the last one.
+        SimTK_TEST(sto.getSize() <= numRowsPerBlock);
+        SimTK_TEST_EQ(sto.getLastTime(), 0.1 * i);
+    }
+    // A row with the same time replaces the last row.
+    sto.append(0.1 * (numRows - 1), row(100));
+    sto.closeStreamingOutput();
+    SimTK_TEST(!sto.isStreamingOutput());
+    SimTK_TEST(sto.getSize() == 0);
+    SimTK_TEST(sto.getStreamingOutputFileName() == "testStorage_streaming.sto");
+
+    Storage streamed("testStorage_streaming.sto");
+    SimTK_TEST(streamed.getSize() == numRows);
+    SimTK_TEST(streamed.getColumnLabels() == labels);
+    for (int i = 0; i < numRows; ++i) {
+        double time;
+        streamed.getTime(i, time);
+        SimTK_TEST_EQ(time, 0.1 * i);
+        const double expected = i < numRows - 1 ? i : 100;
+        SimTK_TEST_EQ(streamed.getStateVector(i)->getData()[0], expected);
+        SimTK_TEST_EQ(streamed.getStateVector(i)->getData()[1], -expected);
+    }
+}
+
 int main() {
     SimTK_START_TEST("testStorage");
 
@@ -194,6 +240,8 @@ int main() {
         SimTK_SUBTEST(testStorageLegacy);
 
         SimTK_SUBTEST(testStorageGetStateIndexBackwardsCompatibility);
+
+        SimTK_SUBTEST(testStorageStreamingOutput);
     SimTK_END_TEST();
 }
 
@@ -142,6 +142,50 @@ int main() {
         DataAdapter::OutputTables tables5 = reader5.read("./");
         auto accelTable5 = tables5.at(XsensDataReader::LinearAccelerations);
         ASSERT(accelTable5->getNumRows() == 5);
+
+        // Reading in blocks gives the same rows, with continuing times.
+        const TimeSeriesTableQuaternion& quatTable5 =
+                reader5.getOrientationsTable(tables5);
+        reader5.setNumThreads(1);
+        int numBlockRows = 0;
+        int numBlocks = 0;
+        reader5.readBlocks("./", 2,
+                [&](const DataAdapter::OutputTables& block) {
+                    const auto& quatBlock = reader5.getOrientationsTable(block);
+                    ASSERT(quatBlock.getNumRows() <= 2);
+                    for (int i = 0; i < (int)quatBlock.getNumRows(); ++i) {
+                        const int row = numBlockRows + i;
+                        ASSERT(quatBlock.getIndependentColumn()[i] ==
+                                quatTable5.getIndependentColumn()[row]);
+                        ASSERT(quatBlock.getRowAtIndex(i)[0] ==
+                                quatTable5.getRowAtIndex(row)[0]);
+                    }
+                    numBlockRows += (int)quatBlock.getNumRows();
+                    ++numBlocks;
+                    return true;
+                });
+        ASSERT(numBlockRows == 5);
+        ASSERT(numBlocks == 3);
+        ASSERT_THROW(Exception, reader5.readBlocks("./", 0,
+                [](const DataAdapter::OutputTables&) { return true; }));
+
+        // Parsing the files of several sensors on one thread or on several
+        // threads gives the same tables.
+        XsensDataReader serialReader(readerSettings);
+        serialReader.setNumThreads(1);
+        DataAdapter::OutputTables serialTables = serialReader.read("./");
+        XsensDataReader parallelReader(readerSettings);
+        parallelReader.setNumThreads(2);
+        DataAdapter::OutputTables parallelTables = parallelReader.read("./");
+        const auto& serialQuats =
+                serialReader.getOrientationsTable(serialTables);
+        const auto& parallelQuats =
+                parallelReader.getOrientationsTable(parallelTables);
+        ASSERT(serialQuats.getNumRows() == quatTableTyped.getNumRows());
+        ASSERT_SAME_DATA(serialQuats, parallelQuats);
+        ASSERT_SAME_DATA(
+                serialReader.getLinearAccelerationsTable(serialTables),
+                parallelReader.getLinearAccelerationsTable(parallelTables));
         //const TimeSeriesTableQuaternion& quatTable5 =
         //        reader5.getOrientationsTable(tables5);
         // STOFileAdapterQuaternion::write(quatTable5, "2020-0-2-quaternions.sto");
@@ -1,4 +1,5 @@
 #include <fstream>
+#include <memory>
 #include "Simbody.h"
 #include "Exception.h"
 #include "FileAdapter.h"
@@ -11,10 +12,30 @@ XsensDataReader* XsensDataReader::clone() const {
     return new XsensDataReader{*this};
 }
 
-DataAdapter::OutputTables 
-XsensDataReader::extendRead(const std::string& folderName) const {
+namespace {
+// The data of the file of one sensor. The rows of the current block are
+// parsed into a buffer per quantity, so that the files can be parsed on
+// separate threads.
+struct SensorFile {
+    std::ifstream stream;
+    // Bytes after the header, to estimate the number of rows.
+    std::streamoff dataSize = 0;
+    bool atEnd = false;
+    std::vector<SimTK::Quaternion> rotations;
+    std::vector<SimTK::Vec3> linearAccelerations;
+    std::vector<SimTK::Vec3> magneticHeadings;
+    std::vector<SimTK::Vec3> angularVelocities;
+    int numRows = 0;
+    // Work space.
+    std::string line;
+    std::vector<int> fieldStarts;
+};
+}
+
+void XsensDataReader::extendReadBlocks(const std::string& folderName,
+        int blockSize, const BlockSink& sink) const {
 
-    std::vector<std::ifstream*> imuStreams;
+    std::vector<std::unique_ptr<SensorFile>> imuFiles;
     std::vector<std::string> labels;
     // files specified by prefix + file name exist
     double dataRate = SimTK::NaN;
@@ -25,15 +46,6 @@ XsensDataReader::extendRead(const std::string& folderName) const {
     int rotationsIndex = -1;
 
     int n_imus = _settings.getProperty_ExperimentalSensors().size();
-    int last_size = 1024;
-    // Will read data into pre-allocated Matrices in-memory rather than appendRow
-    // on the fly to avoid the overhead of 
-    SimTK::Matrix_<SimTK::Quaternion> rotationsData{ last_size, n_imus };
-    SimTK::Matrix_<SimTK::Vec3> linearAccelerationData{ last_size, n_imus };
-    SimTK::Matrix_<SimTK::Vec3> magneticHeadingData{ last_size, n_imus };
-    SimTK::Matrix_<SimTK::Vec3> angularVelocityData{ last_size, n_imus };
-    std::vector<double> times;
-    times.resize(last_size);
     
     std::string prefix = _settings.get_trial_prefix();
     std::map<std::string, std::string> headersKeyValuePairs;
@@ -41,19 +53,19 @@ XsensDataReader::extendRead(const std::string& folderName) const {
         std::string prefix = _settings.get_trial_prefix();
         const ExperimentalSensor& nextItem = _settings.get_ExperimentalSensors(index);
         auto fileName = folderName + prefix + nextItem.getName() +".txt";
-        auto* nextStream = new std::ifstream{ fileName };
-        OPENSIM_THROW_IF(!nextStream->good(),
+        std::unique_ptr<SensorFile> imuFile{new SensorFile};
+        std::ifstream& nextStream = imuFile->stream;
+        nextStream.open(fileName, std::ios::binary);
+        OPENSIM_THROW_IF(!nextStream.good(),
             FileDoesNotExist,
             fileName);
         // Add imu name to labels
         labels.push_back(nextItem.get_name_in_model());
-        // Add corresponding stream to imuStreams
-        imuStreams.push_back(nextStream);
 
         // Skip lines to get to data
         std::string line;
         auto commentLine = true;
-        std::getline(*nextStream, line);
+        std::getline(nextStream, line);
         auto isCommentLine = [](std::string aline) {
             return aline.substr(0, 2) == "//";
         };
@@ -66,7 +78,7 @@ XsensDataReader::extendRead(const std::string& folderName) const {
                 // Put values in map
                 headersKeyValuePairs[tokens[0]] = tokens[1];
             }
-            std::getline(*nextStream, line);
+            std::getline(nextStream, line);
             commentLine = isCommentLine(line);
         }
         // Find indices for Acc_{X,Y,Z}, Gyr_{X,Y,Z},
@@ -77,6 +89,12 @@ XsensDataReader::extendRead(const std::string& folderName) const {
         if (gyroIndex == -1) gyroIndex = find_index(tokens, "Gyr_X");
         if (magIndex == -1) magIndex = find_index(tokens, "Mag_X");
         if (rotationsIndex == -1) rotationsIndex = find_index(tokens, "Mat[1][1]");
+
+        const std::streamoff dataStart = nextStream.tellg();
+        nextStream.seekg(0, std::ios::end);
+        imuFile->dataSize = nextStream.tellg() - dataStart;
+        nextStream.seekg(dataStart);
+        imuFiles.push_back(std::move(imuFile));
     }
     // Compute data rate based on key/value pair if available
     std::map<std::string, std::string>::iterator it =
@@ -92,99 +110,137 @@ XsensDataReader::extendRead(const std::string& folderName) const {
 
     // If no Orientation data is available we'll abort completely
     OPENSIM_THROW_IF((rotationsIndex == -1), TableMissingHeader);
-    
-    // For all tables, will create row, stitch values from different files then append,time and timestep
-    // are based on the first file
-    bool done = false;
-    double time = 0.0;
-    double timeIncrement = 1 / dataRate;
-    int rowNumber = 0;
-    while (!done){
-        // Make vectors one per table
-        TimeSeriesTableQuaternion::RowVector
-            orientation_row_vector{ n_imus, SimTK::Quaternion() };
-        TimeSeriesTableVec3::RowVector
-            accel_row_vector{ n_imus, SimTK::Vec3(SimTK::NaN) };
-        TimeSeriesTableVec3::RowVector
-            magneto_row_vector{ n_imus, SimTK::Vec3(SimTK::NaN) };
-        TimeSeriesTableVec3::RowVector
-            gyro_row_vector{ n_imus, SimTK::Vec3(SimTK::NaN) };
-        // Cycle through the filles collating values
-        int imu_index = 0;
-        for (std::vector<std::ifstream*>::iterator it = imuStreams.begin();
-            it != imuStreams.end();
-            ++it, ++imu_index) {
-            std::ifstream* nextStream = *it;
-            // parse gyro info from imuStream
-            std::vector<std::string> nextRow = FileAdapter::getNextLine(*nextStream, "\t\r");
-            if (nextRow.empty()) {
-                done = true;
+
+    // Parse up to blockSize rows of a file into its buffers.
+    auto parseRows = [&](SensorFile& imuFile) {
+        imuFile.numRows = 0;
+        while (imuFile.numRows < blockSize) {
+            std::string& line = imuFile.line;
+            if (!std::getline(imuFile.stream, line)) {
+                imuFile.atEnd = true;
                 break;
             }
+            // Get rid of the extra \r if parsing a file with CRLF line endings.
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) {
+                imuFile.atEnd = true;
+                break;
+            }
+            if (imuFile.rotations.empty()) {
+                // Preallocate the buffers for the rows that remain, assuming
+                // the lines are about as long as the first.
+                const std::streamoff numRows =
+                        imuFile.dataSize / ((std::streamoff)line.size() + 1) + 1;
+                const size_t capacity =
+                        (size_t)std::min<std::streamoff>(numRows, blockSize);
+                imuFile.rotations.reserve(capacity);
+                if (foundLinearAccelerationData)
+                    imuFile.linearAccelerations.reserve(capacity);
+                if (foundMagneticHeadingData)
+                    imuFile.magneticHeadings.reserve(capacity);
+                if (foundAngularVelocityData)
+                    imuFile.angularVelocities.reserve(capacity);
+            }
+            const int row = imuFile.numRows;
+            if (row == (int)imuFile.rotations.size()) {
+                imuFile.rotations.emplace_back();
+                if (foundLinearAccelerationData)
+                    imuFile.linearAccelerations.emplace_back();
+                if (foundMagneticHeadingData)
+                    imuFile.magneticHeadings.emplace_back();
+                if (foundAngularVelocityData)
+                    imuFile.angularVelocities.emplace_back();
+            }
+            std::vector<int>& fields = imuFile.fieldStarts;
+            findFieldStarts(line, "\t\r", fields);
             if (foundLinearAccelerationData)
-                accel_row_vector[imu_index] = SimTK::Vec3(std::stod(nextRow[accIndex]),
-                    std::stod(nextRow[accIndex + 1]), std::stod(nextRow[accIndex + 2]));
+                imuFile.linearAccelerations[row] = SimTK::Vec3(
+                        parseField(line, fields, accIndex),
+                        parseField(line, fields, accIndex + 1),
+                        parseField(line, fields, accIndex + 2));
             if (foundMagneticHeadingData)
-                magneto_row_vector[imu_index] = SimTK::Vec3(std::stod(nextRow[magIndex]),
-                    std::stod(nextRow[magIndex + 1]), std::stod(nextRow[magIndex + 2]));
+                imuFile.magneticHeadings[row] = SimTK::Vec3(
+                        parseField(line, fields, magIndex),
+                        parseField(line, fields, magIndex + 1),
+                        parseField(line, fields, magIndex + 2));
             if (foundAngularVelocityData)
-                gyro_row_vector[imu_index] = SimTK::Vec3(std::stod(nextRow[gyroIndex]),
-                    std::stod(nextRow[gyroIndex + 1]), std::stod(nextRow[gyroIndex + 2]));
+                imuFile.angularVelocities[row] = SimTK::Vec3(
+                        parseField(line, fields, gyroIndex),
+                        parseField(line, fields, gyroIndex + 1),
+                        parseField(line, fields, gyroIndex + 2));
             // Create Mat33 then convert into Quaternion
             SimTK::Mat33 imu_matrix{ SimTK::NaN };
             int matrix_entry_index = 0;
             for (int mcol = 0; mcol < 3; mcol++) {
                 for (int mrow = 0; mrow < 3; mrow++) {
-                    imu_matrix[mrow][mcol] = std::stod(nextRow[rotationsIndex + matrix_entry_index]);
+                    imu_matrix[mrow][mcol] = parseField(line, fields,
+                            rotationsIndex + matrix_entry_index);
                     matrix_entry_index++;
                 }
             }
             // Convert imu_matrix to Quaternion
             SimTK::Rotation imu_rotation{ imu_matrix };
-            orientation_row_vector[imu_index] = imu_rotation.convertRotationToQuaternion();
+            imuFile.rotations[row] = imu_rotation.convertRotationToQuaternion();
+            ++imuFile.numRows;
         }
-        if (done) 
-            break;
-        // append to the tables
-        times[rowNumber] = time;
-        if (foundLinearAccelerationData) 
-            linearAccelerationData[rowNumber] =  accel_row_vector;
-        if (foundMagneticHeadingData) 
-            magneticHeadingData[rowNumber] = magneto_row_vector;
-        if (foundAngularVelocityData) 
-            angularVelocityData[rowNumber] = gyro_row_vector;
-        rotationsData[rowNumber] = orientation_row_vector;
-        time += timeIncrement;
-        rowNumber++;
-        if (std::remainder(rowNumber, last_size) == 0) {
-            // resize all Data/Matrices, double the size  while keeping data
-            int newSize = last_size*2;
-            times.resize(newSize);
-            // Repeat for Data matrices in use
-            if (foundLinearAccelerationData) linearAccelerationData.resizeKeep(newSize, n_imus);
-            if (foundMagneticHeadingData) magneticHeadingData.resizeKeep(newSize, n_imus);
-            if (foundAngularVelocityData) angularVelocityData.resizeKeep(newSize, n_imus);
-            rotationsData.resizeKeep(newSize, n_imus);
-            last_size = newSize;
+    };
+
+    // Parse the files on separate threads, then stitch the rows of the
+    // sensors together. The rows end with the shortest file; time and
+    // timestep are based on the data rate of the first file.
+    bool done = false;
+    double time = 0.0;
+    double timeIncrement = 1 / dataRate;
+    bool firstBlock = true;
+    while (!done) {
+        runInParallel(n_imus,
+                [&](int imu_index) { parseRows(*imuFiles[imu_index]); });
+        int numRows = blockSize;
+        for (const auto& imuFile : imuFiles) {
+            numRows = std::min(numRows, imuFile->numRows);
+            done = done || imuFile->atEnd;
         }
-    }
-    // Trim Matrices in use to actual data and move into tables
-    times.resize(rowNumber);
-    // Repeat for Data matrices in use and create Tables from them or size 0 for empty
-    linearAccelerationData.resizeKeep(foundLinearAccelerationData? rowNumber : 0,
-        n_imus);
-    magneticHeadingData.resizeKeep(foundMagneticHeadingData? rowNumber : 0,
-            n_imus);
-    angularVelocityData.resizeKeep(foundAngularVelocityData? rowNumber :0,
-        n_imus);
-    rotationsData.resizeKeep(rowNumber, n_imus);
+        // The previous block may have ended with the data.
+        if (numRows == 0 && !firstBlock) break;
+        firstBlock = false;
 
-    // Now create the tables from matrices
-    // Create 4 tables for Rotations, LinearAccelerations, AngularVelocity, MagneticHeading
-    // Tables could be empty if data is not present in file(s)
-    DataAdapter::OutputTables tables = createTablesFromMatrices(dataRate, labels, times,
-        rotationsData, linearAccelerationData, magneticHeadingData, angularVelocityData);
-    return tables;
+        std::vector<double> times(numRows);
+        for (int row = 0; row < numRows; ++row) {
+            times[row] = time;
+            time += timeIncrement;
+        }
+        // Create Matrices for the data in use, or of size 0 for empty
+        SimTK::Matrix_<SimTK::Quaternion> rotationsData{ numRows, n_imus };
+        SimTK::Matrix_<SimTK::Vec3> linearAccelerationData{
+                foundLinearAccelerationData ? numRows : 0, n_imus };
+        SimTK::Matrix_<SimTK::Vec3> magneticHeadingData{
+                foundMagneticHeadingData ? numRows : 0, n_imus };
+        SimTK::Matrix_<SimTK::Vec3> angularVelocityData{
+                foundAngularVelocityData ? numRows : 0, n_imus };
+        for (int imu_index = 0; imu_index < n_imus; ++imu_index) {
+            const SensorFile& imuFile = *imuFiles[imu_index];
+            for (int row = 0; row < numRows; ++row) {
+                rotationsData(row, imu_index) = imuFile.rotations[row];
+                if (foundLinearAccelerationData)
+                    linearAccelerationData(row, imu_index) =
+                            imuFile.linearAccelerations[row];
+                if (foundMagneticHeadingData)
+                    magneticHeadingData(row, imu_index) =
+                            imuFile.magneticHeadings[row];
+                if (foundAngularVelocityData)
+                    angularVelocityData(row, imu_index) =
+                            imuFile.angularVelocities[row];
+            }
+        }
+
+        // Create 4 tables for Rotations, LinearAccelerations,
+        // AngularVelocity, MagneticHeading. Tables could be empty if data is
+        // not present in file(s)
+        DataAdapter::OutputTables tables = createTablesFromMatrices(dataRate,
+                labels, times, rotationsData, linearAccelerationData,
+                magneticHeadingData, angularVelocityData);
+        if (!sink(tables)) break;
+    }
 }
 
 int XsensDataReader::find_index(std::vector<std::string>& tokens, const std::string& keyToMatch) {
@@ -65,8 +65,11 @@ protected:
     - one table for MagneticHeading data, 
     - one table for AngularVelocity data. 
     If data is missing, an empty table is returned. 
+    The files are parsed on separate threads (see setNumThreads()), and the
+    rows end with the shortest file.
     */
-    DataAdapter::OutputTables extendRead(const std::string& folderName) const override;
+    void extendReadBlocks(const std::string& folderName, int blockSize,
+            const BlockSink& sink) const override;
 
     /** Implements writing functionality, not implemented. */
     virtual void extendWrite(const DataAdapter::InputTables& tables,
@@ -31,6 +31,7 @@
 #include "FunctionSet.h"
 #include "GCVSpline.h"
 #include "GCVSplineSet.h"
+#include "Instrumentation.h"
 #include "IO.h"
 #include "LinearFunction.h"
 #include "LoadOpenSimLibrary.h"
@@ -41,6 +42,7 @@
 #include "Object.h"
 #include "ObjectGroup.h"
 #include "PiecewiseConstantFunction.h"
+#include "PiecewiseCubicTable.h"
 #include "PiecewiseLinearFunction.h"
 #include "PolynomialFunction.h"
 #include "RegisterTypes_osimCommon.h" // to expose RegisterTypes_osimCommon
@@ -19,8 +19,10 @@ tracking of pose.*/
 #include <array>
 #include <regex>
 #include <cmath>
+#include <thread>
 
 #include <OpenSim/OpenSim.h>
+#include <OpenSim/Common/DataRingBuffer.h>
 
 class Kalman {
 public:
@@ -250,54 +252,75 @@ int main() {
     bool firstrow{true};
 
     // ------------------------ Streaming.
-    while(true) {
-        char buffer[BUFFSIZE];
-        auto bytes = recvfrom(sock, buffer, BUFFSIZE, 0, 0, 0);
-
-        if(bytes > 0) {
-            auto data = parseImuData(buffer, BUFFSIZE);
-
-            auto& timestamp = std::get<0>(data);
-            auto& gravity   = std::get<1>(data);
-            auto& omega     = std::get<2>(data);
-
-            // If omega is (0, 0, 0), skip over because there was no data.
-            // All three components are never equal except when they are 0.
-            if(omega[0] == omega[1] && omega[1] == omega[2])
-                continue;
-
-            // Compute change in time and record the timestamp.
-            auto deltat = timestamp - oldtimestamp;
-            oldtimestamp = timestamp;
-            if(firstrow) {
-                firstrow = false;
-                continue;
+    // A separate thread receives and parses the samples, so that no packets
+    // are missed while drawing. The samples are passed to this thread as
+    // rows of gravity (3) and omega (3) in a ring buffer, which does not
+    // allocate memory or take locks. If drawing falls behind, the oldest
+    // samples are dropped so that the slab shows the latest pose.
+    OpenSim::DataRingBuffer_<double> samples{256, 6,
+            OpenSim::DataRingBuffer_<double>::OverflowPolicy::DropOldest};
+    std::thread receiver{[&samples, sock]() {
+        while(true) {
+            char buffer[BUFFSIZE];
+            auto bytes = recvfrom(sock, buffer, BUFFSIZE, 0, 0, 0);
+
+            if(bytes > 0) {
+                auto data = parseImuData(buffer, BUFFSIZE);
+
+                const auto& gravity = std::get<1>(data);
+                const auto& omega   = std::get<2>(data);
+                const double row[6]{gravity[0], gravity[1], gravity[2],
+                                     omega[0],   omega[1],   omega[2]};
+                samples.push_back(std::get<0>(data), row);
             }
+        }
+    }};
+
+    auto processSample = [&](double timestamp, const double* row) {
+        const std::array<double, 3> gravity{{row[0], row[1], row[2]}};
+        std::array<double, 3> omega{{row[3], row[4], row[5]}};
+
+        // If omega is (0, 0, 0), skip over because there was no data.
+        // All three components are never equal except when they are 0.
+        if(omega[0] == omega[1] && omega[1] == omega[2])
+            return;
+
+        // Compute change in time and record the timestamp.
+        auto deltat = timestamp - oldtimestamp;
+        oldtimestamp = timestamp;
+        if(firstrow) {
+            firstrow = false;
+            return;
+        }
+
+        auto tilt = computeRollPitch(gravity);
+        auto roll  = radToDeg(tilt.first);
+        auto pitch = radToDeg(tilt.second);
+
+        omega[0] = radToDeg(omega[0]);
+        omega[1] = radToDeg(omega[1]);
+        omega[2] = radToDeg(omega[2]);
+
+        // Angular velocity about axis y is roll.
+        // Angular velocity about axis x is pitch.
+        auto roll_hat  =  kalman_roll.getAngle( roll, omega[1], deltat);
+        auto pitch_hat = kalman_pitch.getAngle(pitch, omega[0], deltat);
+
+        // Multiplying -1 to roll just for display. This way visualizaiton moves
+        // like the physical phone.
+        model.getCoordinateSet()[0].setValue(state, -1 * degToRad( roll_hat));
+        model.getCoordinateSet()[2].setValue(state, degToRad(pitch_hat));
+    };
+
+    while(true) {
+        // Wait for a sample, then filter all samples that arrived while
+        // drawing the previous frame, and draw once.
+        samples.pop_front(processSample);
+        samples.drain(processSample);
 
-            auto tilt = computeRollPitch(gravity);
-            auto roll  = radToDeg(tilt.first);
-            auto pitch = radToDeg(tilt.second);
-
-            omega[0] = radToDeg(omega[0]);
-            omega[1] = radToDeg(omega[1]);
-            omega[2] = radToDeg(omega[2]);
-
-            // Angular velocity about axis y is roll.
-            // Angular velocity about axis x is pitch.
-            auto roll_hat  =  kalman_roll.getAngle( roll, omega[1], deltat);
-            auto pitch_hat = kalman_pitch.getAngle(pitch, omega[0], deltat);
-
-            // Multiplying -1 to roll just for display. This way visualizaiton moves
-            // like the physical phone.
-            model.getCoordinateSet()[0].setValue(state, -1 * degToRad( roll_hat));
-            model.getCoordinateSet()[2].setValue(state, degToRad(pitch_hat));
-            
-            viz.drawFrameNow(state);
-            
-            //std::cout << buffer << std::endl;
-        } else
-            std::cout << "skipping....." << std::endl;
+        viz.drawFrameNow(state);
     }
 
+    receiver.join();
     return 0;
 }
@@ -41,18 +41,18 @@ void BufferedOrientationsReference::getValuesAtTime(
         double time, SimTK::Array_<Rotation> &values) const
 {
     auto& times = _orientationData.getIndependentColumn();
-    SimTK::RowVector_<SimTK::Rotation> nextRow;
 
-    if (time >= times.front() && time <= times.back()) {
-        nextRow = _orientationData.getRow(time);
-    } else {
-        _orientationDataQueue.pop_front(time, nextRow);
-    }
-    int n = nextRow.size();
-    values.resize(n);
+    if (!times.empty() && time >= times.front() && time <= times.back()) {
+        SimTK::RowVector_<SimTK::Rotation> nextRow =
+                _orientationData.getRow(time);
+        int n = nextRow.size();
+        values.resize(n);
 
-    for (int i = 0; i < n; ++i) { 
-        values[i] = nextRow[i];
+        for (int i = 0; i < n; ++i) { 
+            values[i] = nextRow[i];
+        }
+    } else {
+        popValues(time, values);
     }
 }
 
@@ -60,17 +60,59 @@ double BufferedOrientationsReference::getNextValuesAndTime(
         SimTK::Array_<SimTK::Rotation_<double>>& values) {
 
     double returnTime;
-    SimTK::RowVector_<SimTK::Rotation> nextRow;
-    _orientationDataQueue.pop_front(returnTime, nextRow);
-    int n = nextRow.size();
-    values.resize(n);
-
-    for (int i = 0; i < n; ++i) { values[i] = nextRow[i]; }
+    popValues(returnTime, values);
     return returnTime;
 }
 
+void BufferedOrientationsReference::popValues(
+        double& time, SimTK::Array_<Rotation>& values) const {
+    if (_bufferCapacity == 0) {
+        SimTK::RowVector_<SimTK::Rotation> nextRow;
+        _orientationDataQueue.pop_front(time, nextRow);
+        int n = nextRow.size();
+        values.resize(n);
+
+        for (int i = 0; i < n; ++i) { values[i] = nextRow[i]; }
+        return;
+    }
+    // Copy the row directly from the buffer; values only allocates memory
+    // the first time.
+    _orientationDataBuffer.pop_front(
+            [&](double rowTime, const Rotation* row) {
+                time = rowTime;
+                const int width = _orientationDataBuffer.getRowWidth();
+                values.resize(width);
+                for (int i = 0; i < width; ++i) { values[i] = row[i]; }
+            });
+}
+
 void BufferedOrientationsReference::putValues(
         double time, const SimTK::RowVector_<SimTK::Rotation_<double>>& dataRow) {
-    _orientationDataQueue.push_back(time, dataRow);
+    _hasValues = true;
+    if (_bufferCapacity == 0) {
+        _orientationDataQueue.push_back(time, dataRow);
+        return;
+    }
+    // The width of the rows is only known once the first row is put.
+    if (!_orientationDataBuffer.isAllocated()) {
+        _orientationDataBuffer.allocate(
+                _bufferCapacity, dataRow.size(), _overflowPolicy);
+    }
+    _orientationDataBuffer.push_back(time, dataRow);
+}
+
+void BufferedOrientationsReference::setBufferCapacity(int capacity) {
+    OPENSIM_THROW_IF_FRMOBJ(_hasValues, Exception,
+            "Cannot change the buffer capacity after values were put.");
+    OPENSIM_THROW_IF_FRMOBJ(capacity < 0, Exception,
+            "Expected a non-negative buffer capacity, but got {}.", capacity);
+    _bufferCapacity = capacity;
+}
+
+void BufferedOrientationsReference::setBufferOverflowPolicy(
+        OverflowPolicy policy) {
+    OPENSIM_THROW_IF_FRMOBJ(_hasValues, Exception,
+            "Cannot change the buffer overflow policy after values were put.");
+    _overflowPolicy = policy;
 }
 } // end of namespace OpenSim
\ No newline at end of file
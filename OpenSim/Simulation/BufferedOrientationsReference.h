@@ -25,6 +25,7 @@
 
 #include "OrientationsReference.h"
 #include <OpenSim/Common/DataQueue.h>
+#include <OpenSim/Common/DataRingBuffer.h>
 
 namespace OpenSim {
 
@@ -32,11 +33,23 @@ namespace OpenSim {
 //=============================================================================
 //=============================================================================
 /**
- * Subclass of OrientationsReference that handles live data by providing a DataQueue
- * that allows clients to push data into and allows the InverseKinematicsSolver to 
- * draw data from for solving.
+ * Subclass of OrientationsReference that handles live data by providing a
+ * buffer that allows clients to push data into and allows the
+ * InverseKinematicsSolver to draw data from for solving.
  * Ideally this would be templatized, allowing for all Reference classes to leverage it.
  *
+ * By default, the data is held in a DataQueue_, which holds any number of
+ * rows. To bound the memory, and so that streaming data from another thread
+ * does not allocate memory or take locks, call setBufferCapacity() before the
+ * first call to putValues(): the data is then held in a DataRingBuffer_ of
+ * that capacity, which allocates its memory when the first row is put.
+ * setBufferOverflowPolicy() sets what putValues() does with a new row when
+ * that buffer is full; by default, it waits for the solver to make room, so
+ * that no data is lost.
+ *
+ * To stream all of the data, construct the reference from a table that has
+ * the names of the orientation sensors as column labels but no rows.
+ *
  * @author Ayman Habib
  */
 
@@ -69,6 +82,9 @@ public:
     /** get the time range for which this Reference values are valid,
         based on the loaded orientation data.*/
     SimTK::Vec2 getValidTimeRange() const override{
+        // Without loaded data, all values come from putValues().
+        if (getTimes().empty())
+            return SimTK::Vec2(-SimTK::Infinity, SimTK::Infinity);
         SimTK::Vec2 tableRange = Super::getValidTimeRange();
         return SimTK::Vec2(tableRange[0], SimTK::Infinity);
     };
@@ -89,9 +105,36 @@ public:
     void setFinished(bool finished) { 
         _finished = finished;
     };
+
+    /** Set the maximum number of rows waiting to be solved for, or 0 (the
+     * default) for no maximum. This must be called before the first call to
+     * putValues(). */
+    void setBufferCapacity(int capacity);
+    int getBufferCapacity() const { return _bufferCapacity; }
+#ifndef SWIG
+    typedef DataRingBuffer_<SimTK::Rotation>::OverflowPolicy OverflowPolicy;
+    /** Set what putValues() does when the buffer is full, if its capacity
+     * is set. This must be called before the first call to putValues(). */
+    void setBufferOverflowPolicy(OverflowPolicy policy);
+    OverflowPolicy getBufferOverflowPolicy() const { return _overflowPolicy; }
+#endif
+    /** The number of rows discarded by putValues() because the buffer was
+     * full (see setBufferOverflowPolicy()). */
+    long long getNumDroppedValues() const {
+        return _orientationDataBuffer.getNumDropped();
+    }
+
 private:
-    // Use a specialized data structure for holding the orientation data
+    // Wait for the next row in the buffer and copy it to values.
+    void popValues(double& time, SimTK::Array_<SimTK::Rotation>& values) const;
+
+    // Use a specialized data structure for holding the orientation data:
+    // the queue if the capacity is 0, and the buffer otherwise.
     mutable DataQueue_<SimTK::Rotation> _orientationDataQueue;
+    mutable DataRingBuffer_<SimTK::Rotation> _orientationDataBuffer;
+    int _bufferCapacity{0};
+    bool _hasValues{false};
+    OverflowPolicy _overflowPolicy{OverflowPolicy::Block};
     bool _finished{false};
     //=============================================================================
 };  // END of class BufferedOrientationsReference
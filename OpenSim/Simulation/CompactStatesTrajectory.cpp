@@ -0,0 +1,253 @@
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  CompactStatesTrajectory.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "CompactStatesTrajectory.h"
+
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Simulation/Model/Model.h>
+
+using namespace OpenSim;
+
+CompactStatesTrajectory::CompactStatesTrajectory(const Model& model) {
+    OPENSIM_THROW_IF(!model.hasSystem(), ComponentHasNoSystem, model);
+    resolveDiscreteVariables(model);
+    m_discrete.resize(m_discreteVariables.size());
+}
+
+void CompactStatesTrajectory::resolveDiscreteVariables(const Model& model) {
+    // Resolve the owner of each discrete variable once, so that we need not
+    // traverse the component tree for every state.
+    m_discreteVariableNames.clear();
+    m_discreteVariables.clear();
+    const auto names = model.getDiscreteVariableNames();
+    for (int i = 0; i < names.size(); ++i) {
+        const ComponentPath path(names[i]);
+        const auto& owner = model.getComponent(path.getParentPath());
+        m_discreteVariableNames.push_back(names[i]);
+        m_discreteVariables.emplace_back(&owner, path.getComponentName());
+    }
+}
+
+const SimTK::State& CompactStatesTrajectory::get(size_t index) const {
+    OPENSIM_THROW_IF(index >= getSize(), IndexOutOfRange, index, 0,
+            static_cast<unsigned>(getSize() - 1));
+    return materialize(index);
+}
+
+void CompactStatesTrajectory::clear() {
+    m_time.clear();
+    for (auto& column : m_y) column.clear();
+    for (auto& column : m_discrete) column.clear();
+    m_bufferIndex = std::numeric_limits<size_t>::max();
+}
+
+void CompactStatesTrajectory::reserve(size_t numStates) {
+    m_time.reserve(numStates);
+    for (auto& column : m_y) column.reserve(numStates);
+    for (auto& column : m_discrete) column.reserve(numStates);
+}
+
+void CompactStatesTrajectory::append(const SimTK::State& state) {
+    if (m_buffer.getSystemStage() == SimTK::Stage::Empty) {
+        // This is the first state; use it for the parts of the materialized
+        // states that we do not store.
+        m_buffer = state;
+        m_bufferIndex = std::numeric_limits<size_t>::max();
+    } else {
+        if (!m_time.empty()) {
+            SimTK_APIARGCHECK2_ALWAYS(m_time.back() <= state.getTime(),
+                    "CompactStatesTrajectory", "append",
+                    "New state's time (%f) must be equal to or greater than "
+                    "the time for the last state in the trajectory (%f).",
+                    state.getTime(), m_time.back());
+        }
+        OPENSIM_THROW_IF(!m_buffer.isConsistent(state),
+                StatesTrajectory::InconsistentState, state.getTime());
+    }
+
+    const SimTK::Vector& y = state.getY();
+    if (m_y.size() != static_cast<size_t>(y.size())) {
+        m_y.resize(y.size());
+        for (auto& column : m_y) column.reserve(m_time.capacity());
+    }
+    m_time.push_back(state.getTime());
+    for (int iy = 0; iy < y.size(); ++iy) {
+        m_y[iy].push_back(y[iy]);
+    }
+    for (size_t idv = 0; idv < m_discreteVariables.size(); ++idv) {
+        const auto& dv = m_discreteVariables[idv];
+        m_discrete[idv].push_back(
+                dv.first->getDiscreteVariableValue(state, dv.second));
+    }
+}
+
+void CompactStatesTrajectory::setModel(const Model& model) {
+    OPENSIM_THROW_IF(!model.hasSystem(), ComponentHasNoSystem, model);
+    const auto names = model.getDiscreteVariableNames();
+    bool sameDiscreteVariables =
+            names.size() == static_cast<int>(m_discreteVariableNames.size());
+    for (int i = 0; sameDiscreteVariables && i < names.size(); ++i) {
+        sameDiscreteVariables = names[i] == m_discreteVariableNames[i];
+    }
+    OPENSIM_THROW_IF(!sameDiscreteVariables,
+            StatesTrajectory::IncompatibleModel, model);
+    const SimTK::State& state = model.getWorkingState();
+    OPENSIM_THROW_IF(m_buffer.getSystemStage() != SimTK::Stage::Empty &&
+                     !m_buffer.isConsistent(state),
+            StatesTrajectory::InconsistentState, state.getTime());
+
+    resolveDiscreteVariables(model);
+    m_buffer = state;
+    m_bufferIndex = std::numeric_limits<size_t>::max();
+}
+
+const SimTK::State& CompactStatesTrajectory::materialize(size_t index) const {
+    if (index == m_bufferIndex) return m_buffer;
+
+    m_buffer.setTime(m_time[index]);
+    SimTK::Vector& y = m_buffer.updY();
+    for (int iy = 0; iy < y.size(); ++iy) {
+        y[iy] = m_y[iy][index];
+    }
+    for (size_t idv = 0; idv < m_discreteVariables.size(); ++idv) {
+        const auto& dv = m_discreteVariables[idv];
+        dv.first->setDiscreteVariableValue(m_buffer, dv.second,
+                m_discrete[idv][index]);
+    }
+    m_bufferIndex = index;
+    return m_buffer;
+}
+
+bool CompactStatesTrajectory::isCompatibleWith(const Model& model) const {
+    // An empty trajectory is necessarily compatible.
+    if (getSize() == 0) return true;
+
+    // All states in the trajectory are consistent with the buffer, so we only
+    // need to check the buffer. See StatesTrajectory::isCompatibleWith().
+    if (model.getNumSpeeds() != m_buffer.getNU()) return false;
+
+    return model.getDiscreteVariableNames().size() ==
+           static_cast<int>(m_discreteVariableNames.size());
+}
+
+TimeSeriesTable CompactStatesTrajectory::exportToTable(const Model& model,
+        const std::vector<std::string>& requestedStateVars) const {
+
+    OPENSIM_THROW_IF(!isCompatibleWith(model),
+                     StatesTrajectory::IncompatibleModel, model);
+
+    TimeSeriesTable table;
+
+    std::vector<std::string> stateVars;
+    if (requestedStateVars.empty()) {
+        const auto names = model.getStateVariableNames();
+        for (int i = 0; i < names.size(); ++i) stateVars.push_back(names[i]);
+    } else {
+        stateVars = requestedStateVars;
+    }
+    table.setColumnLabels(stateVars);
+    const int numDepColumns = static_cast<int>(stateVars.size());
+
+    TimeSeriesTable::RowVector row(numDepColumns);
+    for (size_t itime = 0; itime < getSize(); ++itime) {
+        const auto& state = materialize(itime);
+        if (requestedStateVars.empty()) {
+            // This is *much* faster than getting the values one-by-one.
+            row = model.getStateVariableValues(state).transpose();
+        } else {
+            for (int icol = 0; icol < numDepColumns; ++icol) {
+                row[icol] = model.getStateVariableValue(state, stateVars[icol]);
+            }
+        }
+        table.appendRow(m_time[itime], row);
+    }
+    return table;
+}
+
+StatesTrajectory CompactStatesTrajectory::toStatesTrajectory() const {
+    StatesTrajectory states;
+    for (const auto& state : *this) states.append(state);
+    return states;
+}
+
+CompactStatesTrajectory CompactStatesTrajectory::createFromStatesTable(
+        const Model& model,
+        const TimeSeriesTable& table,
+        bool allowMissingColumns,
+        bool allowExtraColumns,
+        bool assemble) {
+
+    CompactStatesTrajectory states(model);
+
+    const auto statesToFillUp = StatesTrajectory::mapStatesTableColumns(
+            model, table, allowMissingColumns, allowExtraColumns);
+
+    // Assembling requires a non-const model, so we assemble with a copy. We
+    // only take the continuous state variables from the copy's state.
+    std::unique_ptr<Model> localModel;
+    SimTK::State state;
+    if (assemble) {
+        localModel.reset(new Model(model));
+        state = localModel->initSystem();
+    } else {
+        state = model.getWorkingState();
+    }
+    const Model& stateModel = assemble ? *localModel : model;
+
+    // Working memory for state. Initialize so that missing columns end up as
+    // NaN.
+    SimTK::Vector statesValues(model.getStateVariableNames().getSize(),
+            SimTK::NaN);
+    state.updY().setToNaN();
+
+    states.reserve(table.getNumRows());
+    const auto& times = table.getIndependentColumn();
+    for (int itime = 0; itime < (int)table.getNumRows(); ++itime) {
+        const auto& row = table.getRowAtIndex(itime);
+        state.setTime(times[itime]);
+        for (const auto& kv : statesToFillUp) {
+            // 'first': index for table; 'second': index for Model.
+            statesValues[kv.second] = row[kv.first];
+        }
+        stateModel.setStateVariableValues(state, statesValues);
+        if (assemble) {
+            localModel->assemble(state);
+        }
+        states.append(state);
+    }
+
+    // The materialized states must belong to the provided model, not the
+    // local copy.
+    if (assemble) states.setModel(model);
+
+    return states;
+}
+
+CompactStatesTrajectory CompactStatesTrajectory::createFromStatesStorage(
+        const Model& model,
+        const Storage& sto,
+        bool allowMissingColumns,
+        bool allowExtraColumns,
+        bool assemble) {
+    return createFromStatesTable(model, sto.exportToTable(),
+            allowMissingColumns, allowExtraColumns, assemble);
+}
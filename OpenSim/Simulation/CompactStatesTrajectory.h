@@ -0,0 +1,237 @@
+#ifndef OPENSIM_COMPACT_STATES_TRAJECTORY_H_
+#define OPENSIM_COMPACT_STATES_TRAJECTORY_H_
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  CompactStatesTrajectory.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "StatesTrajectory.h"
+
+#include <iterator>
+#include <limits>
+#include <SimTKcommon/internal/State.h>
+
+namespace OpenSim {
+
+class Component;
+
+/**
+ * \section CompactStatesTrajectory
+ * This class holds a sequence of SimTK::State%s, like StatesTrajectory, but
+ * uses much less memory. A StatesTrajectory stores a complete SimTK::State
+ * (including its cache) for every time; a %CompactStatesTrajectory stores only
+ * the time, the continuous state variables (the SimTK::State's Y vector: q, u,
+ * and z) and the values of the discrete variables added by the model's
+ * components (see Component::getDiscreteVariableNames()). Each of these
+ * quantities is stored in its own contiguous column. Use this class when
+ * recording long simulations (see the `compact` property of
+ * StatesTrajectoryReporter).
+ *
+ * A SimTK::State is created on demand (materialized) when you access an
+ * element of the trajectory: the stored values are copied into a single
+ * SimTK::State buffer that is reused for all accesses. Therefore, **the
+ * reference returned by get(), operator[](), front(), back(), or by
+ * dereferencing an iterator is only valid until the next time a different
+ * element of the trajectory is accessed**. Copy the SimTK::State if you need
+ * to keep it. For the same reason, accessing the same trajectory
+ * concurrently from multiple threads is not supported.
+ * @code{.cpp}
+ * for (const auto& state : compactStates) {
+ *     std::cout << state.getTime() << " "
+ *               << model.getStateVariableValue(state, "knee/flexion/value")
+ *               << std::endl;
+ * }
+ * @endcode
+ *
+ * The remaining contents of the SimTK::State (e.g., modeling options and
+ * discrete variables that were not added through the Component interface)
+ * are the same for all materialized states, and are taken from the first
+ * state appended to the trajectory. The materialized states are not
+ * realized beyond SimTK::Stage::Instance.
+ *
+ * A %CompactStatesTrajectory is created for a specific Model, on which
+ * initSystem() must have been called, and must only be used with that Model
+ * (the model must outlive the trajectory, and the trajectory becomes invalid
+ * if you add or remove components from the model).
+ */
+class OSIMSIMULATION_API CompactStatesTrajectory {
+public:
+    /** Create an empty trajectory for states of the given model.
+     * @throws ComponentHasNoSystem if initSystem() has not been called on the
+     *         model. */
+    explicit CompactStatesTrajectory(const Model& model);
+
+    /** The number of SimTK::State%s in the trajectory. */
+    size_t getSize() const { return m_time.size(); }
+
+    /** The absolute paths of the discrete variables stored for each state. */
+    const std::vector<std::string>& getDiscreteVariableNames() const {
+        return m_discreteVariableNames;
+    }
+
+    /// @name Accessing individual SimTK::State%s
+    /// These functions materialize the requested state into the reused
+    /// buffer; see the class description.
+    /// @{
+    /** This function does not check if the index is larger than the size of
+     * the trajectory; see get() if you want this check. */
+    const SimTK::State& operator[](size_t index) const {
+        return materialize(index);
+    }
+    /** @throws IndexOutOfRange If the index is greater than the size of the
+     *                         trajectory. */
+    const SimTK::State& get(size_t index) const;
+    /** The first state in the trajectory. */
+    const SimTK::State& front() const { return materialize(0); }
+    /** The last state in the trajectory. */
+    const SimTK::State& back() const { return materialize(getSize() - 1); }
+    /** The time of the state at the given index, without materializing the
+     * state. */
+    double getTime(size_t index) const { return m_time[index]; }
+    /// @}
+
+    /** Iterator that materializes each state as it is dereferenced. */
+    class const_iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef SimTK::State value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const SimTK::State* pointer;
+        typedef const SimTK::State& reference;
+
+        const_iterator() = default;
+        const_iterator(const CompactStatesTrajectory* trajectory,
+                size_t index) : m_trajectory(trajectory), m_index(index) {}
+        reference operator*() const { return (*m_trajectory)[m_index]; }
+        pointer operator->() const { return &(*m_trajectory)[m_index]; }
+        const_iterator& operator++() { ++m_index; return *this; }
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            ++m_index;
+            return copy;
+        }
+        bool operator==(const const_iterator& other) const {
+            return m_trajectory == other.m_trajectory &&
+                   m_index == other.m_index;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !operator==(other);
+        }
+    private:
+        const CompactStatesTrajectory* m_trajectory = nullptr;
+        size_t m_index = 0;
+    };
+
+    /** A helper type to allow using range for loops over a subset of the
+     * trajectory. */
+    typedef SimTK::IteratorRange<const_iterator> IteratorRange;
+
+    /// @name Iterating through the trajectory
+    /// @{
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, getSize()); }
+    /// @}
+
+    /// @name Modify the contents of the trajectory
+    /// @{
+    /** Clear all the states in the trajectory. */
+    void clear();
+    /** Reserve memory for the given number of states. */
+    void reserve(size_t numStates);
+    /** Append a SimTK::State to this trajectory. The time of the new state
+     * must be greater than or equal to the time of the last state in the
+     * trajectory, and the new state must be consistent with the states in
+     * the trajectory (see StatesTrajectory::isConsistent()).
+     * @throws StatesTrajectory::InconsistentState */
+    void append(const SimTK::State& state);
+    /** Use this trajectory with the given model instead of the one for
+     * which it was created. The discrete variables are then read from and
+     * written to the components of `model`, and its working state is used
+     * for the parts of the materialized states that are not stored (see the
+     * class description). Use this if the states were appended from a copy
+     * of `model` (e.g., one simulated on another thread) that is about to be
+     * destroyed.
+     * @throws StatesTrajectory::IncompatibleModel if `model` does not have
+     *         the same discrete variables.
+     * @throws StatesTrajectory::InconsistentState */
+    void setModel(const Model& model);
+    /// @}
+
+    /** Weak check for if the trajectory can be used with the given model;
+     * see StatesTrajectory::isCompatibleWith(). */
+    bool isCompatibleWith(const Model& model) const;
+
+    /** Export the continuous state variables to a data table; see
+     * StatesTrajectory::exportToTable().
+     * @throws StatesTrajectory::IncompatibleModel */
+    TimeSeriesTable exportToTable(const Model& model,
+            const std::vector<std::string>& stateVars = {}) const;
+
+    /** Create a StatesTrajectory containing a copy of each materialized
+     * state. */
+    StatesTrajectory toStatesTrajectory() const;
+
+    /// @name Create partial trajectory from a states table
+    /// @{
+    /** Create a trajectory from a states table, as with
+     * StatesTrajectory::createFromStatesTable(). Unlike that function, the
+     * trajectory is created for the provided model (not a copy of it), so
+     * initSystem() must have been called on the model. The discrete
+     * variables take their default values. This function throws the same
+     * exceptions as StatesTrajectory::createFromStatesTable(). */
+    static CompactStatesTrajectory createFromStatesTable(const Model& model,
+            const TimeSeriesTable& table,
+            bool allowMissingColumns = false,
+            bool allowExtraColumns = false,
+            bool assemble = false);
+
+    /** Same as createFromStatesTable(), but for a Storage. */
+    static CompactStatesTrajectory createFromStatesStorage(const Model& model,
+            const Storage& sto,
+            bool allowMissingColumns = false,
+            bool allowExtraColumns = false,
+            bool assemble = false);
+    /// @}
+
+private:
+    void resolveDiscreteVariables(const Model& model);
+    const SimTK::State& materialize(size_t index) const;
+
+    std::vector<double> m_time;
+    // One column for each element of the State's Y vector.
+    std::vector<std::vector<double>> m_y;
+    // One column for each discrete variable.
+    std::vector<std::vector<double>> m_discrete;
+
+    std::vector<std::string> m_discreteVariableNames;
+    // The component that owns each discrete variable, and the name of the
+    // variable within that component.
+    std::vector<std::pair<const Component*, std::string>> m_discreteVariables;
+
+    // The buffer into which states are materialized. This is a copy of the
+    // first state appended to the trajectory (see setModel()).
+    mutable SimTK::State m_buffer;
+    // The index of the state currently in the buffer, if any.
+    mutable size_t m_bufferIndex = std::numeric_limits<size_t>::max();
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_COMPACT_STATES_TRAJECTORY_H_
@@ -0,0 +1,141 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  CompiledControlSet.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include "CompiledControlSet.h"
+
+#include "ControlLinear.h"
+#include "ControlSet.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace OpenSim;
+
+namespace {
+// The slope of the line through two nodes, as in ControlLinear::Interpolate().
+double calcSlope(const ControlLinearNode& node1,
+        const ControlLinearNode& node2) {
+    const double dt = node2.getTime() - node1.getTime();
+    if (std::abs(dt) < SimTK::Zero) return 0;
+    return (node2.getValue() - node1.getValue()) / dt;
+}
+}
+
+CompiledControlSet::CompiledControlSet(const ControlSet& controlSet,
+        bool aForModelControls) {
+    std::vector<Control*> controls;
+    for (int i = 0; i < controlSet.getSize(false); ++i) {
+        Control& control = controlSet.get(i);
+        if (aForModelControls && !control.getIsModelControl()) continue;
+        controls.push_back(&control);
+    }
+    m_numControls = static_cast<int>(controls.size());
+
+    // Merge the node times of all controls.
+    for (auto* control : controls) {
+        if (auto* linear = dynamic_cast<ControlLinear*>(control)) {
+            const auto& nodes = linear->getControlValues();
+            for (int j = 0; j < nodes.getSize(); ++j) {
+                m_times.push_back(nodes[j]->getTime());
+            }
+        }
+    }
+    std::sort(m_times.begin(), m_times.end());
+    m_times.erase(std::unique(m_times.begin(), m_times.end()), m_times.end());
+    if (m_times.empty()) m_times.push_back(0);
+
+    // Between two consecutive grid times, each control is linear (or
+    // constant), so its values at the grid times determine it.
+    const int numTimes = getNumTimes();
+    m_values.resize(numTimes * m_numControls);
+    for (int i = 0; i < numTimes; ++i) {
+        for (int c = 0; c < m_numControls; ++c) {
+            m_values[i * m_numControls + c] =
+                    controls[c]->getControlValue(m_times[i]);
+        }
+    }
+
+    m_useSteps.assign(m_numControls, 0);
+    m_slopesBefore.assign(m_numControls, 0);
+    m_slopesAfter.assign(m_numControls, 0);
+    for (int c = 0; c < m_numControls; ++c) {
+        auto* linear = dynamic_cast<ControlLinear*>(controls[c]);
+        if (!linear) continue;
+        if (linear->getUseSteps()) {
+            m_useSteps[c] = 1;
+            continue;
+        }
+        const auto& nodes = linear->getControlValues();
+        const int numNodes = nodes.getSize();
+        if (linear->getExtrapolate() && numNodes >= 2) {
+            m_slopesBefore[c] = calcSlope(*nodes[0], *nodes[1]);
+            m_slopesAfter[c] =
+                    calcSlope(*nodes[numNodes - 2], *nodes[numNodes - 1]);
+        }
+    }
+}
+
+int CompiledControlSet::findInterval(double time, int hint) const {
+    // Times usually increase from one evaluation to the next, so we first
+    // try the last interval and the one after it.
+    const int lastInterval = getNumTimes() - 2;
+    int i = std::min(std::max(hint, 0), lastInterval);
+    if (time >= m_times[i]) {
+        if (time < m_times[i + 1]) return i;
+        if (i < lastInterval && time < m_times[i + 2]) return i + 1;
+    }
+    const auto it = std::upper_bound(m_times.begin(), m_times.end(), time);
+    i = static_cast<int>(it - m_times.begin()) - 1;
+    return std::min(std::max(i, 0), lastInterval);
+}
+
+void CompiledControlSet::calcValues(double time, double* values,
+        int& interval) const {
+    const int n = m_numControls;
+    if (time <= m_times.front() || time >= m_times.back()) {
+        const bool isBefore = time <= m_times.front();
+        const double dt =
+                time - (isBefore ? m_times.front() : m_times.back());
+        const double* v = isBefore ? m_values.data()
+                                   : m_values.data() + m_values.size() - n;
+        const double* slopes =
+                isBefore ? m_slopesBefore.data() : m_slopesAfter.data();
+        for (int c = 0; c < n; ++c) values[c] = v[c] + slopes[c] * dt;
+        return;
+    }
+
+    // Linear controls are interpolated between the grid times. As in
+    // ControlLinear, controls that use steps take the value at the start
+    // of the interval only at that time, and the value at the end of the
+    // interval otherwise.
+    interval = findInterval(time, interval);
+    const int i = interval;
+    const double s = (time - m_times[i]) / (m_times[i + 1] - m_times[i]);
+    const double stepWeight = time == m_times[i] ? 0 : 1;
+    const double* v0 = &m_values[i * n];
+    const double* v1 = v0 + n;
+    for (int c = 0; c < n; ++c) {
+        const double w = m_useSteps[c] ? stepWeight : s;
+        values[c] = (1 - w) * v0[c] + w * v1[c];
+    }
+}
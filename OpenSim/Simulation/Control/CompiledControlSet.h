@@ -0,0 +1,95 @@
+#ifndef OPENSIM_COMPILED_CONTROL_SET_H_
+#define OPENSIM_COMPILED_CONTROL_SET_H_
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  CompiledControlSet.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include <vector>
+
+namespace OpenSim {
+
+class ControlSet;
+
+/**
+ * A compiled form of the controls of a ControlSet, for evaluating all of
+ * them at once. The node times of all controls are merged into a single time
+ * grid, and the value of each control at each grid time is stored in a
+ * matrix whose rows (one per grid time) are contiguous. Between two grid
+ * times, every ControlLinear is linear (or constant, when it uses steps), so
+ * all controls are evaluated with one interpolation over a row pair. The
+ * caller can keep the grid interval of its last evaluation, so that the
+ * monotonically increasing times of a simulation find their interval without
+ * a search.
+ *
+ * The values are those of Control::getControlValue(), including the
+ * extrapolation of controls for which getExtrapolate() is true, for
+ * ControlLinear (with or without steps) and ControlConstant controls. The
+ * compiled form does not follow subsequent changes to the ControlSet.
+ *
+ * Evaluation does not modify the object, so it can be evaluated from
+ * multiple threads at the same time.
+ */
+class OSIMSIMULATION_API CompiledControlSet {
+public:
+    CompiledControlSet() = default;
+
+    /** Compile the controls of the given set, in the order of the set. If
+     * aForModelControls is true, only the model controls (see
+     * Control::getIsModelControl()) are compiled, as for
+     * ControlSet::getControlValues(). */
+    explicit CompiledControlSet(const ControlSet& controlSet,
+            bool aForModelControls = true);
+
+    int getNumControls() const { return m_numControls; }
+    int getNumTimes() const { return static_cast<int>(m_times.size()); }
+
+    /** Evaluate all controls at the given time. `values` must have room for
+     * getNumControls() values. `interval` is the grid interval returned by
+     * the previous evaluation, which is tried before searching the grid
+     * (0 if there was none); it is updated to the interval of `time`. */
+    void calcValues(double time, double* values, int& interval) const;
+    /** Same as above, searching the grid for the interval of `time`. */
+    void calcValues(double time, double* values) const {
+        int interval = 0;
+        calcValues(time, values, interval);
+    }
+
+private:
+    int findInterval(double time, int hint) const;
+
+    int m_numControls = 0;
+    // The merged node times of all controls.
+    std::vector<double> m_times;
+    // m_values[i * m_numControls + c] is the value of control c at time i.
+    std::vector<double> m_values;
+    // Whether each control uses steps (1) or is linear (0) between times.
+    std::vector<int> m_useSteps;
+    // The slopes of the controls before the first and after the last time,
+    // which are nonzero for controls that extrapolate.
+    std::vector<double> m_slopesBefore;
+    std::vector<double> m_slopesAfter;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_COMPILED_CONTROL_SET_H_
@@ -123,6 +123,7 @@ setupProperties()
 void ControlSetController::copyData(const ControlSetController &aController)
 {   
     _controlsFileName = aController._controlsFileName;
+    _compiledControlSetIsValid = false;
 }
 
 
@@ -162,26 +163,62 @@ void ControlSetController::computeControls(const SimTK::State& s, SimTK::Vector&
 {
     SimTK_ASSERT( _controlSet , "ControlSetController::computeControls controlSet is NULL");
 
-    std::string actName = "";
-    int index = -1;
-
+    Workspace& workspace = updCacheVariableValue(s, _workspaceCV);
+    SimTK::Vector& actControls = workspace.actuatorControl;
     int na = getActuatorSet().getSize();
 
-    for(int i=0; i< na; ++i){
-        actName = getActuatorSet()[i].getName();
-        index = _controlSet->getIndex(actName);
-        if(index < 0){
-            actName = actName + ".excitation";
-            index = _controlSet->getIndex(actName);
+    if (!_compiledControlSetIsValid) {
+        // The ControlSet changed since it was compiled.
+        for(int i=0; i< na; ++i){
+            std::string actName = getActuatorSet()[i].getName();
+            int index = _controlSet->getIndex(actName);
+            if(index < 0){
+                actName = actName + ".excitation";
+                index = _controlSet->getIndex(actName);
+            }
+
+            if(index >= 0){
+                actControls[0] =
+                        _controlSet->get(index).getControlValue(s.getTime());
+                getActuatorSet()[i].addInControls(actControls, controls);
+            }
         }
+        return;
+    }
 
+    std::vector<double>& controlValues = workspace.controlValues;
+    controlValues.resize(_compiledControlSet.getNumControls());
+    if (!controlValues.empty())
+        _compiledControlSet.calcValues(s.getTime(), controlValues.data(),
+                workspace.interval);
+
+    for(int i=0; i< na; ++i){
+        const int index = _actuatorControlIndices[i];
         if(index >= 0){
-            SimTK::Vector actControls(1, _controlSet->get(index).getControlValue(s.getTime()));
+            actControls[0] = controlValues[index];
             getActuatorSet()[i].addInControls(actControls, controls);
         }
     }
 }
 
+void ControlSetController::compileControlSet()
+{
+    _compiledControlSet = CompiledControlSet(*_controlSet, false);
+
+    int na = getActuatorSet().getSize();
+    _actuatorControlIndices.resize(na);
+    for(int i=0; i< na; ++i){
+        std::string actName = getActuatorSet()[i].getName();
+        int index = _controlSet->getIndex(actName);
+        if(index < 0){
+            actName = actName + ".excitation";
+            index = _controlSet->getIndex(actName);
+        }
+        _actuatorControlIndices[i] = index;
+    }
+    _compiledControlSetIsValid = true;
+}
+
 double ControlSetController::getFirstTime() const {
     Array<int> controlList;
    SimTK_ASSERT( _controlSet , "ControlSetController::getFirstTime controlSet is NULL");
@@ -208,9 +245,26 @@ double ControlSetController::getLastTime() const {
     }
 }
 
+void ControlSetController::extendConnectToModel(Model& model)
+{
+    Super::extendConnectToModel(model);
+    // The actuators or the ControlSet may have changed.
+    _compiledControlSetIsValid = false;
+    if (_controlSet) compileControlSet();
+}
+
+void ControlSetController::extendAddToSystem(
+        SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+    _workspaceCV = addCacheVariable("workspace", Workspace(),
+            SimTK::Stage::Topology);
+}
+
 void ControlSetController::extendFinalizeFromProperties()
 {
     Super::extendFinalizeFromProperties();
+    _compiledControlSetIsValid = false;
 
     bool hasFile = !_controlsFileName.empty() &&
                     _controlsFileName.compare("Unassigned");
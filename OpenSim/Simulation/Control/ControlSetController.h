@@ -31,6 +31,7 @@
 // These files contain declarations and definitions of variables and methods
 // that will be used by the Controller class.
 #include "Controller.h"
+#include "CompiledControlSet.h"
 #include <OpenSim/Common/PropertyStr.h>
 
 //=============================================================================
@@ -40,7 +41,14 @@ namespace OpenSim {
 class ControlSet;
 
 /**
- * ControlSetController that simply assigns controls from a ControlSet
+ * ControlSetController that simply assigns controls from a ControlSet.
+ *
+ * The ControlSet is compiled (see CompiledControlSet) when the controller is
+ * connected to the model, so that the controls of all actuators are evaluated
+ * together. After calling setControlSet() or updControlSet(), the controls
+ * are evaluated from the ControlSet one by one until the controller is
+ * connected again (e.g., by Model::initSystem()).
+ *
  * @author Jack Middleton, Ajay Seth 
  * @version 1.0
  */
@@ -81,9 +89,15 @@ public:
     virtual ~ControlSetController();
 
     const ControlSet *getControlSet() {return _controlSet;} 
-    ControlSet *updControlSet() {return _controlSet;}
+    ControlSet *updControlSet() {
+        _compiledControlSetIsValid = false;
+        return _controlSet;
+    }
 
-    void setControlSet(ControlSet *aControlSet) {_controlSet = aControlSet;}
+    void setControlSet(ControlSet *aControlSet) {
+        _controlSet = aControlSet;
+        _compiledControlSetIsValid = false;
+    }
 
 
     
@@ -93,6 +107,27 @@ private:
 
     void setNull();
 
+    /** Compile the ControlSet and find the control of each actuator. */
+    void compileControlSet();
+
+    CompiledControlSet _compiledControlSet;
+    bool _compiledControlSetIsValid = false;
+    /** The index in the ControlSet of the control of each actuator, or -1 if
+    the actuator has no control. */
+    std::vector<int> _actuatorControlIndices;
+
+    // Scratch space for computing the controls, held in the State's cache so
+    // that computeControls() does not allocate and can be called with
+    // different States from multiple threads.
+    struct Workspace {
+        std::vector<double> controlValues;
+        // The control passed to Actuator::addInControls().
+        SimTK::Vector actuatorControl = SimTK::Vector(1);
+        // The grid interval of the last evaluation of the compiled controls.
+        int interval = 0;
+    };
+    mutable CacheVariable<Workspace> _workspaceCV;
+
 protected:
 
     /**
@@ -110,6 +145,8 @@ protected:
 
     /// read in ControlSet and update Controller's actuator list
     void extendFinalizeFromProperties() override;
+    void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
 
     //--------------------------------------------------------------------------
     // OPERATORS
@@ -24,6 +24,13 @@
 #include "InverseDynamicsSolver.h"
 #include "Model/Model.h"
 #include <OpenSim/Common/FunctionSet.h>
+#include <OpenSim/Common/FunctionSetEvaluator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <numeric>
+#include <thread>
 
 using namespace std;
 using namespace SimTK;
@@ -161,16 +168,28 @@ Vector InverseDynamicsSolver::solve(SimTK::State& s, const FunctionSet& Qs,
 /** Same as above but for a given time series */
 void InverseDynamicsSolver::solve(SimTK::State &s, const FunctionSet &Qs, const Array_<double> &times, Array_<Vector> &genForceTrajectory)
 {
+    if (s.getNQ() != s.getNU()) {
+        throw Exception("InverseDynamicsSolver::solve using only FunctionSet of "
+                        "qs, nq != nu not supported.");
+    }
+    std::vector<int> coordinatesToSpeedsIndexMap(s.getNU());
+    std::iota(coordinatesToSpeedsIndexMap.begin(),
+            coordinatesToSpeedsIndexMap.end(), 0);
+    checkFunctions(s, Qs, coordinatesToSpeedsIndexMap);
+
     int nCoords = getModel().getNumCoordinates();
     int nt = times.size();
 
     //Preallocate if not done already
     genForceTrajectory.resize(nt, Vector(nCoords));
-    
+
+    FunctionSetEvaluator evaluator(Qs);
+    std::vector<double> work(3 * Qs.getSize());
     AnalysisSet& analysisSet = const_cast<AnalysisSet&>(getModel().getAnalysisSet());
     //fill in results for each time
     for(int i=0; i<nt; i++){ 
-        genForceTrajectory[i] = solve(s, Qs, times[i]);
+        genForceTrajectory[i] = solveFrame(s, evaluator,
+                coordinatesToSpeedsIndexMap, times[i], work);
         analysisSet.step(s, i);
     }
 }
@@ -179,20 +198,139 @@ void InverseDynamicsSolver::solve(SimTK::State& s, const FunctionSet& Qs,
         const std::vector<int> coordinatesToSpeedsIndexMap,
         const Array_<double>& times,
         Array_<Vector>& genForceTrajectory) {
+    checkFunctions(s, Qs, coordinatesToSpeedsIndexMap);
+
     int nCoords = getModel().getNumCoordinates();
     int nt = times.size();
 
     // Preallocate if not done already
     genForceTrajectory.resize(nt, Vector(nCoords));
 
+    FunctionSetEvaluator evaluator(Qs);
+    std::vector<double> work(3 * Qs.getSize());
     AnalysisSet& analysisSet =
             const_cast<AnalysisSet&>(getModel().getAnalysisSet());
     // fill in results for each time
     for (int i = 0; i < nt; i++) {
-        genForceTrajectory[i] =
-                solve(s, Qs, coordinatesToSpeedsIndexMap, times[i]);
+        genForceTrajectory[i] = solveFrame(s, evaluator,
+                coordinatesToSpeedsIndexMap, times[i], work);
         analysisSet.step(s, i);
     }
 }
 
+void InverseDynamicsSolver::solveInParallel(const SimTK::State& s,
+        const FunctionSet& Qs,
+        const std::vector<int>& coordinatesToSpeedsIndexMap,
+        const Array_<double>& times, Array_<Vector>& genForceTrajectory,
+        int numThreads) {
+    checkFunctions(s, Qs, coordinatesToSpeedsIndexMap);
+
+    const int nCoords = getModel().getNumCoordinates();
+    const int nt = times.size();
+    genForceTrajectory.resize(nt, Vector(nCoords));
+    if (nt == 0) return;
+
+    // Creating the evaluator completes the lazy initialization of the
+    // functions, and solving the first frame that of the model's components,
+    // before any other thread uses them.
+    const FunctionSetEvaluator evaluator(Qs);
+    {
+        SimTK::State state(s);
+        FunctionSetEvaluator firstEvaluator(evaluator);
+        std::vector<double> work(3 * Qs.getSize());
+        genForceTrajectory[0] = solveFrame(state, firstEvaluator,
+                coordinatesToSpeedsIndexMap, times[0], work);
+    }
+
+    // The remaining frames are handed out in blocks of consecutive frames, so
+    // that the interval searches of the evaluator start near the answer.
+    const int blockSize = 8;
+    const int numBlocks = (nt - 1 + blockSize - 1) / blockSize;
+    if (numThreads < 1) {
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    numThreads = std::max(1, std::min(numThreads, numBlocks));
+
+    std::atomic<int> nextBlock(0);
+    std::vector<std::exception_ptr> errors(numThreads);
+    auto solveBlocks = [&](int ithread) {
+        try {
+            SimTK::State state(s);
+            FunctionSetEvaluator threadEvaluator(evaluator);
+            std::vector<double> threadWork(3 * Qs.getSize());
+            while (true) {
+                const int ib = nextBlock++;
+                if (ib >= numBlocks) break;
+                const int first = 1 + ib * blockSize;
+                const int last = std::min(nt, first + blockSize);
+                for (int i = first; i < last; ++i) {
+                    genForceTrajectory[i] = solveFrame(state, threadEvaluator,
+                            coordinatesToSpeedsIndexMap, times[i],
+                            threadWork);
+                }
+            }
+        } catch (...) {
+            errors[ithread] = std::current_exception();
+            // Stop the other threads early.
+            nextBlock = numBlocks;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int ithread = 1; ithread < numThreads; ++ithread) {
+        threads.emplace_back(solveBlocks, ithread);
+    }
+    solveBlocks(0);
+    for (auto& thread : threads) thread.join();
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+Vector InverseDynamicsSolver::solveFrame(SimTK::State& s,
+        FunctionSetEvaluator& evaluator,
+        const std::vector<int>& coordinatesToSpeedsIndexMap, double time,
+        std::vector<double>& work) {
+    const int nf = evaluator.getNumFunctions();
+    double* values = work.data();
+    double* firstDerivatives = values + nf;
+    double* secondDerivatives = firstDerivatives + nf;
+    evaluator.calcValuesAndDerivatives(
+            time, values, firstDerivatives, secondDerivatives);
+
+    // update the State so we get the correct gravity and Coriolis effects
+    s.updTime() = time;
+    Vector& q = s.updQ();
+    Vector& u = s.updU();
+    Vector& udot = s.updUDot();
+    const int nq = s.getNQ();
+    const int nu = s.getNU();
+    for (int i = 0; i < nq; i++) {
+        q[i] = values[i];
+    }
+    for (int i = 0; i < nu; i++) {
+        u[i] = firstDerivatives[coordinatesToSpeedsIndexMap[i]];
+        udot[i] = secondDerivatives[coordinatesToSpeedsIndexMap[i]];
+    }
+
+    // Perform general inverse dynamics
+    return solve(s, udot);
+}
+
+void InverseDynamicsSolver::checkFunctions(const SimTK::State& s,
+        const FunctionSet& Qs,
+        const std::vector<int>& coordinatesToSpeedsIndexMap) const {
+    if (Qs.getSize() != s.getNQ()) {
+        throw Exception("InverseDynamicsSolver::solve invalid number of q functions.");
+    }
+    if ((int)coordinatesToSpeedsIndexMap.size() != s.getNU()) {
+        throw Exception("InverseDynamicsSolver::solve coordinatesToSpeedsIndexMap must be 'nu' long");
+    }
+    for (int index : coordinatesToSpeedsIndexMap) {
+        if (index < 0 || index >= Qs.getSize()) {
+            throw Exception("InverseDynamicsSolver::solve coordinatesToSpeedsIndexMap "
+                            "contains an invalid function index.");
+        }
+    }
+}
+
 } // end of namespace OpenSim
\ No newline at end of file
@@ -29,6 +29,7 @@
 namespace OpenSim {
 
 class FunctionSet;
+class FunctionSetEvaluator;
 
 //=============================================================================
 //=============================================================================
@@ -121,6 +122,42 @@ public:
             const std::vector<int> coordinatesToSpeedsIndexMap,
             const SimTK::Array_<double>& times,
             SimTK::Array_<SimTK::Vector>& genForceTrajectory);
+
+    /** Same as above, but the time frames are solved concurrently by
+        `numThreads` threads (if `numThreads` is less than 1, the number of
+        cores is used), each with its own copy of the state `s`. The
+        generalized forces are bit-for-bit identical to those of the serial
+        solve above. The model's analyses are not stepped, since the frames
+        are not solved in order, and `s` is not modified.
+
+        The values, speeds and accelerations of all coordinates at a time are
+        computed in one pass over the coordinate functions (see
+        FunctionSetEvaluator). The first frame is solved before the others
+        are started, so that the model's components can complete any lazy
+        initialization. After that, the threads realize the same model in
+        different states at once, which is only safe if no component writes
+        to its own members (e.g., mutable buffers) while it is realized:
+        components must keep their computed values in the state's cache and
+        their scratch space on the stack. Solve models with components that
+        do not (e.g., custom components with mutable members) with
+        `numThreads` = 1, or with solve(). */
+    void solveInParallel(const SimTK::State& s, const FunctionSet& Qs,
+            const std::vector<int>& coordinatesToSpeedsIndexMap,
+            const SimTK::Array_<double>& times,
+            SimTK::Array_<SimTK::Vector>& genForceTrajectory,
+            int numThreads = 0);
+#endif
+
+private:
+#ifndef SWIG
+    // Set the time, coordinates, speeds and accelerations of `s` from the
+    // coordinate functions at `time` and solve. `work` holds 3 values per
+    // function.
+    SimTK::Vector solveFrame(SimTK::State& s, FunctionSetEvaluator& evaluator,
+            const std::vector<int>& coordinatesToSpeedsIndexMap, double time,
+            std::vector<double>& work);
+    void checkFunctions(const SimTK::State& s, const FunctionSet& Qs,
+            const std::vector<int>& coordinatesToSpeedsIndexMap) const;
 #endif
 //=============================================================================
 };  // END of class InverseDynamicsSolver
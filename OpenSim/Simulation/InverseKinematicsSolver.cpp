@@ -228,9 +228,11 @@ SimTK::Vec3 InverseKinematicsSolver::computeCurrentMarkerLocation(int markerInde
 /* Compute and return the spatial locations of all markers in ground. */
 void InverseKinematicsSolver::computeCurrentMarkerLocations(SimTK::Array_<SimTK::Vec3> &markerLocations)
 {
-    markerLocations.resize(_markerAssemblyCondition->getNumMarkers());
+    computeMarkerArrays();
+    const MarkerArrays& m = _markerArrays;
+    markerLocations.resize(m.bodies.size());
     for(unsigned int i=0; i<markerLocations.size(); i++)
-        markerLocations[i] = _markerAssemblyCondition->findCurrentMarkerLocation(SimTK::Markers::MarkerIx(i));
+        markerLocations[i] = Vec3(m.locationX[i], m.locationY[i], m.locationZ[i]);
 }
 
 
@@ -255,9 +257,10 @@ double InverseKinematicsSolver::computeCurrentMarkerError(int markerIndex)
 /* Compute and return the distance errors between all model markers and their observations. */
 void InverseKinematicsSolver::computeCurrentMarkerErrors(SimTK::Array_<double> &markerErrors)
 {
-    markerErrors.resize(_markerAssemblyCondition->getNumMarkers());
+    computeMarkerArrays();
+    markerErrors.resize(_markerArrays.bodies.size());
     for(unsigned int i=0; i<markerErrors.size(); i++)
-        markerErrors[i] = _markerAssemblyCondition->findCurrentMarkerError(SimTK::Markers::MarkerIx(i));
+        markerErrors[i] = std::sqrt(_markerArrays.squaredErrors[i]);
 }
 
 
@@ -283,10 +286,97 @@ double InverseKinematicsSolver::computeCurrentSquaredMarkerError(int markerIndex
 void InverseKinematicsSolver::
     computeCurrentSquaredMarkerErrors(SimTK::Array_<double> &markerErrors)
 {
-    markerErrors.resize(_markerAssemblyCondition->getNumMarkers());
+    computeMarkerArrays();
+    markerErrors.resize(_markerArrays.bodies.size());
     for(unsigned int i=0; i<markerErrors.size(); i++)
-        markerErrors[i] = _markerAssemblyCondition->
-                    findCurrentMarkerErrorSquared(SimTK::Markers::MarkerIx(i));
+        markerErrors[i] = _markerArrays.squaredErrors[i];
+}
+
+/* Compute the locations and squared errors of all markers into a row of
+   matrices that hold all frames. */
+void InverseKinematicsSolver::computeCurrentMarkerLocationsAndSquaredErrors(
+        SimTK::Matrix& locations, SimTK::Matrix& squaredErrors, int row)
+{
+    const int nm = (int)_markerArrays.bodies.size();
+    OPENSIM_THROW_IF(locations.ncol() != 0 && locations.ncol() != 3 * nm,
+            Exception,
+            "Expected the matrix of marker locations to have {} columns, "
+            "but it has {}.",
+            3 * nm, locations.ncol());
+    OPENSIM_THROW_IF(squaredErrors.ncol() != 0 && squaredErrors.ncol() != nm,
+            Exception,
+            "Expected the matrix of squared marker errors to have {} "
+            "columns, but it has {}.",
+            nm, squaredErrors.ncol());
+    OPENSIM_THROW_IF(row < 0 ||
+                    (locations.ncol() != 0 && row >= locations.nrow()) ||
+                    (squaredErrors.ncol() != 0 && row >= squaredErrors.nrow()),
+            Exception, "Row {} is outside of the matrices of marker results.",
+            row);
+
+    computeMarkerArrays();
+    const MarkerArrays& m = _markerArrays;
+    if (locations.ncol() != 0) {
+        for (int i = 0; i < nm; ++i) {
+            locations(row, 3 * i) = m.locationX[i];
+            locations(row, 3 * i + 1) = m.locationY[i];
+            locations(row, 3 * i + 2) = m.locationZ[i];
+        }
+    }
+    if (squaredErrors.ncol() != 0) {
+        for (int i = 0; i < nm; ++i)
+            squaredErrors(row, i) = m.squaredErrors[i];
+    }
+}
+
+/* Compute the locations in ground of all markers, and their squared errors,
+   from the configuration of the assembler as SimTK::Markers does for each
+   marker. */
+void InverseKinematicsSolver::computeMarkerArrays()
+{
+    MarkerArrays& m = _markerArrays;
+    const int nm = (int)m.bodies.size();
+    const SimTK::State& s = getAssembler().getInternalState();
+    const SimTK::SimbodyMatterSubsystem& matter =
+            getModel().getMatterSubsystem();
+
+    // Gather the transform of the body of each marker.
+    for (int i = 0; i < nm; ++i) {
+        const SimTK::Transform& X_GB =
+                matter.getMobilizedBody(m.bodies[i]).getBodyTransform(s);
+        for (int j = 0; j < 3; ++j) {
+            for (int k = 0; k < 3; ++k)
+                m.rotation[3 * j + k][i] = X_GB.R()(j, k);
+            m.origin[j][i] = X_GB.p()[j];
+        }
+    }
+
+    const double* R[9];
+    for (int j = 0; j < 9; ++j) R[j] = m.rotation[j].data();
+    const double* px = m.origin[0].data();
+    const double* py = m.origin[1].data();
+    const double* pz = m.origin[2].data();
+    const double* sx = m.stationX.data();
+    const double* sy = m.stationY.data();
+    const double* sz = m.stationZ.data();
+    const double* ox = m.observedX.data();
+    const double* oy = m.observedY.data();
+    const double* oz = m.observedZ.data();
+    const double* observed = m.isObserved.data();
+    double* lx = m.locationX.data();
+    double* ly = m.locationY.data();
+    double* lz = m.locationZ.data();
+    double* e2 = m.squaredErrors.data();
+    for (int i = 0; i < nm; ++i) {
+        const double x = sx[i], y = sy[i], z = sz[i];
+        lx[i] = R[0][i] * x + R[1][i] * y + R[2][i] * z + px[i];
+        ly[i] = R[3][i] * x + R[4][i] * y + R[5][i] * z + py[i];
+        lz[i] = R[6][i] * x + R[7][i] * y + R[8][i] * z + pz[i];
+        const double dx = lx[i] - ox[i];
+        const double dy = ly[i] - oy[i];
+        const double dz = lz[i] - oz[i];
+        e2[i] = observed[i] * (dx * dx + dy * dy + dz * dz);
+    }
 }
 
 /* Marker errors are reported in order different from tasks file or model, find name corresponding to passed in index  */
@@ -400,6 +490,8 @@ void InverseKinematicsSolver::setupMarkersGoal(SimTK::State &s)
     // now build the Goal (AsemblyCondition) for Markers
     std::unique_ptr<SimTK::Markers> condOwner(new SimTK::Markers());
     _markerAssemblyCondition.reset(condOwner.get());
+    MarkerArrays& arrays = _markerArrays;
+    arrays = MarkerArrays();
 
     int index = -1;
     SimTK::Transform X_BF;
@@ -413,11 +505,26 @@ void InverseKinematicsSolver::setupMarkersGoal(SimTK::State &s)
                 marker.getParentFrame().getMobilizedBody();
 
             X_BF = marker.getParentFrame().findTransformInBaseFrame();
+            const SimTK::Vec3 station = X_BF*marker.get_location();
             _markerAssemblyCondition->
-                addMarker(marker.getName(), mobod, X_BF*marker.get_location(),
+                addMarker(marker.getName(), mobod, station,
                     markerWeights[i]);
+
+            arrays.bodies.push_back(mobod.getMobilizedBodyIndex());
+            arrays.observationIndices.push_back(i);
+            arrays.stationX.push_back(station[0]);
+            arrays.stationY.push_back(station[1]);
+            arrays.stationZ.push_back(station[2]);
         }
     }
+    // No marker is observed until the goals are updated.
+    const size_t nm = arrays.bodies.size();
+    for (auto* values : {&arrays.observedX, &arrays.observedY,
+                 &arrays.observedZ, &arrays.isObserved, &arrays.locationX,
+                 &arrays.locationY, &arrays.locationZ, &arrays.squaredErrors})
+        values->assign(nm, 0.0);
+    for (auto& values : arrays.rotation) values.assign(nm, 0.0);
+    for (auto& values : arrays.origin) values.assign(nm, 0.0);
 
     // Add marker goal to the ik objective and transfer ownership of the 
     // goal (AssemblyCondition) to Assembler
@@ -498,9 +605,18 @@ void InverseKinematicsSolver::updateGoals(SimTK::State &s)
     double nextTime = s.getTime();
     // specify the marker observations to be matched
     if (_markersReference && _markersReference->getNumRefs() > 0) {
-        SimTK::Array_<SimTK::Vec3> markerValues;
-        _markersReference->getValuesAtTime(nextTime, markerValues);
-        _markerAssemblyCondition->moveAllObservations(markerValues);
+        _markersReference->getValuesAtTime(nextTime, _markerValues);
+        _markerAssemblyCondition->moveAllObservations(_markerValues);
+
+        MarkerArrays& m = _markerArrays;
+        for (size_t i = 0; i < m.bodies.size(); ++i) {
+            const SimTK::Vec3& value = _markerValues[m.observationIndices[i]];
+            const bool observed = value.isFinite();
+            m.observedX[i] = observed ? value[0] : 0;
+            m.observedY[i] = observed ? value[1] : 0;
+            m.observedZ[i] = observed ? value[2] : 0;
+            m.isObserved[i] = observed ? 1 : 0;
+        }
     }
 
     // specify the orientation observations to be matched
@@ -63,6 +63,13 @@ namespace OpenSim {
  *
  * See SimTK::Assembler for more algorithmic details of the underlying solver.
  *
+ * The marker term of the objective, its gradient and its Jacobian are
+ * evaluated by SimTK::Markers within the SimTK::Assembler, one marker at a
+ * time. Only the reporting of marker locations and errors after a solve
+ * (computeCurrentMarkerLocationsAndSquaredErrors() and the
+ * computeCurrentMarker...() methods) is computed in one pass over arrays
+ * of all markers, so the cost of assemble() and track() is unchanged.
+ *
  * @author Ajay Seth
  */
 class OSIMSIMULATION_API InverseKinematicsSolver: public AssemblySolver
@@ -194,6 +201,17 @@ public:
         returned by computeCurrentMarkerErrors(). */
     void computeCurrentSquaredMarkerErrors(SimTK::Array_<double> &markerErrors);
 
+    /** Compute the spatial locations of all markers in the ground frame and
+        the squared-distance errors between the markers and their
+        observations, in one pass over the markers, and write them to row
+        `row` of matrices that were allocated for all frames of a trial.
+        `locations` has 3 columns per marker (x, y and z), and
+        `squaredErrors` a column per marker, in the order of
+        getMarkerNameForIndex(); a matrix without columns is skipped. Unlike
+        the methods above, this does not allocate memory per frame. */
+    void computeCurrentMarkerLocationsAndSquaredErrors(
+            SimTK::Matrix& locations, SimTK::Matrix& squaredErrors, int row);
+
     /** Marker locations and errors may be computed in an order that is different
         from tasks file or listed in the model. Return the corresponding marker
         name for an index in the list of marker locations/errors returned by the
@@ -248,6 +266,10 @@ private:
         assembly problem. */
     void setupOrientationsGoal(SimTK::State &s);
 
+    /** Compute the locations in ground and the squared errors of all markers
+        into _markerArrays. */
+    void computeMarkerArrays();
+
     // The marker reference values and weightings
     std::shared_ptr<MarkersReference> _markersReference;
 
@@ -258,6 +280,26 @@ private:
     // SimTK::Assembler and the memory is managed by the Assembler
     SimTK::ReferencePtr<SimTK::Markers> _markerAssemblyCondition;
 
+    // The markers of the assembly condition, in its order, with one array
+    // per quantity.
+    struct MarkerArrays {
+        SimTK::Array_<SimTK::MobilizedBodyIndex> bodies;
+        // Index of the observation of each marker in the MarkersReference.
+        std::vector<int> observationIndices;
+        // Location of each marker in the frame of its body.
+        std::vector<double> stationX, stationY, stationZ;
+        // Observed location of each marker, and 1 if it was observed or 0 if
+        // its observation is missing (NaN), in which case its error is 0.
+        std::vector<double> observedX, observedY, observedZ, isObserved;
+        // Work space: the rotation (row-major) and origin of the body of each
+        // marker in ground, and the results.
+        std::vector<double> rotation[9], origin[3];
+        std::vector<double> locationX, locationY, locationZ, squaredErrors;
+    };
+    MarkerArrays _markerArrays;
+    // The marker observations at the time of the current goals.
+    SimTK::Array_<SimTK::Vec3> _markerValues;
+
     // OrientationSensors collectively form a single assembly condition for
     // the SimTK::Assembler and the memory is managed by the Assembler
     SimTK::ReferencePtr<SimTK::OrientationSensors> _orientationAssemblyCondition;
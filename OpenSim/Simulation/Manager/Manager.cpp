@@ -24,13 +24,17 @@
 /* Note: This code was originally developed by Realistic Dynamics Inc.
  * Author: Frank C. Anderson
  */
+#include <cmath>
 #include <cstdio>
 #include "Manager.h"
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/AnalysisSet.h>
 #include <OpenSim/Simulation/Model/ControllerSet.h>
+#include <OpenSim/Common/Reporter.h>
 #include <OpenSim/Common/Array.h>
 
+#include <thread>
+
 
 using namespace OpenSim;
 using namespace std;
@@ -509,6 +513,11 @@ void Manager::setIntegratorMethod(IntegratorMethod integMethod)
         OPENSIM_THROW(Exception, msg);
     }
 
+    createIntegrator(integMethod);
+}
+
+void Manager::createIntegrator(IntegratorMethod integMethod)
+{
     auto& sys = _model->getMultibodySystem();
     switch (integMethod) {
         //case IntegratorMethod::CPodes:
@@ -575,16 +584,19 @@ void Manager::setIntegratorAccuracy(double accuracy)
     }
 
     _integ->setAccuracy(accuracy);
+    _integAccuracy = accuracy;
 }
 
 void Manager::setIntegratorMinimumStepSize(double hmin)
 {
     _integ->setMinimumStepSize(hmin);
+    _integMinimumStepSize = hmin;
 }
 
 void Manager::setIntegratorMaximumStepSize(double hmax)
 {
     _integ->setMaximumStepSize(hmax);
+    _integMaximumStepSize = hmax;
 }
 
 //void Manager::setIntegratorFixedStepSize(double stepSize)
@@ -595,6 +607,7 @@ void Manager::setIntegratorMaximumStepSize(double hmax)
 void Manager::setIntegratorInternalStepLimit(int nSteps)
 {
     _integ->setInternalStepLimit(nSteps);
+    _integInternalStepLimit = nSteps;
 }
 
 //=============================================================================
@@ -652,6 +665,10 @@ const SimTK::State& Manager::integrate(double finalTime)
             "initialized. Call Manager::initialize() first.");
     }
 
+    if (_realTimeControlPeriod > 0) return integrateInRealTime(finalTime);
+    // A real-time integration may have degraded the Manager.
+    resetRealTime(finalTime);
+
     // Get the internal state
     const SimTK::State& s = _integ->getState();
 
@@ -755,6 +772,233 @@ const SimTK::State& Manager::integrate(double finalTime)
     return getState();
 }
 
+//-----------------------------------------------------------------------------
+// REAL-TIME INTEGRATION
+//-----------------------------------------------------------------------------
+void Manager::setRealTimeControlPeriod(double period)
+{
+    OPENSIM_THROW_IF(period < 0 || SimTK::isNaN(period), Exception,
+            "Expected the control period to be non-negative, but got {}.",
+            period);
+    _realTimeControlPeriod = period;
+}
+
+void Manager::setRealTimeDeadlineMargin(double fraction)
+{
+    OPENSIM_THROW_IF(!(fraction > 0), Exception,
+            "Expected the deadline margin to be positive, but got {}.",
+            fraction);
+    _realTimeDeadlineMargin = fraction;
+}
+
+const SimTK::State& Manager::integrateInRealTime(double finalTime)
+{
+    OPENSIM_THROW_IF(_specifiedDT || _constantDT, Exception,
+            "Real-time integration cannot be combined with specified or "
+            "constant time steps.");
+
+    _integ->setFinalTime(finalTime);
+    // Only return at the end of each control period (and at events).
+    _integ->setReturnEveryInternalStep(false);
+    clearHalt();
+
+    // The reporters are only suspended during a real-time integrate().
+    struct ResumeReporters {
+        Manager& manager;
+        ~ResumeReporters() { manager.setReportingSuspended(false); }
+    } resumeReporters{*this};
+    if (_realTimeStatistics.degradationLevel > 0) setReportingSuspended(true);
+
+    double time = _integ->getState().getTime();
+    _model->realizeVelocity(_integ->getState());
+    initializeStorageAndAnalyses(_integ->getState());
+
+    if (!_realTimeStarted) {
+        _realTimeStarted = true;
+        _realTimeWallStart = RealTimeClock::now();
+        _realTimeInitialTime = time;
+    }
+    const double period = _realTimeControlPeriod;
+    // The wall-clock time by which the simulation must reach a given time.
+    auto calcDeadline = [this](double simulationTime) {
+        return _realTimeWallStart +
+               std::chrono::duration_cast<RealTimeClock::duration>(
+                       std::chrono::duration<double>(
+                               simulationTime - _realTimeInitialTime));
+    };
+
+    int step = 1; // for AnalysisSet::step()
+    while (time < finalTime) {
+        // Periods are aligned with the time at which real-time integration
+        // started, so that calls to integrate() may end mid-period.
+        const double periodIndex = std::floor(
+                (time - _realTimeInitialTime) / period + SimTK::SignificantReal);
+        const double periodEnd = std::min(
+                _realTimeInitialTime + (periodIndex + 1) * period, finalTime);
+
+        const double periodStart = time;
+        const auto start = RealTimeClock::now();
+        bool stop = false;
+        int numStalls = 0;
+        while (time < periodEnd) {
+            _timeStepper->stepTo(periodEnd);
+            const SimTK::State& s = _integ->getState();
+            if (_integ->isSimulationOver() &&
+                    _integ->getTerminationReason() !=
+                            SimTK::Integrator::ReachedFinalTime) {
+                log_error("Integration failed due to the following reason: {}",
+                    _integ->getTerminationReasonString(
+                            _integ->getTerminationReason()));
+                return getState();
+            }
+            if (s.getTime() > time) {
+                record(s, step);
+                step++;
+                numStalls = 0;
+            } else if (++numStalls > 1) {
+                // stepTo() may return once at an event without advancing,
+                // but not repeatedly.
+                log_warn("Manager: the integration did not advance past time "
+                         "{}; stopping the real-time integration.", time);
+                stop = true;
+                break;
+            }
+            time = s.getTime();
+            // CHECK FOR INTERRUPT
+            if (checkHalt()) {
+                stop = true;
+                break;
+            }
+        }
+        const auto end = RealTimeClock::now();
+
+        const double computeTime =
+                std::chrono::duration<double>(end - start).count();
+        // Without pacing, each period has as much wall-clock time as it
+        // spans in simulation time.
+        const auto deadline = _realTimePacing
+                ? calcDeadline(periodEnd)
+                : start + std::chrono::duration_cast<RealTimeClock::duration>(
+                          std::chrono::duration<double>(
+                                  periodEnd - periodStart));
+        RealTimeStatistics& stats = _realTimeStatistics;
+        ++stats.numPeriods;
+        stats.totalComputeTime += computeTime;
+        stats.maxComputeTime = std::max(stats.maxComputeTime, computeTime);
+        stats.lastComputeTime = computeTime;
+        stats.lastDeadlineMissed = end > deadline;
+        if (stats.lastDeadlineMissed) ++stats.numDeadlineMisses;
+        if (stop) break;
+
+        if (computeTime > _realTimeDeadlineMargin * period) {
+            _realTimeNumCalmPeriods = 0;
+            if (time < finalTime) degradeRealTime(finalTime, computeTime);
+        } else if (computeTime < 0.5 * _realTimeDeadlineMargin * period) {
+            if (++_realTimeNumCalmPeriods >= 10 && time < finalTime) {
+                recoverRealTime(finalTime);
+                _realTimeNumCalmPeriods = 0;
+            }
+        } else {
+            _realTimeNumCalmPeriods = 0;
+        }
+
+        if (_realTimePacing) std::this_thread::sleep_until(deadline);
+
+        // CHECK FOR INTERRUPT
+        if (checkHalt()) break;
+    }
+
+    // CLEAR ANY INTERRUPT
+    clearHalt();
+
+    record(_integ->getState(), -1);
+
+    return getState();
+}
+
+void Manager::degradeRealTime(double finalTime, double computeTime)
+{
+    RealTimeStatistics& stats = _realTimeStatistics;
+    const double time = _integ->getState().getTime();
+    if (stats.degradationLevel == 0) {
+        log_warn("Manager: the control period ending at time {} took {} s to "
+                 "compute (control period: {} s); skipping the analyses and "
+                 "reporters.", time, computeTime, _realTimeControlPeriod);
+        stats.degradationLevel = 1;
+        setReportingSuspended(true);
+    } else if (stats.degradationLevel == 1) {
+        log_warn("Manager: the control period ending at time {} took {} s to "
+                 "compute (control period: {} s); switching to the fallback "
+                 "integrator.", time, computeTime, _realTimeControlPeriod);
+        // Continue from the current state with a new integrator, keeping the
+        // original one for when the Manager recovers. The time stepper
+        // refers to the integrator, so it is deleted first.
+        const SimTK::State state = _integ->getState();
+        _timeStepper.reset();
+        _realTimeOriginalInteg = std::move(_integ);
+        createIntegrator(_realTimeFallbackIntegratorMethod);
+        double stepSize = _realTimeControlPeriod;
+        if (!SimTK::isNaN(_integMaximumStepSize))
+            stepSize = std::min(stepSize, _integMaximumStepSize);
+        if (!SimTK::isNaN(_integMinimumStepSize))
+            stepSize = std::max(stepSize, _integMinimumStepSize);
+        _integ->setFixedStepSize(stepSize);
+        if (!SimTK::isNaN(_integAccuracy) && _integ->methodHasErrorControl())
+            _integ->setAccuracy(_integAccuracy);
+        if (_integInternalStepLimit > 0)
+            _integ->setInternalStepLimit(_integInternalStepLimit);
+        restartTimeStepper(state, finalTime);
+        stats.degradationLevel = 2;
+    }
+    stats.maxDegradationLevel =
+            std::max(stats.maxDegradationLevel, stats.degradationLevel);
+}
+
+void Manager::recoverRealTime(double finalTime)
+{
+    RealTimeStatistics& stats = _realTimeStatistics;
+    if (stats.degradationLevel == 2) {
+        log_info("Manager: restoring the integrator at time {}.",
+                _integ->getState().getTime());
+        const SimTK::State state = _integ->getState();
+        _timeStepper.reset();
+        _integ = std::move(_realTimeOriginalInteg);
+        restartTimeStepper(state, finalTime);
+        stats.degradationLevel = 1;
+    } else if (stats.degradationLevel == 1) {
+        log_info("Manager: performing the analyses and reporters again at "
+                 "time {}.", _integ->getState().getTime());
+        setReportingSuspended(false);
+        stats.degradationLevel = 0;
+    }
+}
+
+void Manager::resetRealTime(double finalTime)
+{
+    while (_realTimeStatistics.degradationLevel > 0)
+        recoverRealTime(finalTime);
+    _realTimeStarted = false;
+    _realTimeNumCalmPeriods = 0;
+}
+
+void Manager::restartTimeStepper(const SimTK::State& state, double finalTime)
+{
+    _integ->setFinalTime(finalTime);
+    _integ->setReturnEveryInternalStep(false);
+    _timeStepper.reset(
+        new SimTK::TimeStepper(_model->getMultibodySystem(), *_integ));
+    _timeStepper->initialize(state);
+    _timeStepper->setReportAllSignificantStates(true);
+}
+
+void Manager::setReportingSuspended(bool suspended)
+{
+    if (suspended == _reportingSuspended) return;
+    for (auto& reporter : _model->updComponentList<AbstractReporter>())
+        reporter.setReportingSuspended(suspended);
+    _reportingSuspended = suspended;
+}
+
 const SimTK::State& Manager::getState() const
 {
     return _timeStepper->getState();
@@ -822,6 +1066,11 @@ void Manager::initialize(const SimTK::State& s)
         _timeStepper->setReportAllSignificantStates(true);
     }
 
+    // The real-time schedule starts with the first real-time integrate().
+    _realTimeStarted = false;
+    _realTimeNumCalmPeriods = 0;
+    _realTimeStatistics.degradationLevel = 0;
+
     // Here we call the constructStorage because it is possible that
     // the Model's control storage has already been appended in a
     // previous simulation since the Manager mutates the model
@@ -834,7 +1083,10 @@ void Manager::initialize(const SimTK::State& s)
 void Manager::record(const SimTK::State& s, const int& step)
 {
     // ANALYSES
-    if (_performAnalyses) {
+    // The steps are skipped while a real-time integration is behind
+    // schedule, but the analyses always begin and end.
+    if (_performAnalyses &&
+            (step <= 0 || _realTimeStatistics.degradationLevel == 0)) {
         AnalysisSet& analysisSet = _model->updAnalysisSet();
         if (step == 0)
             analysisSet.begin(s);
@@ -34,6 +34,9 @@
 #include <OpenSim/Simulation/osimSimulationDLL.h>
 #include <SimTKcommon/internal/ReferencePtr.h>
 
+#include <chrono>
+#include <vector>
+
 namespace SimTK {
 class Integrator;
 class State;
@@ -47,6 +50,36 @@ class Model;
 class Storage;
 class ControllerSet;
 
+#ifndef SWIG
+/** Measurements of a real-time integration; see
+Manager::setRealTimeControlPeriod(). All times are wall-clock times in
+seconds. The measurements are running totals, so that they take the same
+memory however long the integration runs. */
+struct RealTimeStatistics {
+    /** The number of control periods computed. */
+    int numPeriods = 0;
+    /** The number of periods that finished after their deadline. */
+    int numDeadlineMisses = 0;
+    /** The total time spent computing control periods. */
+    double totalComputeTime = 0;
+    /** The longest time spent computing a control period. */
+    double maxComputeTime = 0;
+    /** The time spent computing the most recent control period. */
+    double lastComputeTime = 0;
+    /** Whether the most recent control period finished after its deadline. */
+    bool lastDeadlineMissed = false;
+    /** How far the Manager is currently degraded to keep up with the wall
+    clock: 0 if not at all, 1 if the analyses and reporters are skipped, and
+    2 if, in addition, the fallback integrator is used. */
+    int degradationLevel = 0;
+    /** The highest degradation level reached. */
+    int maxDegradationLevel = 0;
+    int getNumPeriods() const { return numPeriods; }
+    double getMeanComputeTime() const
+    {   return numPeriods > 0 ? totalComputeTime / numPeriods : 0; }
+};
+#endif
+
 //=============================================================================
 //=============================================================================
 /**
@@ -235,6 +268,70 @@ public:
    
     /** @} */
 
+    /** @name Real-time integration
+      * In real-time mode, integrate() advances the simulation in control
+      * periods of fixed duration and keeps pace with the wall clock, as needed
+      * when the model runs in the loop with hardware (e.g., an exoskeleton
+      * whose controller is a Controller of the model). Reaching simulation
+      * time t0 + T, where t0 is the time at which the first real-time
+      * integrate() started, is due T seconds of wall-clock time after that
+      * start; integrate() waits until then before computing the next period,
+      * so that repeated calls to integrate() (e.g., once per period, after
+      * new sensor data has arrived) remain on the same schedule. The compute
+      * time of each period, and whether it missed its deadline, are measured
+      * (see getRealTimeStatistics()).
+      *
+      * When computing a period takes longer than the deadline margin times
+      * the control period, the deadline is threatened, and the Manager
+      * degrades by one level:
+      * 1. the analyses (except their begin() and end()) and the reporters of
+      *    the model are skipped (the states are still recorded);
+      * 2. the integrator is replaced by the fallback integrator (see
+      *    setRealTimeFallbackIntegratorMethod()), which takes a single fixed
+      *    step per control period (or steps of the maximum step size, if it
+      *    is smaller). The accuracy, minimum and maximum step sizes and
+      *    internal step limit set on this Manager are carried over.
+      *
+      * Once computing a period has taken less than half of the deadline
+      * margin for 10 consecutive periods, the Manager recovers by one level,
+      * restoring the original integrator or performing the analyses and
+      * reporters again. An integrate() call when real-time mode is disabled
+      * undoes all degradation and runs as usual; a later real-time
+      * integrate() starts a new schedule.
+      *
+      * The Controllers of the model are evaluated as in a regular
+      * integration, so they may read inputs produced concurrently by another
+      * thread (e.g., the DataQueue of a BufferedOrientationsReference) in
+      * computeControls(). Real-time mode cannot be combined with specified or
+      * constant time steps (setUseSpecifiedDT(), setUseConstantDT()).
+      * @{ */
+    /** Set the duration of a control period, in seconds of both simulation
+      * and wall-clock time. A period of 0 (the default) disables real-time
+      * mode. Call this before the first call to integrate(). */
+    void setRealTimeControlPeriod(double period);
+    double getRealTimeControlPeriod() const { return _realTimeControlPeriod; }
+    /** Set the fraction of the control period that computing a period may
+      * take before the Manager degrades (default: 0.8). Use SimTK::Infinity
+      * to never degrade. */
+    void setRealTimeDeadlineMargin(double fraction);
+    double getRealTimeDeadlineMargin() const { return _realTimeDeadlineMargin; }
+    /** Set the integrator used once the Manager has degraded to level 2
+      * (default: SemiExplicitEuler2). */
+    void setRealTimeFallbackIntegratorMethod(IntegratorMethod integMethod)
+    {   _realTimeFallbackIntegratorMethod = integMethod; }
+    /** Whether integrate() waits for the wall clock to reach the deadline of
+      * each period (default: true). If false, each period is computed as soon
+      * as the previous one is done, and it misses its deadline if it takes
+      * longer than the control period; this is useful to measure whether a
+      * model can run in real time. */
+    void setRealTimePacing(bool pacing) { _realTimePacing = pacing; }
+#ifndef SWIG
+    /** The measurements of all real-time integrations with this Manager. */
+    const RealTimeStatistics& getRealTimeStatistics() const
+    {   return _realTimeStatistics; }
+#endif
+    /** @} */
+
     // SPECIFIED TIME STEP
     void setUseSpecifiedDT(bool aTrueFalse);
     bool getUseSpecifiedDT() const;
@@ -341,6 +438,11 @@ public:
     /** Set the Storage object to be used for storing states. The Manager takes
     ownership of the passed-in Storage. */
     void setStateStorage(Storage& aStorage);
+    /** The Storage in which the states are recorded. For long simulations,
+    you can write the states to a file as the integration proceeds, instead
+    of keeping them all in memory, with
+    Storage::setStreamingOutputFileName(); the Storage then only holds the
+    rows that have not yet been written. */
     Storage& getStateStorage() const;
     TimeSeriesTable getStatesTable() const;
 
@@ -363,6 +465,50 @@ private:
     // step = 0 is the beginning, step = -1 used to denote the end/final step
     void record(const SimTK::State& s, const int& step);
 
+    // Create an integrator of the given method, replacing the current one.
+    void createIntegrator(IntegratorMethod integMethod);
+
+    // integrate() in real-time mode.
+    const SimTK::State& integrateInRealTime(double finalTime);
+    // Degrade by one level after a period whose deadline was threatened.
+    void degradeRealTime(double finalTime, double computeTime);
+    // Undo the last degradation once the deadlines are no longer threatened.
+    void recoverRealTime(double finalTime);
+    // Undo all degradation and forget the real-time schedule.
+    void resetRealTime(double finalTime);
+    // Continue the integration from a state with the current integrator.
+    void restartTimeStepper(const SimTK::State& state, double finalTime);
+    // Suspend or resume the reporters of the model.
+    void setReportingSuspended(bool suspended);
+
+    typedef std::chrono::steady_clock RealTimeClock;
+    double _realTimeControlPeriod = 0;
+    double _realTimeDeadlineMargin = 0.8;
+    IntegratorMethod _realTimeFallbackIntegratorMethod =
+            IntegratorMethod::SemiExplicitEuler2;
+    bool _realTimePacing = true;
+    // The wall-clock and simulation times at which the first real-time
+    // integration started; deadlines are relative to these.
+    bool _realTimeStarted = false;
+    RealTimeClock::time_point _realTimeWallStart;
+    double _realTimeInitialTime = 0;
+    // The number of consecutive periods computed well within the margin.
+    int _realTimeNumCalmPeriods = 0;
+    // The integrator replaced by the fallback integrator.
+    std::unique_ptr<SimTK::Integrator> _realTimeOriginalInteg;
+    bool _reportingSuspended = false;
+#ifndef SWIG
+    RealTimeStatistics _realTimeStatistics;
+#endif
+
+    // The integrator settings made through this Manager, which are carried
+    // over to the real-time fallback integrator; NaN (or 0 for the step
+    // limit) if they were not set.
+    double _integAccuracy = SimTK::NaN;
+    double _integMinimumStepSize = SimTK::NaN;
+    double _integMaximumStepSize = SimTK::NaN;
+    int _integInternalStepLimit = 0;
+
 //=============================================================================
 };  // END of class Manager
 
@@ -157,9 +157,11 @@ const SimTK::Array_<std::string>& MarkersReference::getNames() const {
 void MarkersReference::getValuesAtTime(double time,
                                   SimTK::Array_<Vec3>& values) const {
     const auto rowView = _markerTable.getNearestRow(time);
-    values.clear();
+    // Values of the same size (e.g., from the previous frame) are
+    // overwritten without reallocating.
+    values.resize(rowView.ncol());
     for(int i = 0; i < rowView.ncol(); ++i)
-        values.push_back(rowView[i]);
+        values[i] = rowView[i];
 }
 
 // void
@@ -30,6 +30,7 @@
 // INCLUDES
 //=============================================================================
 #include "Analysis.h"
+#include "KinematicsSnapshot.h"
 #include "OpenSim/Common/XMLDocument.h"
 
 
@@ -165,6 +166,7 @@ setNull()
     _inDegrees=true;
     _storageList.setMemoryOwner(false);
     _printResultFiles=true;
+    _kinematicsSnapshot = NULL;
 }
 //_____________________________________________________________________________
 /**
@@ -351,6 +353,18 @@ ArrayPtrs<Storage>& Analysis::getStorageList()
 {
     return _storageList;
 }
+//_____________________________________________________________________________
+/**
+ * Get the kinematics of the state shared by the analysis set, if they are
+ * the kinematics of s.
+ */
+const KinematicsSnapshot* Analysis::
+getKinematicsSnapshot(const SimTK::State& s) const
+{
+    if (_kinematicsSnapshot == NULL || !_kinematicsSnapshot->isValid() ||
+            &_kinematicsSnapshot->getState() != &s) return NULL;
+    return _kinematicsSnapshot;
+}
 
 // GET AND SET
 //=============================================================================
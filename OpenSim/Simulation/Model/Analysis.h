@@ -36,6 +36,7 @@
 #include <OpenSim/Common/ArrayPtrs.h>
 #include <OpenSim/Common/Array.h>
 #include <OpenSim/Common/Storage.h>
+#include <SimTKcommon/internal/Stage.h>
 
 namespace SimTK {
 class State;
@@ -43,6 +44,7 @@ class State;
 
 namespace OpenSim { 
 
+class KinematicsSnapshot;
 class Model;
 
 //=============================================================================
@@ -94,6 +96,10 @@ protected:
     ArrayPtrs<Storage> _storageList;
     bool _printResultFiles;
 
+    /** Kinematics of the state being recorded, shared by the analyses of
+    an AnalysisSet. */
+    const KinematicsSnapshot* _kinematicsSnapshot;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -209,6 +215,38 @@ public:
     int getStorageInterval() const;
 #endif
     virtual ArrayPtrs<Storage>& getStorageList();
+
+    //--------------------------------------------------------------------------
+    // SHARED KINEMATICS
+    //--------------------------------------------------------------------------
+    /**
+     * The stage to which the state must be realized to record it. Before
+     * calling its analyses, an AnalysisSet realizes the state once to the
+     * highest stage that they require. The default is Velocity, to which
+     * AnalyzeTool realizes the states it analyzes.
+     */
+    virtual SimTK::Stage getRequiredStage() const
+    {   return SimTK::Stage::Velocity; }
+    /**
+     * Whether the results recorded for a state depend only on that state,
+     * and not on the states recorded before it, so that ranges of
+     * consecutive states can be recorded by copies of the analysis on
+     * separate threads, beginning a copy at the first state of each range,
+     * and the rows of their storages (see getStorageList()) concatenated.
+     * The default is false.
+     */
+    virtual bool getRecordsStatesIndependently() const { return false; }
+#ifndef SWIG
+    /**
+     * While an AnalysisSet calls begin(), step() or end() with the state
+     * `s`, the kinematics of `s`, which the analyses of the set can share
+     * instead of each querying the system; null otherwise.
+     */
+    const KinematicsSnapshot* getKinematicsSnapshot(
+            const SimTK::State& s) const;
+    void setKinematicsSnapshot(const KinematicsSnapshot* aSnapshot)
+    {   _kinematicsSnapshot = aSnapshot; }
+#endif
     void setPrintResultFiles(bool aToWrite) { _printResultFiles = aToWrite; }
     bool getPrintResultFiles() const { return _printResultFiles; }
 
@@ -30,6 +30,7 @@
 // INCLUDES
 //=============================================================================
 #include "AnalysisSet.h"
+#include "Model.h"
 
 
 using namespace OpenSim;
@@ -104,6 +105,7 @@ AnalysisSet::AnalysisSet(const AnalysisSet &aSet) :
 void AnalysisSet::
 setNull()
 {
+    _model = NULL;
     _enable = true;
 }
 void AnalysisSet::
@@ -134,6 +136,7 @@ operator=(const  AnalysisSet &aSet)
 void AnalysisSet::
 setModel(Model& aModel)
 {
+    _model = &aModel;
     int i;
     int size = getSize();
     for(i=0;i<size;i++) {
@@ -183,6 +186,37 @@ getOn() const
     for(int i=0; i<getSize(); i++) on[i] = get(i).getOn();
     return on;
 }
+//_____________________________________________________________________________
+/**
+ * Get the highest stage required by the analyses that are on.
+ */
+SimTK::Stage AnalysisSet::
+getRequiredStage() const
+{
+    SimTK::Stage stage = SimTK::Stage::Empty;
+    for(int i=0; i<getSize(); i++) {
+        const Analysis& analysis = get(i);
+        if (analysis.getOn() && analysis.getRequiredStage() > stage)
+            stage = analysis.getRequiredStage();
+    }
+    return stage;
+}
+//_____________________________________________________________________________
+/**
+ * Whether the analyses that are on record each state independently and at
+ * every step, so that ranges of states can be recorded separately.
+ */
+bool AnalysisSet::
+getRecordsStatesIndependently() const
+{
+    for(int i=0; i<getSize(); i++) {
+        const Analysis& analysis = get(i);
+        if (!analysis.getOn()) continue;
+        if (!analysis.getRecordsStatesIndependently() ||
+                analysis.getStepInterval() != 1) return false;
+    }
+    return true;
+}
 
 
 //=============================================================================
@@ -198,11 +232,13 @@ getOn() const
  */
 void AnalysisSet::begin(const SimTK::State& s )
 {
+    shareKinematics(s);
     int i;
     for(i=0;i<getSize();i++) {
         Analysis& analysis = get(i);
         if (analysis.getOn()) analysis.begin(s);
     }
+    unshareKinematics();
 }
 //_____________________________________________________________________________
 /**
@@ -215,11 +251,13 @@ void AnalysisSet::begin(const SimTK::State& s )
 void AnalysisSet::
 step( const SimTK::State& s, int stepNumber )
 {
+    shareKinematics(s);
     int i;
     for(i=0;i<getSize();i++) {
         Analysis& analysis = get(i);
         if (analysis.getOn()) analysis.step(s, stepNumber);
     }
+    unshareKinematics();
 }
 //_____________________________________________________________________________
 /**
@@ -231,11 +269,45 @@ step( const SimTK::State& s, int stepNumber )
  */
 void AnalysisSet:: end(const SimTK::State& s)
 {
+    shareKinematics(s);
     int i;
     for(i=0;i<getSize();i++) {
         Analysis& analysis = get(i);
         if (analysis.getOn()) analysis.end(s);
     }
+    unshareKinematics();
+}
+
+//_____________________________________________________________________________
+/**
+ * Realize the state to the stage required by the analyses that are on and
+ * share its kinematics with them, so that each analysis neither realizes the
+ * state nor queries the system for the kinematics of the bodies again.
+ *
+ * @param s Current state
+ */
+void AnalysisSet::
+shareKinematics(const SimTK::State& s)
+{
+    if (_model == NULL || !_model->hasSystem()) return;
+    const SimTK::Stage stage = getRequiredStage();
+    if (stage > SimTK::Stage::Empty)
+        _model->getMultibodySystem().realize(s, stage);
+    _kinematicsSnapshot.update(*_model, s);
+    for(int i=0;i<getSize();i++) {
+        Analysis& analysis = get(i);
+        if (analysis.getOn()) analysis.setKinematicsSnapshot(&_kinematicsSnapshot);
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Stop sharing the kinematics of the state with the analyses.
+ */
+void AnalysisSet::
+unshareKinematics()
+{
+    for(int i=0;i<getSize();i++) get(i).setKinematicsSnapshot(NULL);
+    _kinematicsSnapshot.clear();
 }
 
 
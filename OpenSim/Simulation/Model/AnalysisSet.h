@@ -32,6 +32,7 @@
 #include <string>
 #include <OpenSim/Common/Set.h>
 #include "Analysis.h"
+#include "KinematicsSnapshot.h"
 
 
 //=============================================================================
@@ -62,6 +63,10 @@ protected:
     /** Model on which the callbacks have been set. */
     Model *_model;
 
+    /** Kinematics of the state passed to the callbacks, shared by the
+    analyses. */
+    KinematicsSnapshot _kinematicsSnapshot;
+
     // testing for memory free error
     OpenSim::PropertyBool _enableProp;
     bool &_enable;
@@ -82,6 +87,10 @@ public:
 private:
     void setNull();
     void setupProperties();
+    // Realize the state to the stage required by the analyses that are on,
+    // and share its kinematics with them.
+    void shareKinematics(const SimTK::State& s);
+    void unshareKinematics();
 public:
 
     //--------------------------------------------------------------------------
@@ -92,10 +101,20 @@ public:
     void setOn(bool aTrueFalse);
     void setOn(const Array<bool> &aOn);
     Array<bool> getOn() const;
+    /** The highest stage required by the analyses that are on (see
+    Analysis::getRequiredStage()). */
+    SimTK::Stage getRequiredStage() const;
+    /** Whether all the analyses that are on record each state independently
+    (see Analysis::getRecordsStatesIndependently()) at every step. */
+    bool getRecordsStatesIndependently() const;
 
     //--------------------------------------------------------------------------
     // CALLBACKS
     //--------------------------------------------------------------------------
+    /** The callbacks realize the state once to getRequiredStage(), if the
+    model of the set has a system, and share the kinematics of the state with
+    the analyses (see Analysis::getKinematicsSnapshot()) while calling the
+    corresponding callback of each analysis that is on. */
     void begin(const SimTK::State& s );
     void step(const SimTK::State& s, int stepNumber );
     void end(const SimTK::State& s );
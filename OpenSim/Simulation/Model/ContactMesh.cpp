@@ -23,11 +23,304 @@
 
 #include <fstream>
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Logger.h>
 #include "ContactMesh.h"
 #include "Model.h"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <queue>
+
 namespace OpenSim {
 
+struct ContactMesh::LoadedMesh {
+    SimTK::PolygonalMesh mesh;
+    std::unique_ptr<SimTK::ContactGeometry::TriangleMesh> geometry;
+    DecimationReport report;
+};
+
+// The meshes are keyed by the absolute path of the file and the maximum
+// number of faces. The cache holds at most maxMeshes meshes; the least
+// recently used are removed first.
+struct ContactMesh::MeshCache {
+    using Key = std::pair<std::string, int>;
+    struct Entry {
+        std::shared_ptr<const LoadedMesh> mesh;
+        long long lastUse = 0;
+    };
+    std::mutex mutex;
+    std::map<Key, Entry> meshes;
+    long long numUses = 0;
+    int maxMeshes = 16;
+
+    // Remove the least recently used meshes until there are at most
+    // maxMeshes. The mutex must be locked.
+    void shrink() {
+        while (static_cast<int>(meshes.size()) > maxMeshes) {
+            auto oldest = meshes.begin();
+            for (auto it = meshes.begin(); it != meshes.end(); ++it) {
+                if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+            }
+            meshes.erase(oldest);
+        }
+    }
+};
+
+ContactMesh::MeshCache& ContactMesh::getMeshCache()
+{
+    static MeshCache cache;
+    return cache;
+}
+
+namespace {
+
+std::string getAbsolutePath(const std::string& filename) {
+    const bool isAbsolute = (!filename.empty() &&
+            (filename[0] == '/' || filename[0] == '\\')) ||
+            (filename.size() > 1 && filename[1] == ':');
+    if (isAbsolute) return filename;
+    return IO::getCwd() + "/" + filename;
+}
+
+// The error quadric of Garland and Heckbert (1997): a symmetric 4x4 matrix,
+// stored by its upper triangle, whose quadratic form is the (weighted) sum of
+// the squared distances of a point to a set of planes.
+struct Quadric {
+    std::array<double, 10> q{};
+    void addPlane(const SimTK::Vec3& normal, double offset, double weight) {
+        const double p[4] = {normal[0], normal[1], normal[2], offset};
+        int k = 0;
+        for (int i = 0; i < 4; ++i) {
+            for (int j = i; j < 4; ++j) q[k++] += weight * p[i] * p[j];
+        }
+    }
+    void add(const Quadric& other) {
+        for (int k = 0; k < 10; ++k) q[k] += other.q[k];
+    }
+    double evaluate(const SimTK::Vec3& v) const {
+        const double p[4] = {v[0], v[1], v[2], 1};
+        double result = 0;
+        int k = 0;
+        for (int i = 0; i < 4; ++i) {
+            for (int j = i; j < 4; ++j) {
+                result += (i == j ? 1 : 2) * q[k++] * p[i] * p[j];
+            }
+        }
+        return result;
+    }
+};
+
+// Simplify a closed triangle mesh to at most maxFaces faces by collapsing
+// the edges with the smallest error quadric. An edge is only collapsed if
+// the mesh stays closed and manifold and no face is flipped, so the result
+// can be used as a SimTK::ContactGeometry::TriangleMesh.
+SimTK::PolygonalMesh decimateMesh(const SimTK::PolygonalMesh& mesh,
+        int maxFaces) {
+    std::vector<SimTK::Vec3> vertices(mesh.getNumVertices());
+    for (int iv = 0; iv < mesh.getNumVertices(); ++iv) {
+        vertices[iv] = mesh.getVertexPosition(iv);
+    }
+    std::vector<std::array<int, 3>> faces;
+    for (int f = 0; f < mesh.getNumFaces(); ++f) {
+        const int v0 = mesh.getFaceVertex(f, 0);
+        for (int k = 1; k + 1 < mesh.getNumVerticesForFace(f); ++k) {
+            faces.push_back({{v0, mesh.getFaceVertex(f, k),
+                    mesh.getFaceVertex(f, k + 1)}});
+        }
+    }
+
+    const int numVertices = static_cast<int>(vertices.size());
+    std::vector<std::vector<int>> vertexFaces(numVertices);
+    std::vector<Quadric> quadrics(numVertices);
+    for (int f = 0; f < static_cast<int>(faces.size()); ++f) {
+        const auto& face = faces[f];
+        const SimTK::Vec3 cross = (vertices[face[1]] - vertices[face[0]]) %
+                                  (vertices[face[2]] - vertices[face[0]]);
+        const double area = 0.5 * cross.norm();
+        if (area > 0) {
+            const SimTK::Vec3 normal = cross / (2 * area);
+            const double offset = -~normal * vertices[face[0]];
+            for (int v : face) quadrics[v].addPlane(normal, offset, area);
+        }
+        for (int v : face) vertexFaces[v].push_back(f);
+    }
+
+    std::vector<bool> isFaceAlive(faces.size(), true);
+    std::vector<bool> isVertexAlive(numVertices, true);
+    std::vector<int> versions(numVertices, 0);
+
+    struct Collapse {
+        double cost;
+        int a, b;
+        int versionA, versionB;
+        SimTK::Vec3 position;
+        bool operator>(const Collapse& other) const {
+            return cost > other.cost;
+        }
+    };
+    std::priority_queue<Collapse, std::vector<Collapse>,
+            std::greater<Collapse>> queue;
+    auto pushCollapse = [&](int a, int b) {
+        Quadric quadric = quadrics[a];
+        quadric.add(quadrics[b]);
+        // Choose the best of the endpoints and the midpoint, which avoids
+        // inverting the quadric for flat regions.
+        Collapse collapse{SimTK::Infinity, a, b, versions[a], versions[b],
+                SimTK::Vec3(0)};
+        for (const SimTK::Vec3& position : {vertices[a], vertices[b],
+                     SimTK::Vec3(0.5 * (vertices[a] + vertices[b]))}) {
+            const double cost = quadric.evaluate(position);
+            if (cost < collapse.cost) {
+                collapse.cost = cost;
+                collapse.position = position;
+            }
+        }
+        queue.push(collapse);
+    };
+    for (const auto& face : faces) {
+        for (int k = 0; k < 3; ++k) {
+            const int a = face[k];
+            const int b = face[(k + 1) % 3];
+            if (a < b) pushCollapse(a, b);
+        }
+    }
+
+    auto neighbors = [&](int v) {
+        std::vector<int> result;
+        for (int f : vertexFaces[v]) {
+            for (int w : faces[f]) {
+                if (w != v) result.push_back(w);
+            }
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    };
+    auto faceContains = [&](int f, int v) {
+        return faces[f][0] == v || faces[f][1] == v || faces[f][2] == v;
+    };
+    auto canCollapse = [&](int a, int b, const SimTK::Vec3& position) {
+        // In a closed manifold mesh, the edge is shared by exactly two faces,
+        // and the collapse keeps the mesh manifold if the endpoints have no
+        // other common neighbors (the "link condition").
+        int numSharedFaces = 0;
+        for (int f : vertexFaces[a]) {
+            if (faceContains(f, b)) ++numSharedFaces;
+        }
+        if (numSharedFaces != 2) return false;
+        const auto neighborsA = neighbors(a);
+        const auto neighborsB = neighbors(b);
+        std::vector<int> common;
+        std::set_intersection(neighborsA.begin(), neighborsA.end(),
+                neighborsB.begin(), neighborsB.end(),
+                std::back_inserter(common));
+        if (common.size() != 2) return false;
+        // The vertices opposite to the edge lose a neighbor, and would be
+        // left with two faces (which are then back to back) if they have
+        // three neighbors.
+        for (int v : common) {
+            if (neighbors(v).size() <= 3) return false;
+        }
+
+        // The faces that remain must not flip or degenerate.
+        for (int v : {a, b}) {
+            for (int f : vertexFaces[v]) {
+                if (faceContains(f, a) && faceContains(f, b)) continue;
+                SimTK::Vec3 p[3];
+                SimTK::Vec3 q[3];
+                for (int k = 0; k < 3; ++k) {
+                    p[k] = vertices[faces[f][k]];
+                    q[k] = faces[f][k] == v ? position : p[k];
+                }
+                const SimTK::Vec3 before = (p[1] - p[0]) % (p[2] - p[0]);
+                const SimTK::Vec3 after = (q[1] - q[0]) % (q[2] - q[0]);
+                if (~before * after <= 0.2 * before.norm() * after.norm()) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    int numFaces = static_cast<int>(faces.size());
+    while (numFaces > maxFaces && !queue.empty()) {
+        const Collapse collapse = queue.top();
+        queue.pop();
+        const int a = collapse.a;
+        const int b = collapse.b;
+        if (!isVertexAlive[a] || !isVertexAlive[b] ||
+                versions[a] != collapse.versionA ||
+                versions[b] != collapse.versionB) {
+            continue;
+        }
+        if (!canCollapse(a, b, collapse.position)) continue;
+
+        // Move a to the new position, remove the two faces that share the
+        // edge, and replace b with a in the other faces of b.
+        for (int f : vertexFaces[b]) {
+            if (faceContains(f, a)) {
+                isFaceAlive[f] = false;
+                --numFaces;
+                for (int v : faces[f]) {
+                    if (v == b) continue;
+                    auto& list = vertexFaces[v];
+                    list.erase(std::remove(list.begin(), list.end(), f),
+                            list.end());
+                }
+            } else {
+                for (int& v : faces[f]) {
+                    if (v == b) v = a;
+                }
+                vertexFaces[a].push_back(f);
+            }
+        }
+        vertexFaces[b].clear();
+        isVertexAlive[b] = false;
+        vertices[a] = collapse.position;
+        quadrics[a].add(quadrics[b]);
+        ++versions[a];
+        for (int v : neighbors(a)) pushCollapse(std::min(a, v), std::max(a, v));
+    }
+
+    SimTK::PolygonalMesh result;
+    std::vector<int> newIndices(numVertices, -1);
+    for (int iv = 0; iv < numVertices; ++iv) {
+        if (isVertexAlive[iv] && !vertexFaces[iv].empty()) {
+            newIndices[iv] = result.addVertex(vertices[iv]);
+        }
+    }
+    SimTK::Array_<int> faceVertices(3);
+    for (int f = 0; f < static_cast<int>(faces.size()); ++f) {
+        if (!isFaceAlive[f]) continue;
+        for (int k = 0; k < 3; ++k) faceVertices[k] = newIndices[faces[f][k]];
+        result.addFace(faceVertices);
+    }
+    return result;
+}
+
+// Accumulate the distances of the vertices of a mesh to the surface of
+// another.
+void accumulateDistances(const SimTK::PolygonalMesh& from,
+        const SimTK::ContactGeometry::TriangleMesh& to, double& maxDistance,
+        double& sumSquaredDistances) {
+    bool inside;
+    SimTK::UnitVec3 normal;
+    for (int iv = 0; iv < from.getNumVertices(); ++iv) {
+        const SimTK::Vec3& vertex = from.getVertexPosition(iv);
+        const double distance =
+                (to.findNearestPoint(vertex, inside, normal) - vertex).norm();
+        maxDistance = std::max(maxDistance, distance);
+        sumSquaredDistances += distance * distance;
+    }
+}
+
+} // anonymous namespace
+
 ContactMesh::ContactMesh() 
 {
     setNull();
@@ -44,15 +337,8 @@ ContactMesh::ContactMesh(const std::string& filename,
     constructProperties();
     setFilename(filename);
     if (filename != ""){
-        std::ifstream file;
-        file.open(filename.c_str());
-        if (file.fail())
-            throw Exception("Error loading mesh file: "+filename+". The file should exist in same folder with model.\n Model loading is aborted.");
-        file.close();
-        SimTK::PolygonalMesh mesh;
-        mesh.loadFile(filename);
-        _geometry.reset(new SimTK::ContactGeometry::TriangleMesh(mesh));
-        _decorativeGeometry.reset(new SimTK::DecorativeMesh(mesh));
+        _geometry = loadMesh(filename, get_max_faces());
+        _decorativeGeometry.reset(new SimTK::DecorativeMesh(_geometry->mesh));
     }
 }
 
@@ -74,6 +360,7 @@ void ContactMesh::setNull()
 void ContactMesh::constructProperties()
 {
     constructProperty_filename("");
+    constructProperty_max_faces(0);
 }
 
 void ContactMesh::extendFinalizeFromProperties() {
@@ -93,38 +380,144 @@ void ContactMesh::setFilename(const std::string& filename)
     _decorativeGeometry.reset();
 }
 
-SimTK::ContactGeometry::TriangleMesh* ContactMesh::
-    loadMesh(const std::string& filename) const
+std::shared_ptr<const ContactMesh::LoadedMesh> ContactMesh::loadMesh(
+        const std::string& filename, int maxFaces)
 {
-    SimTK::PolygonalMesh mesh;
-    std::ifstream file;
-    assert (_model);
+    const MeshCache::Key key(getAbsolutePath(filename), std::max(maxFaces, 0));
 
-    auto cwd = IO::CwdChanger::noop();
-    if ((_model->getInputFileName()!="")
-            && (_model->getInputFileName()!="Unassigned")) {
-        cwd = IO::CwdChanger::changeToParentOf(_model->getInputFileName());
+    MeshCache& cache = getMeshCache();
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        const auto it = cache.meshes.find(key);
+        if (it != cache.meshes.end()) {
+            it->second.lastUse = ++cache.numUses;
+            return it->second.mesh;
+        }
     }
 
-    file.open(filename.c_str());
-    if (file.fail()){
+    // The mesh is loaded and simplified without holding the lock, so that
+    // other meshes can be loaded meanwhile.
+
+    std::ifstream file(key.first.c_str());
+    if (file.fail()) {
         throw Exception("Error loading mesh file: "+filename+". "
                 "The file should exist in same folder with model.\n "
                 "Loading is aborted.");
     }
     file.close();
-    mesh.loadFile(filename);
-    _decorativeGeometry.reset(new SimTK::DecorativeMesh(mesh));
-    return new SimTK::ContactGeometry::TriangleMesh(mesh);
+
+    auto loaded = std::make_shared<LoadedMesh>();
+    SimTK::PolygonalMesh original;
+    original.loadFile(key.first);
+    loaded->geometry.reset(new SimTK::ContactGeometry::TriangleMesh(original));
+    const int numOriginalFaces = loaded->geometry->getNumFaces();
+    loaded->report.numOriginalFaces = numOriginalFaces;
+    loaded->report.numFaces = numOriginalFaces;
+    loaded->mesh = original;
+
+    if (key.second > 0 && numOriginalFaces > key.second) {
+        OPENSIM_THROW_IF(key.second < 4, Exception,
+                "Expected max_faces to be at least 4 (a tetrahedron), but "
+                "got {}.", key.second);
+        std::unique_ptr<SimTK::ContactGeometry::TriangleMesh> originalGeometry(
+                std::move(loaded->geometry));
+        loaded->mesh = decimateMesh(original, key.second);
+        loaded->geometry.reset(
+                new SimTK::ContactGeometry::TriangleMesh(loaded->mesh));
+
+        auto& report = loaded->report;
+        report.numFaces = loaded->geometry->getNumFaces();
+        double sumSquaredDistances = 0;
+        accumulateDistances(original, *loaded->geometry, report.maxDistance,
+                sumSquaredDistances);
+        accumulateDistances(loaded->mesh, *originalGeometry,
+                report.maxDistance, sumSquaredDistances);
+        report.rmsDistance = std::sqrt(sumSquaredDistances /
+                (original.getNumVertices() + loaded->mesh.getNumVertices()));
+        log_info("Simplified mesh '{}' from {} to {} faces; the surfaces "
+                 "deviate by at most {} (RMS {}).",
+                filename, report.numOriginalFaces, report.numFaces,
+                report.maxDistance, report.rmsDistance);
+        if (report.numFaces > key.second) {
+            log_warn("Mesh '{}' could only be simplified to {} faces, which "
+                     "is more than the requested {}.",
+                    filename, report.numFaces, key.second);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    // If another thread loaded the same mesh meanwhile, use the one in the
+    // cache so that the mesh is shared.
+    auto& entry = cache.meshes[key];
+    entry.lastUse = ++cache.numUses;
+    if (!entry.mesh) entry.mesh = loaded;
+    const auto mesh = entry.mesh;
+    cache.shrink();
+    return mesh;
 }
 
-SimTK::ContactGeometry ContactMesh::createSimTKContactGeometry() const
+const ContactMesh::LoadedMesh& ContactMesh::getLoadedMesh() const
 {
-    if (!_geometry)
-        _geometry.reset(loadMesh(get_filename()));
+    if (!_geometry) {
+        assert (_model);
+
+        auto cwd = IO::CwdChanger::noop();
+        if ((_model->getInputFileName()!="")
+                && (_model->getInputFileName()!="Unassigned")) {
+            cwd = IO::CwdChanger::changeToParentOf(_model->getInputFileName());
+        }
+        _geometry = loadMesh(get_filename(), get_max_faces());
+        _decorativeGeometry.reset(new SimTK::DecorativeMesh(_geometry->mesh));
+    }
     return *_geometry;
 }
 
+const ContactMesh::DecimationReport& ContactMesh::getDecimationReport() const
+{
+    return getLoadedMesh().report;
+}
+
+void ContactMesh::clearMeshCache()
+{
+    MeshCache& cache = getMeshCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.meshes.clear();
+}
+
+int ContactMesh::getNumCachedMeshes()
+{
+    MeshCache& cache = getMeshCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return static_cast<int>(cache.meshes.size());
+}
+
+void ContactMesh::setMaxCachedMeshes(int maxMeshes)
+{
+    OPENSIM_THROW_IF(maxMeshes < 0, Exception,
+            "Expected the maximum number of cached meshes to be non-negative, "
+            "but got {}.", maxMeshes);
+    MeshCache& cache = getMeshCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.maxMeshes = maxMeshes;
+    cache.shrink();
+}
+
+int ContactMesh::getMaxCachedMeshes()
+{
+    MeshCache& cache = getMeshCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    return cache.maxMeshes;
+}
+
+SimTK::ContactGeometry ContactMesh::createSimTKContactGeometry() const
+{
+    // Copying a SimTK::ContactGeometry clones its implementation, so the
+    // Simbody contact subsystem stores its own copy of the triangles and
+    // their bounding-volume hierarchy; this copies the cached ones rather
+    // than building them again.
+    return *getLoadedMesh().geometry;
+}
+
 //=============================================================================
 // VISUALIZER GEOMETRY
 //=============================================================================
@@ -25,6 +25,8 @@
 // INCLUDE
 #include "ContactGeometry.h"
 
+#include <memory>
+
 namespace OpenSim {
 
 // TODO update doxygen comments to mention socket.
@@ -32,6 +34,26 @@ namespace OpenSim {
 /**
  * This class represents a polygonal mesh for use in contact modeling.
  *
+ * Loading a mesh involves parsing the file and building the bounding-volume
+ * hierarchy that Simbody uses for contact queries, which is expensive for
+ * high-resolution surfaces. Loaded meshes are therefore kept in a cache that
+ * is shared by all ContactMesh%es in the process (including copies of a
+ * model and models used in other threads), so that each file is loaded only
+ * once. The cache holds a limited number of meshes (see
+ * setMaxCachedMeshes()), removing the least recently used first; a mesh
+ * removed from the cache is freed with the last ContactMesh that uses it.
+ * The cache is keyed by the absolute path of the file; call clearMeshCache()
+ * if a mesh file changes on disk. Simbody keeps its own copy of the mesh for
+ * each contact force that uses it.
+ *
+ * ElasticFoundationForce places a spring at the center of each face of the
+ * mesh, so its cost is proportional to the number of faces. Use the
+ * `max_faces` property to simplify a dense mesh before it is used for
+ * contact. The mesh is simplified by collapsing the edges whose removal
+ * changes the surface the least (Garland and Heckbert, 1997), keeping it
+ * closed; the deviation of the simplified surface from the original is
+ * logged and available from getDecimationReport().
+ *
  * @author Peter Eastman
  */
 class OSIMSIMULATION_API ContactMesh : public ContactGeometry {
@@ -45,6 +67,10 @@ public:
     OpenSim_DECLARE_PROPERTY(filename, std::string,
             "Path to mesh geometry file (supports .obj, .stl, .vtp). "
             "Mesh should be closed and water-tight.");
+    OpenSim_DECLARE_PROPERTY(max_faces, int,
+            "If positive, the mesh is simplified to at most this number of "
+            "triangular faces before it is used for contact. Default is 0 "
+            "(the mesh is used as is).");
 
 //=============================================================================
 // METHODS
@@ -94,6 +120,37 @@ public:
      */
     void setFilename(const std::string& filename);
 
+#ifndef SWIG
+    /** The result of simplifying the mesh (see the `max_faces` property).
+    The distances are measured between the vertices of each of the original
+    and simplified meshes and the surface of the other. */
+    struct DecimationReport {
+        int numOriginalFaces = 0;
+        int numFaces = 0;
+        double maxDistance = 0;
+        double rmsDistance = 0;
+    };
+    /** Get the result of simplifying the mesh, loading the mesh if
+    necessary. If the mesh is not simplified, the number of faces is that of
+    the original mesh and the distances are 0. The ContactMesh must be part
+    of a Model that has been finalized. */
+    const DecimationReport& getDecimationReport() const;
+#endif
+
+    /** Remove all meshes from the process-wide cache of loaded meshes, so
+    that they are loaded from their files again the next time they are
+    needed. ContactMesh%es that have already loaded their mesh are not
+    affected. */
+    static void clearMeshCache();
+    /** The number of meshes in the process-wide cache of loaded meshes. */
+    static int getNumCachedMeshes();
+    /** %Set the maximum number of meshes in the process-wide cache of loaded
+    meshes (default: 16), removing the least recently used meshes if there
+    are more. ContactMesh%es that have already loaded their mesh are not
+    affected. */
+    static void setMaxCachedMeshes(int maxMeshes);
+    static int getMaxCachedMeshes();
+
     // VISUALIZATION
     void generateDecorations(bool fixed, const ModelDisplayHints& hints,
         const SimTK::State& s,
@@ -104,15 +161,26 @@ private:
     void constructProperties();
     void extendFinalizeFromProperties() override;
 
-    /** Load the mesh from a file.
-    @param filename   string containing the file to be loaded
-    @return SimTK::ContactGeometry::TriangleMesh* heap allocated Contact mesh */
-    SimTK::ContactGeometry::TriangleMesh* loadMesh(const std::string& filename) const;
+    /** A mesh loaded from a file, which is shared by all ContactMesh%es
+    that use the same file and `max_faces`. */
+    struct LoadedMesh;
+    /** The process-wide cache of loaded meshes. */
+    struct MeshCache;
+    static MeshCache& getMeshCache();
+
+    /** Load the mesh from a file, or get it from the cache.
+    @param filename   string containing the file to be loaded, relative to
+                      the current working directory
+    @param maxFaces   the maximum number of faces, or 0 not to simplify the
+                      mesh */
+    static std::shared_ptr<const LoadedMesh> loadMesh(
+            const std::string& filename, int maxFaces);
+    /** Get the mesh, loading it (relative to the model file) if necessary. */
+    const LoadedMesh& getLoadedMesh() const;
 //=============================================================================
 // DATA
 //=============================================================================
-    mutable SimTK::ResetOnCopy<std::unique_ptr<SimTK::ContactGeometry::TriangleMesh>>
-        _geometry;
+    mutable SimTK::ResetOnCopy<std::shared_ptr<const LoadedMesh>> _geometry;
     mutable SimTK::ResetOnCopy<std::unique_ptr<SimTK::DecorativeMesh>>
         _decorativeGeometry;
 
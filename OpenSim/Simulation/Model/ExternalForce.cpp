@@ -30,6 +30,7 @@
 #include <OpenSim/Common/Constant.h>
 #include <OpenSim/Common/PiecewiseLinearFunction.h>
 #include <OpenSim/Common/GCVSpline.h>
+#include <OpenSim/Common/PiecewiseCubicTable.h>
 
 #include "ExternalForce.h"
 
@@ -318,6 +319,66 @@ void ExternalForce::extendConnectToModel(Model& model)
             }
         }
     }
+
+    // Compile the functions into a table that evaluates all of them at once.
+    // The table requires strictly increasing times; otherwise, the functions
+    // are evaluated individually.
+    _table.reset();
+    _tableFirstColumn = 0;
+    bool timesIncrease = nt >= 2;
+    for (int i = 1; i < nt && timesIncrease; ++i)
+        timesIncrease = time[i] > time[i-1];
+    if (timesIncrease) {
+        try {
+            _table = std::make_shared<const PiecewiseCubicTable>(
+                    std::vector<double>(&time[0], &time[0] + nt),
+                    getTableFunctions());
+        } catch (const Exception& e) {
+            log_debug("ExternalForce '{}' evaluates its data functions "
+                      "individually: {}", getName(), e.getMessage());
+        }
+    }
+}
+
+std::vector<const Function*> ExternalForce::getTableFunctions() const
+{
+    std::vector<const Function*> functions;
+    for (const auto* set : {&_forceFunctions, &_pointFunctions,
+                &_torqueFunctions}) {
+        if (set->size() == 3)
+            for (int i = 0; i < 3; ++i) functions.push_back((*set)[i]);
+    }
+    return functions;
+}
+
+void ExternalForce::calcDataAtTime(double time, Vec3& force, Vec3& point,
+        Vec3& torque) const
+{
+    force = point = torque = Vec3(0);
+    const bool hasForce = _forceFunctions.size() == 3;
+    const bool hasPoint = _pointFunctions.size() == 3;
+    const bool hasTorque = _torqueFunctions.size() == 3;
+
+    if (_table && _table->isInRange(time)) {
+        double values[9];
+        const int numColumns = 3 * (hasForce + hasPoint + hasTorque);
+        _table->calcValues(time, _tableFirstColumn, numColumns, values);
+        int c = 0;
+        if (hasForce) { force = Vec3(values[c], values[c+1], values[c+2]); c += 3; }
+        if (hasPoint) { point = Vec3(values[c], values[c+1], values[c+2]); c += 3; }
+        if (hasTorque) { torque = Vec3(values[c], values[c+1], values[c+2]); }
+        return;
+    }
+
+    SimTK::Vector timeAsVector(1, time);
+    auto evaluate = [&timeAsVector](const ArrayPtrs<Function>& functions) {
+        return Vec3(functions[0]->calcValue(timeAsVector),
+                    functions[1]->calcValue(timeAsVector),
+                    functions[2]->calcValue(timeAsVector));
+    };
+    if (hasForce) force = evaluate(_forceFunctions);
+    if (hasPoint) point = evaluate(_pointFunctions);
+    if (hasTorque) torque = evaluate(_torqueFunctions);
 }
 
 
@@ -335,12 +396,13 @@ void ExternalForce::computeForce(const SimTK::State& state,
 
     assert(_appliedToBody!=nullptr);
 
+    Vec3 force, point, torque;
+    calcDataAtTime(time, force, point, torque);
+
     if (_appliesForce) {
-        Vec3 force = getForceAtTime(time);
         force = _forceExpressedInBody->expressVectorInGround(state, force);
-        Vec3 point(0); // Default is body origin.
+        // If no point is specified, the point is the body origin.
         if (_specifiesPoint) {
-            point = getPointAtTime(time);
             point = _pointExpressedInBody->
                 findStationLocationInAnotherFrame(state, point, *_appliedToBody);
         }
@@ -348,7 +410,6 @@ void ExternalForce::computeForce(const SimTK::State& state,
     }
 
     if (_appliesTorque) {
-        Vec3 torque = getTorqueAtTime(time);
         torque = _forceExpressedInBody->expressVectorInGround(state, torque);
         applyTorque(state, *_appliedToBody, torque, bodyForces);
     }
@@ -359,46 +420,22 @@ void ExternalForce::computeForce(const SimTK::State& state,
  */
 Vec3 ExternalForce::getForceAtTime(double aTime) const  
 {
-    SimTK::Vector timeAsVector(1, aTime);
-    const Function* forceX=NULL;
-    const Function* forceY=NULL;
-    const Function* forceZ=NULL;
-    if (_forceFunctions.size()==3){
-        forceX=_forceFunctions[0];  forceY=_forceFunctions[1];  forceZ=_forceFunctions[2];
-    }
-    Vec3 force(forceX?forceX->calcValue(timeAsVector):0.0, 
-        forceY?forceY->calcValue(timeAsVector):0.0, 
-        forceZ?forceZ->calcValue(timeAsVector):0.0);
+    Vec3 force, point, torque;
+    calcDataAtTime(aTime, force, point, torque);
     return force;
 }
 
 Vec3 ExternalForce::getPointAtTime(double aTime) const
 {
-    SimTK::Vector timeAsVector(1, aTime);
-    const Function* pointX=NULL;
-    const Function* pointY=NULL;
-    const Function* pointZ=NULL;
-    if (_pointFunctions.size()==3){
-        pointX=_pointFunctions[0];  pointY=_pointFunctions[1];  pointZ=_pointFunctions[2];
-    }
-    Vec3 point(pointX?pointX->calcValue(timeAsVector):0.0, 
-        pointY?pointY->calcValue(timeAsVector):0.0, 
-        pointZ?pointZ->calcValue(timeAsVector):0.0);
+    Vec3 force, point, torque;
+    calcDataAtTime(aTime, force, point, torque);
     return point;
 }
 
 Vec3 ExternalForce::getTorqueAtTime(double aTime) const
 {
-    SimTK::Vector timeAsVector(1, aTime);
-    const Function* torqueX=NULL;
-    const Function* torqueY=NULL;
-    const Function* torqueZ=NULL;
-    if (_torqueFunctions.size()==3){
-        torqueX=_torqueFunctions[0];    torqueY=_torqueFunctions[1];    torqueZ=_torqueFunctions[2];
-    }
-    Vec3 torque(torqueX?torqueX->calcValue(timeAsVector):0.0, 
-        torqueY?torqueY->calcValue(timeAsVector):0.0, 
-        torqueZ?torqueZ->calcValue(timeAsVector):0.0);
+    Vec3 force, point, torque;
+    calcDataAtTime(aTime, force, point, torque);
     return torque;
 }
 
@@ -439,14 +476,15 @@ OpenSim::Array<double> ExternalForce::getRecordValues(const SimTK::State& state)
     OpenSim::Array<double>  values(SimTK::NaN);
     double time = state.getTime();
 
+    Vec3 force, point, torque;
+    calcDataAtTime(time, force, point, torque);
+
     if (_appliesForce) {
-        Vec3 force = getForceAtTime(time);
         force = _forceExpressedInBody->expressVectorInGround(state, force);
         for(int i=0; i<3; ++i)
             values.append(force[i]);
     
         if (_specifiesPoint) {
-            Vec3 point = getPointAtTime(time);
             point = _pointExpressedInBody->
                 findStationLocationInAnotherFrame(state, point, *_appliedToBody);
             for(int i=0; i<3; ++i)
@@ -454,7 +492,6 @@ OpenSim::Array<double> ExternalForce::getRecordValues(const SimTK::State& state)
         }
     }
     if (_appliesTorque){
-        Vec3 torque = getTorqueAtTime(time);
         torque = _forceExpressedInBody->expressVectorInGround(state, torque);
         for(int i=0; i<3; ++i)
             values.append(torque[i]);
@@ -24,12 +24,14 @@
  * -------------------------------------------------------------------------- */
 // INCLUDE
 #include "Force.h"
+#include <memory>
 
 namespace OpenSim {
 
 class Model;
 class Storage;
 class Function;
+class PiecewiseCubicTable;
 
 /**
  * An ExternalForce is a Force class specialized at applying an external force 
@@ -230,6 +232,14 @@ private:
     void setNull();
     void constructProperties();
 
+    /** The functions for the force, point and torque (in that order) that
+     * this force uses, for compiling them into a PiecewiseCubicTable. */
+    std::vector<const Function*> getTableFunctions() const;
+    /** Evaluate the force, point and torque (where applicable) at the given
+     * time. */
+    void calcDataAtTime(double time, SimTK::Vec3& force, SimTK::Vec3& point,
+            SimTK::Vec3& torque) const;
+
 
 //==============================================================================
 // DATA
@@ -259,6 +269,14 @@ private:
     ArrayPtrs<Function> _torqueFunctions;
     ArrayPtrs<Function> _pointFunctions;
 
+    /** The force data functions compiled into a table, which is evaluated in
+        place of the functions within the time range of the data. An
+        ExternalLoads replaces this with a table shared by all the forces with
+        the same data source; _tableFirstColumn is the column of the table
+        that contains this force's first value. */
+    mutable std::shared_ptr<const PiecewiseCubicTable> _table;
+    mutable int _tableFirstColumn{0};
+
     friend class ExternalLoads;
 //==============================================================================
 };  // END of class ExternalForce
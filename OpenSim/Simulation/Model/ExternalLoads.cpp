@@ -30,6 +30,9 @@
 #include "BodySet.h"
 #include <OpenSim/Simulation/Model/PrescribedForce.h>
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/PiecewiseCubicTable.h>
+
+#include <map>
 
 using namespace std;
 using namespace OpenSim;
@@ -199,6 +202,43 @@ void ExternalLoads::extendConnectToModel(Model& aModel)
     }
 }
 
+void ExternalLoads::extendAddToSystem(SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+
+    // Each ExternalForce compiled its own table when it was connected to the
+    // model; replace these with one table per data source. Forces without a
+    // table (e.g., with a single time) keep evaluating their functions.
+    std::map<const Storage*, std::vector<const ExternalForce*>> forcesBySource;
+    for (int i = 0; i < getSize(); ++i) {
+        const ExternalForce& force = get(i);
+        if (force._table && force._dataSource)
+            forcesBySource[force._dataSource].push_back(&force);
+    }
+    for (const auto& entry : forcesBySource) {
+        const auto& forces = entry.second;
+        if (forces.size() < 2) continue;
+
+        std::vector<const Function*> functions;
+        std::vector<int> firstColumns;
+        for (const auto* force : forces) {
+            firstColumns.push_back((int)functions.size());
+            const auto forceFunctions = force->getTableFunctions();
+            functions.insert(functions.end(), forceFunctions.begin(),
+                    forceFunctions.end());
+        }
+        Array<double> time;
+        entry.first->getTimeColumn(time);
+        const auto table = std::make_shared<const PiecewiseCubicTable>(
+                std::vector<double>(&time[0], &time[0] + time.getSize()),
+                functions);
+        for (int i = 0; i < (int)forces.size(); ++i) {
+            forces[i]->_table = table;
+            forces[i]->_tableFirstColumn = firstColumns[i];
+        }
+    }
+}
+
 //-----------------------------------------------------------------------------
 // RE-EXPRESS POINT DATA 
 //-----------------------------------------------------------------------------
@@ -107,6 +107,10 @@ public:
     // Connect all ExternalForces inside this ExternalLoads collection to
     // their Model. Overrides ModelComponentSet method.
     void extendConnectToModel(Model& aModel) override;
+    // Compile the data of all ExternalForces with the same data source into
+    // a single table, from which all their forces, points and torques are
+    // evaluated.
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
 
     const std::string& getDataFileName() const { return _dataFileName;};
     void setDataFileName(const std::string& aNewFile) { _dataFileName = aNewFile; };
@@ -91,6 +91,7 @@ void Force::extendAddToSystem(SimTK::MultibodySystem& system) const
 
     ForceAdapter* adapter = new ForceAdapter(*this);
     SimTK::Force::Custom force(_model->updForceSubsystem(), adapter);
+    _adapter.reset(adapter);
 
      // Beyond the const Component get the index so we can access the SimTK::Force later
     Force* mutableThis = const_cast<Force *>(this);
@@ -28,6 +28,7 @@
 
 namespace OpenSim {
 
+class ForceAdapter;
 class PhysicalFrame;
 class Coordinate;
 
@@ -228,7 +229,12 @@ private:
     void setNull();
     void constructProperties();
 
+    // The adapter that computes this force, if the force uses the default
+    // extendAddToSystem().
+    mutable SimTK::ReferencePtr<ForceAdapter> _adapter;
+
     friend class ForceAdapter;
+    friend class ParallelForceAdapter;
 
 //=============================================================================
 };  // END of class Force
@@ -46,6 +46,8 @@ void ForceAdapter::calcForce(const SimTK::State& state,
     SimTK::Vector_<SimTK::SpatialVec>& bodyForces,SimTK::Vector_<SimTK::Vec3>& particleForces,
     SimTK::Vector& mobilityForces) const
 {
+    if (!_computeForce) return;
+    OPENSIM_INSTRUMENT_SCOPE(*_force, ComputeForce);
     _force->computeForce(state, bodyForces, mobilityForces);
 }
 
@@ -46,6 +46,7 @@ class OSIMSIMULATION_API ForceAdapter : public SimTK::Force::Custom::Implementat
 //=============================================================================
 private:
     const Force* _force;
+    bool _computeForce = true;
 
 //=============================================================================
 // METHODS
@@ -65,6 +66,10 @@ public:
     // SIMBODY PARALLELISM FLAG 
     bool shouldBeParallelized() const;
 
+    /** If false, calcForce() does nothing, because the force is computed by
+    a ParallelForceAdapter. */
+    void setComputeForce(bool computeForce) { _computeForce = computeForce; }
+
     // No need to override realize() methods; we don't provide that service
     // to OpenSim Force elements.
 };
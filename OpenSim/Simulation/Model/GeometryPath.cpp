@@ -913,6 +913,8 @@ void GeometryPath::computePath(const SimTK::State& s) const
         return;
     }
 
+    OPENSIM_INSTRUMENT_SCOPE(*this, ComputePath);
+
     // Clear the current path.
     _currentPathPtrsCache.setSize(0);
 
@@ -955,6 +957,8 @@ void GeometryPath::computeLengtheningSpeed(const SimTK::State& s) const
         return;
     }
 
+    OPENSIM_INSTRUMENT_SCOPE(*this, ComputeLengtheningSpeed);
+
     const Array<AbstractPathPoint*>& currentPath = getCurrentPath(s);
 
     double speed = 0.0;
@@ -979,6 +983,7 @@ applyWrapObjects(const SimTK::State& s, Array<AbstractPathPoint*>& path) const
 
     WrapResult best_wrap;
     Array<int> result, order;
+    std::vector<char> mayWrap;
 
     result.setSize(wrapSetSize);
     order.setSize(wrapSetSize);
@@ -1069,7 +1074,9 @@ applyWrapObjects(const SimTK::State& s, Array<AbstractPathPoint*>& path) const
                 // represent the used-defined range of points to consider for 
                 // wrapping over this wrap object. Check each path segment in 
                 // this range, choosing the best wrap as the one that changes 
-                // the path segment length the least:
+                // the path segment length the least. The segments that cannot
+                // wrap over the object are found for all segments at once:
+                wo->findPathSegmentsToWrap(s, path, start, end, mayWrap);
                 for (int pt1 = start; pt1 < end; pt1++)
                 {
                     const int pt2 = pt1 + 1;
@@ -1081,6 +1088,11 @@ applyWrapObjects(const SimTK::State& s, Array<AbstractPathPoint*>& path) const
                         || (   path.get(pt1)->getWrapObject() 
                             != path.get(pt2)->getWrapObject()))
                     {
+                        if (!mayWrap[pt1 - start]) {
+                            // wrapPathSegment() would return noWrap.
+                            result[i] = WrapObject::noWrap;
+                            continue;
+                        }
                         WrapResult wr;
                         wr.startPoint = pt1;
                         wr.endPoint   = pt2;
@@ -1098,7 +1110,7 @@ applyWrapObjects(const SimTK::State& s, Array<AbstractPathPoint*>& path) const
                             best_wrap = wr;
                             // Store the best wrap in the pathWrap for possible 
                             // use next time.
-                            ws.setPreviousWrap(wr);
+                            ws.setPreviousWrap(s, wr);
                             break;
                         }  else if (result[i] == WrapObject::wrapped) {
                             // "wrapped" means the path segment was wrapped over
@@ -1112,7 +1124,7 @@ applyWrapObjects(const SimTK::State& s, Array<AbstractPathPoint*>& path) const
                                 best_wrap = wr;
                                 // Store the best wrap in the pathWrap for 
                                 // possible use next time
-                                ws.setPreviousWrap(wr);
+                                ws.setPreviousWrap(s, wr);
                                 min_length_change = path_length_change;
                             } else {
                                 // The wrap was not shorter than the current 
@@ -1130,7 +1142,7 @@ applyWrapObjects(const SimTK::State& s, Array<AbstractPathPoint*>& path) const
                 ws.updWrapPoint2().clearWrapPath(s);
 
                 if (best_wrap.wrap_pts.getSize() == 0) {
-                    ws.resetPreviousWrap();
+                    ws.resetPreviousWrap(s);
                     ws.updWrapPoint2().clearWrapPath(s);
                 } else {
                     // If wrapping did occur, copy wrap info into the PathStruct.
@@ -0,0 +1,142 @@
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  KinematicsSnapshot.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "KinematicsSnapshot.h"
+
+#include "Model.h"
+#include "PhysicalFrame.h"
+
+#include <algorithm>
+
+using namespace OpenSim;
+using SimTK::SpatialVec;
+using SimTK::Transform;
+using SimTK::Vec3;
+
+void KinematicsSnapshot::update(const Model& model, const SimTK::State& s) {
+    _matter = &model.getMatterSubsystem();
+    _state = &s;
+    _gatheredStage = SimTK::Stage::Empty;
+    // Gather what is available now, in case the stage of the state is
+    // invalidated (e.g., by overriding actuators) while the snapshot is used.
+    const SimTK::Stage stage =
+            std::min(s.getSystemStage(), SimTK::Stage::Acceleration);
+    if (stage >= SimTK::Stage::Position) gather(stage);
+}
+
+void KinematicsSnapshot::clear() {
+    _matter = nullptr;
+    _state = nullptr;
+    _gatheredStage = SimTK::Stage::Empty;
+}
+
+const SimTK::State& KinematicsSnapshot::getState() const {
+    OPENSIM_THROW_IF(!isValid(), Exception,
+            "The snapshot has no state; call update() first.");
+    return *_state;
+}
+
+void KinematicsSnapshot::gather(SimTK::Stage stage) const {
+    if (_gatheredStage >= stage) return;
+    const SimTK::State& s = getState();
+    OPENSIM_THROW_IF(s.getSystemStage() < stage, Exception,
+            "Expected the state to be realized to stage {}, but it is only "
+            "realized to stage {}.",
+            stage.getName(), s.getSystemStage().getName());
+
+    const int nb = _matter->getNumBodies();
+    if (_gatheredStage < SimTK::Stage::Position) {
+        _transforms.resize(nb);
+        for (SimTK::MobilizedBodyIndex b(0); b < nb; ++b)
+            _transforms[b] = _matter->getMobilizedBody(b).getBodyTransform(s);
+    }
+    if (stage >= SimTK::Stage::Velocity &&
+            _gatheredStage < SimTK::Stage::Velocity) {
+        _velocities.resize(nb);
+        for (SimTK::MobilizedBodyIndex b(0); b < nb; ++b)
+            _velocities[b] = _matter->getMobilizedBody(b).getBodyVelocity(s);
+    }
+    if (stage >= SimTK::Stage::Acceleration &&
+            _gatheredStage < SimTK::Stage::Acceleration) {
+        _accelerations.resize(nb);
+        for (SimTK::MobilizedBodyIndex b(0); b < nb; ++b) {
+            _accelerations[b] =
+                    _matter->getMobilizedBody(b).getBodyAcceleration(s);
+        }
+    }
+    _gatheredStage = std::min(stage, SimTK::Stage::Acceleration);
+}
+
+Transform KinematicsSnapshot::getTransformInGround(
+        const PhysicalFrame& frame) const {
+    gather(SimTK::Stage::Position);
+    return _transforms[frame.getMobilizedBodyIndex()] *
+           frame.findTransformInBaseFrame();
+}
+
+SpatialVec KinematicsSnapshot::getVelocityInGround(
+        const PhysicalFrame& frame) const {
+    gather(SimTK::Stage::Velocity);
+    return SpatialVec(_velocities[frame.getMobilizedBodyIndex()][0],
+            findStationVelocityInGround(frame, Vec3(0)));
+}
+
+SpatialVec KinematicsSnapshot::getAccelerationInGround(
+        const PhysicalFrame& frame) const {
+    gather(SimTK::Stage::Acceleration);
+    return SpatialVec(_accelerations[frame.getMobilizedBodyIndex()][0],
+            findStationAccelerationInGround(frame, Vec3(0)));
+}
+
+Vec3 KinematicsSnapshot::findStationLocationInGround(
+        const PhysicalFrame& frame, const Vec3& station) const {
+    gather(SimTK::Stage::Position);
+    return _transforms[frame.getMobilizedBodyIndex()] *
+           (frame.findTransformInBaseFrame() * station);
+}
+
+Vec3 KinematicsSnapshot::findStationVelocityInGround(
+        const PhysicalFrame& frame, const Vec3& station) const {
+    gather(SimTK::Stage::Velocity);
+    const SimTK::MobilizedBodyIndex b = frame.getMobilizedBodyIndex();
+    // The station relative to the body origin, expressed in ground.
+    const Vec3 r = _transforms[b].R() *
+                   (frame.findTransformInBaseFrame() * station);
+    const SpatialVec& V_GB = _velocities[b];
+    return V_GB[1] + V_GB[0] % r;
+}
+
+Vec3 KinematicsSnapshot::findStationAccelerationInGround(
+        const PhysicalFrame& frame, const Vec3& station) const {
+    gather(SimTK::Stage::Acceleration);
+    const SimTK::MobilizedBodyIndex b = frame.getMobilizedBodyIndex();
+    const Vec3 r = _transforms[b].R() *
+                   (frame.findTransformInBaseFrame() * station);
+    const Vec3& w = _velocities[b][0];
+    const SpatialVec& A_GB = _accelerations[b];
+    return A_GB[1] + A_GB[0] % r + w % (w % r);
+}
+
+Vec3 KinematicsSnapshot::expressVectorInFrame(
+        const PhysicalFrame& frame, const Vec3& vectorInGround) const {
+    return ~getTransformInGround(frame).R() * vectorInGround;
+}
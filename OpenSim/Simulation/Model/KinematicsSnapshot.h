@@ -0,0 +1,108 @@
+#ifndef OPENSIM_KINEMATICS_SNAPSHOT_H_
+#define OPENSIM_KINEMATICS_SNAPSHOT_H_
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  KinematicsSnapshot.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include "SimTKcommon.h"
+
+#include <vector>
+
+namespace SimTK {
+class SimbodyMatterSubsystem;
+}
+
+namespace OpenSim {
+
+class Model;
+class PhysicalFrame;
+
+/**
+ * The transforms, spatial velocities and spatial accelerations in ground of
+ * all the mobilized bodies of a model at one state, gathered once so that
+ * several readers (e.g., the analyses of an AnalysisSet) do not each query
+ * the system for them.
+ *
+ * The kinematics of all bodies, up to the stage to which the state is
+ * realized, are gathered when the snapshot is updated; the kinematics of a
+ * later stage are gathered the first time they are asked for, so the state
+ * must be realized to that stage by then. The results agree with those of
+ * the corresponding methods of PhysicalFrame to within roundoff. A snapshot
+ * is not thread-safe; use one per thread.
+ */
+class OSIMSIMULATION_API KinematicsSnapshot {
+public:
+    KinematicsSnapshot() = default;
+
+    /** Use the kinematics of `s`, a state of `model`'s system. Both must
+     * outlive the snapshot, or until update() or clear() is called. */
+    void update(const Model& model, const SimTK::State& s);
+    /** Forget the state; isValid() is false until update() is called. */
+    void clear();
+    bool isValid() const { return _state != nullptr; }
+    /** The state from which the kinematics are gathered. */
+    const SimTK::State& getState() const;
+
+    /// @name Kinematics of frames
+    /// These are the kinematics of the origin of the frame, in ground.
+    /// @{
+    SimTK::Transform getTransformInGround(const PhysicalFrame& frame) const;
+    /** The angular (index 0) and linear (index 1) velocity. */
+    SimTK::SpatialVec getVelocityInGround(const PhysicalFrame& frame) const;
+    /** The angular (index 0) and linear (index 1) acceleration. */
+    SimTK::SpatialVec getAccelerationInGround(
+            const PhysicalFrame& frame) const;
+    /// @}
+
+    /// @name Kinematics of stations
+    /// The location, velocity and acceleration in ground of a point fixed in
+    /// a frame, given by its location in the frame.
+    /// @{
+    SimTK::Vec3 findStationLocationInGround(
+            const PhysicalFrame& frame, const SimTK::Vec3& station) const;
+    SimTK::Vec3 findStationVelocityInGround(
+            const PhysicalFrame& frame, const SimTK::Vec3& station) const;
+    SimTK::Vec3 findStationAccelerationInGround(
+            const PhysicalFrame& frame, const SimTK::Vec3& station) const;
+    /// @}
+
+    /** The components in `frame` of a vector expressed in ground. */
+    SimTK::Vec3 expressVectorInFrame(
+            const PhysicalFrame& frame, const SimTK::Vec3& vectorInGround) const;
+
+private:
+    // Gather the kinematics of all bodies up to `stage` if they were not.
+    void gather(SimTK::Stage stage) const;
+
+    const SimTK::SimbodyMatterSubsystem* _matter = nullptr;
+    const SimTK::State* _state = nullptr;
+
+    // Indexed by SimTK::MobilizedBodyIndex.
+    mutable SimTK::Stage _gatheredStage = SimTK::Stage::Empty;
+    mutable std::vector<SimTK::Transform> _transforms;
+    mutable std::vector<SimTK::SpatialVec> _velocities;
+    mutable std::vector<SimTK::SpatialVec> _accelerations;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_KINEMATICS_SNAPSHOT_H_
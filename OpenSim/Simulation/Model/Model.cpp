@@ -38,6 +38,7 @@
 #include "ForceSet.h"
 #include "Ligament.h"
 #include "MarkerSet.h"
+#include "ParallelForceAdapter.h"
 #include "ProbeSet.h"
 #include "SimTKcommon/internal/SystemGuts.h"
 #include <iostream>
@@ -79,7 +80,8 @@ Model::Model() : ModelComponent(),
     _coordinateSet(CoordinateSet()),
     _workingState(),
     _useVisualizer(false),
-    _allControllersEnabled(true)
+    _allControllersEnabled(true),
+    _numForceThreads(1)
 {
     constructProperties();
     setNull();
@@ -96,7 +98,8 @@ Model::Model(const string &aFileName) :
     _coordinateSet(CoordinateSet()),
     _workingState(),
     _useVisualizer(false),
-    _allControllersEnabled(true)
+    _allControllersEnabled(true),
+    _numForceThreads(1)
 {   
     constructProperties();
     setNull();
@@ -318,6 +321,7 @@ void Model::setNull()
 {
     _useVisualizer = false;
     _allControllersEnabled = true;
+    _numForceThreads = 1;
 
     _validationLog="";
 
@@ -590,6 +594,23 @@ void Model::createMultibodySystem()
                 direction, magnitude));
 
     addToSystem(*_system);
+
+    if (_numForceThreads > 1) {
+        // The forces that are computed by this adapter do not compute their
+        // force in their own ForceAdapter.
+        auto* adapter = new ParallelForceAdapter(*this, _numForceThreads);
+        SimTK::Force::Custom(*_forceSubsystem, adapter);
+        log_debug("Computing {} forces in {} groups.",
+                adapter->getNumForces(), adapter->getNumGroups());
+    }
+}
+
+void Model::setNumForceThreads(int numThreads)
+{
+    OPENSIM_THROW_IF_FRMOBJ(numThreads < 0, Exception,
+            "Expected the number of force threads to be non-negative, but "
+            "got {}.", numThreads);
+    _numForceThreads = std::max(numThreads, 1);
 }
 
 
@@ -1931,6 +1952,7 @@ void Model::computeControls(const SimTK::State& s, SimTK::Vector &controls) cons
     }
 
     for (const Controller& controller : this->_enabledControllers) {
+        OPENSIM_INSTRUMENT_SCOPE(controller, ComputeControls);
         controller.computeControls(s, controls);
     }
 }
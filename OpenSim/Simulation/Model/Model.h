@@ -333,6 +333,27 @@ public:
     take effect at the next call to initSystem() on this %Model. **/
     bool getUseVisualizer() const {return _useVisualizer;}
 
+    /** Compute the Force%s of this %Model on multiple threads. This applies
+    to the forces that compute their force in Force::computeForce() (e.g.,
+    muscles and other actuators, springs, and bushings), which are divided
+    into groups of consecutive forces that are computed concurrently, each
+    into its own buffers; the buffers are then added in a fixed order, so that
+    the results are reproducible. This pays off for models with many
+    expensive forces, such as hundreds of muscles. The caches that forces
+    share and compute lazily are filled before the groups are computed: the
+    controls (see getControls()), which calls the controllers, and the
+    kinematics of the frames and of the points that are not part of a force.
+    A custom force must not lazily compute any other cache that a force in
+    another group uses (e.g., a cache variable of another component). The
+    buffers are kept in the cache of each State, so the model can still be
+    realized in several States at once; the threads are used by one State
+    at a time. Use 0 or 1 (the default) to compute all forces serially.
+    This takes effect at the next call to initSystem(). **/
+    void setNumForceThreads(int numThreads);
+    /** Return the number of threads on which Force%s are computed. @see
+    setNumForceThreads() **/
+    int getNumForceThreads() const {return _numForceThreads;}
+
     /** Test whether a ModelVisualizer has been created for this Model. Even
     if visualization has been requested there will be no visualizer present
     until initSystem() has been successfully invoked. Use this method prior
@@ -1165,6 +1186,9 @@ private:
     // Global flag used to disable all Controllers.
     bool _allControllersEnabled;
 
+    // The number of threads on which Forces are computed.
+    int _numForceThreads;
+
 
     //                      SIMBODY MULTIBODY SYSTEM
     // We dynamically allocate these because they are not available at
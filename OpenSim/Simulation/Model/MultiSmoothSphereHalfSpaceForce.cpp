@@ -0,0 +1,395 @@
+/* -------------------------------------------------------------------------- *
+ *               OpenSim: MultiSmoothSphereHalfSpaceForce.cpp                 *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2023 Stanford University and the Authors                     *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "MultiSmoothSphereHalfSpaceForce.h"
+
+#include <OpenSim/Simulation/Model/Model.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace OpenSim;
+
+//=============================================================================
+//  MULTI SMOOTH SPHERE HALF SPACE FORCE
+//=============================================================================
+// Uses default (compiler-generated) destructor, copy constructor, copy
+// assignment operator.
+
+MultiSmoothSphereHalfSpaceForce::MultiSmoothSphereHalfSpaceForce() {
+    constructProperties();
+}
+
+MultiSmoothSphereHalfSpaceForce::MultiSmoothSphereHalfSpaceForce(
+        const std::string& name, const ContactHalfSpace& contactHalfSpace) {
+    setName(name);
+    connectSocket_half_space(contactHalfSpace);
+
+    constructProperties();
+}
+
+void MultiSmoothSphereHalfSpaceForce::constructProperties() {
+    constructProperty_contact_spheres();
+    constructProperty_stiffness(1.0);
+    constructProperty_dissipation(0.0);
+    constructProperty_static_friction(0.0);
+    constructProperty_dynamic_friction(0.0);
+    constructProperty_viscous_friction(0.0);
+    constructProperty_transition_velocity(0.01);
+    constructProperty_constant_contact_force(1e-5);
+    constructProperty_hertz_smoothing(300.0);
+    constructProperty_hunt_crossley_smoothing(50.0);
+    constructProperty_force_visualization_radius(0.01);
+    constructProperty_force_visualization_scale_factor();
+}
+
+void MultiSmoothSphereHalfSpaceForce::addContactSphere(
+        const ContactSphere& contactSphere) {
+    append_contact_spheres(contactSphere.getAbsolutePathString());
+}
+
+void MultiSmoothSphereHalfSpaceForce::extendConnectToModel(Model& model) {
+    Super::extendConnectToModel(model);
+
+    m_spheres.clear();
+    for (int i = 0; i < getNumContactSpheres(); ++i) {
+        const std::string& path = get_contact_spheres(i);
+        if (model.hasComponent<ContactSphere>(path)) {
+            m_spheres.emplace_back(&model.getComponent<ContactSphere>(path));
+        } else {
+            m_spheres.emplace_back(&model.getComponent<ContactSphere>(
+                    "./contactgeometryset/" + path));
+        }
+    }
+}
+
+void MultiSmoothSphereHalfSpaceForce::extendAddToSystem(
+        SimTK::MultibodySystem& system) const {
+    Super::extendAddToSystem(system);
+
+    const int numSpheres = getNumContactSpheres();
+    m_sphereBodies.resize(numSpheres);
+    m_sphereLocationInBodyX.resize(numSpheres);
+    m_sphereLocationInBodyY.resize(numSpheres);
+    m_sphereLocationInBodyZ.resize(numSpheres);
+    m_sphereRadii.resize(numSpheres);
+    for (int i = 0; i < numSpheres; ++i) {
+        const ContactSphere& sphere = *m_spheres[i];
+        const SimTK::Vec3 location =
+                sphere.getFrame().findTransformInBaseFrame() *
+                sphere.get_location();
+        m_sphereBodies[i] = sphere.getFrame().getMobilizedBodyIndex();
+        m_sphereLocationInBodyX[i] = location[0];
+        m_sphereLocationInBodyY[i] = location[1];
+        m_sphereLocationInBodyZ[i] = location[2];
+        m_sphereRadii[i] = sphere.getRadius();
+    }
+
+    const auto& halfSpace = getConnectee<ContactHalfSpace>("half_space");
+    m_halfSpaceBody = halfSpace.getFrame().getMobilizedBodyIndex();
+    m_halfSpaceFrameInBody = halfSpace.getFrame().findTransformInBaseFrame() *
+                             halfSpace.getTransform();
+
+    m_workspaceCV = addCacheVariable("workspace", Workspace(),
+            SimTK::Stage::Topology);
+}
+
+void MultiSmoothSphereHalfSpaceForce::extendRealizeInstance(
+        const SimTK::State& state) const {
+    Super::extendRealizeInstance(state);
+    if (!getProperty_force_visualization_scale_factor().empty()) {
+        m_forceVizScaleFactor = get_force_visualization_scale_factor();
+    } else {
+        const Model& model = getModel();
+        const double mass = model.getTotalMass(state);
+        const double weight = mass * model.getGravity().norm();
+        m_forceVizScaleFactor = 1 / weight;
+    }
+}
+
+MultiSmoothSphereHalfSpaceForce::Workspace&
+MultiSmoothSphereHalfSpaceForce::updWorkspace(const SimTK::State& state) const {
+    return updCacheVariableValue(state, m_workspaceCV);
+}
+
+void MultiSmoothSphereHalfSpaceForce::calcContactForces(
+        const SimTK::State& state, std::vector<SimTK::Vec3>& forces,
+        std::vector<SimTK::Vec3>& points) const {
+    Workspace& workspace = updWorkspace(state);
+    calcContactForces(state, workspace);
+    forces = workspace.forces;
+    points = workspace.points;
+}
+
+void MultiSmoothSphereHalfSpaceForce::calcContactForces(
+        const SimTK::State& state, Workspace& workspace) const {
+    using SimTK::Vec3;
+    const int n = getNumContactSpheres();
+    std::vector<Vec3>& forces = workspace.forces;
+    std::vector<Vec3>& points = workspace.points;
+    forces.resize(n);
+    points.resize(n);
+    if (n == 0) return;
+
+    const auto& matter = getModel().getMatterSubsystem();
+
+    // The half space, whose outward normal is the -x axis of its frame.
+    const auto& halfSpaceBody = matter.getMobilizedBody(m_halfSpaceBody);
+    const SimTK::Transform X_GP =
+            halfSpaceBody.getBodyTransform(state) * m_halfSpaceFrameInBody;
+    const Vec3 normal = X_GP.R() * Vec3(-1, 0, 0);
+    const Vec3& halfSpaceOrigin = X_GP.p();
+    const Vec3& halfSpaceBodyOrigin = halfSpaceBody.getBodyOriginLocation(state);
+    const SimTK::SpatialVec& halfSpaceBodyVelocity =
+            halfSpaceBody.getBodyVelocity(state);
+    const Vec3& wH = halfSpaceBodyVelocity[0];
+    const Vec3& vH = halfSpaceBodyVelocity[1];
+
+    // Gather, for each sphere, the location of its center and the origin,
+    // angular velocity, and linear velocity of its body, all in ground.
+    enum { CX, CY, CZ, OX, OY, OZ, WX, WY, WZ, VX, VY, VZ,
+           FX, FY, FZ, PX, PY, PZ, NumArrays };
+    std::vector<double>& work = workspace.columns;
+    work.resize(NumArrays * n);
+    auto column = [&](int k) { return work.data() + k * n; };
+    for (int i = 0; i < n; ++i) {
+        const auto& body = matter.getMobilizedBody(m_sphereBodies[i]);
+        const SimTK::Transform& X_GB = body.getBodyTransform(state);
+        const SimTK::SpatialVec& V_GB = body.getBodyVelocity(state);
+        const Vec3 center = X_GB * Vec3(m_sphereLocationInBodyX[i],
+                m_sphereLocationInBodyY[i], m_sphereLocationInBodyZ[i]);
+        for (int d = 0; d < 3; ++d) {
+            column(CX + d)[i] = center[d];
+            column(OX + d)[i] = X_GB.p()[d];
+            column(WX + d)[i] = V_GB[0][d];
+            column(VX + d)[i] = V_GB[1][d];
+        }
+    }
+
+    // Parameters shared by all spheres.
+    const double stiffness = get_stiffness();
+    const double c = get_dissipation();
+    const double us = get_static_friction();
+    const double ud = get_dynamic_friction();
+    const double uv = get_viscous_friction();
+    const double vt = get_transition_velocity();
+    const double cf = get_constant_contact_force();
+    const double bd = get_hertz_smoothing();
+    const double bv = get_hunt_crossley_smoothing();
+    const double k = 0.5 * std::pow(stiffness, 2.0 / 3.0);
+    const double nx = normal[0], ny = normal[1], nz = normal[2];
+
+    const double* cx = column(CX); const double* cy = column(CY);
+    const double* cz = column(CZ);
+    const double* ox = column(OX); const double* oy = column(OY);
+    const double* oz = column(OZ);
+    const double* wx = column(WX); const double* wy = column(WY);
+    const double* wz = column(WZ);
+    const double* vx = column(VX); const double* vy = column(VY);
+    const double* vz = column(VZ);
+    const double* radii = m_sphereRadii.data();
+    double* fx = column(FX); double* fy = column(FY); double* fz = column(FZ);
+    double* px = column(PX); double* py = column(PY); double* pz = column(PZ);
+
+    // The contact model of SimTK::SmoothSphereHalfSpaceForce, for all
+    // spheres at once.
+    for (int i = 0; i < n; ++i) {
+        const double radius = radii[i];
+        // Indentation of the sphere into the half space.
+        const double indentation = radius -
+                ((cx[i] - halfSpaceOrigin[0]) * nx +
+                 (cy[i] - halfSpaceOrigin[1]) * ny +
+                 (cz[i] - halfSpaceOrigin[2]) * nz);
+        // The contact point is halfway through the indentation.
+        const double a = radius - 0.5 * indentation;
+        const double pxi = cx[i] - a * nx;
+        const double pyi = cy[i] - a * ny;
+        const double pzi = cz[i] - a * nz;
+
+        // Velocity of the contact point on the sphere relative to the
+        // contact point on the half space.
+        const double rx = pxi - ox[i], ry = pyi - oy[i], rz = pzi - oz[i];
+        const double hx = pxi - halfSpaceBodyOrigin[0];
+        const double hy = pyi - halfSpaceBodyOrigin[1];
+        const double hz = pzi - halfSpaceBodyOrigin[2];
+        const double velx = (vx[i] + wy[i] * rz - wz[i] * ry) -
+                            (vH[0] + wH[1] * hz - wH[2] * hy);
+        const double vely = (vy[i] + wz[i] * rx - wx[i] * rz) -
+                            (vH[1] + wH[2] * hx - wH[0] * hz);
+        const double velz = (vz[i] + wx[i] * ry - wy[i] * rx) -
+                            (vH[2] + wH[0] * hy - wH[1] * hx);
+        const double normalVelocity = velx * nx + vely * ny + velz * nz;
+        const double indentationVelocity = -normalVelocity;
+        const double tx = velx - normalVelocity * nx;
+        const double ty = vely - normalVelocity * ny;
+        const double tz = velz - normalVelocity * nz;
+
+        // Smoothed Hertz force.
+        const double fH = (4.0 / 3.0) * k * std::sqrt(radius * k) *
+                std::pow(std::sqrt(indentation * indentation + cf), 1.5);
+        const double fHd = fH * (0.5 + 0.5 * std::tanh(bd * indentation));
+        // Smoothed Hunt-Crossley force.
+        const double fHC = fHd * (1.0 + 1.5 * c * indentationVelocity);
+        const double fHCd = fHC * (0.5 + 0.5 * std::tanh(
+                bv * (indentationVelocity + 2.0 / (3.0 * c))));
+        // Friction force, opposing the slip velocity.
+        const double slipVelocity = std::sqrt(tx * tx + ty * ty + tz * tz + cf);
+        const double vrel = slipVelocity / vt;
+        const double friction = fHCd *
+                (std::min(vrel, 1.0) * (ud + 2 * (us - ud) / (1 + vrel * vrel)) +
+                        uv * slipVelocity);
+        const double frictionPerVelocity = friction / slipVelocity;
+
+        fx[i] = fHCd * nx - frictionPerVelocity * tx;
+        fy[i] = fHCd * ny - frictionPerVelocity * ty;
+        fz[i] = fHCd * nz - frictionPerVelocity * tz;
+        px[i] = pxi;
+        py[i] = pyi;
+        pz[i] = pzi;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        forces[i] = Vec3(fx[i], fy[i], fz[i]);
+        points[i] = Vec3(px[i], py[i], pz[i]);
+    }
+}
+
+void MultiSmoothSphereHalfSpaceForce::computeForce(const SimTK::State& state,
+        SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+        SimTK::Vector& generalizedForces) const {
+    Workspace& workspace = updWorkspace(state);
+    calcContactForces(state, workspace);
+    const std::vector<SimTK::Vec3>& forces = workspace.forces;
+    const std::vector<SimTK::Vec3>& points = workspace.points;
+
+    const auto& matter = getModel().getMatterSubsystem();
+    const SimTK::Vec3& halfSpaceBodyOrigin =
+            matter.getMobilizedBody(m_halfSpaceBody)
+                    .getBodyOriginLocation(state);
+    SimTK::SpatialVec& halfSpaceBodyForce = bodyForces[m_halfSpaceBody];
+    for (int i = 0; i < getNumContactSpheres(); ++i) {
+        const SimTK::Vec3& sphereBodyOrigin =
+                matter.getMobilizedBody(m_sphereBodies[i])
+                        .getBodyOriginLocation(state);
+        bodyForces[m_sphereBodies[i]] += SimTK::SpatialVec(
+                (points[i] - sphereBodyOrigin) % forces[i], forces[i]);
+        halfSpaceBodyForce -= SimTK::SpatialVec(
+                (points[i] - halfSpaceBodyOrigin) % forces[i], forces[i]);
+    }
+}
+
+void MultiSmoothSphereHalfSpaceForce::generateDecorations(bool fixed,
+        const ModelDisplayHints& hints, const SimTK::State& state,
+        SimTK::Array_<SimTK::DecorativeGeometry>& geometry) const {
+    Super::generateDecorations(fixed, hints, state, geometry);
+
+    if (!fixed && (state.getSystemStage() >= SimTK::Stage::Dynamics) &&
+            hints.get_show_forces()) {
+        Workspace& workspace = updWorkspace(state);
+        calcContactForces(state, workspace);
+
+        // One cylinder per sphere, centered on the sphere and aligned with
+        // the force applied to it.
+        const auto& matter = getModel().getMatterSubsystem();
+        for (int i = 0; i < getNumContactSpheres(); ++i) {
+            const auto& body = matter.getMobilizedBody(m_sphereBodies[i]);
+            const SimTK::Vec3 contactSpherePosition =
+                    body.findStationLocationInGround(state,
+                            SimTK::Vec3(m_sphereLocationInBodyX[i],
+                                    m_sphereLocationInBodyY[i],
+                                    m_sphereLocationInBodyZ[i]));
+
+            // Scale the contact force vector and compute the cylinder length.
+            const SimTK::Vec3 scaledContactForce =
+                    m_forceVizScaleFactor * workspace.forces[i];
+            const SimTK::Real length(scaledContactForce.norm());
+
+            // Compute the force visualization transform.
+            const SimTK::Transform forceVizTransform(
+                    SimTK::Rotation(SimTK::UnitVec3(scaledContactForce),
+                            SimTK::YAxis),
+                    contactSpherePosition + scaledContactForce / 2.0);
+
+            // Construct the force decoration and add it to the list of
+            // geometries.
+            SimTK::DecorativeCylinder forceViz(
+                    get_force_visualization_radius(), 0.5 * length);
+            forceViz.setTransform(forceVizTransform);
+            forceViz.setColor(SimTK::Vec3(0.0, 0.6, 0.0));
+            geometry.push_back(forceViz);
+        }
+    }
+}
+
+//=============================================================================
+//  REPORTING
+//=============================================================================
+OpenSim::Array<std::string>
+MultiSmoothSphereHalfSpaceForce::getRecordLabels() const {
+    OpenSim::Array<std::string> labels("");
+
+    for (int i = 0; i < getNumContactSpheres(); ++i) {
+        const std::string prefix = getName() + "." +
+                ComponentPath(get_contact_spheres(i)).getComponentName();
+        labels.append(prefix + ".force.X");
+        labels.append(prefix + ".force.Y");
+        labels.append(prefix + ".force.Z");
+        labels.append(prefix + ".torque.X");
+        labels.append(prefix + ".torque.Y");
+        labels.append(prefix + ".torque.Z");
+    }
+
+    labels.append(getName() + ".HalfSpace" + ".force.X");
+    labels.append(getName() + ".HalfSpace" + ".force.Y");
+    labels.append(getName() + ".HalfSpace" + ".force.Z");
+    labels.append(getName() + ".HalfSpace" + ".torque.X");
+    labels.append(getName() + ".HalfSpace" + ".torque.Y");
+    labels.append(getName() + ".HalfSpace" + ".torque.Z");
+
+    return labels;
+}
+
+OpenSim::Array<double> MultiSmoothSphereHalfSpaceForce::getRecordValues(
+        const SimTK::State& state) const {
+
+    OpenSim::Array<double> values(1);
+
+    Workspace& workspace = updWorkspace(state);
+    calcContactForces(state, workspace);
+    const std::vector<SimTK::Vec3>& forces = workspace.forces;
+    const std::vector<SimTK::Vec3>& points = workspace.points;
+
+    const auto& matter = getModel().getMatterSubsystem();
+    const SimTK::Vec3& halfSpaceBodyOrigin =
+            matter.getMobilizedBody(m_halfSpaceBody)
+                    .getBodyOriginLocation(state);
+    SimTK::Vec3 halfSpaceForce(0);
+    SimTK::Vec3 halfSpaceTorque(0);
+    for (int i = 0; i < getNumContactSpheres(); ++i) {
+        const SimTK::Vec3& sphereBodyOrigin =
+                matter.getMobilizedBody(m_sphereBodies[i])
+                        .getBodyOriginLocation(state);
+        const SimTK::Vec3 torque = (points[i] - sphereBodyOrigin) % forces[i];
+        values.append(3, &forces[i][0]);
+        values.append(3, &torque[0]);
+        halfSpaceForce -= forces[i];
+        halfSpaceTorque -= (points[i] - halfSpaceBodyOrigin) % forces[i];
+    }
+    values.append(3, &halfSpaceForce[0]);
+    values.append(3, &halfSpaceTorque[0]);
+
+    return values;
+}
@@ -0,0 +1,178 @@
+#ifndef OPENSIM_MULTI_SMOOTH_SPHERE_HALF_SPACE_FORCE_H_
+#define OPENSIM_MULTI_SMOOTH_SPHERE_HALF_SPACE_FORCE_H_
+/* -------------------------------------------------------------------------- *
+ *                OpenSim: MultiSmoothSphereHalfSpaceForce.h                  *
+ * -------------------------------------------------------------------------- *
+ * Copyright (c) 2023 Stanford University and the Authors                     *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0          *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "Force.h"
+#include "ContactHalfSpace.h"
+#include "ContactSphere.h"
+
+namespace OpenSim {
+
+/** This force applies the contact force of SmoothSphereHalfSpaceForce
+between each of several ContactSphere%s and a single ContactHalfSpace, with
+the same contact parameters (see SmoothSphereHalfSpaceForce for their
+description) for all spheres. It is equivalent to a SmoothSphereHalfSpaceForce
+for each sphere, but is cheaper to evaluate when there are many spheres, as in
+foot-ground contact models that use 6 to 12 spheres per foot: the model has a
+single force element instead of one per sphere, the position of the half
+space is computed once, and the forces of all spheres are computed in one
+pass over arrays that hold one quantity for all spheres. Use separate
+components for spheres that need different contact parameters.
+
+The spheres are listed by their path in the `contact_spheres` property (see
+addContactSphere()); as for HuntCrossleyForce, a name without a path refers
+to a sphere in the model's ContactGeometrySet. */
+class OSIMSIMULATION_API MultiSmoothSphereHalfSpaceForce : public Force {
+    OpenSim_DECLARE_CONCRETE_OBJECT(MultiSmoothSphereHalfSpaceForce, Force);
+
+public:
+    //=========================================================================
+    // PROPERTIES
+    //=========================================================================
+    OpenSim_DECLARE_LIST_PROPERTY(contact_spheres, std::string,
+            "Paths to the ContactSpheres participating in this contact.");
+    OpenSim_DECLARE_PROPERTY(stiffness, double,
+            "The stiffness constant (i.e., plain strain modulus), "
+            "default is 1 (N/m^2)");
+    OpenSim_DECLARE_PROPERTY(dissipation, double,
+            "The dissipation coefficient, default is 0 (s/m).");
+    OpenSim_DECLARE_PROPERTY(static_friction, double,
+            "The coefficient of static friction, default is 0.");
+    OpenSim_DECLARE_PROPERTY(dynamic_friction, double,
+            "The coefficient of dynamic friction, default is 0.");
+    OpenSim_DECLARE_PROPERTY(viscous_friction, double,
+            "The coefficient of viscous friction, default is 0.");
+    OpenSim_DECLARE_PROPERTY(transition_velocity, double,
+            "The transition velocity, default is 0.01 (m/s).");
+    OpenSim_DECLARE_PROPERTY(constant_contact_force, double,
+            "The constant that enforces non-null derivatives, "
+            "default is 1e-5 (N).");
+    OpenSim_DECLARE_PROPERTY(hertz_smoothing, double,
+            "The parameter that determines the smoothness of the transition "
+            "of the tanh used to smooth the Hertz force. The larger the "
+            "steeper the transition but the worse for optimization, "
+            "default is 300.");
+    OpenSim_DECLARE_PROPERTY(hunt_crossley_smoothing, double,
+            "The parameter that determines the smoothness of the transition "
+            "of the tanh used to smooth the Hunt-Crossley force. The larger "
+            "the steeper the transition but the worse for optimization, "
+            "default is 50.");
+    OpenSim_DECLARE_PROPERTY(force_visualization_radius, double,
+            "The radius of the cylinders that visualize contact "
+            "forces generated by this force component. Default: 0.01 m");
+    OpenSim_DECLARE_OPTIONAL_PROPERTY(force_visualization_scale_factor, double,
+            "(Optional) The scale factor that determines the length of the "
+            "cylinders that visualize contact forces generated by this force "
+            "component. A cylinder will be one meter long when the contact "
+            "force magnitude is equal to this value. If this property is not "
+            "specified, the scale factor is the model's weight.");
+
+    //=========================================================================
+    // SOCKETS
+    //=========================================================================
+    OpenSim_DECLARE_SOCKET(half_space, ContactHalfSpace,
+            "The half-space participating in this contact.");
+
+    //=========================================================================
+    // PUBLIC METHODS
+    //=========================================================================
+    MultiSmoothSphereHalfSpaceForce();
+
+    MultiSmoothSphereHalfSpaceForce(const std::string& name,
+            const ContactHalfSpace& contactHalfSpace);
+
+    /** Add a sphere to the contact, by its absolute path. */
+    void addContactSphere(const ContactSphere& contactSphere);
+    int getNumContactSpheres() const {
+        return getProperty_contact_spheres().size();
+    }
+
+    /** Compute the force applied to each sphere by the half space, expressed
+    in ground, and the point (in ground) at which it is applied. The half
+    space receives the opposite force at the same point. The forces are
+    those of SmoothSphereHalfSpaceForce. The vectors are resized to
+    getNumContactSpheres(). */
+    void calcContactForces(const SimTK::State& state,
+            std::vector<SimTK::Vec3>& forces,
+            std::vector<SimTK::Vec3>& points) const;
+
+    //=========================================================================
+    // REPORTING
+    //=========================================================================
+    /// Obtain names of the quantities (column labels) of the force values to
+    /// be reported. For each sphere, the order is the three forces (XYZ) and
+    /// three torques (XYZ) applied on the sphere's body, as for
+    /// SmoothSphereHalfSpaceForce; these are followed by the three forces
+    /// (XYZ) and three torques (XYZ) applied on the half space by all
+    /// spheres. Forces and torques are expressed in the ground frame.
+    OpenSim::Array<std::string> getRecordLabels() const override;
+    /// Obtain the values to be reported that correspond to the labels. The
+    /// values are expressed in the ground frame.
+    OpenSim::Array<double> getRecordValues(
+            const SimTK::State& state) const override;
+
+protected:
+    void computeForce(const SimTK::State& state,
+            SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+            SimTK::Vector& generalizedForces) const override;
+
+    void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
+    void extendRealizeInstance(const SimTK::State& state) const override;
+    void generateDecorations(bool fixed, const ModelDisplayHints& hints,
+            const SimTK::State& state,
+            SimTK::Array_<SimTK::DecorativeGeometry>& geometry) const override;
+
+private:
+    void constructProperties();
+
+    // Scratch space for computing the forces, held in the State's cache so
+    // that it is allocated once per State rather than on every call.
+    struct Workspace {
+        std::vector<double> columns;
+        std::vector<SimTK::Vec3> forces;
+        std::vector<SimTK::Vec3> points;
+    };
+    Workspace& updWorkspace(const SimTK::State& state) const;
+    void calcContactForces(const SimTK::State& state,
+            Workspace& workspace) const;
+
+    // The spheres in the order of the contact_spheres property.
+    std::vector<SimTK::ReferencePtr<const ContactSphere>> m_spheres;
+
+    // The location of the spheres, with one entry per sphere, set in
+    // extendAddToSystem().
+    mutable std::vector<SimTK::MobilizedBodyIndex> m_sphereBodies;
+    mutable std::vector<double> m_sphereLocationInBodyX;
+    mutable std::vector<double> m_sphereLocationInBodyY;
+    mutable std::vector<double> m_sphereLocationInBodyZ;
+    mutable std::vector<double> m_sphereRadii;
+    // The half space's frame in its body.
+    mutable SimTK::MobilizedBodyIndex m_halfSpaceBody;
+    mutable SimTK::Transform m_halfSpaceFrameInBody;
+
+    mutable CacheVariable<Workspace> m_workspaceCV;
+    mutable double m_forceVizScaleFactor;
+
+//=============================================================================
+}; // END of class MultiSmoothSphereHalfSpaceForce
+//=============================================================================
+//=============================================================================
+
+} // namespace OpenSim
+
+#endif // OPENSIM_MULTI_SMOOTH_SPHERE_HALF_SPACE_FORCE_H_
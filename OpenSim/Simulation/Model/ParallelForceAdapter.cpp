@@ -0,0 +1,184 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  ParallelForceAdapter.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ParallelForceAdapter.h"
+
+#include "Force.h"
+#include "ForceAdapter.h"
+#include "Frame.h"
+#include "Model.h"
+#include "Point.h"
+
+#include <OpenSim/Common/Instrumentation.h>
+#include <algorithm>
+#include <exception>
+
+using namespace OpenSim;
+
+namespace {
+// Whether the component is part of a Force, whose caches only that force
+// uses (e.g., the path points of a muscle).
+bool isPartOfForce(const Component& component) {
+    const Component* owner = &component;
+    while (owner->hasOwner()) {
+        owner = &owner->getOwner();
+        if (dynamic_cast<const Force*>(owner)) return true;
+    }
+    return false;
+}
+} // anonymous namespace
+
+// Computes the enabled forces of each group into the group's buffers.
+class ParallelForceAdapter::GroupTask : public SimTK::ParallelExecutor::Task {
+public:
+    GroupTask(const ParallelForceAdapter& adapter, const SimTK::State& state,
+            Buffers& buffers)
+            : _adapter(adapter), _state(state), _buffers(buffers),
+              _exceptions(adapter.getNumGroups()) {}
+
+    void execute(int group) override {
+        // An exception must not escape a worker thread; it is rethrown by
+        // the calling thread.
+        try {
+            auto& bodyForces = _buffers.bodyForces[group];
+            auto& mobilityForces = _buffers.mobilityForces[group];
+            bodyForces.setToZero();
+            mobilityForces.setToZero();
+            const auto& forces = _adapter._groups[group];
+            for (int i = 0; i < static_cast<int>(forces.size()); ++i) {
+                if (!_buffers.appliesForce[group][i]) continue;
+                OPENSIM_INSTRUMENT_SCOPE(*forces[i], ComputeForce);
+                forces[i]->computeForce(_state, bodyForces, mobilityForces);
+            }
+        } catch (...) {
+            _exceptions[group] = std::current_exception();
+        }
+    }
+
+    void rethrowException() const {
+        for (const auto& exception : _exceptions) {
+            if (exception) std::rethrow_exception(exception);
+        }
+    }
+
+private:
+    const ParallelForceAdapter& _adapter;
+    const SimTK::State& _state;
+    Buffers& _buffers;
+    std::vector<std::exception_ptr> _exceptions;
+};
+
+ParallelForceAdapter::ParallelForceAdapter(const Model& model,
+        int numThreads) : _model(model) {
+    for (const auto& frame : model.getComponentList<Frame>()) {
+        _sharedFrames.push_back(&frame);
+    }
+    for (const auto& point : model.getComponentList<Point>()) {
+        if (!isPartOfForce(point)) _sharedPoints.push_back(&point);
+    }
+
+    std::vector<const Force*> forces;
+    for (const auto& force : model.getComponentList<Force>()) {
+        if (force._adapter.empty()) continue;
+        force._adapter->setComputeForce(false);
+        forces.push_back(&force);
+    }
+
+    const int numForces = static_cast<int>(forces.size());
+    const int numGroups = std::max(1, std::min(numThreads, numForces));
+    _groups.resize(numGroups);
+    for (int g = 0; g < numGroups; ++g) {
+        _groups[g].assign(forces.begin() + g * numForces / numGroups,
+                forces.begin() + (g + 1) * numForces / numGroups);
+    }
+    _executor.reset(new SimTK::ParallelExecutor(numGroups));
+}
+
+void ParallelForceAdapter::realizeTopology(SimTK::State& state) const {
+    Buffers buffers;
+    buffers.bodyForces.resize(getNumGroups());
+    buffers.mobilityForces.resize(getNumGroups());
+    buffers.appliesForce.resize(getNumGroups());
+    for (int g = 0; g < getNumGroups(); ++g) {
+        buffers.appliesForce[g].resize(_groups[g].size());
+    }
+    _buffersIndex = _model.getForceSubsystem().allocateLazyCacheEntry(state,
+            SimTK::Stage::Topology, new SimTK::Value<Buffers>(buffers));
+}
+
+int ParallelForceAdapter::getNumForces() const {
+    int numForces = 0;
+    for (const auto& group : _groups) {
+        numForces += static_cast<int>(group.size());
+    }
+    return numForces;
+}
+
+void ParallelForceAdapter::calcForce(const SimTK::State& state,
+        SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+        SimTK::Vector_<SimTK::Vec3>& particleForces,
+        SimTK::Vector& mobilityForces) const {
+    // The caches that the forces of different groups share are filled here,
+    // so that the worker threads only read them: the controls of the model,
+    // and the kinematics of the frames and of the points that are not part
+    // of a force.
+    _model.getControls(state);
+    for (const Frame* frame : _sharedFrames) {
+        frame->getTransformInGround(state);
+        frame->getVelocityInGround(state);
+    }
+    for (const Point* point : _sharedPoints) {
+        point->getLocationInGround(state);
+        point->getVelocityInGround(state);
+    }
+
+    // Whether a force is disabled is looked up here, rather than on the
+    // worker threads, since it accesses the force subsystem.
+    auto& buffers = SimTK::Value<Buffers>::updDowncast(
+            _model.getForceSubsystem().updCacheEntry(state, _buffersIndex))
+            .upd();
+    const int numGroups = getNumGroups();
+    for (int g = 0; g < numGroups; ++g) {
+        for (int i = 0; i < static_cast<int>(_groups[g].size()); ++i) {
+            buffers.appliesForce[g][i] = _groups[g][i]->appliesForce(state);
+        }
+        buffers.bodyForces[g].resize(bodyForces.size());
+        buffers.mobilityForces[g].resize(mobilityForces.size());
+    }
+
+    GroupTask task(*this, state, buffers);
+    {
+        // If another State is using the threads, compute the groups here.
+        std::unique_lock<std::mutex> lock(_executorMutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            _executor->execute(task, numGroups);
+        } else {
+            for (int g = 0; g < numGroups; ++g) task.execute(g);
+        }
+    }
+    task.rethrowException();
+
+    for (int g = 0; g < numGroups; ++g) {
+        bodyForces += buffers.bodyForces[g];
+        mobilityForces += buffers.mobilityForces[g];
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef OPENSIM_PARALLEL_FORCE_ADAPTER_H_
+#define OPENSIM_PARALLEL_FORCE_ADAPTER_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  ParallelForceAdapter.h                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include "OpenSim/Simulation/osimSimulationDLL.h"
+
+#include <SimTKsimbody.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace OpenSim {
+
+class Force;
+class Frame;
+class Model;
+class Point;
+
+//=============================================================================
+//=============================================================================
+/**
+ * A SimTK::Force that computes the Force%s of a Model that use a
+ * ForceAdapter (i.e., that compute their force in Force::computeForce()) on
+ * multiple threads, in place of their ForceAdapter%s. This is used when
+ * Model::setNumForceThreads() is greater than 1.
+ *
+ * The forces are divided, in the order of the model's component list, into
+ * one group of consecutive forces per thread. Each group is computed
+ * serially into its own body and mobility force buffers, and the buffers are
+ * added to the system's forces in the order of the groups. The result
+ * therefore does not depend on the scheduling of the threads, though it can
+ * differ from serial evaluation by roundoff since the forces are summed in a
+ * different order.
+ *
+ * Caches that forces in different groups compute lazily must be filled
+ * before the groups are computed: the model's controls (see
+ * Model::getControls()) and the kinematics of the model's Frame%s and of its
+ * Point%s that are not part of a force are computed on the calling thread.
+ *
+ * The buffers of the groups are kept in the cache of each State, so that
+ * the model can be realized in several States at once. The threads are used
+ * by one State at a time; the forces of the other States are computed on
+ * their calling threads meanwhile.
+ */
+class OSIMSIMULATION_API ParallelForceAdapter
+        : public SimTK::Force::Custom::Implementation {
+public:
+    ParallelForceAdapter(const Model& model, int numThreads);
+
+    int getNumForces() const;
+    int getNumGroups() const { return static_cast<int>(_groups.size()); }
+
+    // CALC FORCES (Called by Simbody)
+    void calcForce(const SimTK::State& state,
+            SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+            SimTK::Vector_<SimTK::Vec3>& particleForces,
+            SimTK::Vector& mobilityForces) const override;
+
+    // The potential energy is computed by the forces' ForceAdapters.
+    SimTK::Real calcPotentialEnergy(const SimTK::State&) const override {
+        return 0;
+    }
+
+    // Allocate the buffers of the groups in the state's cache.
+    void realizeTopology(SimTK::State& state) const override;
+
+private:
+    class GroupTask;
+    // The buffers of the groups, per State.
+    struct Buffers {
+        std::vector<SimTK::Vector_<SimTK::SpatialVec>> bodyForces;
+        std::vector<SimTK::Vector> mobilityForces;
+        std::vector<std::vector<char>> appliesForce;
+    };
+
+    const Model& _model;
+    std::vector<const Frame*> _sharedFrames;
+    std::vector<const Point*> _sharedPoints;
+    std::vector<std::vector<const Force*>> _groups;
+    std::unique_ptr<SimTK::ParallelExecutor> _executor;
+    // Held while the executor computes the forces of a State.
+    mutable std::mutex _executorMutex;
+    mutable SimTK::CacheEntryIndex _buffersIndex;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_PARALLEL_FORCE_ADAPTER_H_
@@ -23,13 +23,19 @@
 
 #include "SimulationUtilities.h"
 
+#include "Control/Controller.h"
 #include "Manager/Manager.h"
 #include "Model/Model.h"
 
 #include <simbody/internal/Visualizer_InputListener.h>
 
+#include <OpenSim/Common/CommonUtilities.h>
 #include <OpenSim/Common/TableUtilities.h>
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 using namespace OpenSim;
 
 SimTK::State OpenSim::simulate(Model& model,
@@ -437,4 +443,200 @@ TimeSeriesTableVec3 OpenSim::createSyntheticIMUAccelerationSignals(
     accelTableIMU.setColumnLabels(framePaths);
 
     return accelTableIMU;
-}
\ No newline at end of file
+}
+
+namespace {
+    // The values from a member's initial state that are applied to a state of
+    // a copy of the model.
+    struct EnsembleInitialValues {
+        double time = SimTK::NaN;
+        SimTK::Vector stateVariables;
+        std::vector<double> discreteVariables;
+    };
+
+    std::unique_ptr<Model> createEnsembleModel(
+            const Model& model, const Controller* controller) {
+        auto copy = OpenSim::make_unique<Model>(model);
+        copy->setUseVisualizer(false);
+        if (controller) {
+            auto& controllers = copy->updControllerSet();
+            for (int ic = 0; ic < controllers.getSize(); ++ic) {
+                controllers.get(ic).setEnabled(false);
+            }
+            copy->addController(controller->clone());
+        }
+        copy->initSystem();
+        OPENSIM_THROW_IF(
+                copy->getNumStateVariables() != model.getNumStateVariables() ||
+                copy->getDiscreteVariableNames().size() !=
+                        model.getDiscreteVariableNames().size(),
+                Exception,
+                "Expected the controller '{}' to not add state variables or "
+                "discrete variables to the model.",
+                controller ? controller->getName() : "");
+        return copy;
+    }
+
+    void simulateEnsembleMember(Model& model,
+            const EnsembleInitialValues& values,
+            const Array<std::string>& discreteVariableNames,
+            const EnsembleSettings& settings,
+            EnsembleMemberResult& result) {
+        OPENSIM_THROW_IF(values.time > settings.finalTime, Exception,
+                "Expected the initial time ({}) to be less than or equal to "
+                "the final time ({}).",
+                values.time, settings.finalTime);
+        const double start = SimTK::realTime();
+
+        SimTK::State state = model.getWorkingState();
+        state.setTime(values.time);
+        model.setStateVariableValues(state, values.stateVariables);
+        for (int idv = 0; idv < discreteVariableNames.size(); ++idv) {
+            model.setDiscreteVariableValue(state,
+                    ComponentPath(discreteVariableNames[idv]),
+                    values.discreteVariables[idv]);
+        }
+
+        // The trajectory reads the discrete variables through this copy's
+        // components; simulateEnsemble() later rebinds it to the provided
+        // model.
+        result.states.reset(new CompactStatesTrajectory(model));
+
+        Manager manager(model);
+        manager.setIntegratorMethod(settings.integratorMethod);
+        manager.setIntegratorAccuracy(settings.integratorAccuracy);
+        manager.setPerformAnalyses(false);
+        manager.setWriteToStorage(false);
+        manager.initialize(state);
+
+        auto& states = *result.states;
+        states.append(manager.getState());
+        double time = values.time;
+        int numIntervals = 0;
+        while (time < settings.finalTime) {
+            double nextTime = settings.finalTime;
+            if (settings.reportInterval > 0) {
+                ++numIntervals;
+                nextTime = values.time + numIntervals * settings.reportInterval;
+                // Avoid a tiny final interval due to roundoff.
+                if (nextTime > settings.finalTime - 1e-12) {
+                    nextTime = settings.finalTime;
+                }
+            }
+            states.append(manager.integrate(nextTime));
+            time = nextTime;
+        }
+        result.numSteps = manager.getIntegrator().getNumStepsTaken();
+        result.wallTime = SimTK::realTime() - start;
+    }
+}
+
+EnsembleResult OpenSim::simulateEnsemble(const Model& model,
+        const std::vector<EnsembleMember>& members,
+        const EnsembleSettings& settings) {
+    OPENSIM_THROW_IF(!model.hasSystem(), ComponentHasNoSystem, model);
+    OPENSIM_THROW_IF(settings.reportInterval < 0, Exception,
+            "Expected the report interval to be non-negative, but got {}.",
+            settings.reportInterval);
+    const double start = SimTK::realTime();
+
+    const int numMembers = static_cast<int>(members.size());
+    EnsembleResult result;
+    result.members.resize(numMembers);
+
+    // Read the initial states on this thread. The worker threads only use
+    // their own copies of the model (copying the model reads the provided
+    // model, and is serialized below).
+    const auto discreteVariableNames = model.getDiscreteVariableNames();
+    std::vector<EnsembleInitialValues> initialValues(numMembers);
+    for (int im = 0; im < numMembers; ++im) {
+        auto& memberResult = result.members[im];
+        try {
+            const auto& state = members[im].initialState;
+            auto& values = initialValues[im];
+            values.stateVariables = model.getStateVariableValues(state);
+            for (int idv = 0; idv < discreteVariableNames.size(); ++idv) {
+                values.discreteVariables.push_back(
+                        model.getDiscreteVariableValue(state,
+                                ComponentPath(discreteVariableNames[idv])));
+            }
+            values.time = state.getTime();
+        } catch (const std::exception& e) {
+            memberResult.errorMessage = e.what();
+        }
+    }
+
+    int numThreads = settings.numThreads;
+    if (numThreads < 1) {
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    numThreads = std::max(1, std::min(numThreads, numMembers));
+    result.numThreads = numThreads;
+
+    // Each thread keeps a copy of the model for consecutive members that use
+    // the same controller. Copying the model and calling initSystem() are
+    // serialized; only the simulations run concurrently.
+    std::atomic<int> nextMember(0);
+    std::mutex modelMutex;
+    auto work = [&]() {
+        std::unique_ptr<Model> threadModel;
+        const Controller* threadController = nullptr;
+        while (true) {
+            const int im = nextMember++;
+            if (im >= numMembers) break;
+            auto& memberResult = result.members[im];
+            // Reading the initial state failed.
+            if (SimTK::isNaN(initialValues[im].time)) continue;
+            const Controller* controller = members[im].controller.get();
+            try {
+                if (!threadModel || threadController != controller) {
+                    std::lock_guard<std::mutex> lock(modelMutex);
+                    threadModel.reset();
+                    threadModel = createEnsembleModel(model, controller);
+                    threadController = controller;
+                }
+                simulateEnsembleMember(*threadModel, initialValues[im],
+                        discreteVariableNames, settings, memberResult);
+                memberResult.success = true;
+            } catch (const std::exception& e) {
+                memberResult.errorMessage = e.what();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int ithread = 1; ithread < numThreads; ++ithread) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) thread.join();
+
+    // The trajectories must use the provided model, not the copies, which no
+    // longer exist.
+    double simulatedTime = 0;
+    for (int im = 0; im < numMembers; ++im) {
+        auto& memberResult = result.members[im];
+        if (memberResult.states) {
+            memberResult.states->setModel(model);
+        } else {
+            memberResult.states.reset(new CompactStatesTrajectory(model));
+        }
+        if (memberResult.success) {
+            ++result.numSucceeded;
+            simulatedTime += settings.finalTime - initialValues[im].time;
+        } else {
+            ++result.numFailed;
+            log_warn("Ensemble member {} failed: {}", im,
+                    memberResult.errorMessage);
+        }
+    }
+    result.wallTime = SimTK::realTime() - start;
+    if (result.wallTime > 0) {
+        result.membersPerSecond = numMembers / result.wallTime;
+        result.simulatedTimePerSecond = simulatedTime / result.wallTime;
+    }
+    log_info("Simulated {} ensemble members ({} failed) on {} threads in "
+             "{:.3f} s ({:.1f} members/s).",
+            numMembers, result.numFailed, numThreads, result.wallTime,
+            result.membersPerSecond);
+    return result;
+}
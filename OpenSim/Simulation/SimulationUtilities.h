@@ -23,6 +23,7 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 
+#include "CompactStatesTrajectory.h"
 #include "StatesTrajectory.h"
 #include "osimSimulationDLL.h"
 #include <regex>
@@ -31,10 +32,13 @@
 
 #include <OpenSim/Common/Reporter.h>
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Simulation/Manager/Manager.h>
 #include <OpenSim/Simulation/Model/Model.h>
 
 namespace OpenSim {
 
+class Controller;
+
 /** Simulate a model from an initial state and return the final state.
     If the model's useVisualizer flag is true, the user is repeatedly prompted
     to either begin simulating or quit. The provided state is not updated but
@@ -378,6 +382,110 @@ OSIMSIMULATION_API TimeSeriesTableVec3 createSyntheticIMUAccelerationSignals(
         const TimeSeriesTable& statesTable, const TimeSeriesTable& controlsTable,
         const std::vector<std::string>& framePaths);
 
+#ifndef SWIG
+/// @name Ensemble simulation
+/// Run many forward simulations of the same model (e.g., a Monte Carlo study
+/// of perturbed initial states or controls) concurrently; see
+/// simulateEnsemble().
+/// @{
+
+/// One simulation of an ensemble.
+/// @ingroup simulationutil
+struct EnsembleMember {
+    /// The initial state of the simulation. This state must be for the model
+    /// passed to simulateEnsemble(); only its time, state variables and
+    /// discrete variables are used.
+    SimTK::State initialState;
+    /// (Optional) If provided, a copy of this controller (e.g., a
+    /// PrescribedController or ControlSetController) is added to this
+    /// member's copy of the model, and the model's other controllers are
+    /// disabled. The controller must not add state variables or discrete
+    /// variables. Members may share the same controller.
+    std::shared_ptr<const Controller> controller;
+};
+
+/// Settings for simulateEnsemble().
+/// @ingroup simulationutil
+struct EnsembleSettings {
+    /// The time at which all simulations end.
+    double finalTime = 1.0;
+    /// The states are recorded at the initial time, at this interval, and at
+    /// the final time. Use 0 to record only the initial and final states.
+    double reportInterval = 0;
+    /// The number of threads; use -1 for the number of hardware threads.
+    /// No more threads than members are used.
+    int numThreads = -1;
+    Manager::IntegratorMethod integratorMethod =
+            Manager::IntegratorMethod::RungeKuttaMerson;
+    double integratorAccuracy = 1e-3;
+};
+
+/// The outcome of one simulation of an ensemble.
+/// @ingroup simulationutil
+struct EnsembleMemberResult {
+    /// False if the simulation threw an exception.
+    bool success = false;
+    /// The message of the exception, if the simulation failed.
+    std::string errorMessage;
+    /// The recorded states, for the model passed to simulateEnsemble(). If
+    /// the simulation failed, this contains the states recorded before the
+    /// failure.
+    std::unique_ptr<CompactStatesTrajectory> states;
+    /// The number of steps taken by the integrator.
+    int numSteps = 0;
+    /// The wall-clock time, in seconds, spent on this simulation (excluding
+    /// the creation of model copies).
+    double wallTime = 0;
+};
+
+/// The outcome of simulateEnsemble().
+/// @ingroup simulationutil
+struct EnsembleResult {
+    /// One entry per member, in the order in which the members were given.
+    std::vector<EnsembleMemberResult> members;
+    int numThreads = 0;
+    int numSucceeded = 0;
+    int numFailed = 0;
+    /// The wall-clock time, in seconds, for the entire ensemble.
+    double wallTime = 0;
+    /// The number of members simulated per second of wall-clock time.
+    double membersPerSecond = 0;
+    /// The total simulated time of all successful members divided by
+    /// wallTime.
+    double simulatedTimePerSecond = 0;
+};
+
+/// Simulate each member of an ensemble from its initial state to
+/// `settings.finalTime`. The members are distributed over a pool of threads;
+/// each thread simulates its members with its own copy of the model and its
+/// own Manager, so the provided model is not modified, and initSystem() must
+/// have been called on it. Analyses are not performed and the Manager's
+/// storage is not written.
+///
+/// An exception thrown by one member is caught, logged, and recorded in that
+/// member's result; the other members are not affected.
+///
+/// @code{.cpp}
+/// std::vector<EnsembleMember> members(100);
+/// for (auto& member : members) {
+///     member.initialState = model.getWorkingState();
+///     coord.setValue(member.initialState, SimTK::Random::Gaussian().getValue());
+/// }
+/// EnsembleSettings settings;
+/// settings.finalTime = 2.0;
+/// settings.reportInterval = 0.01;
+/// EnsembleResult result = simulateEnsemble(model, members, settings);
+/// for (const auto& member : result.members) {
+///     if (member.success) { /* use *member.states */ }
+/// }
+/// @endcode
+/// @ingroup simulationutil
+OSIMSIMULATION_API EnsembleResult simulateEnsemble(const Model& model,
+        const std::vector<EnsembleMember>& members,
+        const EnsembleSettings& settings = EnsembleSettings());
+/// @}
+#endif // SWIG
+
 } // end of namespace OpenSim
 
 #endif // OPENSIM_SIMULATION_UTILITIES_H_
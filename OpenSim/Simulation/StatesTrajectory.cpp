@@ -171,24 +171,11 @@ StatesTrajectory StatesTrajectory::createFromStatesStorage(
             allowMissingColumns, allowExtraColumns, assemble);
 }
 
-StatesTrajectory StatesTrajectory::createFromStatesTable(
+std::map<int, int> StatesTrajectory::mapStatesTableColumns(
         const Model& model,
         const TimeSeriesTable& table,
         bool allowMissingColumns,
-        bool allowExtraColumns,
-        bool assemble) {
-
-    // Assemble the required objects.
-    // ==============================
-
-    // This is what we'll return.
-    StatesTrajectory states;
-
-    // Make a copy of the model so that we can get a corresponding state.
-    Model localModel(model);
-
-    // We'll keep editing this state as we loop through time.
-    auto state = localModel.initSystem();
+        bool allowExtraColumns) {
 
     // The labels of the columns in the storage file.
     const auto& tableLabels = table.getColumnLabels();
@@ -207,7 +194,7 @@ StatesTrajectory StatesTrajectory::createFromStatesTable(
 
     // Check if states are missing from the Storage.
     // ---------------------------------------------
-    const auto& modelStateNames = localModel.getStateVariableNames();
+    const auto& modelStateNames = model.getStateVariableNames();
     std::vector<std::string> missingColumnNames;
     // Also, assemble the indices of the states that we will actually set in the
     // trajectory.
@@ -224,7 +211,7 @@ StatesTrajectory StatesTrajectory::createFromStatesTable(
     }
     OPENSIM_THROW_IF(!allowMissingColumns && !missingColumnNames.empty(),
             MissingColumns,
-            localModel.getName(), missingColumnNames);
+            model.getName(), missingColumnNames);
 
     // Check if the Storage has columns that are not states in the Model.
     // ------------------------------------------------------------------
@@ -239,10 +226,35 @@ StatesTrajectory StatesTrajectory::createFromStatesTable(
                     extraColumnNames.push_back(tableLabels[ic]);
                 }
             }
-            OPENSIM_THROW(ExtraColumns, localModel.getName(),
+            OPENSIM_THROW(ExtraColumns, model.getName(),
                     extraColumnNames);
         }
     }
+    return statesToFillUp;
+}
+
+StatesTrajectory StatesTrajectory::createFromStatesTable(
+        const Model& model,
+        const TimeSeriesTable& table,
+        bool allowMissingColumns,
+        bool allowExtraColumns,
+        bool assemble) {
+
+    // Assemble the required objects.
+    // ==============================
+
+    // This is what we'll return.
+    StatesTrajectory states;
+
+    // Make a copy of the model so that we can get a corresponding state.
+    Model localModel(model);
+
+    // We'll keep editing this state as we loop through time.
+    auto state = localModel.initSystem();
+
+    const auto statesToFillUp = mapStatesTableColumns(localModel, table,
+            allowMissingColumns, allowExtraColumns);
+    const int numStateVariables = localModel.getStateVariableNames().getSize();
 
     // Fill up trajectory.
     // ===================
@@ -252,7 +264,7 @@ StatesTrajectory StatesTrajectory::createFromStatesTable(
 
     // Working memory for state. Initialize so that missing columns end up as
     // NaN.
-    SimTK::Vector statesValues(modelStateNames.getSize(), SimTK::NaN);
+    SimTK::Vector statesValues(numStateVariables, SimTK::NaN);
 
     // Initialize so that missing columns end up as NaN.
     state.updY().setToNaN();
@@ -23,6 +23,7 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 
+#include <map>
 #include <vector>
 
 #include <OpenSim/Common/Exception.h>
@@ -293,6 +294,16 @@ private:
 
     std::vector<SimTK::State> m_states;
 
+    friend class CompactStatesTrajectory;
+
+    /** Map the indices of the columns of a states table to the indices of
+     * the corresponding state variables in model.getStateVariableNames(),
+     * after checking the table as described in createFromStatesTable(). */
+    static std::map<int, int> mapStatesTableColumns(const Model& model,
+            const TimeSeriesTable& table,
+            bool allowMissingColumns,
+            bool allowExtraColumns);
+
 public:
 
     /** Thrown when trying to append a state that is not consistent with the
@@ -23,17 +23,43 @@
 
 #include "StatesTrajectoryReporter.h"
 
+#include <OpenSim/Simulation/Model/Model.h>
+
 using namespace OpenSim;
 
+StatesTrajectoryReporter::StatesTrajectoryReporter() {
+    constructProperties();
+}
+
+void StatesTrajectoryReporter::constructProperties() {
+    constructProperty_compact(false);
+}
 
 void StatesTrajectoryReporter::clear() {
     m_states.clear();
+    if (m_compactStates) m_compactStates->clear();
 }
 
 const StatesTrajectory& StatesTrajectoryReporter::getStates() const {
+    if (m_compactStates) {
+        // Expand the states reported since the last call.
+        for (size_t i = m_states.getSize(); i < m_compactStates->getSize();
+                ++i) {
+            m_states.append((*m_compactStates)[i]);
+        }
+    }
     return m_states;
 }
 
+const CompactStatesTrajectory&
+StatesTrajectoryReporter::getCompactStates() const {
+    OPENSIM_THROW_IF_FRMOBJ(!get_compact(), Exception,
+            "The 'compact' property is false; use getStates().");
+    OPENSIM_THROW_IF_FRMOBJ(!m_compactStates, Exception,
+            "No states have been reported.");
+    return *m_compactStates;
+}
+
 /*
 TODO we have to discuss if the trajectory should be cleared.
 void StatesTrajectoryReporter::extendRealizeInstance(const SimTK::State& state) const {
@@ -43,5 +69,16 @@ void StatesTrajectoryReporter::extendRealizeInstance(const SimTK::State& state)
 */
 
 void StatesTrajectoryReporter::implementReport(const SimTK::State& state) const {
-    m_states.append(state);
+    if (get_compact()) {
+        if (!m_compactStates) {
+            const auto* model = dynamic_cast<const Model*>(&getRoot());
+            OPENSIM_THROW_IF_FRMOBJ(!model, Exception,
+                    "Storing compact states requires this reporter to be "
+                    "part of a Model.");
+            m_compactStates.reset(new CompactStatesTrajectory(*model));
+        }
+        m_compactStates->append(state);
+    } else {
+        m_states.append(state);
+    }
 }
@@ -23,7 +23,7 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 
-#include "StatesTrajectory.h"
+#include "CompactStatesTrajectory.h"
 #include <OpenSim/Common/Reporter.h>
 
 #include "osimSimulationDLL.h"
@@ -35,14 +35,32 @@ namespace OpenSim {
  * This class was introduced in v4.0 and is intended to replace the
  * StatesReporter analysis.
  *
+ * For long simulations, set the `compact` property to true to store the
+ * states in a CompactStatesTrajectory instead, which uses much less memory;
+ * access them with getCompactStates(). getStates() still works, but
+ * expands the compact states into full SimTK::State%s, so it gives up the
+ * memory savings.
+ *
  * @ingroup reporters
  */
 class OSIMSIMULATION_API StatesTrajectoryReporter : public AbstractReporter {
 OpenSim_DECLARE_CONCRETE_OBJECT(StatesTrajectoryReporter, AbstractReporter);
 
 public:
-    /** Access the accumulated states. */
+    OpenSim_DECLARE_PROPERTY(compact, bool,
+        "Store the states in a CompactStatesTrajectory, which uses much less "
+        "memory than a StatesTrajectory (default: false).");
+
+    StatesTrajectoryReporter();
+
+    /** Access the accumulated states. If the `compact` property is true,
+     * the states reported since the last call are first expanded from the
+     * compact trajectory. */
     const StatesTrajectory& getStates() const; 
+    /** Access the accumulated states if the `compact` property is true.
+     * @throws Exception if the `compact` property is false, or if no states
+     *         have been reported yet. */
+    const CompactStatesTrajectory& getCompactStates() const;
     /** Clear the accumulated states. */ 
     void clear();
 
@@ -59,6 +77,11 @@ private:
     // Mutable because we append during reporting. This is OK to do since
     // reporting never occurs for trial states.
     mutable StatesTrajectory m_states;
+    // Created when the first state is reported, since it depends on the model.
+    mutable SimTK::ResetOnCopy<std::unique_ptr<CompactStatesTrajectory>>
+            m_compactStates;
+
+    void constructProperties();
 };
 
 } // namespace
@@ -75,6 +75,7 @@ const static string mesh_files[] = {"sphere_10cm_radius.obj",
 int testBouncingBall(bool useMesh, const std::string mesh_filename="");
 int testBallToBallContact(bool useElasticFoundation, bool useMesh1, bool useMesh2);
 void compareHertzAndMeshContactResults();
+void testMeshCacheAndDecimation();
 template <typename ContactType> // e.g., HuntCrossley.
 void testIntermediateFrames();
 
@@ -94,6 +95,7 @@ int main()
         testBallToBallContact(true, false, true);
         testBallToBallContact(true, true, true); 
         compareHertzAndMeshContactResults();
+        testMeshCacheAndDecimation();
 
         testIntermediateFrames<OpenSim::HuntCrossleyForce>();
         testIntermediateFrames<OpenSim::ElasticFoundationForce>();
@@ -372,6 +374,68 @@ void compareHertzAndMeshContactResults()
 }
 
 
+// Meshes are loaded once per process, and can be simplified.
+void testMeshCacheAndDecimation()
+{
+    ContactMesh::clearMeshCache();
+
+    Model model;
+    auto* ball = new OpenSim::Body("ball", mass, Vec3(0), mass*Inertia(1));
+    model.addBody(ball);
+    model.addJoint(new FreeJoint("free", model.getGround(), *ball));
+    auto* full = new ContactMesh(mesh_files[0], Vec3(0), Vec3(0), *ball,
+            "full");
+    model.addContactGeometry(full);
+    auto* simplified = new ContactMesh(mesh_files[0], Vec3(0), Vec3(0),
+            *ball, "simplified");
+    simplified->set_max_faces(2000);
+    model.addContactGeometry(simplified);
+    auto* contactParams = new OpenSim::ElasticFoundationForce::
+            ContactParameters(1.0e6, 1e-5, 0.0, 0.0, 0.0);
+    contactParams->addGeometry("simplified");
+    auto* contact = new OpenSim::ElasticFoundationForce(contactParams);
+    model.addForce(contact);
+    model.initSystem();
+
+    // The full mesh was loaded by the constructors, and the simplified mesh
+    // by initSystem().
+    ASSERT(ContactMesh::getNumCachedMeshes() == 2);
+
+    // Copies of the model use the cached meshes.
+    std::unique_ptr<Model> copy(model.clone());
+    copy->initSystem();
+    ASSERT(ContactMesh::getNumCachedMeshes() == 2);
+
+    const auto& fullReport = full->getDecimationReport();
+    ASSERT(fullReport.numFaces == fullReport.numOriginalFaces);
+    ASSERT(fullReport.maxDistance == 0);
+
+    const auto& report = copy->getComponent<ContactMesh>(
+            "contactgeometryset/simplified").getDecimationReport();
+    ASSERT(report.numOriginalFaces == fullReport.numOriginalFaces);
+    ASSERT(report.numFaces <= 2000);
+    ASSERT(report.rmsDistance <= report.maxDistance);
+    ASSERT(report.maxDistance < 0.05 * radius);
+
+    // Too few faces to form a closed mesh.
+    auto* tooSimple = new ContactMesh(mesh_files[0], Vec3(0), Vec3(0),
+            model.getGround(), "tooSimple");
+    tooSimple->set_max_faces(3);
+    model.addContactGeometry(tooSimple);
+    contactParams->addGeometry("tooSimple");
+    ASSERT_THROW(OpenSim::Exception, model.initSystem());
+
+    // The cache is bounded; the least recently used meshes are removed.
+    const int maxCachedMeshes = ContactMesh::getMaxCachedMeshes();
+    ContactMesh::setMaxCachedMeshes(1);
+    ASSERT(ContactMesh::getNumCachedMeshes() == 1);
+    ASSERT_THROW(OpenSim::Exception, ContactMesh::setMaxCachedMeshes(-1));
+    ContactMesh::setMaxCachedMeshes(maxCachedMeshes);
+
+    ContactMesh::clearMeshCache();
+    ASSERT(ContactMesh::getNumCachedMeshes() == 0);
+}
+
 // In version 4.0, we introduced intermediate PhysicalFrames to
 // ContactGeometry. The test below ensures that the intermediate frames (as
 // well as the ContactGeometry's location and orientation properties) are
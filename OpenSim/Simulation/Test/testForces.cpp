@@ -28,7 +28,7 @@
 //      2. BushingForce
 //      3. ElasticFoundationForce
 //      4. HuntCrossleyForce
-//      5. SmoothSphereHalfSpaceForce
+//      5. SmoothSphereHalfSpaceForce, MultiSmoothSphereHalfSpaceForce
 //      6. CoordinateLimitForce
 //      7. RotationalCoordinateLimitForce
 //      8. ExternalForce
@@ -41,7 +41,10 @@
 //==============================================================================
 #include "SimTKcommon/internal/Xml.h"
 #include <ctime> // clock(), clock_t, CLOCKS_PER_SEC
+#include <thread>
 
+#include <OpenSim/Actuators/CoordinateActuator.h>
+#include <OpenSim/Actuators/Thelen2003Muscle.h>
 #include <OpenSim/Analyses/osimAnalyses.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include <OpenSim/Simulation/osimSimulation.h>
@@ -66,6 +69,7 @@ void testExpressionBasedBushingForceRotational();
 void testElasticFoundation();
 void testHuntCrossleyForce();
 void testSmoothSphereHalfSpaceForce();
+void testMultiSmoothSphereHalfSpaceForce();
 void testCoordinateLimitForce();
 void testCoordinateLimitForceRotational();
 void testExpressionBasedPointToPointForce();
@@ -74,6 +78,7 @@ void testSerializeDeserialize();
 void testTranslationalDampingEffect(Model& osimModel, Coordinate& sliderCoord,
         double start_h, Component& componentWithDamping);
 void testBlankevoort1991Ligament();
+void testParallelForces();
 
 int main() {
     SimTK::Array_<std::string> failures;
@@ -138,6 +143,12 @@ int main() {
         failures.push_back("testSmoothSphereHalfSpaceForce");
     }
 
+    try { testMultiSmoothSphereHalfSpaceForce(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testMultiSmoothSphereHalfSpaceForce");
+    }
+
     try { testCoordinateLimitForce(); }
     catch (const std::exception& e){
         cout << e.what() <<endl; failures.push_back("testCoordinateLimitForce");
@@ -174,6 +185,12 @@ int main() {
         failures.push_back("testBlankevoort1991Ligament");
     }
 
+    try { testParallelForces(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testParallelForces");
+    }
+
     if (!failures.empty()) {
         cout << "Done, with failure(s): " << failures << endl;
         return 1;
@@ -1342,6 +1359,117 @@ void testHuntCrossleyForce() {
     ASSERT(isEqual);
 }
 
+// MultiSmoothSphereHalfSpaceForce applies the same forces as a
+// SmoothSphereHalfSpaceForce for each of its spheres.
+void testMultiSmoothSphereHalfSpaceForce()
+{
+    using SimTK::Vec3;
+
+    Model model;
+    model.setGravity(gravity_vec);
+    auto* foot = new OpenSim::Body("foot", 1.0, Vec3(0),
+            SimTK::Inertia::brick(0.1, 0.02, 0.05));
+    model.addBody(foot);
+    auto* joint = new FreeJoint("joint", model.getGround(), *foot);
+    model.addJoint(joint);
+
+    auto* floor = new ContactHalfSpace(Vec3(0.1, 0, 0),
+            Vec3(0, 0, -0.5 * SimTK::Pi), model.getGround(), "floor");
+    model.addContactGeometry(floor);
+
+    auto* multi = new MultiSmoothSphereHalfSpaceForce("multi", *floor);
+    multi->set_stiffness(1e6);
+    multi->set_dissipation(2.0);
+    multi->set_static_friction(0.8);
+    multi->set_dynamic_friction(0.6);
+    multi->set_viscous_friction(0.5);
+    model.addForce(multi);
+
+    const std::vector<Vec3> locations{
+            {0.08, -0.01, 0.02}, {-0.07, -0.015, -0.03}, {0.0, 0.05, 0.0}};
+    const std::vector<double> radii{0.03, 0.025, 0.02};
+    std::vector<SmoothSphereHalfSpaceForce*> singles;
+    for (int i = 0; i < (int)locations.size(); ++i) {
+        auto* sphere = new ContactSphere(radii[i], locations[i], *foot,
+                "sphere" + std::to_string(i));
+        model.addContactGeometry(sphere);
+        multi->addContactSphere(*sphere);
+
+        auto* single = new SmoothSphereHalfSpaceForce(
+                "single" + std::to_string(i), *sphere, *floor);
+        single->set_stiffness(multi->get_stiffness());
+        single->set_dissipation(multi->get_dissipation());
+        single->set_static_friction(multi->get_static_friction());
+        single->set_dynamic_friction(multi->get_dynamic_friction());
+        single->set_viscous_friction(multi->get_viscous_friction());
+        model.addForce(single);
+        singles.push_back(single);
+    }
+
+    SimTK::State& state = model.initSystem();
+    // Tilt the foot and move it so that some spheres penetrate the floor,
+    // with velocities that cause slip.
+    joint->getCoordinate(FreeJoint::Coord::Rotation1X).setValue(state, 0.1);
+    joint->getCoordinate(FreeJoint::Coord::Rotation3Z).setValue(state, -0.2);
+    joint->getCoordinate(FreeJoint::Coord::TranslationX).setValue(state, 0.3);
+    joint->getCoordinate(FreeJoint::Coord::TranslationY).setValue(state, 0.03);
+    joint->getCoordinate(FreeJoint::Coord::Rotation2Y)
+            .setSpeedValue(state, 1.5);
+    joint->getCoordinate(FreeJoint::Coord::TranslationX)
+            .setSpeedValue(state, 0.4);
+    joint->getCoordinate(FreeJoint::Coord::TranslationY)
+            .setSpeedValue(state, -0.2);
+    model.realizeVelocity(state);
+
+    const Array<double> multiValues = multi->getRecordValues(state);
+    const int numSpheres = (int)singles.size();
+    ASSERT(multiValues.size() == 6 * numSpheres + 6);
+    ASSERT(multi->getRecordLabels().size() == multiValues.size());
+    Vec3 halfSpaceForce(0), halfSpaceTorque(0);
+    bool anyContact = false;
+    for (int i = 0; i < numSpheres; ++i) {
+        const Array<double> singleValues = singles[i]->getRecordValues(state);
+        const double scale = std::max(1.0, std::abs(singleValues[1]));
+        anyContact = anyContact || std::abs(singleValues[1]) > 1.0;
+        for (int j = 0; j < 6; ++j) {
+            ASSERT_EQUAL(multiValues[6 * i + j], singleValues[j],
+                    1e-10 * scale);
+        }
+        for (int j = 0; j < 3; ++j) {
+            halfSpaceForce[j] += singleValues[6 + j];
+            halfSpaceTorque[j] += singleValues[9 + j];
+        }
+    }
+    ASSERT(anyContact);
+    for (int j = 0; j < 3; ++j) {
+        ASSERT_EQUAL(multiValues[6 * numSpheres + j], halfSpaceForce[j],
+                1e-8 * std::max(1.0, halfSpaceForce.norm()));
+        ASSERT_EQUAL(multiValues[6 * numSpheres + 3 + j], halfSpaceTorque[j],
+                1e-8 * std::max(1.0, halfSpaceTorque.norm()));
+    }
+
+    // The model's equations of motion are unchanged if the spheres'
+    // individual forces are replaced with the multi-sphere force.
+    for (auto* single : singles) single->set_appliesForce(false);
+    multi->set_appliesForce(true);
+    SimTK::State stateMulti = model.initSystem();
+    stateMulti.updQ() = state.getQ();
+    stateMulti.updU() = state.getU();
+    model.realizeAcceleration(stateMulti);
+    multi->set_appliesForce(false);
+    for (auto* single : singles) single->set_appliesForce(true);
+    SimTK::State stateSingles = model.initSystem();
+    stateSingles.updQ() = state.getQ();
+    stateSingles.updU() = state.getU();
+    model.realizeAcceleration(stateSingles);
+    const SimTK::Vector& udotMulti = stateMulti.getUDot();
+    const SimTK::Vector& udotSingles = stateSingles.getUDot();
+    for (int i = 0; i < udotMulti.size(); ++i) {
+        ASSERT_EQUAL(udotMulti[i], udotSingles[i],
+                1e-8 * std::max(1.0, std::abs(udotSingles[i])));
+    }
+}
+
 // Test our wrapping of SimTK::SmoothSphereHalfSpaceForce.
 // Simple simulation of bouncing ball with dissipation should generate contact
 // forces that settle to ball weight.
@@ -2382,3 +2510,161 @@ void testBlankevoort1991Ligament() {
         "reference state be equal to the strain value input "
         "to setSlackLengthFromReferenceStrain().");
 }
+
+// Computing the forces on multiple threads (Model::setNumForceThreads())
+// gives the same accelerations as computing them serially, and the same
+// accelerations every time.
+void testParallelForces() {
+    using SimTK::Vec3;
+
+    Model model;
+    model.setGravity(gravity_vec);
+    const PhysicalFrame* previous = &model.getGround();
+    for (int i = 0; i < 6; ++i) {
+        const std::string index = std::to_string(i);
+        auto* body = new OpenSim::Body("body" + index, 1.0 + 0.1 * i,
+                Vec3(0.1, 0, 0), SimTK::Inertia::brick(0.1, 0.05, 0.02));
+        model.addBody(body);
+        model.addJoint(new FreeJoint("joint" + index, model.getGround(),
+                Vec3(0.2 * i, 0, 0), Vec3(0), *body, Vec3(0), Vec3(0)));
+        model.addForce(new PointToPointSpring(*previous, Vec3(0, 0.1, 0),
+                *body, Vec3(0.05, 0, 0), 100.0 * (i + 1), 0.15));
+        auto* bushing = new BushingForce("bushing" + index, model.getGround(),
+                *body, Vec3(50.0 * (i + 1)), Vec3(5.0), Vec3(2.0), Vec3(0.5));
+        model.addForce(bushing);
+        previous = body;
+    }
+
+    // Computes the accelerations for a state with nonzero positions and
+    // speeds.
+    auto calcUDot = [](Model& m) {
+        SimTK::State& state = m.initSystem();
+        for (int i = 0; i < state.getNQ(); ++i) state.updQ()[i] = 0.01 * i;
+        for (int i = 0; i < state.getNU(); ++i) state.updU()[i] = -0.02 * i;
+        m.realizeAcceleration(state);
+        return SimTK::Vector(state.getUDot());
+    };
+
+    const SimTK::Vector udotSerial = calcUDot(model);
+    model.setNumForceThreads(4);
+    ASSERT(model.getNumForceThreads() == 4);
+    const SimTK::Vector udotParallel = calcUDot(model);
+    for (int i = 0; i < udotSerial.size(); ++i) {
+        ASSERT_EQUAL(udotSerial[i], udotParallel[i],
+                1e-10 * std::max(1.0, std::abs(udotSerial[i])));
+    }
+    for (int repeat = 0; repeat < 5; ++repeat) {
+        const SimTK::Vector udot = calcUDot(model);
+        for (int i = 0; i < udot.size(); ++i) {
+            ASSERT(udot[i] == udotParallel[i]);
+        }
+    }
+
+    // Disabled forces are not applied.
+    model.updComponent<Force>("forceset/bushing2").set_appliesForce(false);
+    const SimTK::Vector udotDisabledParallel = calcUDot(model);
+    model.setNumForceThreads(1);
+    const SimTK::Vector udotDisabledSerial = calcUDot(model);
+    ASSERT((udotDisabledSerial - udotSerial).normInf() > 1e-6);
+    for (int i = 0; i < udotSerial.size(); ++i) {
+        ASSERT_EQUAL(udotDisabledSerial[i], udotDisabledParallel[i],
+                1e-10 * std::max(1.0, std::abs(udotDisabledSerial[i])));
+    }
+
+    // The model can be realized in several states at once.
+    model.setNumForceThreads(4);
+    const SimTK::State& defaultState = model.initSystem();
+    std::vector<SimTK::State> states(3, defaultState);
+    std::vector<SimTK::Vector> udotExpected;
+    for (int k = 0; k < (int)states.size(); ++k) {
+        SimTK::State& state = states[k];
+        for (int i = 0; i < state.getNQ(); ++i) state.updQ()[i] = 0.01 * i * k;
+        model.realizeAcceleration(state);
+        udotExpected.push_back(state.getUDot());
+    }
+    std::vector<std::thread> threads;
+    std::vector<int> numMismatches(states.size(), 0);
+    for (int k = 0; k < (int)states.size(); ++k) {
+        threads.emplace_back([&, k]() {
+            for (int repeat = 0; repeat < 20; ++repeat) {
+                SimTK::State state(states[k]);
+                state.invalidateAll(SimTK::Stage::Position);
+                model.realizeAcceleration(state);
+                if ((state.getUDot() - udotExpected[k]).normInf() != 0) {
+                    ++numMismatches[k];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (int n : numMismatches) ASSERT(n == 0);
+
+    ASSERT_THROW(OpenSim::Exception, model.setNumForceThreads(-1));
+
+    // Muscles whose paths share frames, and actuators whose controls come
+    // from a controller: the threads share the controls and the kinematics
+    // of the frames.
+    Model arm;
+    arm.setGravity(gravity_vec);
+    const PhysicalFrame* parent = &arm.getGround();
+    std::vector<const PhysicalFrame*> frames{parent};
+    auto* controller = new PrescribedController();
+    for (int i = 0; i < 3; ++i) {
+        const std::string index = std::to_string(i);
+        auto* body = new OpenSim::Body("link" + index, 1.0,
+                Vec3(0, -0.15, 0), SimTK::Inertia::brick(0.02, 0.15, 0.02));
+        arm.addBody(body);
+        auto* joint = new PinJoint("pin" + index, *parent,
+                Vec3(0, i == 0 ? 0 : -0.3, 0), Vec3(0), *body, Vec3(0),
+                Vec3(0));
+        joint->updCoordinate().setName("q" + index);
+        arm.addJoint(joint);
+        auto* actuator = new CoordinateActuator("q" + index);
+        actuator->setName("actuator" + index);
+        actuator->setOptimalForce(10.0);
+        arm.addForce(actuator);
+        controller->addActuator(*actuator);
+        controller->prescribeControlForActuator(
+                actuator->getName(), new Constant(0.2 + 0.1 * i));
+        frames.push_back(body);
+        parent = body;
+    }
+    for (int i = 0; i < 8; ++i) {
+        const std::string index = std::to_string(i);
+        const double side = i % 2 == 0 ? 1 : -1;
+        // Some of the muscles span two joints.
+        const int origin = i % 3;
+        const int insertion = std::min(origin + 1 + i % 2, 3);
+        auto* muscle = new Thelen2003Muscle(
+                "muscle" + index, 200.0, 0.1, 0.15 * (insertion - origin), 0);
+        muscle->addNewPathPoint("origin", *frames[origin],
+                Vec3(0.03 * side, -0.05 - 0.01 * i, 0));
+        muscle->addNewPathPoint("insertion", *frames[insertion],
+                Vec3(0.03 * side, -0.2, 0));
+        arm.addForce(muscle);
+        controller->addActuator(*muscle);
+        controller->prescribeControlForActuator(
+                muscle->getName(), new Constant(0.1 + 0.1 * i));
+    }
+    arm.addController(controller);
+
+    // Computes the derivatives of all states, which include the activations
+    // of the muscles.
+    auto calcYDot = [](Model& m) {
+        SimTK::State& state = m.initSystem();
+        for (int i = 0; i < state.getNQ(); ++i) state.updQ()[i] = 0.1 * i;
+        for (int i = 0; i < state.getNU(); ++i) state.updU()[i] = -0.2 * i;
+        m.realizeAcceleration(state);
+        return SimTK::Vector(state.getYDot());
+    };
+
+    const SimTK::Vector ydotSerial = calcYDot(arm);
+    arm.setNumForceThreads(4);
+    for (int repeat = 0; repeat < 5; ++repeat) {
+        const SimTK::Vector ydotParallel = calcYDot(arm);
+        for (int i = 0; i < ydotSerial.size(); ++i) {
+            ASSERT_EQUAL(ydotSerial[i], ydotParallel[i],
+                    1e-10 * std::max(1.0, std::abs(ydotSerial[i])));
+        }
+    }
+}
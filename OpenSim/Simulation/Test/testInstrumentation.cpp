@@ -0,0 +1,124 @@
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  testInstrumentation.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/Instrumentation.h>
+#include <OpenSim/Simulation/Control/PrescribedController.h>
+#include <OpenSim/Simulation/Manager/Manager.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/PathSpring.h>
+#include <OpenSim/Simulation/SimbodyEngine/SliderJoint.h>
+#include <OpenSim/Actuators/CoordinateActuator.h>
+
+#include <fstream>
+
+#define CATCH_CONFIG_MAIN
+#include <OpenSim/Auxiliary/catch.hpp>
+
+using namespace OpenSim;
+using SimTK::Vec3;
+
+namespace {
+void buildSlidingBlockModel(Model& model) {
+    model.setName("sliding_block");
+    auto* block = new OpenSim::Body("block", 1.0, Vec3(0),
+            SimTK::Inertia::brick(0.1, 0.1, 0.1));
+    model.addBody(block);
+    auto* slider = new SliderJoint("slider", model.getGround(), *block);
+    slider->updCoordinate().setName("x");
+    model.addJoint(slider);
+
+    auto* spring = new PathSpring("spring", 0.5, 10.0, 0.1);
+    spring->updGeometryPath().appendNewPathPoint(
+            "origin", model.getGround(), Vec3(-1, 0, 0));
+    spring->updGeometryPath().appendNewPathPoint(
+            "insertion", *block, Vec3(0));
+    model.addForce(spring);
+
+    auto* actu = new CoordinateActuator("x");
+    actu->setName("actuator");
+    model.addForce(actu);
+
+    auto* controller = new PrescribedController();
+    controller->setName("controller");
+    controller->addActuator(*actu);
+    controller->prescribeControlForActuator("actuator", new Constant(0.5));
+    model.addController(controller);
+    model.finalizeConnections();
+}
+} // anonymous namespace
+
+TEST_CASE("Instrumentation records per-component statistics") {
+    Model model;
+    buildSlidingBlockModel(model);
+    SimTK::State state = model.initSystem();
+
+    Instrumentation::reset();
+    Instrumentation::setEnabled(true);
+    Instrumentation::setRecordTraceEvents(true);
+    Manager manager(model, state);
+    manager.integrate(0.1);
+    Instrumentation::setEnabled(false);
+    Instrumentation::setRecordTraceEvents(false);
+
+    const auto& spring = model.getComponent<PathSpring>("/forceset/spring");
+    const auto& controller =
+            model.getComponent<PrescribedController>("/controllerset/controller");
+    using Category = Instrumentation::Category;
+    const long long numForceCalls =
+            Instrumentation::getCallCount(spring, Category::ComputeForce);
+    const long long numPathCalls = Instrumentation::getCallCount(
+            spring.getGeometryPath(), Category::ComputePath);
+    const long long numControlsCalls = Instrumentation::getCallCount(
+            controller, Category::ComputeControls);
+
+    if (Instrumentation::isCompiledIn()) {
+        CHECK(numForceCalls > 0);
+        CHECK(numPathCalls > 0);
+        CHECK(numControlsCalls > 0);
+        CHECK(Instrumentation::getCallCount(
+                      spring, Category::RealizeDynamics) > 0);
+        CHECK(Instrumentation::getTotalTime(spring, Category::ComputeForce) >
+                0);
+        const std::string report = Instrumentation::getReport(-1);
+        CHECK(report.find("/forceset/spring") != std::string::npos);
+        CHECK(report.find("computeForce") != std::string::npos);
+
+        const std::string filename = "testInstrumentation_trace.json";
+        Instrumentation::writeChromeTrace(filename);
+        std::ifstream trace(filename);
+        const std::string contents((std::istreambuf_iterator<char>(trace)),
+                std::istreambuf_iterator<char>());
+        CHECK(contents.find("\"traceEvents\"") != std::string::npos);
+        CHECK(contents.find("\"cat\": \"computePath\"") != std::string::npos);
+    } else {
+        // The instrumentation points compile to nothing.
+        CHECK(numForceCalls == 0);
+        CHECK(numPathCalls == 0);
+        CHECK(numControlsCalls == 0);
+    }
+
+    // Nothing is recorded while disabled.
+    Instrumentation::reset();
+    manager.integrate(0.2);
+    CHECK(Instrumentation::getCallCount(spring, Category::ComputeForce) == 0);
+}
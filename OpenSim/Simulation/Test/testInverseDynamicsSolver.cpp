@@ -0,0 +1,192 @@
+/* -------------------------------------------------------------------------- *
+ *                OpenSim:  testInverseDynamicsSolver.cpp                     *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2017 Stanford University and the Authors                *
+ * Author(s): Ajay Seth                                                       *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Tests:
+// 1. FunctionSetEvaluator gives the values and derivatives of the functions
+//    of a FunctionSet, as FunctionSet::evaluate() does.
+// 2. InverseDynamicsSolver::solveInParallel() gives the same generalized
+//    forces, bit for bit, as the serial solve of a trajectory, for any number
+//    of threads.
+
+#include <OpenSim/Simulation/InverseDynamicsSolver.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/Muscle.h>
+#include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/FunctionSetEvaluator.h>
+#include <OpenSim/Common/GCVSplineSet.h>
+#include <OpenSim/Common/Sine.h>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+#include <numeric>
+
+using namespace OpenSim;
+using namespace std;
+
+namespace {
+const std::string ModelFile = "testSimulationUtilities_leg6dof9musc_20303.osim";
+const std::string CoordinatesFile =
+        "testSimulationUtilities_leg69_IK_stance_pre4.mot";
+
+// The coordinate functions of the model, in the order of the coordinates in
+// the State, as InverseDynamicsTool creates them.
+void createCoordinateFunctions(const Model& model, const Storage& coordinates,
+        FunctionSet& functions) {
+    GCVSplineSet splines(5, &coordinates);
+    for (const auto& coord : model.getCoordinatesInMultibodyTreeOrder()) {
+        if (splines.contains(coord->getName())) {
+            functions.cloneAndAppend(splines.get(coord->getName()));
+        } else {
+            functions.adoptAndAppend(new Constant(coord->getDefaultValue()));
+        }
+    }
+}
+} // anonymous namespace
+
+void testFunctionSetEvaluator() {
+    Storage coordinates(CoordinatesFile);
+    FunctionSet functions;
+    GCVSplineSet splines(5, &coordinates);
+    for (int i = 0; i < 5; ++i) functions.cloneAndAppend(splines.get(i));
+    functions.adoptAndAppend(new Constant(0.7));
+    // A cubic spline with other knots and a function that is not a spline.
+    const double x[] = {-0.1, 0.2, 0.5, 0.6, 0.9, 1.3, 1.6};
+    const double y[] = {0.3, -0.2, 0.4, 0.1, 0.8, 0.5, -0.3};
+    functions.adoptAndAppend(new GCVSpline(3, 7, x, y));
+    functions.adoptAndAppend(new Sine(0.5, 3.0, 0.2));
+    for (int i = 5; i < 10; ++i) functions.cloneAndAppend(splines.get(i));
+
+    const int n = functions.getSize();
+    FunctionSetEvaluator evaluator(functions);
+    ASSERT(evaluator.getNumFunctions() == n);
+    std::vector<double> values(n), first(n), second(n);
+    // Include times outside the range of the knots.
+    for (double time = -0.05; time < 1.6; time += 0.0123) {
+        evaluator.calcValuesAndDerivatives(
+                time, values.data(), first.data(), second.data());
+        for (int i = 0; i < n; ++i) {
+            const double* results[] = {&values[i], &first[i], &second[i]};
+            for (int order = 0; order < 3; ++order) {
+                const double expected = functions.evaluate(i, order, time);
+                ASSERT_EQUAL(expected, *results[order],
+                        1e-10 * (1 + std::abs(expected)), __FILE__, __LINE__,
+                        "Derivative " + std::to_string(order) +
+                                " of function " + std::to_string(i) +
+                                " is wrong at time " + std::to_string(time) +
+                                ".");
+            }
+        }
+    }
+
+    // The derivatives are optional.
+    std::vector<double> valuesOnly(n);
+    evaluator.calcValuesAndDerivatives(0.5, valuesOnly.data(), nullptr,
+            nullptr);
+    evaluator.calcValuesAndDerivatives(
+            0.5, values.data(), first.data(), second.data());
+    ASSERT(valuesOnly == values);
+}
+
+void testSolveInParallel() {
+    Model model(ModelFile);
+    // Muscles are excluded, as by default in InverseDynamicsTool.
+    for (auto& muscle : model.updComponentList<Muscle>()) {
+        muscle.set_appliesForce(false);
+    }
+    SimTK::State& s = model.initSystem();
+
+    Storage coordinates(CoordinatesFile);
+    model.getSimbodyEngine().convertDegreesToRadians(coordinates);
+    FunctionSet functions;
+    createCoordinateFunctions(model, coordinates, functions);
+    ASSERT(s.getNQ() == s.getNU());
+    std::vector<int> coordinatesToSpeedsIndexMap(s.getNU());
+    std::iota(coordinatesToSpeedsIndexMap.begin(),
+            coordinatesToSpeedsIndexMap.end(), 0);
+
+    Array<double> storageTimes;
+    coordinates.getTimeColumn(storageTimes);
+    SimTK::Array_<double> times(storageTimes.getSize());
+    for (int i = 0; i < storageTimes.getSize(); ++i) {
+        times[i] = storageTimes[i];
+    }
+    const int nt = (int)times.size();
+
+    InverseDynamicsSolver solver(model);
+    SimTK::Array_<SimTK::Vector> serial;
+    SimTK::State serialState(s);
+    solver.solve(serialState, functions, coordinatesToSpeedsIndexMap, times,
+            serial);
+    ASSERT((int)serial.size() == nt);
+
+    // The frames agree with those solved one at a time.
+    SimTK::State frameState(s);
+    for (int i = 0; i < nt; i += 10) {
+        const SimTK::Vector tau = solver.solve(frameState, functions,
+                coordinatesToSpeedsIndexMap, times[i]);
+        for (int j = 0; j < tau.size(); ++j) {
+            ASSERT_EQUAL(tau[j], serial[i][j], 1e-6 * (1 + std::abs(tau[j])));
+        }
+    }
+
+    for (int numThreads : {1, 2, 4, 0}) {
+        SimTK::Array_<SimTK::Vector> parallel;
+        const double start = SimTK::realTime();
+        solver.solveInParallel(s, functions, coordinatesToSpeedsIndexMap,
+                times, parallel, numThreads);
+        log_info("Solved {} frames with {} threads in {:.3f} s.", nt,
+                numThreads, SimTK::realTime() - start);
+        ASSERT((int)parallel.size() == nt);
+        for (int i = 0; i < nt; ++i) {
+            ASSERT(parallel[i].size() == serial[i].size());
+            for (int j = 0; j < serial[i].size(); ++j) {
+                ASSERT(parallel[i][j] == serial[i][j], __FILE__, __LINE__,
+                        "Generalized force " + std::to_string(j) +
+                                " at frame " + std::to_string(i) +
+                                " differs from the serial solve.");
+            }
+        }
+    }
+
+    // Invalid coordinate functions.
+    SimTK::Array_<SimTK::Vector> results;
+    std::vector<int> invalidMap(coordinatesToSpeedsIndexMap);
+    invalidMap.back() = functions.getSize();
+    ASSERT_THROW(Exception, solver.solveInParallel(s, functions, invalidMap,
+            times, results));
+    invalidMap.pop_back();
+    ASSERT_THROW(Exception, solver.solveInParallel(s, functions, invalidMap,
+            times, results));
+}
+
+int main() {
+    try {
+        testFunctionSetEvaluator();
+        testSolveInParallel();
+    } catch (const std::exception& e) {
+        log_error("testInverseDynamicsSolver failed: {}", e.what());
+        return 1;
+    }
+    log_info("testInverseDynamicsSolver passed.");
+    return 0;
+}
@@ -85,7 +85,8 @@ void testTrackWithUpdateMarkerWeights();
 
 // Verify that solver does not confuse/mismanage markers when reference
 // has more markers than the model, order is changed or marker reference
-// includes intervals with NaNs (no observation)
+// includes intervals with NaNs (no observation), and that the errors and
+// locations of all markers computed together match those of each marker
 void testNumberOfMarkersMismatch();
 void testNumberOfOrientationsMismatch();
 
@@ -651,17 +652,50 @@ void testNumberOfMarkersMismatch()
     ikSolver.assemble(state);
 
     int nm = ikSolver.getNumMarkersInUse();
+    const int nf = (int)markersRef->getNumFrames();
 
     SimTK::Array_<double> markerErrors(nm);
-    for (unsigned i = 0; i < markersRef->getNumFrames(); ++i) {
+    SimTK::Array_<SimTK::Vec3> markerLocations(nm);
+    SimTK::Matrix allMarkerLocations(nf, 3*nm);
+    SimTK::Matrix allSquaredMarkerErrors(nf, nm);
+    SimTK::Matrix noMarkerResults;
+    for (int i = 0; i < nf; ++i) {
         state.updTime() = i*dt;
         ikSolver.track(state);
 
         //get the marker errors
         ikSolver.computeCurrentMarkerErrors(markerErrors);
+        ikSolver.computeCurrentMarkerLocations(markerLocations);
+        ikSolver.computeCurrentMarkerLocationsAndSquaredErrors(
+                allMarkerLocations, allSquaredMarkerErrors, i);
+        ikSolver.computeCurrentMarkerLocationsAndSquaredErrors(
+                noMarkerResults, allSquaredMarkerErrors, i);
 
         int nme = markerErrors.size();
 
+        // The errors and locations of all markers, computed together, match
+        // those computed one marker at a time, including missing markers.
+        for (int j = 0; j < nme; ++j) {
+            SimTK_ASSERT_ALWAYS(
+                abs(markerErrors[j] - ikSolver.computeCurrentMarkerError(j))
+                        <= SimTK::SignificantReal,
+                "Marker errors computed together do not match.");
+            SimTK_ASSERT_ALWAYS(abs(allSquaredMarkerErrors(i, j) -
+                        ikSolver.computeCurrentSquaredMarkerError(j))
+                        <= SimTK::SignificantReal,
+                "Squared marker errors computed together do not match.");
+            const SimTK::Vec3 location =
+                    ikSolver.computeCurrentMarkerLocation(j);
+            for (int k = 0; k < 3; ++k) {
+                SimTK_ASSERT_ALWAYS(
+                    abs(markerLocations[j][k] - location[k]) <=
+                            SimTK::SignificantReal &&
+                    abs(allMarkerLocations(i, 3*j + k) - location[k]) <=
+                            SimTK::SignificantReal,
+                    "Marker locations computed together do not match.");
+            }
+        }
+
         SimTK_ASSERT_ALWAYS(nme == nm,
             "InverseKinematicsSolver failed to account "
             "for unused marker reference (observation).");
@@ -687,6 +721,15 @@ void testNumberOfMarkersMismatch()
         }
         cout << endl;
     }
+
+    SimTK::Matrix tooFewColumns(nf, nm - 1);
+    bool threw = false;
+    try {
+        ikSolver.computeCurrentMarkerLocationsAndSquaredErrors(
+                allMarkerLocations, tooFewColumns, 0);
+    } catch (const OpenSim::Exception&) { threw = true; }
+    SimTK_ASSERT_ALWAYS(threw,
+        "Expected an exception for a matrix of the wrong size.");
 }
 
 void testNumberOfOrientationsMismatch()
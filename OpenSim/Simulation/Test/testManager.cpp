@@ -47,6 +47,9 @@ Manager Tests:
 #include <OpenSim/Common/LoadOpenSimLibrary.h>
 #include <OpenSim/Simulation/Control/PrescribedController.h>
 #include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/Reporter.h>
+
+#include <chrono>
 
 using namespace OpenSim;
 using namespace std;
@@ -56,6 +59,7 @@ void testExcitationUpdatesWithManager();
 void testConstructors();
 void testIntegratorInterface();
 void testExceptions();
+void testRealTime();
 
 int main()
 {
@@ -97,6 +101,12 @@ int main()
         failures.push_back("testExceptions");
     }
 
+    try { testRealTime(); }
+    catch (const std::exception& e) {
+        cout << e.what() << endl;
+        failures.push_back("testRealTime");
+    }
+
     if (!failures.empty()) {
         cout << "Done, with failure(s): " << failures << endl;
         return 1;
@@ -478,3 +488,144 @@ void testExceptions()
     manager.setIntegratorAccuracy(1e-4);
     manager.setIntegratorMinimumStepSize(0.01);
 }
+
+// Counts the reports.
+class ReportCounter : public AbstractReporter {
+    OpenSim_DECLARE_CONCRETE_OBJECT(ReportCounter, AbstractReporter);
+public:
+    mutable int numReports = 0;
+protected:
+    void implementReport(const SimTK::State&) const override { ++numReports; }
+};
+
+void testRealTime()
+{
+    cout << "Running testRealTime" << endl;
+
+    using SimTK::Vec3;
+    const double g = 9.81;
+
+    Model model;
+    model.setGravity(Vec3(0, -g, 0));
+    auto ball = new Body("ball", 1., Vec3(0), SimTK::Inertia::sphere(1.));
+    model.addBody(ball);
+    auto freeJoint = new FreeJoint("freeJoint", model.getGround(), *ball);
+    model.addJoint(freeJoint);
+    const Coordinate& height =
+        freeJoint->getCoordinate(FreeJoint::Coord::TranslationY);
+    const double period = 0.01;
+    const double finalTime = 0.1;
+    auto reporter = new ReportCounter();
+    reporter->set_report_time_interval(period);
+    model.addComponent(reporter);
+    SimTK::State initState = model.initSystem();
+
+    // Without pacing, and never degrading: the result is the same as for a
+    // regular integration, and each period is measured.
+    {
+        Manager manager(model);
+        manager.setRealTimeControlPeriod(period);
+        manager.setRealTimeDeadlineMargin(SimTK::Infinity);
+        manager.setRealTimePacing(false);
+        manager.initialize(initState);
+        // Integrate in two calls, the first ending mid-period.
+        manager.integrate(0.045);
+        SimTK::State state = manager.integrate(finalTime);
+        SimTK_TEST_EQ(state.getTime(), finalTime);
+        SimTK_TEST_EQ(height.getValue(state), -0.5 * g * finalTime * finalTime);
+
+        const auto& stats = manager.getRealTimeStatistics();
+        // The period from 0.04 to 0.05 is split between the two calls.
+        SimTK_TEST(stats.getNumPeriods() == 11);
+        SimTK_TEST(stats.numDeadlineMisses <= stats.getNumPeriods());
+        SimTK_TEST(stats.getMeanComputeTime() > 0);
+        SimTK_TEST(stats.getMeanComputeTime() <= stats.maxComputeTime);
+        SimTK_TEST(stats.degradationLevel == 0);
+        SimTK_TEST(stats.maxDegradationLevel == 0);
+        SimTK_TEST(stats.maxComputeTime > 0);
+        SimTK_TEST(manager.getStateStorage().getSize() >= 11);
+    }
+
+    // A deadline that is always threatened degrades the Manager down to the
+    // fallback integrator, with which the integration continues. The fallback
+    // integrator keeps the maximum step size. The reporters are skipped after
+    // the first period, and an integration that is not in real time undoes
+    // the degradation.
+    {
+        reporter->numReports = 0;
+        Manager manager(model);
+        manager.setRealTimeControlPeriod(period);
+        manager.setRealTimeDeadlineMargin(1e-12);
+        manager.setRealTimePacing(false);
+        manager.setRealTimeFallbackIntegratorMethod(
+                Manager::IntegratorMethod::ExplicitEuler);
+        manager.setIntegratorMaximumStepSize(0.5 * period);
+        manager.initialize(initState);
+        SimTK::State state = manager.integrate(finalTime);
+        SimTK_TEST_EQ(state.getTime(), finalTime);
+        const auto& stats = manager.getRealTimeStatistics();
+        SimTK_TEST(stats.degradationLevel == 2);
+        SimTK_TEST(stats.getNumPeriods() == 10);
+        SimTK_TEST(std::string(manager.getIntegrator().getMethodName()) ==
+                   "ExplicitEuler");
+        // Explicit Euler with two steps per period, for the 8 periods after
+        // the 2 that degraded the Manager.
+        SimTK_TEST(manager.getIntegrator().getNumStepsTaken() >= 16);
+        SimTK_TEST_EQ_TOL(height.getValue(state),
+                -0.5 * g * finalTime * finalTime, 0.01);
+        SimTK_TEST(reporter->numReports <= 2);
+        SimTK_TEST(!reporter->isReportingSuspended());
+
+        manager.setRealTimeControlPeriod(0);
+        state = manager.integrate(2 * finalTime);
+        SimTK_TEST_EQ(state.getTime(), 2 * finalTime);
+        SimTK_TEST(stats.degradationLevel == 0);
+        SimTK_TEST(stats.maxDegradationLevel == 2);
+        SimTK_TEST(std::string(manager.getIntegrator().getMethodName()) ==
+                   "RungeKuttaMerson");
+        SimTK_TEST(reporter->numReports >= 10);
+    }
+
+    // Once the deadlines are no longer threatened, the Manager performs the
+    // analyses and reporters again.
+    {
+        reporter->numReports = 0;
+        Manager manager(model);
+        manager.setRealTimeControlPeriod(period);
+        manager.setRealTimeDeadlineMargin(1e-12);
+        manager.setRealTimePacing(false);
+        manager.initialize(initState);
+        // The first period degrades the Manager.
+        manager.integrate(2 * period);
+        SimTK_TEST(manager.getRealTimeStatistics().degradationLevel == 1);
+        manager.setRealTimeDeadlineMargin(SimTK::Infinity);
+        manager.integrate(20 * period);
+        SimTK_TEST(manager.getRealTimeStatistics().degradationLevel == 0);
+        // Reported in the first period and, after 10 periods within the
+        // margin, in the last 8 periods.
+        SimTK_TEST(reporter->numReports >= 9);
+        SimTK_TEST(reporter->numReports <= 10);
+    }
+
+    // With pacing, the integration keeps pace with the wall clock.
+    {
+        Manager manager(model);
+        manager.setRealTimeControlPeriod(period);
+        manager.initialize(initState);
+        const auto start = std::chrono::steady_clock::now();
+        manager.integrate(finalTime);
+        const double wallTime = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+        SimTK_TEST(wallTime >= 0.99 * finalTime);
+    }
+
+    // Real-time mode cannot be combined with constant time steps.
+    {
+        Manager manager(model);
+        manager.setRealTimeControlPeriod(period);
+        manager.setUseConstantDT(true);
+        manager.initialize(initState);
+        ASSERT_THROW(Exception, manager.integrate(finalTime));
+    }
+    ASSERT_THROW(Exception, Manager(model).setRealTimeControlPeriod(-1));
+}
@@ -22,21 +22,27 @@
  * -------------------------------------------------------------------------- */
 
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <OpenSim/Actuators/CoordinateActuator.h>
+#include <OpenSim/Simulation/Control/PrescribedController.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/SimbodyEngine/FreeJoint.h>
+#include <OpenSim/Simulation/SimbodyEngine/SliderJoint.h>
 #include <OpenSim/Simulation/SimulationUtilities.h>
+#include <OpenSim/Common/Constant.h>
 #include <OpenSim/Common/LoadOpenSimLibrary.h>
 
 using namespace OpenSim;
 using namespace std;
 
 void testUpdatePre40KinematicsFor40MotionType();
+void testSimulateEnsemble();
 
 int main() {
     LoadOpenSimLibrary("osimActuators");
 
     SimTK_START_TEST("testSimulationUtilities");
         SimTK_SUBTEST(testUpdatePre40KinematicsFor40MotionType);
+        SimTK_SUBTEST(testSimulateEnsemble);
     SimTK_END_TEST();
 }
 
@@ -174,22 +180,66 @@ void testUpdatePre40KinematicsFor40MotionType() {
     }
 }
 
+void testSimulateEnsemble() {
+    using SimTK::Vec3;
+    const double gravity = 9.81;
+    const double mass = 2.0;
 
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+    // A block that slides along the direction of gravity.
+    Model model;
+    model.setGravity(Vec3(-gravity, 0, 0));
+    auto* block = new Body("block", mass, Vec3(0), SimTK::Inertia(1.));
+    model.addBody(block);
+    auto* slider = new SliderJoint("slider", model.getGround(), *block);
+    slider->updCoordinate().setName("x");
+    model.addJoint(slider);
+    auto* actu = new CoordinateActuator("x");
+    actu->setName("actuator");
+    actu->setOptimalForce(1.0);
+    model.addForce(actu);
+    model.initSystem();
+    const auto& coord = model.getCoordinateSet().get("x");
+
+    // With this controller, the net force on the block is mass * gravity.
+    const double force = 2 * mass * gravity;
+    auto controller = std::make_shared<PrescribedController>();
+    controller->setName("constant");
+    controller->addActuator(*actu);
+    controller->prescribeControlForActuator("actuator", new Constant(force));
+
+    const int numMembers = 9;
+    std::vector<EnsembleMember> members(numMembers);
+    for (int im = 0; im < numMembers; ++im) {
+        members[im].initialState = model.getWorkingState();
+        coord.setValue(members[im].initialState, 0.1 * im, false);
+        if (im % 3 == 1) members[im].controller = controller;
+    }
+    // This member fails because its initial time is after the final time.
+    members[numMembers - 1].initialState.setTime(5.0);
+
+    EnsembleSettings settings;
+    settings.finalTime = 1.0;
+    settings.reportInterval = 0.1;
+    settings.numThreads = 3;
+    settings.integratorAccuracy = 1e-8;
+    EnsembleResult result = simulateEnsemble(model, members, settings);
+
+    SimTK_TEST(result.numThreads == 3);
+    SimTK_TEST(result.numSucceeded == numMembers - 1);
+    SimTK_TEST(result.numFailed == 1);
+    SimTK_TEST(!result.members.back().success);
+    SimTK_TEST(!result.members.back().errorMessage.empty());
+    for (int im = 0; im < numMembers - 1; ++im) {
+        const auto& member = result.members[im];
+        SimTK_TEST(member.success);
+        SimTK_TEST(member.numSteps > 0);
+        const auto& states = *member.states;
+        SimTK_TEST(states.getSize() == 11);
+        SimTK_TEST_EQ(states.getTime(5), 0.5);
+        SimTK_TEST_EQ(states.back().getTime(), 1.0);
+        // The materialized states can be used with the original model.
+        const double acceleration = members[im].controller ? gravity : -gravity;
+        const double expected = 0.1 * im + 0.5 * acceleration;
+        SimTK_TEST_EQ_TOL(coord.getValue(states.back()), expected, 1e-6);
+    }
+}
@@ -770,6 +770,99 @@ void testExport() {
             OpenSim::Exception);
 }
 
+void testCompactStatesTrajectory() {
+    Model model("arm26.osim");
+
+    auto* statesCol = new StatesTrajectoryReporter();
+    statesCol->setName("states_collector");
+    model.addComponent(statesCol);
+    auto* compactCol = new StatesTrajectoryReporter();
+    compactCol->setName("compact_states_collector");
+    compactCol->set_compact(true);
+    model.addComponent(compactCol);
+
+    auto& state = model.initSystem();
+    SimTK_TEST_MUST_THROW_EXC(compactCol->getCompactStates(), Exception);
+    SimTK_TEST(compactCol->getStates().getSize() == 0);
+    SimTK_TEST_MUST_THROW_EXC(statesCol->getCompactStates(), Exception);
+
+    // Discrete variables can be accessed by path.
+    const auto dvNames = model.getDiscreteVariableNames();
+    SimTK_TEST(dvNames.size() > 0);
+    const ComponentPath dvPath(dvNames[0]);
+    model.setDiscreteVariableValue(state, dvPath, 1.5);
+    SimTK_TEST_EQ(model.getDiscreteVariableValue(state, dvPath), 1.5);
+    model.setDiscreteVariableValue(state, dvPath, 0);
+    SimTK_TEST_MUST_THROW_EXC(
+            model.getDiscreteVariableValue(state, dvNames[0]), Exception);
+
+    SimTK::RungeKuttaMersonIntegrator integrator(model.getSystem());
+    SimTK::TimeStepper ts(model.getSystem(), integrator);
+    ts.initialize(state);
+    ts.setReportAllSignificantStates(true);
+    integrator.setReturnEveryInternalStep(true);
+    const double finalTime = 0.05;
+    while (ts.getState().getTime() < finalTime) {
+        ts.stepTo(finalTime);
+        model.getMultibodySystem().realize(ts.getState(), SimTK::Stage::Report);
+    }
+
+    // The compact trajectory materializes the same states.
+    const auto& states = statesCol->getStates();
+    const auto& compact = compactCol->getCompactStates();
+    SimTK_TEST(compact.getSize() == states.getSize());
+    SimTK_TEST(compact.getDiscreteVariableNames().size() ==
+               static_cast<size_t>(dvNames.size()));
+    size_t i = 0;
+    for (const auto& compactState : compact) {
+        SimTK_TEST_EQ(compactState.getTime(), states[i].getTime());
+        SimTK_TEST_EQ(compactState.getY(), states[i].getY());
+        for (int idv = 0; idv < dvNames.size(); ++idv) {
+            SimTK_TEST_EQ(
+                    model.getDiscreteVariableValue(compactState,
+                            ComponentPath(dvNames[idv])),
+                    model.getDiscreteVariableValue(states[i],
+                            ComponentPath(dvNames[idv])));
+        }
+        ++i;
+    }
+    SimTK_TEST_EQ(compact.back().getY(), states.back().getY());
+    SimTK_TEST_EQ(compact.get(1).getY(), states[1].getY());
+    SimTK_TEST_MUST_THROW_EXC(compact.get(compact.getSize()),
+            IndexOutOfRange);
+
+    // getStates() expands the compact trajectory.
+    const auto& expanded = compactCol->getStates();
+    SimTK_TEST(expanded.getSize() == states.getSize());
+    SimTK_TEST_EQ(expanded[1].getY(), states[1].getY());
+    SimTK_TEST_EQ(expanded.back().getY(), states.back().getY());
+
+    // Materialized states can be used for computations.
+    model.realizePosition(compact[2]);
+    SimTK_TEST_EQ(model.calcMassCenterPosition(compact[2]),
+            model.calcMassCenterPosition(states[2]));
+
+    // Exporting gives the same table.
+    SimTK_TEST(compact.isCompatibleWith(model));
+    const auto tableCompact = compact.exportToTable(model);
+    const auto table = states.exportToTable(model);
+    SimTK_TEST(tableCompact.getColumnLabels() == table.getColumnLabels());
+    SimTK_TEST_EQ(tableCompact.getMatrix(), table.getMatrix());
+
+    // Round trip through a table and through a StatesTrajectory.
+    const auto fromTable =
+            CompactStatesTrajectory::createFromStatesTable(model, table);
+    SimTK_TEST(fromTable.getSize() == states.getSize());
+    SimTK_TEST_EQ(fromTable.exportToTable(model).getMatrix(),
+            table.getMatrix());
+    const auto converted = compact.toStatesTrajectory();
+    SimTK_TEST(converted.getSize() == states.getSize());
+    SimTK_TEST_EQ(converted.back().getY(), states.back().getY());
+
+    compactCol->clear();
+    SimTK_TEST(compactCol->getCompactStates().getSize() == 0);
+}
+
 int main() {
     SimTK_START_TEST("testStatesTrajectory");
         // actuators library is not loaded automatically (unless using clang).
@@ -803,5 +896,7 @@ int main() {
         // Export to data table.
         SimTK_SUBTEST(testExport);
 
+        SimTK_SUBTEST(testCompactStatesTrajectory);
+
     SimTK_END_TEST();
 }
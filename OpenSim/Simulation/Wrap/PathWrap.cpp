@@ -63,7 +63,8 @@ PathWrap::~PathWrap()
  */
 void PathWrap::setNull()
 {
-    resetPreviousWrap();
+    _wrapObject = nullptr;
+    _path = nullptr;
 }
 
 //_____________________________________________________________________________
@@ -76,6 +77,7 @@ void PathWrap::constructProperties()
     constructProperty_method("hybrid");
     OpenSim::Array<int> range(-1, 2);
     constructProperty_range(range);
+    constructProperty_use_previous_wrap(false);
 }
 
 
@@ -136,25 +138,53 @@ void PathWrap::setEndPoint( const SimTK::State& s, int aIndex)
     }
 }
 
-void PathWrap::resetPreviousWrap()
-{
-    _previousWrap.startPoint = -1;
-    _previousWrap.endPoint = -1;
+namespace {
+    // A WrapResult that indicates that there was no previous wrapping.
+    WrapResult createResetWrapResult()
+    {
+        WrapResult wrapResult;
+        wrapResult.startPoint = -1;
+        wrapResult.endPoint = -1;
 
-    _previousWrap.wrap_pts.setSize(0);
-    _previousWrap.wrap_path_length = 0.0;
+        wrapResult.wrap_pts.setSize(0);
+        wrapResult.wrap_path_length = 0.0;
 
-    int i;
-    for (i = 0; i < 3; i++) {
-        _previousWrap.r1[i] = -std::numeric_limits<SimTK::Real>::infinity();
-        _previousWrap.r2[i] = -std::numeric_limits<SimTK::Real>::infinity();
-        _previousWrap.sv[i] = -std::numeric_limits<SimTK::Real>::infinity();
+        for (int i = 0; i < 3; i++) {
+            wrapResult.r1[i] = -std::numeric_limits<SimTK::Real>::infinity();
+            wrapResult.r2[i] = -std::numeric_limits<SimTK::Real>::infinity();
+            wrapResult.sv[i] = -std::numeric_limits<SimTK::Real>::infinity();
+        }
+        return wrapResult;
     }
 }
 
-void PathWrap::setPreviousWrap(const WrapResult& aWrapResult)
+void PathWrap::extendAddToSystem(SimTK::MultibodySystem& system) const
+{
+    Super::extendAddToSystem(system);
+
+    _previousWrap = addCacheVariable("previous_wrap",
+            createResetWrapResult(), SimTK::Stage::Instance);
+}
+
+const WrapResult& PathWrap::getPreviousWrap(const SimTK::State& s) const
+{
+    return updCacheVariableValue(s, _previousWrap);
+}
+
+void PathWrap::setPreviousWrap(const SimTK::State& s,
+        const WrapResult& aWrapResult) const
+{
+    WrapResult& previousWrap = updCacheVariableValue(s, _previousWrap);
+    previousWrap = aWrapResult;
+    // Without the factor, the wrap objects cannot re-normalize the tangent
+    // points of the previous wrap, and start from scratch.
+    if (!get_use_previous_wrap()) previousWrap.factor = SimTK::NaN;
+    markCacheVariableValid(s, _previousWrap);
+}
+
+void PathWrap::resetPreviousWrap(const SimTK::State& s) const
 {
-    _previousWrap = aWrapResult;
+    setPreviousWrap(s, createResetWrapResult());
 }
 
 void PathWrap::setWrapObject(WrapObject& aWrapObject)
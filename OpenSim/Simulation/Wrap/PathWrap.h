@@ -68,6 +68,11 @@ public:
     // ignoring/overwriting this property anyways.
     OpenSim_DECLARE_LIST_PROPERTY_SIZE(range, int, 2,
         "The range of indices to use to compute the path over the wrap object.")
+    OpenSim_DECLARE_PROPERTY(use_previous_wrap, bool,
+        "Whether the wrap object starts from the tangent points of the "
+        "previous wrapping calculation of this path (default: false). This "
+        "can speed up the wrapping over a motion, but the result can differ "
+        "slightly from that of a calculation that starts from scratch.");
 
     enum WrapMethod {
         hybrid,
@@ -112,13 +117,20 @@ public:
     void setMethod(WrapMethod aMethod);
     const std::string& getMethodName() const { return get_method(); }
 
-    const WrapResult& getPreviousWrap() const { return _previousWrap; }
-    void setPreviousWrap(const WrapResult& aWrapResult);
-    void resetPreviousWrap();
+    /** The result of the previous wrapping calculation for this path and wrap
+     * object, which the wrap object uses as an initial guess if
+     * use_previous_wrap is true. It is stored in a cache variable of the
+     * State (and is copied with the State), so that paths can be evaluated
+     * for different States in any order and concurrently. */
+    const WrapResult& getPreviousWrap(const SimTK::State& s) const;
+    void setPreviousWrap(const SimTK::State& s,
+            const WrapResult& aWrapResult) const;
+    void resetPreviousWrap(const SimTK::State& s) const;
 
 private:
     void constructProperties();
     void extendConnectToModel(Model& model) override;
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override;
     void setNull();
 
 private:
@@ -127,7 +139,9 @@ private:
     const WrapObject* _wrapObject;
     const GeometryPath* _path;
 
-    WrapResult _previousWrap;  // results from previous wrapping
+    // Results from the previous wrapping. This does not depend on the state
+    // variables, so it is accessed regardless of whether it is valid.
+    mutable CacheVariable<WrapResult> _previousWrap;
 
     MemberSubcomponentIndex _wrapPoint1Ix{
         constructSubcomponent<PathWrapPoint>("pwpt1") };
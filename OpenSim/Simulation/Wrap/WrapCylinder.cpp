@@ -163,6 +163,37 @@ string WrapCylinder::getDimensionsString() const
 //=============================================================================
 // WRAPPING
 //=============================================================================
+//_____________________________________________________________________________
+/**
+ * Find the line segments that may wrap over the cylinder. If the cylinder is
+ * not constrained to a quadrant, wrapLine() returns noWrap unless the
+ * segment passes within the radius of the cylinder's axis, so the segments
+ * that stay farther than the radius (with a small tolerance for round-off)
+ * are skipped. A constrained cylinder may wrap segments that do not
+ * intersect it, so all of its segments are left to wrapLine().
+ */
+void WrapCylinder::findLinesToWrap(int numPoints, const double* x,
+        const double* y, const double* z, char* mayWrap) const
+{
+    if (_wrapSign != 0) {
+        Super::findLinesToWrap(numPoints, x, y, z, mayWrap);
+        return;
+    }
+    const double limit = get_radius() * get_radius() * (1.0 + 1e-6);
+    for (int k = 0; k < numPoints - 1; k++) {
+        // Only the distance to the axis (z) matters.
+        const double dx = x[k + 1] - x[k];
+        const double dy = y[k + 1] - y[k];
+        const double dd = dx * dx + dy * dy;
+        const double proj = -(x[k] * dx + y[k] * dy);
+        double t = dd > 0.0 ? proj / dd : 0.0;
+        t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+        const double cx = x[k] + t * dx;
+        const double cy = y[k] + t * dy;
+        mayWrap[k] = (cx * cx + cy * cy <= limit);
+    }
+}
+
 //_____________________________________________________________________________
 /**
  * Calculate the wrapping of one line segment over the cylinder.
@@ -195,7 +226,7 @@ int WrapCylinder::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::V
     // In case you need any variables from the previous wrap, copy them from
     // the PathWrap into the WrapResult, re-normalizing the ones that were
     // un-normalized at the end of the previous wrap calculation.
-    const WrapResult& previousWrap = aPathWrap.getPreviousWrap();
+    const WrapResult& previousWrap = aPathWrap.getPreviousWrap(s);
     aWrapResult.factor = previousWrap.factor;
     // Use Vec3 operators
     aWrapResult.r1 = previousWrap.r1 * previousWrap.factor;
@@ -175,6 +175,40 @@ SimTK::Vec3 WrapEllipsoid::getRadii() const
 //=============================================================================
 // WRAPPING
 //=============================================================================
+//_____________________________________________________________________________
+/**
+ * Find the line segments that may wrap over the ellipsoid. Scaling each
+ * coordinate by the inverse of the ellipsoid's dimension turns the
+ * ellipsoid into the unit sphere, and wrapLine() returns noWrap if the
+ * scaled segment stays outside of that sphere. The segments within a small
+ * tolerance of the surface are left to wrapLine().
+ */
+void WrapEllipsoid::findLinesToWrap(int numPoints, const double* x,
+        const double* y, const double* z, char* mayWrap) const
+{
+    const SimTK::Vec3& dims = get_dimensions();
+    const double sx = 1.0 / dims[0];
+    const double sy = 1.0 / dims[1];
+    const double sz = 1.0 / dims[2];
+    const double limit = 1.0 + 1e-6;
+    for (int k = 0; k < numPoints - 1; k++) {
+        const double ax = x[k] * sx;
+        const double ay = y[k] * sy;
+        const double az = z[k] * sz;
+        const double dx = x[k + 1] * sx - ax;
+        const double dy = y[k + 1] * sy - ay;
+        const double dz = z[k + 1] * sz - az;
+        const double dd = dx * dx + dy * dy + dz * dz;
+        const double proj = -(ax * dx + ay * dy + az * dz);
+        double t = dd > 0.0 ? proj / dd : 0.0;
+        t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+        const double cx = ax + t * dx;
+        const double cy = ay + t * dy;
+        const double cz = az + t * dz;
+        mayWrap[k] = (cx * cx + cy * cy + cz * cz <= limit);
+    }
+}
+
 //_____________________________________________________________________________
 /**
  * Calculate the wrapping of one line segment over the ellipsoid.
@@ -200,7 +234,7 @@ int WrapEllipsoid::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::
     // In case you need any variables from the previous wrap, copy them from
     // the PathWrap into the WrapResult, re-normalizing the ones that were
     // un-normalized at the end of the previous wrap calculation.
-    const WrapResult& previousWrap = aPathWrap.getPreviousWrap();
+    const WrapResult& previousWrap = aPathWrap.getPreviousWrap(s);
     aWrapResult.factor = previousWrap.factor;
     for (i = 0; i < 3; i++)
     {
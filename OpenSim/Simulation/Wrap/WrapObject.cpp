@@ -30,6 +30,8 @@
 #include <OpenSim/Simulation/Model/PhysicalFrame.h>
 #include <OpenSim/Common/ScaleSet.h>
 
+#include <algorithm>
+
 
 //=============================================================================
 // STATICS
@@ -180,6 +182,41 @@ int WrapObject::wrapPathSegment(const SimTK::State& s,
    return return_code;
 }
 
+void WrapObject::findPathSegmentsToWrap(const SimTK::State& s,
+        const Array<AbstractPathPoint*>& path, int start, int end,
+        std::vector<char>& mayWrap) const
+{
+    const int numPoints = end - start + 1;
+    mayWrap.resize(std::max(numPoints - 1, 0));
+    if (numPoints < 2)
+        return;
+
+    // Store the points in the frame of the wrap object as separate arrays
+    // of x, y and z coordinates.
+    std::vector<double> coords(3 * numPoints);
+    double* x = coords.data();
+    double* y = x + numPoints;
+    double* z = y + numPoints;
+    for (int k = 0; k < numPoints; k++) {
+        const AbstractPathPoint& point = *path.get(start + k);
+        const Vec3 pt = _pose.shiftBaseStationToFrame(
+                point.getParentFrame().findStationLocationInAnotherFrame(
+                        s, point.getLocation(s), getFrame()));
+        x[k] = pt[0];
+        y[k] = pt[1];
+        z[k] = pt[2];
+    }
+
+    findLinesToWrap(numPoints, x, y, z, mayWrap.data());
+}
+
+void WrapObject::findLinesToWrap(int numPoints, const double* x,
+        const double* y, const double* z, char* mayWrap) const
+{
+    for (int k = 0; k < numPoints - 1; k++)
+        mayWrap[k] = 1;
+}
+
 void WrapObject::updateFromXMLNode(SimTK::Xml::Element& node,
         int versionNumber) {
     int documentVersion = versionNumber;
@@ -131,7 +131,39 @@ public:
                          const PathWrap& aPathWrap,
                          WrapResult& aWrapResult) const;
 
+/**
+* Determine which of the consecutive path segments between path[start] and
+* path[end] may wrap over this wrap object. The points are transformed into
+* the frame of the wrap object once, and all segments are tested together
+* (see findLinesToWrap()). If mayWrap[k] is 0, wrapPathSegment() would
+* return noWrap for the segment from path[start + k] to path[start + k + 1],
+* so it need not be called. The test is conservative: a segment for which
+* mayWrap[k] is 1 may still not wrap, and the wrapping of the segments that
+* may wrap is computed by wrapPathSegment(), one segment at a time.
+* @param state   The State of the model
+* @param path    The path points
+* @param start   The index of the first point in path
+* @param end     The index of the last point in path
+* @param mayWrap Resized to end - start, with one entry per segment
+*/
+    void findPathSegmentsToWrap(const SimTK::State& state,
+                                const Array<AbstractPathPoint*>& path,
+                                int start, int end,
+                                std::vector<char>& mayWrap) const;
+
 protected:
+    /**
+     * Test the line segments between consecutive points, whose coordinates
+     * in the frame of the wrap object are given by the arrays x, y and z of
+     * length numPoints. mayWrap[k] may only be set to 0 if wrapLine() would
+     * return noWrap for the segment from point k to point k + 1. The default
+     * sets all numPoints - 1 entries to 1; wrap objects with a closed-form
+     * test override it with a single loop over the segments.
+     */
+    virtual void findLinesToWrap(int numPoints, const double* x,
+                                 const double* y, const double* z,
+                                 char* mayWrap) const;
+
     virtual int wrapLine(const SimTK::State& state,
                          SimTK::Vec3& aPoint1, SimTK::Vec3& aPoint2,
                          const PathWrap& aPathWrap,
@@ -58,7 +58,9 @@ void WrapResult::copyData(const WrapResult& aWrapResult) {
     }
 
     singleWrap = aWrapResult.singleWrap;
-    // TODO: Should factor be omitted from the copy?
+    // The wrap objects use the factor to re-normalize the tangent points of
+    // the previous wrap (see PathWrap::getPreviousWrap()).
+    factor = aWrapResult.factor;
 }
 
 //=============================================================================
@@ -74,6 +74,12 @@ public:
     WrapResult(const WrapResult& other);
     WrapResult& operator=(const WrapResult& aWrapResult);
 
+    // Required for storing a WrapResult in a cache variable (see PathWrap).
+    friend std::ostream& operator<<(std::ostream& o, const WrapResult& wr) {
+        o << "WrapResult should not be serialized!" << std::endl;
+        return o;
+    }
+
 private:
     void copyData(const WrapResult& aWrapResult);
 
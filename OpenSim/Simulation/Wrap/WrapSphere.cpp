@@ -150,6 +150,34 @@ double WrapSphere::getRadius() const
 //=============================================================================
 // WRAPPING
 //=============================================================================
+//_____________________________________________________________________________
+/**
+ * Find the line segments that may wrap over the sphere. wrapLine() returns
+ * noWrap if the line through the points misses the sphere or does not enter
+ * it between the points, which is the case if the segment stays farther than
+ * the radius from the center. The segments within a small tolerance of the
+ * radius are left to wrapLine(), so that both tests agree despite round-off.
+ */
+void WrapSphere::findLinesToWrap(int numPoints, const double* x,
+        const double* y, const double* z, char* mayWrap) const
+{
+    const double limit = get_radius() * get_radius() * (1.0 + 1e-6);
+    for (int k = 0; k < numPoints - 1; k++) {
+        const double dx = x[k + 1] - x[k];
+        const double dy = y[k + 1] - y[k];
+        const double dz = z[k + 1] - z[k];
+        const double dd = dx * dx + dy * dy + dz * dz;
+        const double proj = -(x[k] * dx + y[k] * dy + z[k] * dz);
+        // Parameter of the point on the segment closest to the center.
+        double t = dd > 0.0 ? proj / dd : 0.0;
+        t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+        const double cx = x[k] + t * dx;
+        const double cy = y[k] + t * dy;
+        const double cz = z[k] + t * dz;
+        mayWrap[k] = (cx * cx + cy * cy + cz * cz <= limit);
+    }
+}
+
 //_____________________________________________________________________________
 /**
  * Calculate the wrapping of one line segment over the sphere.
@@ -180,7 +208,7 @@ int WrapSphere::wrapLine(const SimTK::State& s, SimTK::Vec3& aPoint1, SimTK::Vec
     // In case you need any variables from the previous wrap, copy them from
     // the PathWrap into the WrapResult, re-normalizing the ones that were
     // un-normalized at the end of the previous wrap calculation.
-    const WrapResult& previousWrap = aPathWrap.getPreviousWrap();
+    const WrapResult& previousWrap = aPathWrap.getPreviousWrap(s);
     aWrapResult.factor = previousWrap.factor;
     for (i = 0; i < 3; i++)
     {
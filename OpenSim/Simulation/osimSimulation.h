@@ -24,6 +24,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "Model/AnalysisSet.h"
+#include "Model/KinematicsSnapshot.h"
 #include "Model/Bhargava2004MuscleMetabolicsProbe.h"
 #include "Model/Bhargava2004SmoothedMuscleMetabolics.h"
 #include "Model/Model.h"
@@ -42,6 +43,7 @@
 #include "Model/ElasticFoundationForce.h"
 #include "Model/HuntCrossleyForce.h"
 #include "Model/SmoothSphereHalfSpaceForce.h"
+#include "Model/MultiSmoothSphereHalfSpaceForce.h"
 #include "Model/Ligament.h"
 #include "Model/Blankevoort1991Ligament.h"
 #include "Model/JointSet.h"
@@ -79,6 +81,7 @@
 #include "Control/ControlSetController.h"
 #include "Control/ControlConstant.h"
 #include "Control/ControlLinear.h"
+#include "Control/CompiledControlSet.h"
 #include "Control/PrescribedController.h"
 #include "Wrap/PathWrap.h"
 #include "Wrap/PathWrapSet.h"
@@ -123,6 +126,7 @@
 #include "Reference.h"
 #include "Solver.h"
 #include "StatesTrajectory.h"
+#include "CompactStatesTrajectory.h"
 #include "StatesTrajectoryReporter.h"
 #include "TableProcessor.h"
 #include "PositionMotion.h"
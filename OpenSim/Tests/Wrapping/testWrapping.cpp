@@ -48,6 +48,9 @@ public:
 
 void testWrapCylinder();
 void testWrapObjectUpdateFromXMLNode30515();
+void testPreviousWrapIsStoredInState();
+void testUsePreviousWrapMatchesColdStart();
+void testFindPathSegmentsToWrap();
 void simulate(Model& osimModel, State& si, double initialTime, double finalTime);
 void simulateModelWithMusclesNoViz(const string &modelFile, double finalTime, double activation=0.5);
 void simulateModelWithPassiveMuscles(const string &modelFile, double finalTime);
@@ -74,6 +77,27 @@ int main()
          failures.push_back("testWrapObjectUpdateFromXMLNode30515");
     }
 
+    try{
+        testPreviousWrapIsStoredInState();
+    } catch (const std::exception& e) {
+         std::cout << "Exception: " << e.what() << std::endl;
+         failures.push_back("testPreviousWrapIsStoredInState");
+    }
+
+    try{
+        testUsePreviousWrapMatchesColdStart();
+    } catch (const std::exception& e) {
+         std::cout << "Exception: " << e.what() << std::endl;
+         failures.push_back("testUsePreviousWrapMatchesColdStart");
+    }
+
+    try{
+        testFindPathSegmentsToWrap();
+    } catch (const std::exception& e) {
+         std::cout << "Exception: " << e.what() << std::endl;
+         failures.push_back("testFindPathSegmentsToWrap");
+    }
+
     if (!failures.empty()) {
         cout << "Done, with failure(s): " << failures << endl;
         return 1;
@@ -626,7 +650,7 @@ void simulateModelWithCables(const string &modelFile, double finalTime)
             }
             else { // next two path points should be a wrap point
                 for (int k = 0; k < wrapSet.getSize(); ++k) {
-                    const Vec3& wrapStartPointLoc = wrapSet[k].getPreviousWrap().r1;
+                    const Vec3& wrapStartPointLoc = wrapSet[k].getPreviousWrap(si).r1;
                     if (!wrapStartPointLoc.isInf() && pp->getLocation(si).isNumericallyEqual(wrapStartPointLoc)) {
                         ObstacleInfo* obs = wrapObs[k];
                         obs->isActive = true;
@@ -891,6 +915,184 @@ void simulate(Model& osimModel, State& si, double initialTime, double finalTime)
     states.print(osimModel.getName()+"_states_degrees.mot");
 } // end of simulate()
 
+// The result of the previous wrapping, used as an initial guess by the wrap
+// objects, is stored in the State. Evaluating the path for many states in any
+// order gives the same lengths as evaluating them in sequence.
+void testPreviousWrapIsStoredInState()
+{
+    Model model("test_wrapEllipsoid_vasint.osim");
+    State& s = model.initSystem();
+    const auto& coord = model.getCoordinateSet().get("knee_angle_r");
+    const auto& path = model.getMuscles().get(0).getGeometryPath();
+    SimTK_TEST(path.getWrapSet().getSize() > 0);
+
+    const int n = 10;
+    std::vector<double> values(n);
+    for (int i = 0; i < n; ++i) {
+        values[i] = coord.getRangeMin() +
+                i * (coord.getRangeMax() - coord.getRangeMin()) / (n - 1);
+    }
+
+    std::vector<double> lengths(n);
+    State sequential = s;
+    for (int i = 0; i < n; ++i) {
+        coord.setValue(sequential, values[i]);
+        model.realizePosition(sequential);
+        lengths[i] = path.getLength(sequential);
+    }
+
+    std::vector<State> states(n, s);
+    for (int i = n - 1; i >= 0; --i) {
+        coord.setValue(states[i], values[i]);
+        model.realizePosition(states[i]);
+        ASSERT_EQUAL<double>(lengths[i], path.getLength(states[i]), 1e-6);
+    }
+}
+
+// The path segments that WrapObject::findPathSegmentsToWrap() skips must be
+// those for which wrapPathSegment() returns noWrap.
+void testFindPathSegmentsToWrap()
+{
+    Model model;
+    model.setName("testFindPathSegmentsToWrap");
+    auto& ground = model.updGround();
+
+    auto body1 = new OpenSim::Body("body1", 1, Vec3(0), Inertia(0.01));
+    auto body2 = new OpenSim::Body("body2", 1, Vec3(0), Inertia(0.01));
+    model.addComponent(body1);
+    model.addComponent(body2);
+    model.addComponent(new FreeJoint("free1", ground, *body1));
+    model.addComponent(new FreeJoint("free2", ground, *body2));
+
+    auto sphere = new WrapSphere();
+    sphere->setName("sphere");
+    sphere->set_radius(0.1);
+    sphere->set_translation(Vec3(0.02, -0.03, 0.01));
+
+    auto constrainedSphere = new WrapSphere();
+    constrainedSphere->setName("constrained_sphere");
+    constrainedSphere->set_radius(0.12);
+    constrainedSphere->set_quadrant("+y");
+
+    auto cylinder = new WrapCylinder();
+    cylinder->setName("cylinder");
+    cylinder->set_radius(0.08);
+    cylinder->set_length(0.3);
+    cylinder->set_xyz_body_rotation(Vec3(0.3, -0.5, 0.2));
+
+    auto ellipsoid = new WrapEllipsoid();
+    ellipsoid->setName("ellipsoid");
+    ellipsoid->set_dimensions(Vec3(0.06, 0.1, 0.15));
+    ellipsoid->set_xyz_body_rotation(Vec3(-0.4, 0.1, 0.7));
+    ellipsoid->set_translation(Vec3(-0.02, 0.01, 0.03));
+
+    std::vector<WrapObject*> wrapObjects{sphere, constrainedSphere, cylinder,
+                                         ellipsoid};
+    std::vector<PathSpring*> springs;
+    for (auto* wo : wrapObjects) {
+        ground.addWrapObject(wo);
+        auto spring = new PathSpring("spring_" + wo->getName(), 1.0, 0.1, 0);
+        spring->updGeometryPath().
+            appendNewPathPoint("origin", *body1, Vec3(0.01, 0, 0));
+        spring->updGeometryPath().
+            appendNewPathPoint("insert", *body2, Vec3(0, -0.01, 0));
+        spring->updGeometryPath().addPathWrap(*wo);
+        model.addComponent(spring);
+        springs.push_back(spring);
+    }
+
+    State& s = model.initSystem();
+    Random::Uniform rand(-0.4, 0.4);
+    rand.setSeed(7);
+    std::vector<char> mayWrap;
+    for (size_t iw = 0; iw < wrapObjects.size(); ++iw) {
+        const WrapObject& wo = *wrapObjects[iw];
+        auto& path = springs[iw]->updGeometryPath();
+        const PathWrap& pathWrap = path.getWrapSet().get(0);
+        Array<AbstractPathPoint*> points;
+        points.append(&path.upd_PathPointSet().get(0));
+        points.append(&path.upd_PathPointSet().get(1));
+
+        int numSkipped = 0;
+        int numWrapped = 0;
+        for (int i = 0; i < 2000; ++i) {
+            for (int ic = 0; ic < model.getNumCoordinates(); ++ic) {
+                model.updCoordinateSet().get(ic).setValue(s, rand.getValue(),
+                        false);
+            }
+            model.realizePosition(s);
+
+            WrapResult wr;
+            wr.startPoint = 0;
+            wr.endPoint = 1;
+            wr.singleWrap = true;
+            const int action =
+                    wo.wrapPathSegment(s, *points[0], *points[1], pathWrap, wr);
+            wo.findPathSegmentsToWrap(s, points, 0, 1, mayWrap);
+            SimTK_TEST(mayWrap.size() == 1);
+            if (!mayWrap[0]) {
+                SimTK_TEST(action == WrapObject::noWrap);
+                ++numSkipped;
+            }
+            if (action == WrapObject::wrapped ||
+                    action == WrapObject::mandatoryWrap) {
+                ++numWrapped;
+            }
+        }
+        log_info("{}: {} segments wrapped, {} skipped.", wo.getName(),
+                numWrapped, numSkipped);
+        SimTK_TEST(numWrapped > 0);
+        SimTK_TEST(numSkipped > 0);
+    }
+}
+
+// Starting the wrapping calculations from the previous wrap (the
+// use_previous_wrap property of PathWrap) gives the same lengths and moment
+// arms over a motion as starting each calculation from scratch.
+void testUsePreviousWrapMatchesColdStart()
+{
+    for (const std::string modelFile : {"test_wrapEllipsoid_vasint.osim",
+                "test_wrapCylinder_vasint.osim"}) {
+        Model coldModel(modelFile);
+        Model warmModel(modelFile);
+        for (auto& muscle : warmModel.updComponentList<Muscle>()) {
+            auto& wrapSet = muscle.updGeometryPath().updWrapSet();
+            for (int k = 0; k < wrapSet.getSize(); ++k) {
+                SimTK_TEST(!wrapSet[k].get_use_previous_wrap());
+                wrapSet[k].set_use_previous_wrap(true);
+            }
+        }
+        State& coldState = coldModel.initSystem();
+        State& warmState = warmModel.initSystem();
+        const auto& coldCoord = coldModel.getCoordinateSet().get(
+                "knee_angle_r");
+        const auto& warmCoord = warmModel.getCoordinateSet().get(
+                "knee_angle_r");
+        const auto& coldPath = coldModel.getMuscles().get(0).getGeometryPath();
+        const auto& warmPath = warmModel.getMuscles().get(0).getGeometryPath();
+
+        // Sweep the knee back and forth.
+        const int n = 50;
+        for (int i = 0; i <= 2 * n; ++i) {
+            const double fraction = (i <= n ? i : 2 * n - i) / double(n);
+            const double value = coldCoord.getRangeMin() +
+                    fraction * (coldCoord.getRangeMax() -
+                            coldCoord.getRangeMin());
+            coldCoord.setValue(coldState, value);
+            warmCoord.setValue(warmState, value);
+            coldModel.realizePosition(coldState);
+            warmModel.realizePosition(warmState);
+            ASSERT_EQUAL<double>(coldPath.getLength(coldState),
+                    warmPath.getLength(warmState), 1e-6, __FILE__, __LINE__,
+                    modelFile + ": lengths differ.");
+            ASSERT_EQUAL<double>(
+                    coldPath.computeMomentArm(coldState, coldCoord),
+                    warmPath.computeMomentArm(warmState, warmCoord), 1e-5,
+                    __FILE__, __LINE__, modelFile + ": moment arms differ.");
+        }
+    }
+}
+
 // In XMLDocument version 30515, we converted VisibleObject, color and
 // display_preference properties to Appearance properties.
 void testWrapObjectUpdateFromXMLNode30515() {
@@ -141,13 +141,32 @@ prepareToOptimize(SimTK::State& s, double *x)
     f = 0;
     computePerformanceVectors(s, f, _accelPerformanceVector, _forcePerformanceVector);
 
-
-    for(int j=0; j<nf; j++) {
-        f[j] = 1;
+    // If the sensitivities of the task accelerations to the forces can be
+    // computed in one pass, only the stresses need another evaluation: the
+    // stress of an actuator depends only on its own force, so one evaluation
+    // with all forces set to 1 gives the diagonal of the force matrix.
+    CMC_TaskSet& taskSet = _controller->updTaskSet();
+    Matrix sensitivities;
+    if(taskSet.computeAccelerationSensitivities(s,
+                _controller->getActuatorSet(), sensitivities) &&
+            sensitivities.nrow()==nacc) {
+        const Array<double> &w = taskSet.getWeights();
+        for(int i=0; i<nacc; i++)
+            for(int j=0; j<nf; j++)
+                _accelPerformanceMatrix(i,j) = sqrt(w[i]) * sensitivities(i,j);
+        f = 1;
         computePerformanceVectors(s, f, accelVec, forceVec);
-        for(int i=0; i<nacc; i++) _accelPerformanceMatrix(i,j) = (accelVec[i] - _accelPerformanceVector[i]);
-        for(int i=0; i<nf; i++) _forcePerformanceMatrix(i,j) = (forceVec[i] - _forcePerformanceVector[i]);
-        f[j] = 0;
+        f = 0;
+        _forcePerformanceMatrix = 0;
+        for(int j=0; j<nf; j++) _forcePerformanceMatrix(j,j) = (forceVec[j] - _forcePerformanceVector[j]);
+    } else {
+        for(int j=0; j<nf; j++) {
+            f[j] = 1;
+            computePerformanceVectors(s, f, accelVec, forceVec);
+            for(int i=0; i<nacc; i++) _accelPerformanceMatrix(i,j) = (accelVec[i] - _accelPerformanceVector[i]);
+            for(int i=0; i<nf; i++) _forcePerformanceMatrix(i,j) = (forceVec[i] - _forcePerformanceVector[i]);
+            f[j] = 0;
+        }
     }
 
 #ifdef USE_LAPACK_DIRECT_SOLVE
@@ -131,11 +131,25 @@ prepareToOptimize(SimTK::State& s, double *x)
 
     computeConstraintVector(s, f, _constraintVector);
 
-    for(int j=0; j<nf; j++) {
-        f[j] = 1;
-        computeConstraintVector(s, f, c);
-        _constraintMatrix(j) = (c - _constraintVector);
-        f[j] = 0;
+    // The constraints are w*(aDes-a), so their sensitivities to the forces
+    // follow from those of the task accelerations if these can be computed
+    // in one pass; otherwise, compute the constraints for each unit force.
+    CMC_TaskSet& taskSet = _controller->updTaskSet();
+    Matrix sensitivities;
+    if(taskSet.computeAccelerationSensitivities(s,
+                _controller->getActuatorSet(), sensitivities) &&
+            sensitivities.nrow()==nc) {
+        const Array<double> &w = taskSet.getWeights();
+        for(int i=0; i<nc; i++)
+            for(int j=0; j<nf; j++)
+                _constraintMatrix(i,j) = -w[i]*sensitivities(i,j);
+    } else {
+        for(int j=0; j<nf; j++) {
+            f[j] = 1;
+            computeConstraintVector(s, f, c);
+            _constraintMatrix(j) = (c - _constraintVector);
+            f[j] = 0;
+        }
     }
 #endif
 
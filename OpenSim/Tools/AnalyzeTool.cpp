@@ -35,6 +35,8 @@
 #include <OpenSim/Simulation/Model/PrescribedForce.h>
 #include <OpenSim/Actuators/Thelen2003Muscle.h>
 
+#include <thread>
+
 using namespace OpenSim;
 using namespace std;
 
@@ -59,6 +61,7 @@ AnalyzeTool::AnalyzeTool() :
     _coordinatesFileName(_coordinatesFileNameProp.getValueStr()),
     _speedsFileName(_speedsFileNameProp.getValueStr()),
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _printResultFiles(true),
     _loadModelAndInput(false)
 {
@@ -79,6 +82,7 @@ AnalyzeTool::AnalyzeTool(const string &aFileName, bool aLoadModelAndInput) :
     _coordinatesFileName(_coordinatesFileNameProp.getValueStr()),
     _speedsFileName(_speedsFileNameProp.getValueStr()),
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _printResultFiles(true),
     _loadModelAndInput(aLoadModelAndInput)
 {
@@ -111,6 +115,7 @@ AnalyzeTool::AnalyzeTool(Model& aModel) :
     _coordinatesFileName(_coordinatesFileNameProp.getValueStr()),
     _speedsFileName(_speedsFileNameProp.getValueStr()),
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _printResultFiles(true),
     _loadModelAndInput(false)
 {
@@ -171,6 +176,7 @@ AnalyzeTool(const AnalyzeTool &aTool) :
     _coordinatesFileName(_coordinatesFileNameProp.getValueStr()),
     _speedsFileName(_speedsFileNameProp.getValueStr()),
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
+    _numThreads(_numThreadsProp.getValueInt()),
     _loadModelAndInput(false)
 {
     setNull();
@@ -191,6 +197,7 @@ setNull()
     _coordinatesFileName = "";
     _speedsFileName = "";
     _lowpassCutoffFrequency = -1.0;
+    _numThreads = 1;
 
     _statesStore = NULL;
 
@@ -236,6 +243,15 @@ void AnalyzeTool::setupProperties()
     _lowpassCutoffFrequencyProp.setName("lowpass_cutoff_frequency_for_coordinates");
     _propertySet.append( &_lowpassCutoffFrequencyProp );
 
+    comment = "Number of threads over which ranges of states are distributed, each with its own copy of the model "
+                 "and the analyses. The states are analyzed in parallel only if all the analyses that are on record "
+                 "each state independently of the others (e.g., Kinematics, BodyKinematics, PointKinematics and "
+                 "JointReaction). A value less than 1 uses the number of cores. The default value is 1.";
+    _numThreadsProp.setComment(comment);
+    _numThreadsProp.setName("num_threads");
+    _numThreadsProp.setValue(1);
+    _propertySet.append( &_numThreadsProp );
+
 }
 
 
@@ -259,6 +275,7 @@ operator=(const AnalyzeTool &aTool)
     _coordinatesFileName = aTool._coordinatesFileName;
     _speedsFileName = aTool._speedsFileName;
     _lowpassCutoffFrequency= aTool._lowpassCutoffFrequency;
+    _numThreads = aTool._numThreads;
     _statesStore = aTool._statesStore;
     _printResultFiles = aTool._printResultFiles;
     return(*this);
@@ -557,6 +574,7 @@ bool AnalyzeTool::run(bool plotting)
 
 
     bool completed = true;
+    bool releasedCwd = false;
 
     try {
 
@@ -590,7 +608,16 @@ bool AnalyzeTool::run(bool plotting)
     //}
 
     log_info("Executing the analyses from {} to {}...", ti, tf);
-    run(s, *_model, iInitial, iFinal, *_statesStore, _solveForEquilibriumForAuxiliaryStates);
+    if(_numThreads != 1 && analysisSet.getRecordsStatesIndependently()) {
+        // The working directory is shared by all threads, so do not hold it
+        // while the other threads analyze the states.
+        cwd.restore();
+        releasedCwd = true;
+        runInParallel(s, *_model, iInitial, iFinal, *_statesStore,
+                _solveForEquilibriumForAuxiliaryStates, _numThreads);
+    } else {
+        run(s, *_model, iInitial, iFinal, *_statesStore, _solveForEquilibriumForAuxiliaryStates);
+    }
     _model->getMultibodySystem().realize(s, SimTK::Stage::Position );
     } catch (const Exception& x) {
         x.print(cout);
@@ -600,6 +627,8 @@ bool AnalyzeTool::run(bool plotting)
 
     // PRINT RESULTS
     // TODO: give option to write partial results if not completed
+    if (releasedCwd && getDocument() != nullptr)
+        cwd = IO::CwdChanger::changeToParentOf(getDocumentFileName());
     if (completed && _printResultFiles)
         printResults(getName(),getResultsDir()); // this will create results directory if necessary
 
@@ -613,20 +642,17 @@ bool AnalyzeTool::run(bool plotting)
 //=============================================================================
 // HELPER
 //=============================================================================
-void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium)
+namespace {
+// Set the state to the rows iFirst to iLast of the states storage and call
+// the callbacks of the analysis set for each: begin() at iFirst, end() at
+// iEnd and step() otherwise. State variables that are not in the storage
+// keep the values in stateValues.
+void analyzeStates(SimTK::State& s, Model& aModel, AnalysisSet& analysisSet,
+        int iFirst, int iLast, int iEnd, const Storage& aStatesStore,
+        bool aSolveForEquilibrium, SimTK::Vector stateValues)
 {
-    AnalysisSet& analysisSet = aModel.updAnalysisSet();
-
-    for(int i=0;i<analysisSet.getSize();i++) {
-        analysisSet.get(i).setStatesStore(aStatesStore);
-    }
-
-
     // PERFORM THE ANALYSES
-    double /*tPrev=0.0,*/t=0.0/*,dt=0.0*/;
-    int ny = s.getNY();
-    Array<double> dydt(0.0,ny);
-    Array<double> yFromStorage(0.0,ny);
+    double t=0.0;
 
     const Array<string>& labels =  aStatesStore.getColumnLabels();
     int numOpenSimStates = labels.getSize()-1;
@@ -655,16 +681,7 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
         }
     }
 
-    // It is possible that there are internal states or that future modeling
-    // choices add state variables that are not known to the modeler/user.
-    // In which case we rely on the model to supply reasonable defaults and
-    // assume all the important/necessary state values for running an analysis
-    // are provided by the Storage. Here we initialize the state values to their
-    // model defaults.
-    SimTK::Vector stateValues = aModel.getStateVariableValues(s);
-
-    for(int i=iInitial;i<=iFinal;i++) {
-        // tPrev = t;
+    for(int i=iFirst;i<=iLast;i++) {
         aStatesStore.getTime(i,s.updTime()); // time
         t = s.getTime();
         aModel.setAllControllersEnabled(true);
@@ -697,9 +714,9 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
         // Make sure model is at least ready to provide kinematics
         aModel.getMultibodySystem().realize(s, SimTK::Stage::Velocity);
 
-        if(i==iInitial) {
+        if(i==iFirst) {
             analysisSet.begin(s);
-        } else if(i==iFinal) {
+        } else if(i==iEnd) {
             analysisSet.end(s);
         // Step
         } else {
@@ -707,3 +724,116 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
         }
     }
 }
+} // anonymous namespace
+
+void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium)
+{
+    AnalysisSet& analysisSet = aModel.updAnalysisSet();
+
+    for(int i=0;i<analysisSet.getSize();i++) {
+        analysisSet.get(i).setStatesStore(aStatesStore);
+    }
+
+    // It is possible that there are internal states or that future modeling
+    // choices add state variables that are not known to the modeler/user.
+    // In which case we rely on the model to supply reasonable defaults and
+    // assume all the important/necessary state values for running an analysis
+    // are provided by the Storage. Here we initialize the state values to their
+    // model defaults.
+    analyzeStates(s, aModel, analysisSet, iInitial, iFinal, iFinal,
+            aStatesStore, aSolveForEquilibrium,
+            aModel.getStateVariableValues(s));
+}
+//_____________________________________________________________________________
+/**
+ * Analyze contiguous ranges of the states on separate threads.
+ */
+void AnalyzeTool::runInParallel(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium, int aNumThreads)
+{
+    AnalysisSet& analysisSet = aModel.updAnalysisSet();
+    const int numStates = iFinal - iInitial + 1;
+    int numThreads = aNumThreads;
+    if(numThreads < 1)
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    numThreads = std::min(numThreads, numStates);
+    if(numThreads > 1 && !analysisSet.getRecordsStatesIndependently()) {
+        log_info("AnalyzeTool: an analysis records states that depend on "
+                 "earlier states, so the states are analyzed on one thread.");
+        numThreads = 1;
+    }
+    if(numThreads <= 1) {
+        run(s, aModel, iInitial, iFinal, aStatesStore, aSolveForEquilibrium);
+        return;
+    }
+
+    for(int i=0;i<analysisSet.getSize();i++) {
+        analysisSet.get(i).setStatesStore(aStatesStore);
+    }
+    // The other threads use the values of the state variables that are not
+    // in the storage from this state, as run() does.
+    const SimTK::Vector stateValues = aModel.getStateVariableValues(s);
+
+    // Copy the model, with its analyses, for the other threads. The copies
+    // are initialized here, since initSystem() is not thread-safe.
+    struct Worker {
+        std::unique_ptr<Model> model;
+        SimTK::State* state = nullptr;
+    };
+    std::vector<Worker> workers(numThreads - 1);
+    for(auto& worker : workers) {
+        worker.model.reset(aModel.clone());
+        worker.state = &worker.model->initSystem();
+        AnalysisSet& copies = worker.model->updAnalysisSet();
+        OPENSIM_THROW_IF(copies.getSize() != analysisSet.getSize(), Exception,
+                "Expected the copy of the model to have {} analyses, but it "
+                "has {}.", analysisSet.getSize(), copies.getSize());
+        for(int i=0;i<copies.getSize();i++) {
+            copies.get(i).setStatesStore(aStatesStore);
+        }
+    }
+
+    std::vector<std::exception_ptr> errors(numThreads);
+    auto analyzeRange = [&](int ithread) {
+        const int iFirst = iInitial + ithread * numStates / numThreads;
+        const int iLast = iInitial + (ithread + 1) * numStates / numThreads - 1;
+        try {
+            if(ithread == 0) {
+                analyzeStates(s, aModel, analysisSet, iFirst, iLast, iFinal,
+                        aStatesStore, aSolveForEquilibrium, stateValues);
+            } else {
+                Worker& worker = workers[ithread - 1];
+                analyzeStates(*worker.state, *worker.model,
+                        worker.model->updAnalysisSet(), iFirst, iLast, iFinal,
+                        aStatesStore, aSolveForEquilibrium, stateValues);
+            }
+        } catch (...) {
+            errors[ithread] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    for(int ithread=1; ithread<numThreads; ithread++)
+        threads.emplace_back(analyzeRange, ithread);
+    analyzeRange(0);
+    for(auto& thread : threads) thread.join();
+    for(const auto& error : errors)
+        if(error) std::rethrow_exception(error);
+
+    // Append the results of the other ranges, in order of time.
+    for(const auto& worker : workers) {
+        AnalysisSet& copies = worker.model->updAnalysisSet();
+        for(int i=0;i<analysisSet.getSize();i++) {
+            Analysis& analysis = analysisSet.get(i);
+            if(!analysis.getOn()) continue;
+            ArrayPtrs<Storage>& storages = analysis.getStorageList();
+            ArrayPtrs<Storage>& results = copies.get(i).getStorageList();
+            OPENSIM_THROW_IF(storages.getSize() != results.getSize(), Exception,
+                    "Expected the copy of analysis '{}' to have {} storages, "
+                    "but it has {}.",
+                    analysis.getName(), storages.getSize(), results.getSize());
+            for(int j=0;j<storages.getSize();j++) {
+                for(int r=0;r<results[j]->getSize();r++)
+                    storages[j]->append(*results[j]->getStateVector(r));
+            }
+        }
+    }
+}
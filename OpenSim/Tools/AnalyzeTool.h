@@ -68,6 +68,10 @@ private:
     /** Low-pass cut-off frequency for filtering the coordinates (does not apply to states). */
     PropertyDbl _lowpassCutoffFrequencyProp;
     double &_lowpassCutoffFrequency;
+    /** Number of threads over which ranges of states are distributed, each
+    with its own copy of the model and the analyses. */
+    PropertyInt _numThreadsProp;
+    int &_numThreads;
 
     /** Storage for the model states. */
     Storage *_statesStore;
@@ -120,6 +124,12 @@ public:
     double getLowpassCutoffFrequency() const { return _lowpassCutoffFrequency; }
     void setLowpassCutoffFrequency(double aLowpassCutoffFrequency) { _lowpassCutoffFrequency = aLowpassCutoffFrequency; }
     bool getLoadModelAndInput() const { return _loadModelAndInput; }
+    /** Set the number of threads that analyze the states; a value less than 1
+     * uses the number of cores. The default is 1. The states are analyzed in
+     * parallel only if all the analyses that are on record each state
+     * independently (see AnalysisSet::getRecordsStatesIndependently()). */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
     void setLoadModelAndInput(bool b) { _loadModelAndInput = b; }
 
     //--------------------------------------------------------------------------
@@ -141,6 +151,15 @@ public:
     //--------------------------------------------------------------------------
 #ifndef SWIG
     static void run(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium);
+    /** Same as run(), but split the states into contiguous ranges, one per
+     * thread. The other threads use copies of the model and its analyses,
+     * which begin at the first state of their range, and the
+     * rows of the storages of the copies (see Analysis::getStorageList())
+     * are appended to those of the analyses of the model in order of time.
+     * If an analysis that is on does not record states independently, this
+     * calls run(). run(bool) does not hold the working directory (see
+     * IO::CwdChanger) while it calls this. */
+    static void runInParallel(SimTK::State& s, Model &aModel, int iInitial, int iFinal, const Storage &aStatesStore, bool aSolveForEquilibrium, int aNumThreads);
 #endif
 //=============================================================================
 };  // END of class AnalyzeTool
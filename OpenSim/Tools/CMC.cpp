@@ -32,6 +32,7 @@
 #include "CMC.h"
 #include "VectorFunctionForActuators.h"
 #include <OpenSim/Common/RootSolver.h>
+#include <OpenSim/Common/Stopwatch.h>
 #include <OpenSim/Simulation/Control/ControlConstant.h>
 #include <OpenSim/Simulation/Control/ControlLinear.h>
 #include <OpenSim/Tools/CMC_Joint.h>
@@ -156,6 +157,7 @@ void CMC::copyData( const CMC &aCmc )
    _verbose               = aCmc._verbose;
    _predictor             = aCmc._predictor;
    _f                     = aCmc._f;
+   _fBoundStatus          = aCmc._fBoundStatus;
    _taskSet               = aCmc._taskSet;
 
 }
@@ -706,6 +708,8 @@ restoreConfiguration(SimTK::State& s, const SimTK::State& initialState)
 void CMC::
 computeControls(SimTK::State& s, ControlSet &controlSet)
 {
+    Stopwatch intervalWatch;
+
     // CONTROLS SHOULD BE RECOMPUTED- NEED A NEW TARGET TIME
     _tf = s.getTime() + _targetDT;
 
@@ -847,6 +851,7 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     }
 
     // COMPUTE BOUNDS ON MUSCLE FORCES
+    Stopwatch boundsWatch;
     Array<double> zero(0.0,N);
     Array<double> fmin(0.0,N),fmax(0.0,N);
     _predictor->setInitialTime(tiReal);
@@ -856,6 +861,7 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     _predictor->evaluate(s, &xmax[0], &fmax[0]);
 
     SimTK::State newState = _predictor->getCMCActSubsys()->getCompleteState();
+    const double boundsTime = boundsWatch.getElapsedTime();
     
      if(_verbose) {
         log_info("tiReal = {}, tfReal = {}", tiReal, tfReal);
@@ -901,9 +907,20 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     _target->setParameterLimits(lowerBounds, upperBounds);
 
     // OPTIMIZER ERROR TRAP
+    // Start from the solution of the last interval, with the forces that
+    // were at their bounds at the new bounds.
     _f.setSize(N);
+    _fBoundStatus.setSize(N);
+    for(i=0;i<N;i++) {
+        if(_fBoundStatus[i]<0 || _f[i]<lowerBounds[i]) _f[i] = lowerBounds[i];
+        else if(_fBoundStatus[i]>0 || _f[i]>upperBounds[i]) _f[i] = upperBounds[i];
+    }
 
-    if(!_target->prepareToOptimize(newState, &_f[0])) {
+    Stopwatch targetWatch;
+    const bool solvedDirectly = _target->prepareToOptimize(newState, &_f[0]);
+    const double targetTime = targetWatch.getElapsedTime();
+    Stopwatch optimizerWatch;
+    if(!solvedDirectly) {
         // No direct solution, need to run optimizer
         Vector fVector(N,&_f[0],true);
 
@@ -930,6 +947,14 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     } else {
         // Got a direct solution, don't need to run optimizer
     }
+    const double optimizerTime = optimizerWatch.getElapsedTime();
+
+    for(i=0;i<N;i++) {
+        const double boundTol = 1.0e-6 * (1.0 + upperBounds[i] - lowerBounds[i]);
+        if(_f[i] <= lowerBounds[i] + boundTol) _fBoundStatus[i] = -1;
+        else if(_f[i] >= upperBounds[i] - boundTol) _fBoundStatus[i] = 1;
+        else _fBoundStatus[i] = 0;
+    }
 
     if(_verbose) _target->printPerformance(&_f[0]);
 
@@ -940,12 +965,14 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
 
 
     // ROOT SOLVE FOR EXCITATIONS
+    Stopwatch rootWatch;
     _predictor->setTargetForces(&_f[0]);
     RootSolver rootSolver(_predictor);
     Array<double> tol(4.0e-3,N);
     Array<double> fErrors(0.0,N);
     Array<double> controls(0.0,N);
     controls = rootSolver.solve(s, xmin,xmax,tol);
+    const double rootTime = rootWatch.getElapsedTime();
     if(_verbose) {
         log_info("CMC::computeControls, root solve (tFinal = {}):", _tf);
         log_info(" -- controls = {}", _tf, controls);
@@ -959,6 +986,11 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     controlSet.setControlValues(_tf,&controls[0]);
 
     _model->updAnalysisSet().setOn(true);
+
+    log_info("CMC::computeControls, t = {}: {:.3g} s (force bounds {:.3g} s, "
+             "optimization target {:.3g} s, optimizer {:.3g} s, root solve "
+             "{:.3g} s).", tiReal, intervalWatch.getElapsedTime(), boundsTime,
+            targetTime, optimizerTime, rootTime);
 }
 
 //_____________________________________________________________________________
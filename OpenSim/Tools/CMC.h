@@ -134,6 +134,10 @@ protected:
     VectorFunctionForActuators *_predictor;
     /** Array of actuator forces for achieving the desired accelerations. */
     Array<double> _f;
+    /** For each actuator force, -1 or 1 if it was at its lower or upper
+    bound in the last solution, and 0 otherwise. The next optimization
+    starts from the last solution with the same forces at their bounds. */
+    Array<int> _fBoundStatus;
 
 
 //=============================================================================
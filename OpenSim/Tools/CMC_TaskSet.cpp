@@ -29,7 +29,11 @@
 // INCLUDES
 //=============================================================================
 #include "CMC_TaskSet.h"
+#include "CMC_Joint.h"
 #include "StateTrackingTask.h"
+#include <OpenSim/Actuators/CoordinateActuator.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/Muscle.h>
 
 
 using namespace std;
@@ -936,4 +940,107 @@ computeAccelerations(const SimTK::State& s)
     //printf("track goals are active.\n");
 }
 
+//_____________________________________________________________________________
+/**
+ * Compute the sensitivities of the task accelerations to the actuator
+ * forces.
+ *
+ * The accelerations satisfy M udot + ~G lambda = f and G udot = b, so the
+ * change in udot due to a change f in the applied generalized forces is
+ * M^-1 (f - ~G lambda), with (G M^-1 ~G) lambda = G M^-1 f.
+ */
+bool CMC_TaskSet::
+computeAccelerationSensitivities(const SimTK::State& s,
+        const Set<const Actuator>& aActuators,
+        SimTK::Matrix& rSensitivities) const
+{
+    if(_model==NULL) return false;
+    const SimTK::SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+
+    // The generalized speed whose derivative is each task acceleration.
+    std::vector<int> taskSpeeds;
+    for(int i=0;i<getSize();i++) {
+        const CMC_Task* task = dynamic_cast<const CMC_Task*>(&get(i));
+        if(task==NULL) continue;
+        const CMC_Joint* joint = dynamic_cast<const CMC_Joint*>(task);
+        for(int j=0;j<3;j++) {
+            if(!task->getActive(j)) continue;
+            if(joint==NULL || j>0) return false;
+            const Coordinate& coord =
+                    _model->getCoordinateSet().get(joint->getCoordinateName());
+            const SimTK::MobilizedBody& mobod =
+                    matter.getMobilizedBody(coord.getBodyIndex());
+            // A coordinate is both a q and a u of its mobilizer only if the
+            // mobilizer does not use quaternions.
+            if(mobod.getNumQ(s)!=mobod.getNumU(s)) return false;
+            taskSpeeds.push_back(
+                    mobod.getFirstUIndex(s) + coord.getMobilizerQIndex());
+        }
+    }
 
+    _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+    matter.realizeArticulatedBodyInertias(s);
+
+    // Accelerations due to a unit force of each actuator, ignoring the
+    // constraints.
+    const int nu = s.getNU();
+    const int na = aActuators.getSize();
+    SimTK::Matrix udots(nu, na);
+    SimTK::Vector_<SimTK::SpatialVec> bodyForces(matter.getNumBodies());
+    SimTK::Vector mobilityForces(nu), generalizedForces(nu), udot(nu);
+    for(int j=0;j<na;j++) {
+        const Actuator& actuator = aActuators[j];
+        bodyForces.setToZero();
+        mobilityForces.setToZero();
+        const CoordinateActuator* coordActuator =
+                dynamic_cast<const CoordinateActuator*>(&actuator);
+        const PathActuator* pathActuator =
+                dynamic_cast<const PathActuator*>(&actuator);
+        if(coordActuator) {
+            const Coordinate* coord = coordActuator->getCoordinate();
+            if(coord==NULL) return false;
+            const SimTK::MobilizedBody& mobod =
+                    matter.getMobilizedBody(coord->getBodyIndex());
+            if(mobod.getNumQ(s)!=mobod.getNumU(s)) return false;
+            matter.addInMobilityForce(s, coord->getBodyIndex(),
+                    SimTK::MobilizerUIndex(coord->getMobilizerQIndex()), 1.0,
+                    mobilityForces);
+        } else if(pathActuator && (dynamic_cast<const Muscle*>(&actuator) ||
+                actuator.getConcreteClassName()=="PathActuator")) {
+            // The overridden force is the tension in the path.
+            pathActuator->getGeometryPath().addInEquivalentForces(s, 1.0,
+                    bodyForces, mobilityForces);
+        } else {
+            return false;
+        }
+        matter.multiplyBySystemJacobianTranspose(s, bodyForces,
+                generalizedForces);
+        generalizedForces += mobilityForces;
+        matter.multiplyByMInv(s, generalizedForces, udot);
+        udots(j) = udot;
+    }
+
+    // Project out the constraint forces.
+    const int nm = s.getNMultipliers();
+    if(nm>0) {
+        SimTK::Matrix G;
+        matter.calcG(s, G);
+        SimTK::Matrix MInvGt(nu, nm);
+        SimTK::Vector g(nu);
+        for(int i=0;i<nm;i++) {
+            g = ~G[i];
+            matter.multiplyByMInv(s, g, udot);
+            MInvGt(i) = udot;
+        }
+        SimTK::FactorQTZ GMInvGt(G * MInvGt);
+        SimTK::Matrix lambdas;
+        GMInvGt.solve(G * udots, lambdas);
+        udots -= MInvGt * lambdas;
+    }
+
+    rSensitivities.resize((int)taskSpeeds.size(), na);
+    for(int i=0;i<(int)taskSpeeds.size();i++) {
+        rSensitivities[i] = udots[taskSpeeds[i]];
+    }
+    return true;
+}
@@ -33,6 +33,7 @@
 
 namespace OpenSim {
 
+class Actuator;
 class Model;
 
 //=============================================================================
@@ -154,6 +155,25 @@ public:
     void computeDesiredAccelerations(const SimTK::State& s, double aT);
     void computeDesiredAccelerations(const SimTK::State& s, double aTCurrent,double aTFuture);
     void computeAccelerations(const SimTK::State& s );
+    /** Compute the change in the accelerations of the active task functions
+     * (see getAccelerations()) per unit force of each actuator, at the state
+     * s, which must be realized to the Velocity stage with the forces of the
+     * actuators overridden. The accelerations are linear in the actuator
+     * forces, so this is the matrix obtained by calling
+     * computeAccelerations() with each actuator force set to 1 in turn, to
+     * within roundoff, but the model is not realized for each actuator: the
+     * generalized force of each actuator is mapped to accelerations with
+     * the articulated-body inertias computed once, and the constraints of
+     * the model are accounted for with one factorization. Only joint tasks
+     * (CMC_Joint) and muscles, PathActuators and CoordinateActuators are
+     * supported, and the coordinates of the tasks and CoordinateActuators
+     * must not belong to joints that use quaternions (e.g., a BallJoint or
+     * FreeJoint, unless the state uses Euler angles).
+     * @returns false, without changing rSensitivities, if a task or an
+     * actuator is not supported. */
+    bool computeAccelerationSensitivities(const SimTK::State& s,
+            const Set<const Actuator>& aActuators,
+            SimTK::Matrix& rSensitivities) const;
 
 
 //=============================================================================
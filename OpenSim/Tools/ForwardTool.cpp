@@ -144,6 +144,7 @@ void ForwardTool::setNull()
     _statesFileName = "";
     _useSpecifiedDt = false;
     _printResultFiles = true;
+    _streamResultsNumRowsPerBlock = 0;
 
     _replaceForceSet = false;   // default should be false for Forward.
 
@@ -305,6 +306,8 @@ bool ForwardTool::run()
         log_info("Integrating from {} to {}.", _ti, _tf);
         s.setTime(_ti);
         manager.initialize(s);
+        if (_printResultFiles && _streamResultsNumRowsPerBlock > 0)
+            streamResults(manager);
         manager.integrate(_tf);
     } catch(const std::exception& x) {
         log_error("ForwardTool::run() caught an exception: \n {}", x.what());
@@ -341,9 +344,31 @@ void ForwardTool::printResultsInternal()
     // so that the parsing code behaves properly if called from a different directory.
     auto cwd = IO::CwdChanger::changeToParentOf(getDocumentFileName());
 
+    // Write the rows that are still in memory to the streamed files. The
+    // analyses do not write the storages that were streamed.
+    Storage& stateStorage = getManager().getStateStorage();
+    const bool streamed = !stateStorage.getStreamingOutputFileName().empty();
+    if (streamed) {
+        stateStorage.closeStreamingOutput();
+        if (_model) {
+            AnalysisSet& analyses = _model->updAnalysisSet();
+            for (int i = 0; i < analyses.getSize(); ++i) {
+                ArrayPtrs<Storage>& storages = analyses.get(i).getStorageList();
+                for (int j = 0; j < storages.getSize(); ++j)
+                    storages.get(j)->closeStreamingOutput();
+            }
+        }
+    }
+
     AbstractTool::printResults(getName(),getResultsDir()); // this will create results directory if necessary
     if (_model) {
         _model->printControlStorage(getResultsDir() + "/" + getName() + "_controls.sto");
+        if (streamed) {
+            log_info("The states were written to '{}' during the integration; "
+                     "not writing them in degrees.",
+                    stateStorage.getStreamingOutputFileName());
+            return;
+        }
         getManager().getStateStorage().print(getResultsDir() + "/" + getName() + "_states.sto");
 
         Storage statesDegrees(getManager().getStateStorage());
@@ -355,6 +380,33 @@ void ForwardTool::printResultsInternal()
 
 
 
+//_____________________________________________________________________________
+/**
+ * Write the states and the storages of the analyses to the results directory
+ * as the integration proceeds. The analyses have created their storages by
+ * the time the manager is initialized.
+ */
+void ForwardTool::streamResults(Manager& manager)
+{
+    IO::makeDir(getResultsDir());
+    const std::string prefix = getResultsDir() + "/" + getName() + "_";
+    const int numRowsPerBlock = _streamResultsNumRowsPerBlock;
+    manager.getStateStorage().setStreamingOutputFileName(
+            prefix + "states.sto", numRowsPerBlock);
+
+    AnalysisSet& analyses = _model->updAnalysisSet();
+    for (int i = 0; i < analyses.getSize(); ++i) {
+        Analysis& analysis = analyses.get(i);
+        if (!analysis.getOn()) continue;
+        ArrayPtrs<Storage>& storages = analysis.getStorageList();
+        for (int j = 0; j < storages.getSize(); ++j) {
+            Storage& storage = *storages.get(j);
+            storage.setStreamingOutputFileName(prefix + analysis.getName() +
+                    "_" + storage.getName() + ".sto", numRowsPerBlock);
+        }
+    }
+}
+
 //=============================================================================
 // UTILITY
 //=============================================================================
@@ -75,6 +75,9 @@ protected:
     Storage *_yStore;
     /** Flag indicating whether or not to write to the results (GUI will set this to false). */
     bool _printResultFiles;
+    /** If positive, the states and analysis results are written to files
+    during the integration, in blocks of this many rows. */
+    int _streamResultsNumRowsPerBlock;
 
     /** pointer to the simulation Manager */
     Manager* _manager;
@@ -121,6 +124,22 @@ public:
     void setUseSpecifiedDt(bool aUseSpecifiedDt) { _useSpecifiedDt = aUseSpecifiedDt; }
 
     void setPrintResultFiles(bool aToWrite) { _printResultFiles = aToWrite; }
+    /** Write the states and the results of the analyses to the results
+    directory as the integration proceeds, rather than keeping them in memory
+    until the end of the integration (see
+    Storage::setStreamingOutputFileName()). This keeps the memory used by
+    long simulations constant and preserves the results computed before an
+    integration fails. The states are written to <name>_states.sto and each
+    storage of an analysis (see Analysis::getStorageList()) to
+    <name>_<analysis name>_<storage name>.sto; these results are then not
+    written again at the end of the integration, and the states are not
+    written in degrees. The controls are still written at the end. Has no
+    effect if setPrintResultFiles(false) was called.
+    @param aNumRowsPerBlock Number of rows written at once (0 to disable
+    streaming). */
+    void setStreamResults(int aNumRowsPerBlock)
+    {   _streamResultsNumRowsPerBlock = aNumRowsPerBlock; }
+    int getStreamResults() const { return _streamResultsNumRowsPerBlock; }
 
     //--------------------------------------------------------------------------
     // INTERFACE
@@ -131,6 +150,7 @@ public:
     void printResults();
 private:
     void printResultsInternal();
+    void streamResults(Manager& manager);
 public:
 
     //--------------------------------------------------------------------------
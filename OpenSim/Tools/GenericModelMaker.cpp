@@ -164,14 +164,8 @@ Model* GenericModelMaker::processModel(const string& aPathToSubject) const
         model = new Model(modelPath);
         model->initSystem();
 
-        if (!_markerSetFileNameProp.getValueIsDefault() && _markerSetFileName !="Unassigned") {
-            log_info("Loading marker set from '{}'.", 
-                aPathToSubject + _markerSetFileName);
-            std::string markerSetPath = 
-                SimTK::Pathname::getAbsolutePathnameUsingSpecifiedWorkingDirectory(aPathToSubject, _markerSetFileName);
-            MarkerSet *markerSet = new MarkerSet(markerSetPath);
-            model->updateMarkerSet(*markerSet);
-        }
+        std::unique_ptr<MarkerSet> markerSet(loadMarkerSet(aPathToSubject));
+        if (markerSet) model->updateMarkerSet(*markerSet);
     }
     catch (const Exception& x)
     {
@@ -181,3 +175,21 @@ Model* GenericModelMaker::processModel(const string& aPathToSubject) const
 
     return model;
 }
+
+//_____________________________________________________________________________
+/**
+ * Read the marker set file, if one is specified.
+ *
+ * @return Pointer to the MarkerSet that is read, or NULL.
+ */
+MarkerSet* GenericModelMaker::loadMarkerSet(const string& aPathToSubject) const
+{
+    if (_markerSetFileNameProp.getValueIsDefault() || _markerSetFileName == "Unassigned")
+        return NULL;
+
+    log_info("Loading marker set from '{}'.", 
+        aPathToSubject + _markerSetFileName);
+    std::string markerSetPath = 
+        SimTK::Pathname::getAbsolutePathnameUsingSpecifiedWorkingDirectory(aPathToSubject, _markerSetFileName);
+    return new MarkerSet(markerSetPath);
+}
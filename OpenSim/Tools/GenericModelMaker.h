@@ -38,6 +38,7 @@
 
 namespace OpenSim {
 
+class MarkerSet;
 class Model;
 
 //=============================================================================
@@ -81,6 +82,11 @@ public:
     void copyData(const GenericModelMaker &aGenericModelMaker);
 
     Model* processModel(const std::string& aPathToSubject="") const;
+    /**
+     * Load the marker set file, whose name is relative to aPathToSubject.
+     * Returns null if no marker set file is specified.
+     */
+    MarkerSet* loadMarkerSet(const std::string& aPathToSubject="") const;
 
     /* Register types to be used when reading a GenericModelMaker object from xml file. */
     static void registerTypes();
@@ -63,7 +63,8 @@ InverseDynamicsTool::InverseDynamicsTool() : DynamicsTool(),
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
     _outputGenForceFileName(_outputGenForceFileNameProp.getValueStr()),
     _jointsForReportingBodyForces(_jointsForReportingBodyForcesProp.getValueStrArray()),
-    _outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr())
+    _outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
 }
@@ -82,7 +83,8 @@ InverseDynamicsTool::InverseDynamicsTool(const string &aFileName, bool aLoadMode
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
     _outputGenForceFileName(_outputGenForceFileNameProp.getValueStr()),
     _jointsForReportingBodyForces(_jointsForReportingBodyForcesProp.getValueStrArray()),
-    _outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr())
+    _outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
     updateFromXMLDocument();
@@ -104,7 +106,8 @@ InverseDynamicsTool::InverseDynamicsTool(const InverseDynamicsTool &aTool) :
     _lowpassCutoffFrequency(_lowpassCutoffFrequencyProp.getValueDbl()),
     _outputGenForceFileName(_outputGenForceFileNameProp.getValueStr()),
     _jointsForReportingBodyForces(_jointsForReportingBodyForcesProp.getValueStrArray()),
-    _outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr())
+    _outputBodyForcesAtJointsFileName(_outputBodyForcesAtJointsFileNameProp.getValueStr()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
     *this = aTool;
@@ -120,6 +123,7 @@ void InverseDynamicsTool::setNull()
     _model = NULL;
     _lowpassCutoffFrequency = -1.0;
     _coordinateValues = NULL;
+    _numThreads = 1;
 }
 //_____________________________________________________________________________
 /**
@@ -156,6 +160,16 @@ void InverseDynamicsTool::setupProperties()
     _outputBodyForcesAtJointsFileNameProp.setName("output_body_forces_file");
     _outputBodyForcesAtJointsFileNameProp.setValue("body_forces_at_joints.sto");
     _propertySet.append(&_outputBodyForcesAtJointsFileNameProp);
+
+    string numThreadsComment = "Number of threads that solve the time frames. "
+        "The frames are solved in parallel only if the model has no analyses, "
+        "and its components must allow realizing the model in several states "
+        "at once. A value less than 1 uses the number of cores. The default "
+        "value is 1.";
+    _numThreadsProp.setComment(numThreadsComment);
+    _numThreadsProp.setName("num_threads");
+    _numThreadsProp.setValue(1);
+    _propertySet.append(&_numThreadsProp);
 }
 
 //_____________________________________________________________________________
@@ -188,6 +202,7 @@ operator=(const InverseDynamicsTool &aTool)
     _outputGenForceFileName = aTool._outputGenForceFileName;
     _outputBodyForcesAtJointsFileName = aTool._outputBodyForcesAtJointsFileName;
     _coordinateValues = NULL;
+    _numThreads = aTool._numThreads;
 
     return(*this);
 }
@@ -261,7 +276,11 @@ bool InverseDynamicsTool::run()
         log_info("Running tool {}...", getName());
         // Do the maneuver to change then restore working directory 
         // so that the parsing code behaves properly if called from a different directory.
-        auto cwd = IO::CwdChanger::changeToParentOf(getDocumentFileName());
+        // A tool that is not associated with a setup file uses the file
+        // names as they are.
+        auto cwd = getDocument() != nullptr
+                ? IO::CwdChanger::changeToParentOf(getDocumentFileName())
+                : IO::CwdChanger::noop();
 
         /*bool externalLoads = */createExternalLoads(_externalLoadsFileName, *_model);
         // Initialize the model's underlying computational system and get its default state.
@@ -392,6 +411,10 @@ bool InverseDynamicsTool::run()
                 " or setCoordinateValues() was not called.");
         }
 
+        // The working directory is shared by all threads, so do not hold it
+        // while solving.
+        cwd.restore();
+
         // Exclude user-specified forces from the dynamics for this analysis
         disableModelForces(*_model, s, _excludedForces);
 
@@ -421,8 +444,14 @@ bool InverseDynamicsTool::run()
 
         // solve for the trajectory of generalized forces that correspond to the 
         // coordinate trajectories provided
-        ivdSolver.solve(s, coordFunctions, coordinatesToSpeedsIndexMap, times,
-                genForceTraj);
+        if (_numThreads != 1 && _model->getAnalysisSet().getSize() == 0) {
+            ivdSolver.solveInParallel(s, coordFunctions,
+                    coordinatesToSpeedsIndexMap, times, genForceTraj,
+                    _numThreads);
+        } else {
+            ivdSolver.solve(s, coordFunctions, coordinatesToSpeedsIndexMap,
+                    times, genForceTraj);
+        }
         success = true;
 
         log_info("InverseDynamicsTool: {} time frames in {}.", nt, 
@@ -500,6 +529,9 @@ bool InverseDynamicsTool::run()
         genForceResults.setColumnLabels(labels);
         genForceResults.setName("Inverse Dynamics Generalized Forces");
 
+        if (getDocument() != nullptr) {
+            cwd = IO::CwdChanger::changeToParentOf(getDocumentFileName());
+        }
         IO::makeDir(getResultsDir());
         Storage::printResult(&genForceResults, _outputGenForceFileName, getResultsDir(), -1, ".sto");
         cwd.restore();
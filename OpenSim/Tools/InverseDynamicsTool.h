@@ -24,6 +24,7 @@
  * -------------------------------------------------------------------------- */
 
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/PropertyInt.h>
 #include "DynamicsTool.h"
 
 #ifdef SWIG
@@ -88,6 +89,10 @@ protected:
     PropertyStr _outputBodyForcesAtJointsFileNameProp;
     std::string &_outputBodyForcesAtJointsFileName;
 
+    /** Number of threads that solve the time frames. */
+    PropertyInt _numThreadsProp;
+    int &_numThreads;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -156,6 +161,14 @@ public:
     void setLowpassCutoffFrequency(double aFrequency) {
         _lowpassCutoffFrequency = aFrequency;
     }
+    /** The number of threads that solve the time frames (default: 1). If
+     * it is not 1, the frames are solved with
+     * InverseDynamicsSolver::solveInParallel(), unless the model has
+     * analyses, which must be stepped in order; if it is less than 1, the
+     * number of cores is used. See InverseDynamicsSolver::solveInParallel()
+     * for the components that can be solved in parallel. */
+    void setNumThreads(int numThreads) { _numThreads = numThreads; }
+    int getNumThreads() const { return _numThreads; }
     //--------------------------------------------------------------------------
     // INTERFACE
     //--------------------------------------------------------------------------
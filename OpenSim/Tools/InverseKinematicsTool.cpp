@@ -105,6 +105,7 @@ bool InverseKinematicsTool::run()
     bool success = false;
     bool modelFromFile=true;
     std::unique_ptr<Kinematics> kinematicsReporter(new Kinematics());
+    _outputMotion.reset();
     try{
         //Load and create the indicated model
         if (_model.empty()) { 
@@ -122,7 +123,11 @@ bool InverseKinematicsTool::run()
 
         // Do the maneuver to change then restore working directory so that the
         // parsing code behaves properly if called from a different directory.
-        auto cwd = IO::CwdChanger::changeToParentOf(getDocumentFileName());
+        // A tool that is not associated with a setup file uses the file
+        // names as they are.
+        auto cwd = getDocument() != nullptr
+                ? IO::CwdChanger::changeToParentOf(getDocumentFileName())
+                : IO::CwdChanger::noop();
 
         // Define reporter for output
         kinematicsReporter->setRecordAccelerations(false);
@@ -142,6 +147,9 @@ bool InverseKinematicsTool::run()
         SimTK::Array_<CoordinateReference> coordinateReferences;
         // populate the references according to the setting of this Tool
         populateReferences(markersReference, coordinateReferences);
+        // The working directory is shared by all threads, so do not hold it
+        // while solving.
+        cwd.restore();
 
         // Determine the start time, if the provided time range is not 
         // specified then use time from marker reference.
@@ -179,8 +187,15 @@ bool InverseKinematicsTool::run()
         // can be fewer than the number of references if there isn't a
         // corresponding model marker for each reference.
         int nm = ikSolver.getNumMarkersInUse();
-        SimTK::Array_<double> squaredMarkerErrors(nm, 0.0);
-        SimTK::Array_<Vec3> markerLocations(nm, Vec3(0));
+        // The results of all frames are computed into matrices that are
+        // allocated once, with a row per frame, and written to storages
+        // after the last frame.
+        SimTK::Matrix squaredMarkerErrors(get_report_errors() ? Nframes : 0,
+                get_report_errors() ? nm : 0);
+        SimTK::Matrix markerLocations(
+                get_report_marker_locations() ? Nframes : 0,
+                get_report_marker_locations() ? 3*nm : 0);
+        SimTK::Matrix markerErrors(squaredMarkerErrors.nrow(), 3);
         
         Storage *modelMarkerLocations = get_report_marker_locations() ?
             new Storage(Nframes, "ModelMarkerLocations") : nullptr;
@@ -190,31 +205,34 @@ bool InverseKinematicsTool::run()
         Stopwatch watch;
 
         for (int i = start_ix; i <= final_ix; ++i) {
+            const int frame = i - start_ix;
             s.updTime() = times[i];
             ikSolver.track(s);
             // show progress line every 1000 frames so users see progress
             if (std::remainder(i - start_ix, 1000) == 0 && i != start_ix)
                 log_info("Solved {} frame(s)...", i - start_ix);
+            if(get_report_errors() || get_report_marker_locations()){
+                ikSolver.computeCurrentMarkerLocationsAndSquaredErrors(
+                        markerLocations, squaredMarkerErrors, frame);
+            }
             if(get_report_errors()){
-                Array<double> markerErrors(0.0, 3);
                 double totalSquaredMarkerError = 0.0;
                 double maxSquaredMarkerError = 0.0;
                 int worst = -1;
 
-                ikSolver.computeCurrentSquaredMarkerErrors(squaredMarkerErrors);
                 for(int j=0; j<nm; ++j){
-                    totalSquaredMarkerError += squaredMarkerErrors[j];
-                    if(squaredMarkerErrors[j] > maxSquaredMarkerError){
-                        maxSquaredMarkerError = squaredMarkerErrors[j];
+                    const double squaredError = squaredMarkerErrors(frame, j);
+                    totalSquaredMarkerError += squaredError;
+                    if(squaredError > maxSquaredMarkerError){
+                        maxSquaredMarkerError = squaredError;
                         worst = j;
                     }
                 }
 
                 double rms = nm > 0 ? sqrt(totalSquaredMarkerError / nm) : 0;
-                markerErrors.set(0, totalSquaredMarkerError); 
-                markerErrors.set(1, rms);
-                markerErrors.set(2, sqrt(maxSquaredMarkerError));
-                modelMarkerErrors->append(s.getTime(), 3, &markerErrors[0]);
+                markerErrors(frame, 0) = totalSquaredMarkerError;
+                markerErrors(frame, 1) = rms;
+                markerErrors(frame, 2) = sqrt(maxSquaredMarkerError);
 
                 log_info("Frame {} (t = {}):\t total squared error = {}, "
                          "marker error: RMS = {}, max = {} ({})", 
@@ -223,29 +241,37 @@ bool InverseKinematicsTool::run()
                     ikSolver.getMarkerNameForIndex(worst));
             }
 
-            if(get_report_marker_locations()){
-                ikSolver.computeCurrentMarkerLocations(markerLocations);
-                Array<double> locations(0.0, 3*nm);
-                for(int j=0; j<nm; ++j){
-                    for(int k=0; k<3; ++k)
-                        locations.set(3*j+k, markerLocations[j][k]);
-                }
-
-                modelMarkerLocations->append(s.getTime(), 3*nm, &locations[0]);
-
-            }
-
             kinematicsReporter->step(s, i);
             analysisSet.step(s, i);
         }
 
+        // The rows of a SimTK::Matrix are not contiguous, so each is copied
+        // to a row of the storage through a buffer.
+        std::vector<double> row(std::max(3, 3*nm));
+        for (int frame = 0; frame < markerErrors.nrow(); ++frame) {
+            for (int k = 0; k < 3; ++k) row[k] = markerErrors(frame, k);
+            modelMarkerErrors->append(times[start_ix + frame], 3, row.data());
+        }
+        for (int frame = 0; frame < markerLocations.nrow(); ++frame) {
+            for (int k = 0; k < 3*nm; ++k) row[k] = markerLocations(frame, k);
+            modelMarkerLocations->append(times[start_ix + frame], 3*nm,
+                    row.data());
+        }
+
         // Do the maneuver to change then restore working directory 
         // so that output files are saved to same folder as setup file.
+        if (getDocument() != nullptr) {
+            cwd = IO::CwdChanger::changeToParentOf(getDocumentFileName());
+        }
         if (get_output_motion_file() != "" &&
                 get_output_motion_file() != "Unassigned") {
             kinematicsReporter->getPositionStorage()->print(
                     get_output_motion_file());
         }
+        if (_keepOutputMotion) {
+            _outputMotion.reset(
+                    new Storage(*kinematicsReporter->getPositionStorage()));
+        }
         // Remove the analysis we added to the model, do not delete as 
         // the unique_ptr takes care of that automatically
         _model->removeAnalysis(kinematicsReporter.get(), false);
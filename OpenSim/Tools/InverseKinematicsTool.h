@@ -27,6 +27,8 @@
 #include <OpenSim/Common/Object.h>
 #include <OpenSim/Tools/IKTaskSet.h>
 #include <OpenSim/Tools/InverseKinematicsToolBase.h>
+#include <OpenSim/Common/Storage.h>
+#include <SimTKcommon/internal/ResetOnCopy.h>
 
 namespace OpenSim {
 
@@ -102,6 +104,24 @@ public:
 
     IKTaskSet& getIKTaskSet() { return upd_IKTaskSet(); }
 
+    /** Keep a copy of the coordinates solved by run() in memory, for
+    getOutputMotion(). This is off by default, since the copy is as large as
+    the output motion. Copies of the tool do not keep the motion. */
+    void setKeepOutputMotion(bool keep) { _keepOutputMotion = keep; }
+    bool getKeepOutputMotion() const { return _keepOutputMotion; }
+
+    /** The coordinates solved by the last call to run(), in degrees, as they
+    are written to output_motion_file, if setKeepOutputMotion() was called;
+    otherwise, or before run() succeeds, this is null. Tools that take a
+    motion in memory (e.g., InverseDynamicsTool setCoordinateValues()) can
+    use it without reading the file. */
+    const Storage* getOutputMotion() const { return _outputMotion.get(); }
+    /** Take ownership of the motion of getOutputMotion(), which becomes
+    null. */
+    std::unique_ptr<Storage> releaseOutputMotion() {
+        return std::move(_outputMotion.updT());
+    }
+
     //--------------------------------------------------------------------------
     // INTERFACE
     //--------------------------------------------------------------------------
@@ -120,6 +140,9 @@ public:
 private:
     void constructProperties();
 
+    SimTK::ResetOnCopy<bool> _keepOutputMotion;
+    SimTK::ResetOnCopy<std::unique_ptr<Storage>> _outputMotion;
+
     //=============================================================================
 };  // END of class InverseKinematicsTool
 //=============================================================================
@@ -38,6 +38,10 @@
 #include "IKTaskSet.h"
 #include <OpenSim/Analyses/StatesReporter.h>
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/CommonUtilities.h>
+
+#include <exception>
+#include <thread>
 //=============================================================================
 // STATICS
 //=============================================================================
@@ -61,7 +65,10 @@ MarkerPlacer::MarkerPlacer() :
     _outputModelFileName(_outputModelFileNameProp.getValueStr()),
     _outputMarkerFileName(_outputMarkerFileNameProp.getValueStr()),
     _outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-    _maxMarkerMovement(_maxMarkerMovementProp.getValueDbl())
+    _maxMarkerMovement(_maxMarkerMovementProp.getValueDbl()),
+    _solveEachFrame(_solveEachFrameProp.getValueBool()),
+    _outlierThreshold(_outlierThresholdProp.getValueDbl()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
     setupProperties();
@@ -93,7 +100,10 @@ MarkerPlacer::MarkerPlacer(const MarkerPlacer &aMarkerPlacer) :
     _outputModelFileName(_outputModelFileNameProp.getValueStr()),
     _outputMarkerFileName(_outputMarkerFileNameProp.getValueStr()),
     _outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-    _maxMarkerMovement(_maxMarkerMovementProp.getValueDbl())
+    _maxMarkerMovement(_maxMarkerMovementProp.getValueDbl()),
+    _solveEachFrame(_solveEachFrameProp.getValueBool()),
+    _outlierThreshold(_outlierThresholdProp.getValueDbl()),
+    _numThreads(_numThreadsProp.getValueInt())
 {
     setNull();
     setupProperties();
@@ -120,6 +130,9 @@ void MarkerPlacer::copyData(const MarkerPlacer &aMarkerPlacer)
     _outputMarkerFileName = aMarkerPlacer._outputMarkerFileName;
     _outputMotionFileName = aMarkerPlacer._outputMotionFileName;
     _maxMarkerMovement = aMarkerPlacer._maxMarkerMovement;
+    _solveEachFrame = aMarkerPlacer._solveEachFrame;
+    _outlierThreshold = aMarkerPlacer._outlierThreshold;
+    _numThreads = aMarkerPlacer._numThreads;
     _printResultFiles = aMarkerPlacer._printResultFiles;
 }
 
@@ -194,6 +207,26 @@ void MarkerPlacer::setupProperties()
     _maxMarkerMovementProp.setName("max_marker_movement");
     _maxMarkerMovementProp.setValue(-1.0); // units of this value are the units of the marker data in the static pose (usually mm)
     _propertySet.append(&_maxMarkerMovementProp);
+
+    _solveEachFrameProp.setComment("Whether to solve the static pose for each frame in the time range, "
+        "instead of for the average of the frames, and place each marker at the median of its locations "
+        "over the frames that are not outliers (see outlier_threshold). The frames are solved in parallel.");
+    _solveEachFrameProp.setName("solve_each_frame");
+    _solveEachFrameProp.setValue(false);
+    _propertySet.append(&_solveEachFrameProp);
+
+    _outlierThresholdProp.setComment("When solving each frame, frames whose RMS marker error differs from "
+        "the median by more than this many robust standard deviations (1.4826 times the median absolute "
+        "deviation) are not used to place the markers. A negative value means that no frames are rejected.");
+    _outlierThresholdProp.setName("outlier_threshold");
+    _outlierThresholdProp.setValue(3.0);
+    _propertySet.append(&_outlierThresholdProp);
+
+    _numThreadsProp.setComment("Number of threads that solve the frames when solving each frame. "
+        "A value less than 1 means the number of cores.");
+    _numThreadsProp.setName("num_threads");
+    _numThreadsProp.setValue(0);
+    _propertySet.append(&_numThreadsProp);
 }
 
 //=============================================================================
@@ -218,6 +251,194 @@ MarkerPlacer& MarkerPlacer::operator=(const MarkerPlacer &aMarkerPlacer)
 //=============================================================================
 // UTILITY
 //=============================================================================
+namespace {
+// The inverse kinematics solution for one frame of the static pose.
+struct FrameSolution {
+    SimTK::Vector q;
+    double rmsMarkerError = SimTK::NaN;
+    // The location of each marker of the model in its parent frame, or NaN
+    // if the marker is fixed or was not observed in the frame.
+    std::vector<Vec3> markerLocations;
+};
+
+// Solve inverse kinematics for each frame of the static pose table, whose
+// markers must be in the units of the model. The frames are split into
+// blocks of consecutive frames, one per thread; each thread assembles the
+// model for the first frame of its block and tracks it over the others.
+std::vector<FrameSolution> solveEachFrame(const Model& model,
+        const TimeSeriesTableVec3& poseTable,
+        const Set<MarkerWeight>& markerWeightSet,
+        const SimTK::Array_<CoordinateReference>& coordinateReferences,
+        int numThreads) {
+    const int nf = (int)poseTable.getNumRows();
+    const auto& times = poseTable.getIndependentColumn();
+    const MarkerSet& markerSet = model.getMarkerSet();
+    const int nm = markerSet.getSize();
+    std::vector<int> columns(nm, -1);
+    for (int k = 0; k < nm; ++k) {
+        const Marker& marker = markerSet.get(k);
+        if (!marker.get_fixed() && poseTable.hasColumn(marker.getName()))
+            columns[k] = (int)poseTable.getColumnIndex(marker.getName());
+    }
+
+    if (numThreads < 1) {
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    numThreads = std::max(1, std::min(numThreads, nf));
+
+    // Each thread has its own copy of the model and of the references, which
+    // are made before the threads start.
+    std::vector<std::unique_ptr<Model>> models;
+    std::vector<SimTK::Array_<CoordinateReference>> threadCoordinateReferences(
+            numThreads, coordinateReferences);
+    for (int ithread = 0; ithread < numThreads; ++ithread) {
+        models.emplace_back(model.clone());
+        models.back()->initSystem();
+    }
+
+    std::vector<FrameSolution> solutions(nf);
+    std::vector<std::exception_ptr> errors(numThreads);
+    auto solveFrames = [&](int ithread) {
+        try {
+            Model& threadModel = *models[ithread];
+            SimTK::State state = threadModel.getWorkingState();
+            std::shared_ptr<MarkersReference> markersReference(
+                    new MarkersReference(poseTable, markerWeightSet));
+            InverseKinematicsSolver ikSol(threadModel, markersReference,
+                    threadCoordinateReferences[ithread],
+                    std::numeric_limits<SimTK::Real>::infinity());
+            SimTK::Array_<double> squaredMarkerErrors;
+            const int first = ithread * nf / numThreads;
+            const int last = (ithread + 1) * nf / numThreads;
+            // After a frame fails, the next frame is assembled again.
+            bool assembled = false;
+            for (int i = first; i < last; ++i) {
+                FrameSolution& solution = solutions[i];
+                try {
+                    state.updTime() = times[i];
+                    if (!assembled) ikSol.assemble(state);
+                    else ikSol.track(state);
+                    assembled = true;
+                    threadModel.realizePosition(state);
+
+                    ikSol.computeCurrentSquaredMarkerErrors(
+                            squaredMarkerErrors);
+                    double totalSquaredMarkerError = 0.0;
+                    for (double squaredError : squaredMarkerErrors)
+                        totalSquaredMarkerError += squaredError;
+
+                    solution.markerLocations.assign(nm, Vec3(SimTK::NaN));
+                    const auto row = poseTable.getRowAtIndex(i);
+                    for (int k = 0; k < nm; ++k) {
+                        if (columns[k] < 0 || row[columns[k]].isNaN())
+                            continue;
+                        solution.markerLocations[k] =
+                                threadModel.getGround()
+                                        .findStationLocationInAnotherFrame(
+                                                state, row[columns[k]],
+                                                threadModel.getMarkerSet()
+                                                        .get(k)
+                                                        .getParentFrame());
+                    }
+                    solution.q = state.getQ();
+                    solution.rmsMarkerError =
+                            std::sqrt(totalSquaredMarkerError /
+                                      squaredMarkerErrors.size());
+                } catch (const std::exception& e) {
+                    // A frame that cannot be solved is an outlier (its RMS
+                    // marker error is NaN).
+                    solution = FrameSolution();
+                    assembled = false;
+                    log_warn("MarkerPlacer: failed to solve the frame of the "
+                             "static pose at time {}: {}", times[i], e.what());
+                }
+            }
+        } catch (...) {
+            errors[ithread] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int ithread = 1; ithread < numThreads; ++ithread) {
+        threads.emplace_back(solveFrames, ithread);
+    }
+    solveFrames(0);
+    for (auto& thread : threads) thread.join();
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    return solutions;
+}
+
+// Solve each frame of the static pose table and move the non-fixed markers of
+// the model to the median of their locations over the frames whose RMS marker
+// error is not an outlier. The state is left in the pose of the frame with
+// the smallest RMS marker error.
+void placeMarkersFromEachFrame(SimTK::State& s, Model& model,
+        const TimeSeriesTableVec3& poseTable,
+        const Set<MarkerWeight>& markerWeightSet,
+        const SimTK::Array_<CoordinateReference>& coordinateReferences,
+        double outlierThreshold, int numThreads, bool moveModelMarkers) {
+    const auto solutions = solveEachFrame(model, poseTable, markerWeightSet,
+            coordinateReferences, numThreads);
+    const int nf = (int)solutions.size();
+    std::vector<double> rmsMarkerErrors(nf);
+    for (int i = 0; i < nf; ++i)
+        rmsMarkerErrors[i] = solutions[i].rmsMarkerError;
+    const std::vector<bool> inliers =
+            findInliers(rmsMarkerErrors, outlierThreshold);
+
+    int numInliers = 0;
+    int best = -1;
+    for (int i = 0; i < nf; ++i) {
+        if (!inliers[i]) continue;
+        ++numInliers;
+        if (best < 0 || rmsMarkerErrors[i] < rmsMarkerErrors[best]) best = i;
+    }
+    OPENSIM_THROW_IF(best < 0, Exception,
+            "MarkerPlacer::processModel -- None of the {} frames of the "
+            "static pose were solved.", nf);
+    log_info("Solved {} frames of the static pose; {} frames were rejected "
+             "as outliers. RMS marker error: median = {}, min = {} "
+             "(t = {}).",
+            nf, nf - numInliers, calcMedian(rmsMarkerErrors),
+            rmsMarkerErrors[best], poseTable.getIndependentColumn()[best]);
+
+    s.updTime() = poseTable.getIndependentColumn()[best];
+    s.updQ() = solutions[best].q;
+    model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+    if (!moveModelMarkers) return;
+
+    MarkerSet& markerSet = model.updMarkerSet();
+    std::vector<double> components;
+    components.reserve(numInliers);
+    for (int k = 0; k < markerSet.getSize(); ++k) {
+        Marker& modelMarker = markerSet.get(k);
+        if (modelMarker.get_fixed() ||
+                !poseTable.hasColumn(modelMarker.getName()))
+            continue;
+        Vec3 location;
+        for (int c = 0; c < 3; ++c) {
+            components.clear();
+            for (int i = 0; i < nf; ++i) {
+                if (inliers[i])
+                    components.push_back(solutions[i].markerLocations[k][c]);
+            }
+            location[c] = calcMedian(components);
+        }
+        if (!location.isNaN()) {
+            modelMarker.set_location(location);
+        } else {
+            log_warn("Marker {} does not have valid coordinates in any of "
+                     "the frames of the static pose. It will not be moved.",
+                    modelMarker.getName());
+        }
+    }
+    log_info("Moved markers in model {} to the median of their locations "
+             "over {} frames of the static pose.",
+            model.getName(), numInliers);
+}
+} // anonymous namespace
+
 //_____________________________________________________________________________
 /**
  * This method creates a SimmMotionTrial instance with the markerFile and
@@ -226,7 +447,10 @@ MarkerPlacer& MarkerPlacer::operator=(const MarkerPlacer &aMarkerPlacer)
  * the model, if specified. Then it does IK to fit the model to the static
  * pose. Then it uses the current model pose to relocate all non-fixed markers
  * according to their locations in the SimmMotionTrial. Then it writes the
- * output files selected by the user.
+ * output files selected by the user. If solve_each_frame is set, IK is done
+ * for each frame in the time range instead of for the average of the frames,
+ * and the markers are relocated to the median of their locations over the
+ * frames that are not outliers.
  *
  * @param aModel the model to use for the marker placing process.
  * @return Whether the marker placing process was successful or not.
@@ -257,11 +481,24 @@ bool MarkerPlacer::processModel(Model* aModel,
     if (_timeRange[1] > timeCol.back())
         _timeRange[1] = timeCol.back();
 
-    const auto avgRow = staticPoseTable.averageRow(_timeRange[0],
-                                                   _timeRange[1]);
-    for(size_t r = staticPoseTable.getNumRows(); r-- > 0; )
-        staticPoseTable.removeRowAtIndex(r);
-    staticPoseTable.appendRow(_timeRange[0], avgRow);
+    if (_solveEachFrame) {
+        // Keep the frames in the time range, to be solved one by one.
+        for(size_t r = staticPoseTable.getNumRows(); r-- > 0; ) {
+            const double time = timeCol[r];
+            if (time < _timeRange[0] || time > _timeRange[1])
+                staticPoseTable.removeRowAtIndex(r);
+        }
+        OPENSIM_THROW_IF(staticPoseTable.getNumRows() == 0, Exception,
+                "MarkerPlacer::processModel -- No frames of marker file "
+                "'{}' are in the time range [{}, {}].",
+                _markerFileName, _timeRange[0], _timeRange[1]);
+    } else {
+        const auto avgRow = staticPoseTable.averageRow(_timeRange[0],
+                                                       _timeRange[1]);
+        for(size_t r = staticPoseTable.getNumRows(); r-- > 0; )
+            staticPoseTable.removeRowAtIndex(r);
+        staticPoseTable.appendRow(_timeRange[0], avgRow);
+    }
     
     OPENSIM_THROW_IF(!staticPoseTable.hasTableMetaDataKey("Units"),
                      Exception,
@@ -299,8 +536,6 @@ bool MarkerPlacer::processModel(Model* aModel,
     // Create references and WeightSets needed to initialize InverseKinemaicsSolver
     Set<MarkerWeight> markerWeightSet;
     _ikTaskSet.createMarkerWeightSet(markerWeightSet); // order in tasks file
-    // MarkersReference takes ownership of marker data (staticPose)
-    std::shared_ptr<MarkersReference> markersReference(new MarkersReference(staticPoseTable, markerWeightSet));
     SimTK::Array_<CoordinateReference> coordinateReferences;
 
     // Load the coordinate data
@@ -343,41 +578,49 @@ bool MarkerPlacer::processModel(Model* aModel,
             coordinateReferences.push_back(*coordRef);      
         }           
     }
-    double constraintWeight = std::numeric_limits<SimTK::Real>::infinity();
-
-    InverseKinematicsSolver ikSol(*aModel, markersReference,
-                                  coordinateReferences, constraintWeight);
-    ikSol.assemble(s);
-
-    // Call realize Position so that the transforms are updated and  markers can be moved correctly
-    aModel->getMultibodySystem().realize(s, SimTK::Stage::Position);
-    // Report marker errors to assess the quality 
-    int nm = markerWeightSet.getSize();
-    SimTK::Array_<double> squaredMarkerErrors(nm, 0.0);
-    SimTK::Array_<Vec3> markerLocations(nm, Vec3(0));
-    double totalSquaredMarkerError = 0.0;
-    double maxSquaredMarkerError = 0.0;
-    int worst = -1;
-    // Report in the same order as the marker tasks/weights
-    ikSol.computeCurrentSquaredMarkerErrors(squaredMarkerErrors);
-    for(int j=0; j<nm; ++j){
-        totalSquaredMarkerError += squaredMarkerErrors[j];
-        if(squaredMarkerErrors[j] > maxSquaredMarkerError){
-            maxSquaredMarkerError = squaredMarkerErrors[j];
-            worst = j;
+    if (_solveEachFrame) {
+        placeMarkersFromEachFrame(s, *aModel, staticPoseTable,
+                markerWeightSet, coordinateReferences, _outlierThreshold,
+                _numThreads, _moveModelMarkers);
+    } else {
+        // MarkersReference takes ownership of marker data (staticPose)
+        std::shared_ptr<MarkersReference> markersReference(new MarkersReference(staticPoseTable, markerWeightSet));
+        double constraintWeight = std::numeric_limits<SimTK::Real>::infinity();
+
+        InverseKinematicsSolver ikSol(*aModel, markersReference,
+                                      coordinateReferences, constraintWeight);
+        ikSol.assemble(s);
+
+        // Call realize Position so that the transforms are updated and  markers can be moved correctly
+        aModel->getMultibodySystem().realize(s, SimTK::Stage::Position);
+        // Report marker errors to assess the quality 
+        int nm = markerWeightSet.getSize();
+        SimTK::Array_<double> squaredMarkerErrors(nm, 0.0);
+        SimTK::Array_<Vec3> markerLocations(nm, Vec3(0));
+        double totalSquaredMarkerError = 0.0;
+        double maxSquaredMarkerError = 0.0;
+        int worst = -1;
+        // Report in the same order as the marker tasks/weights
+        ikSol.computeCurrentSquaredMarkerErrors(squaredMarkerErrors);
+        for(int j=0; j<nm; ++j){
+            totalSquaredMarkerError += squaredMarkerErrors[j];
+            if(squaredMarkerErrors[j] > maxSquaredMarkerError){
+                maxSquaredMarkerError = squaredMarkerErrors[j];
+                worst = j;
+            }
         }
+        log_info("Frame at (t = {}):\t total squared error = {}, "
+                 "marker error: RMS = {}, max = {} ({})",
+                s.getTime(), totalSquaredMarkerError,
+                sqrt(totalSquaredMarkerError/nm),
+                sqrt(maxSquaredMarkerError),
+                ikSol.getMarkerNameForIndex(worst));
+        /* Now move the non-fixed markers on the model so that they are coincident
+         * with the measured markers in the static pose. The model is already in
+         * the proper configuration so the coordinates do not need to be changed.
+         */
+        if(_moveModelMarkers) moveModelMarkersToPose(s, *aModel, *staticPose);
     }
-    log_info("Frame at (t = {}):\t total squared error = {}, "
-             "marker error: RMS = {}, max = {} ({})",
-            s.getTime(), totalSquaredMarkerError,
-            sqrt(totalSquaredMarkerError/nm),
-            sqrt(maxSquaredMarkerError),
-            ikSol.getMarkerNameForIndex(worst));
-    /* Now move the non-fixed markers on the model so that they are coincident
-     * with the measured markers in the static pose. The model is already in
-     * the proper configuration so the coordinates do not need to be changed.
-     */
-    if(_moveModelMarkers) moveModelMarkersToPose(s, *aModel, *staticPose);
 
     _outputStorage.reset();
     // Make a storage file containing the solved states and markers for display in GUI.
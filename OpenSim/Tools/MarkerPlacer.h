@@ -28,6 +28,7 @@
 #include <OpenSim/Common/PropertyBool.h>
 #include <OpenSim/Common/PropertyDbl.h>
 #include <OpenSim/Common/PropertyDblArray.h>
+#include <OpenSim/Common/PropertyInt.h>
 #include <OpenSim/Common/PropertyObj.h>
 #include <OpenSim/Common/PropertyStr.h>
 #include "osimToolsDLL.h"
@@ -102,6 +103,20 @@ protected:
     PropertyDbl _maxMarkerMovementProp;
     double &_maxMarkerMovement;
 
+    // whether to solve the static pose for each frame in the time range
+    // instead of for the average of the frames
+    PropertyBool _solveEachFrameProp;
+    bool &_solveEachFrame;
+
+    // frames whose RMS marker error is further than this many (robust)
+    // standard deviations from the median are rejected as outliers
+    PropertyDbl _outlierThresholdProp;
+    double &_outlierThreshold;
+
+    // number of threads that solve the frames of the static pose
+    PropertyInt _numThreadsProp;
+    int &_numThreads;
+
     // Whether or not to write to the designated output files (GUI will set this to false)
     bool _printResultFiles;
     // Whether to move the model markers (set to false if you just want to preview the static pose)
@@ -176,6 +191,41 @@ public:
         _maxMarkerMovementProp.setValueIsDefault(false);
     }
 
+    bool getSolveEachFrame() const { return _solveEachFrame; }
+    /** Solve the static pose for each frame in the time range, instead of
+     * for the average of the frames, and move the markers to the median of
+     * their locations (in their parent frames) over the frames that are not
+     * outliers; see setOutlierThreshold(). Frames for which inverse
+     * kinematics fails are also treated as outliers. The model is left in
+     * the pose of the frame with the smallest RMS marker error. The frames
+     * are solved in parallel; see setNumThreads(). */
+    void setSolveEachFrame(bool aSolveEachFrame)
+    {
+        _solveEachFrame = aSolveEachFrame;
+        _solveEachFrameProp.setValueIsDefault(false);
+    }
+
+    double getOutlierThreshold() const { return _outlierThreshold; }
+    /** When solving each frame, frames whose RMS marker error is more than
+     * this many robust standard deviations (1.4826 times the median absolute
+     * deviation) above or below the median are not used to place the
+     * markers (default: 3). A negative value means that no frames are
+     * rejected for their error; see findInliers(). */
+    void setOutlierThreshold(double aOutlierThreshold)
+    {
+        _outlierThreshold = aOutlierThreshold;
+        _outlierThresholdProp.setValueIsDefault(false);
+    }
+
+    int getNumThreads() const { return _numThreads; }
+    /** The number of threads that solve the frames when solving each frame;
+     * if less than 1 (the default), the number of cores is used. */
+    void setNumThreads(int aNumThreads)
+    {
+        _numThreads = aNumThreads;
+        _numThreadsProp.setValueIsDefault(false);
+    }
+
     const std::string& getOutputModelFileName() const { return _outputModelFileName; }
     void setOutputModelFileName(const std::string& aOutputModelFileName)
     {
@@ -28,6 +28,7 @@
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Common/MarkerData.h>
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/CommonUtilities.h>
 
 //=============================================================================
 // STATICS
@@ -53,7 +54,8 @@ ModelScaler::ModelScaler() :
     _timeRange(_timeRangeProp.getValueDblArray()),
     _preserveMassDist(_preserveMassDistProp.getValueBool()),
     _outputModelFileName(_outputModelFileNameProp.getValueStr()),
-    _outputScaleFileName(_outputScaleFileNameProp.getValueStr())
+    _outputScaleFileName(_outputScaleFileNameProp.getValueStr()),
+    _outlierThreshold(_outlierThresholdProp.getValueDbl())
 {
     setNull();
     setupProperties();
@@ -85,7 +87,8 @@ ModelScaler::ModelScaler(const ModelScaler &aModelScaler) :
     _timeRange(_timeRangeProp.getValueDblArray()),
     _preserveMassDist(_preserveMassDistProp.getValueBool()),
     _outputModelFileName(_outputModelFileNameProp.getValueStr()),
-    _outputScaleFileName(_outputScaleFileNameProp.getValueStr())
+    _outputScaleFileName(_outputScaleFileNameProp.getValueStr()),
+    _outlierThreshold(_outlierThresholdProp.getValueDbl())
 {
     setNull();
     setupProperties();
@@ -112,6 +115,7 @@ void ModelScaler::copyData(const ModelScaler &aModelScaler)
     _preserveMassDist = aModelScaler._preserveMassDist;
     _outputModelFileName = aModelScaler._outputModelFileName;
     _outputScaleFileName = aModelScaler._outputScaleFileName;
+    _outlierThreshold = aModelScaler._outlierThreshold;
     _printResultFiles = aModelScaler._printResultFiles;
 }
 
@@ -176,6 +180,14 @@ void ModelScaler::setupProperties()
     _outputScaleFileNameProp.setComment("Name of file to write containing the scale factors that were applied to the unscaled model (optional).");
     _outputScaleFileNameProp.setName("output_scale_file");
     _propertySet.append(&_outputScaleFileNameProp);
+
+    _outlierThresholdProp.setComment("When measuring the distance between a pair of experimental markers, "
+        "ignore the frames in which either marker is missing and those in which the distance differs from the "
+        "median by more than this many robust standard deviations (1.4826 times the median absolute deviation). "
+        "A negative value means that the distance is averaged over all frames in the time range.");
+    _outlierThresholdProp.setName("outlier_threshold");
+    _outlierThresholdProp.setValue(-1.0);
+    _propertySet.append(&_outlierThresholdProp);
 }
 
 //_____________________________________________________________________________
@@ -400,6 +412,31 @@ double ModelScaler::takeExperimentalMarkerMeasurement(const MarkerData& aMarkerD
             throw Exception("ModelScaler::takeExperimentalMarkerMeasurement, time_range is unspecified.");
 
         aMarkerData.findFrameRange(_timeRange[0], _timeRange[1], startIndex, endIndex);
+        if (_outlierThreshold >= 0) {
+            // Average the distances of the frames that are not outliers;
+            // frames in which a marker is missing have NaN distances.
+            std::vector<double> lengths;
+            for(int i=startIndex; i<=endIndex; i++) {
+                Vec3 p1 = aMarkerData.getFrame(i).getMarker(marker1);
+                Vec3 p2 = aMarkerData.getFrame(i).getMarker(marker2);
+                lengths.push_back((p2 - p1).norm());
+            }
+            const std::vector<bool> inliers =
+                    findInliers(lengths, _outlierThreshold);
+            double length = 0;
+            int numInliers = 0;
+            for (size_t i = 0; i < lengths.size(); ++i) {
+                if (!inliers[i]) continue;
+                length += lengths[i];
+                ++numInliers;
+            }
+            if (numInliers < (int)lengths.size())
+                log_info("Ignored {} of {} frames of the {} - {} distance in "
+                         "the {} measurement.",
+                        lengths.size() - numInliers, lengths.size(), aName1,
+                        aName2, aMeasurementName);
+            return numInliers > 0 ? length/numInliers : SimTK::NaN;
+        }
         double length = 0;
         for(int i=startIndex; i<=endIndex; i++) {
             Vec3 p1 = aMarkerData.getFrame(i).getMarker(marker1);
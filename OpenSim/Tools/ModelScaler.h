@@ -25,6 +25,7 @@
 
 
 // INCLUDE
+#include <OpenSim/Common/PropertyDbl.h>
 #include <OpenSim/Common/ScaleSet.h>
 #include "MeasurementSet.h"
 
@@ -92,6 +93,11 @@ protected:
     PropertyStr _outputScaleFileNameProp;
     std::string &_outputScaleFileName;
 
+    // frames whose marker pair distance is further than this many (robust)
+    // standard deviations from the median are not used in a measurement
+    PropertyDbl _outlierThresholdProp;
+    double &_outlierThreshold;
+
     // Whether or not to write to the designated output files (GUI will set this to false)
     bool _printResultFiles;
 
@@ -186,6 +192,18 @@ public:
         _outputScaleFileNameProp.setValueIsDefault(false);
     }
 
+    double getOutlierThreshold() const { return _outlierThreshold; }
+    /** When measuring the distance between a pair of experimental markers,
+     * ignore the frames in which either marker is missing and those in which
+     * the distance differs from the median by more than this many robust
+     * standard deviations (1.4826 times the median absolute deviation). A
+     * negative value (the default) means that the distance is averaged over
+     * all frames in the time range. */
+    void setOutlierThreshold(double aOutlierThreshold) {
+        _outlierThreshold = aOutlierThreshold;
+        _outlierThresholdProp.setValueIsDefault(false);
+    }
+
     void setPrintResultFiles(bool aToWrite) { _printResultFiles = aToWrite; }
 
     double computeMeasurementScaleFactor(const SimTK::State& s, const Model& aModel, const MarkerData& aMarkerData, const Measurement& aMeasurement) const;
@@ -0,0 +1,107 @@
+/* -------------------------------------------------------------------------- *
+ *                  OpenSim:  OrientationsFileReplay.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "OrientationsFileReplay.h"
+
+#include "StreamingIMUInverseKinematics.h"
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Simulation/OpenSense/OpenSenseUtilities.h>
+
+#include <chrono>
+
+using namespace OpenSim;
+
+OrientationsFileReplay::OrientationsFileReplay(
+        const std::string& orientationsFile,
+        const SimTK::Vec3& sensorToOpenSimRotations) {
+    TimeSeriesTable_<SimTK::Quaternion> quatTable(orientationsFile);
+    log_info("Loading orientations as quaternions from '{}'...",
+            orientationsFile);
+    const SimTK::Rotation sensorToOpenSim(
+            SimTK::BodyOrSpaceType::SpaceRotationSequence,
+            sensorToOpenSimRotations[0], SimTK::XAxis,
+            sensorToOpenSimRotations[1], SimTK::YAxis,
+            sensorToOpenSimRotations[2], SimTK::ZAxis);
+    OpenSenseUtilities::rotateOrientationTable(quatTable, sensorToOpenSim);
+    m_orientations =
+            OpenSenseUtilities::convertQuaternionsToRotations(quatTable);
+}
+
+OrientationsFileReplay::OrientationsFileReplay(
+        const TimeSeriesTable_<SimTK::Rotation>& orientations)
+        : m_orientations(orientations) {}
+
+OrientationsFileReplay::~OrientationsFileReplay() { stop(); }
+
+void OrientationsFileReplay::setSpeed(double speed) {
+    OPENSIM_THROW_IF(m_thread.joinable(), Exception,
+            "Cannot change the speed while the replay is playing.");
+    OPENSIM_THROW_IF(!(speed > 0), Exception,
+            "Expected a positive speed, but got {}.", speed);
+    m_speed = speed;
+}
+
+void OrientationsFileReplay::start(Sink sink) {
+    OPENSIM_THROW_IF(m_thread.joinable(), Exception,
+            "The replay is already playing; call wait() or stop() first.");
+    m_stopRequested.store(false);
+    m_numRowsPlayed.store(0);
+    m_thread = std::thread(&OrientationsFileReplay::play, this, sink);
+}
+
+void OrientationsFileReplay::start(
+        StreamingIMUInverseKinematics& service, int subject) {
+    OPENSIM_THROW_IF(service.getSensorNames(subject) != getSensorNames(),
+            Exception,
+            "Expected the sensors of subject {} to be the sensors in the "
+            "file, in the same order.",
+            subject);
+    start([&service, subject](double time,
+                  const SimTK::RowVectorView_<SimTK::Rotation>& orientations) {
+        service.pushOrientations(subject, time, orientations);
+    });
+}
+
+void OrientationsFileReplay::wait() {
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void OrientationsFileReplay::stop() {
+    m_stopRequested.store(true);
+    wait();
+}
+
+void OrientationsFileReplay::play(Sink sink) {
+    typedef std::chrono::steady_clock Clock;
+    const auto& times = m_orientations.getIndependentColumn();
+    if (times.empty()) return;
+    const Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < times.size(); ++i) {
+        const std::chrono::duration<double> offset(
+                (times[i] - times.front()) / m_speed);
+        std::this_thread::sleep_until(
+                start + std::chrono::duration_cast<Clock::duration>(offset));
+        if (m_stopRequested.load()) break;
+        sink(times[i], m_orientations.getRowAtIndex(i));
+        ++m_numRowsPlayed;
+    }
+}
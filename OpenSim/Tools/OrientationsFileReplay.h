@@ -0,0 +1,104 @@
+#ifndef OPENSIM_ORIENTATIONS_FILE_REPLAY_H_
+#define OPENSIM_ORIENTATIONS_FILE_REPLAY_H_
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  OrientationsFileReplay.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimToolsDLL.h"
+#include <OpenSim/Common/TimeSeriesTable.h>
+
+#include <atomic>
+#include <functional>
+#include <thread>
+
+namespace OpenSim {
+
+class StreamingIMUInverseKinematics;
+
+/** Play back the orientations of sensors (IMUs) in a file on a separate
+thread, at the rate at which they were recorded, as if they were streamed
+from the sensors. This is a local data source for testing
+StreamingIMUInverseKinematics or other clients of streamed orientations.
+
+The file holds quaternions, as the orientations file of
+IMUInverseKinematicsTool, and the orientations are rotated into the OpenSim
+ground frame in the same way. */
+class OSIMTOOLS_API OrientationsFileReplay {
+public:
+    /** The function to which each row of orientations is passed, in the
+    order of getSensorNames(). */
+    typedef std::function<void(double time,
+            const SimTK::RowVectorView_<SimTK::Rotation>& orientations)>
+            Sink;
+
+    /** Load the quaternions in `orientationsFile` and rotate them by the
+    space-fixed X-Y-Z rotations `sensorToOpenSimRotations` (in radians; see
+    the `sensor_to_opensim_rotations` property of IMUInverseKinematicsTool). */
+    explicit OrientationsFileReplay(const std::string& orientationsFile,
+            const SimTK::Vec3& sensorToOpenSimRotations = SimTK::Vec3(0));
+    /** Play back orientations that are already in the OpenSim ground
+    frame. */
+    explicit OrientationsFileReplay(
+            const TimeSeriesTable_<SimTK::Rotation>& orientations);
+    OrientationsFileReplay(const OrientationsFileReplay&) = delete;
+    OrientationsFileReplay& operator=(const OrientationsFileReplay&) = delete;
+    /** Calls stop(). */
+    ~OrientationsFileReplay();
+
+    std::vector<std::string> getSensorNames() const {
+        return m_orientations.getColumnLabels();
+    }
+    const TimeSeriesTable_<SimTK::Rotation>& getOrientations() const {
+        return m_orientations;
+    }
+
+    /** Play back `speed` times faster than the data were recorded (default:
+    1, real time). This must be set before start(). */
+    void setSpeed(double speed);
+    double getSpeed() const { return m_speed; }
+
+    /** Start passing the rows to `sink` on a separate thread, each at the
+    time (relative to the first row) at which it was recorded.
+    @throws Exception if the replay is already playing. */
+    void start(Sink sink);
+    /** Push the rows to a subject of `service`, whose sensors must be
+    getSensorNames(). */
+    void start(StreamingIMUInverseKinematics& service, int subject);
+    /** Wait until all rows were played back or stop() was called. */
+    void wait();
+    /** Stop the replay at the next row. */
+    void stop();
+    /** The number of rows passed to the sink since start(). */
+    int getNumRowsPlayed() const { return m_numRowsPlayed.load(); }
+
+private:
+    void play(Sink sink);
+
+    TimeSeriesTable_<SimTK::Rotation> m_orientations;
+    double m_speed = 1;
+    std::thread m_thread;
+    std::atomic<bool> m_stopRequested{false};
+    std::atomic<int> m_numRowsPlayed{0};
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_ORIENTATIONS_FILE_REPLAY_H_
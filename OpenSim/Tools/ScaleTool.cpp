@@ -29,6 +29,10 @@
 #include <OpenSim/Simulation/Model/Model.h>
 #include "GenericModelMaker.h"
 
+#include <atomic>
+#include <exception>
+#include <thread>
+
 //=============================================================================
 // STATICS
 //=============================================================================
@@ -260,10 +264,14 @@ bool ScaleTool::run() const {
         throw Exception(msg, __FILE__, __LINE__);
     }
 
+    return processModel(model.get());
+}
+
+bool ScaleTool::processModel(Model* aModel) const {
     if (!isDefaultModelScaler() && getModelScaler().getApply())
     {
         const ModelScaler& scaler = getModelScaler();
-        if(!scaler.processModel(model.get(), getPathToSubject(), getSubjectMass())) {
+        if(!scaler.processModel(aModel, getPathToSubject(), getSubjectMass())) {
             return false;
         }
     }
@@ -276,7 +284,7 @@ bool ScaleTool::run() const {
     if (!isDefaultMarkerPlacer())
     {
         const MarkerPlacer& placer = getMarkerPlacer();
-        if(!placer.processModel(model.get(), getPathToSubject())) {
+        if(!placer.processModel(aModel, getPathToSubject())) {
             return false;
         }
     }
@@ -287,3 +295,62 @@ bool ScaleTool::run() const {
     }
     return true;
 }
+
+std::vector<std::unique_ptr<Model>> ScaleTool::runBatch(
+        const Model& genericModel, const std::vector<const ScaleTool*>& subjects,
+        int numThreads) {
+    const int numSubjects = (int)subjects.size();
+    std::vector<std::unique_ptr<Model>> models(numSubjects);
+    if (numSubjects == 0) return models;
+
+    // Copy the tools and the generic model, and read the marker set files,
+    // before the threads start.
+    std::vector<std::unique_ptr<ScaleTool>> tools(numSubjects);
+    std::vector<std::unique_ptr<MarkerSet>> markerSets(numSubjects);
+    for (int i = 0; i < numSubjects; ++i) {
+        OPENSIM_THROW_IF(subjects[i] == nullptr, Exception,
+                "Expected a ScaleTool for subject {}, but got null.", i);
+        tools[i].reset(subjects[i]->clone());
+        tools[i]->setPathToSubject(subjects[i]->getPathToSubject());
+        tools[i]->setPrintResultFiles(false);
+        models[i].reset(genericModel.clone());
+        models[i]->setName(tools[i]->getName());
+        if (!tools[i]->isDefaultGenericModelMaker()) {
+            markerSets[i].reset(tools[i]->getGenericModelMaker().loadMarkerSet(
+                    tools[i]->getPathToSubject()));
+        }
+    }
+
+    if (numThreads < 1) {
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    numThreads = std::max(1, std::min(numThreads, numSubjects));
+
+    std::atomic<int> nextSubject(0);
+    std::vector<std::exception_ptr> errors(numThreads);
+    auto processSubjects = [&](int ithread) {
+        try {
+            while (true) {
+                const int i = nextSubject++;
+                if (i >= numSubjects) break;
+                log_info("Processing subject {}...", tools[i]->getName());
+                if (markerSets[i]) models[i]->updateMarkerSet(*markerSets[i]);
+                if (!tools[i]->processModel(models[i].get())) models[i].reset();
+            }
+        } catch (...) {
+            errors[ithread] = std::current_exception();
+            // Stop the other threads early.
+            nextSubject = numSubjects;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (int ithread = 1; ithread < numThreads; ++ithread) {
+        threads.emplace_back(processSubjects, ithread);
+    }
+    processSubjects(0);
+    for (auto& thread : threads) thread.join();
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+    return models;
+}
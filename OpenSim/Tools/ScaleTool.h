@@ -32,6 +32,9 @@
 #include "ModelScaler.h"
 #include "MarkerPlacer.h"
 
+#include <memory>
+#include <vector>
+
 namespace OpenSim {
 
 class GenericModelMaker;
@@ -108,6 +111,10 @@ public:
 
     const MarkerPlacer& getMarkerPlacer() const
     { return _markerPlacer; }
+    ModelScaler& updModelScaler()
+    { return _modelScaler; }
+    MarkerPlacer& updMarkerPlacer()
+    { return _markerPlacer; }
 
     /** Run the scale tool. This first runs the ModelScaler, then runs the
      * MarkerPlacer. This is the method called by the command line `scale`
@@ -115,6 +122,33 @@ public:
      * @returns whether or not the scale procedure was successful. */
     bool run() const;
 
+    /** Run the ModelScaler, then the MarkerPlacer, on a model such as the
+     * one returned by createModel(), as run() does.
+     * @returns whether or not the scale procedure was successful. */
+    bool processModel(Model* aModel) const;
+
+#ifndef SWIG
+    /** Scale a copy of a generic model and place its markers for each of
+     * the subjects, processing several subjects at once on `numThreads`
+     * threads (if `numThreads` is less than 1, the number of cores is used).
+     * The generic model is loaded once by the caller, instead of once per
+     * subject from the model file of each subject's GenericModelMaker; the
+     * marker set file of the GenericModelMaker, if any, updates the markers
+     * of the subject's copy as in createModel().
+     *
+     * No result files are written: the tools write them relative to the
+     * working directory, which all threads share. Print the returned models
+     * instead. If the MarkerPlacer of a subject solves each frame, its
+     * threads are in addition to `numThreads`.
+     * @returns the model of each subject, in order, or null for subjects
+     *     whose scale procedure was not successful.
+     * @throws Exception if the scale procedure of any subject throws. */
+    static std::vector<std::unique_ptr<Model>> runBatch(
+            const Model& genericModel,
+            const std::vector<const ScaleTool*>& subjects,
+            int numThreads = 0);
+#endif
+
     bool isDefaultGenericModelMaker() const
     { return _genericModelMakerProp.getValueIsDefault(); }
     bool isDefaultModelScaler() const
@@ -0,0 +1,361 @@
+/* -------------------------------------------------------------------------- *
+ *               OpenSim:  StreamingIMUInverseKinematics.cpp                  *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "StreamingIMUInverseKinematics.h"
+
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Common/TimeSeriesTable.h>
+#include <OpenSim/Simulation/SimbodyEngine/Coordinate.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace OpenSim;
+
+namespace {
+// A sample takes 1 element for the time at which it was pushed and 9 elements
+// for each rotation.
+const int NumElementsPerRotation = 9;
+// The number of samples of a subject that a thread solves before it looks for
+// samples of the other subjects.
+const int MaxFramesPerClaim = 4;
+
+// The nearest-rank percentile; reorders the latencies.
+double calcPercentile(std::vector<double>& latencies, double fraction) {
+    const int n = static_cast<int>(latencies.size());
+    const int rank = std::min(std::max(
+            static_cast<int>(std::ceil(fraction * n)) - 1, 0), n - 1);
+    std::nth_element(latencies.begin(), latencies.begin() + rank,
+            latencies.end());
+    return latencies[rank];
+}
+} // anonymous namespace
+
+StreamingIMUInverseKinematics::StreamingIMUInverseKinematics(int numThreads) {
+    if (numThreads < 1) {
+        numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    m_numThreads = numThreads;
+}
+
+StreamingIMUInverseKinematics::~StreamingIMUInverseKinematics() { stop(); }
+
+void StreamingIMUInverseKinematics::setAccuracy(double accuracy) {
+    OPENSIM_THROW_IF(!m_subjects.empty(), Exception,
+            "Cannot change the accuracy after subjects were added.");
+    m_accuracy = accuracy;
+}
+
+void StreamingIMUInverseKinematics::setInputCapacity(int capacity) {
+    OPENSIM_THROW_IF(!m_subjects.empty(), Exception,
+            "Cannot change the input capacity after subjects were added.");
+    OPENSIM_THROW_IF(capacity <= 0, Exception,
+            "Expected a positive input capacity, but got {}.", capacity);
+    m_inputCapacity = capacity;
+}
+
+void StreamingIMUInverseKinematics::setOutputCapacity(int capacity) {
+    OPENSIM_THROW_IF(!m_subjects.empty(), Exception,
+            "Cannot change the output capacity after subjects were added.");
+    OPENSIM_THROW_IF(capacity <= 0, Exception,
+            "Expected a positive output capacity, but got {}.", capacity);
+    m_outputCapacity = capacity;
+}
+
+void StreamingIMUInverseKinematics::setLatencyWindow(int numFrames) {
+    OPENSIM_THROW_IF(!m_subjects.empty(), Exception,
+            "Cannot change the latency window after subjects were added.");
+    OPENSIM_THROW_IF(numFrames <= 0, Exception,
+            "Expected a positive latency window, but got {}.", numFrames);
+    m_latencyWindow = numFrames;
+}
+
+int StreamingIMUInverseKinematics::addSubject(const Model& model,
+        const std::vector<std::string>& sensorNames,
+        const Set<OrientationWeight>* weights) {
+    throwIfRunning("add a subject");
+    OPENSIM_THROW_IF(sensorNames.empty(), Exception,
+            "Expected the names of the sensors of the subject.");
+
+    std::unique_ptr<Subject> subject(new Subject());
+    subject->model.reset(model.clone());
+    Model& subjectModel = *subject->model;
+    subjectModel.finalizeFromProperties();
+
+    // Lock the translational coordinates, which cannot be determined from
+    // the orientations, as IMUInverseKinematicsTool does.
+    for (auto& coord : subjectModel.updComponentList<Coordinate>()) {
+        if (coord.getMotionType() == Coordinate::Translational) {
+            coord.setDefaultLocked(true);
+        }
+    }
+    subject->state = subjectModel.initSystem();
+
+    int numSensorsInModel = 0;
+    for (const auto& frame : subjectModel.getComponentList<PhysicalFrame>()) {
+        if (std::find(sensorNames.begin(), sensorNames.end(),
+                    frame.getName()) != sensorNames.end()) {
+            ++numSensorsInModel;
+        }
+    }
+    OPENSIM_THROW_IF(numSensorsInModel == 0, Exception,
+            "None of the {} sensors of the subject is a frame of model '{}'.",
+            sensorNames.size(), model.getName());
+
+    // The reference has no data of its own; each sample is put in it right
+    // before the solver takes it out.
+    const int numSensors = static_cast<int>(sensorNames.size());
+    TimeSeriesTable_<SimTK::Rotation> noOrientations(std::vector<double>(),
+            SimTK::Matrix_<SimTK::Rotation>(0, numSensors), sensorNames);
+    subject->reference = std::make_shared<BufferedOrientationsReference>(
+            noOrientations, weights);
+    subject->reference->setBufferCapacity(2);
+    subject->reference->setBufferOverflowPolicy(
+            BufferedOrientationsReference::OverflowPolicy::DropOldest);
+
+    SimTK::Array_<CoordinateReference> coordinateReferences;
+    subject->solver.reset(new InverseKinematicsSolver(subjectModel, nullptr,
+            subject->reference, coordinateReferences));
+    subject->solver->setAccuracy(m_accuracy);
+    subject->solver->setAdvanceTimeFromReference(true);
+
+    const CoordinateSet& coordinates = subjectModel.getCoordinateSet();
+    for (int i = 0; i < coordinates.getSize(); ++i) {
+        subject->coordinateNames.push_back(coordinates[i].getName());
+        subject->coordinates.emplace_back(&coordinates[i]);
+    }
+    subject->sensorNames = sensorNames;
+
+    subject->input.allocate(m_inputCapacity,
+            1 + NumElementsPerRotation * numSensors,
+            DataRingBuffer_<double>::OverflowPolicy::DropOldest);
+    subject->output.allocate(m_outputCapacity, coordinates.getSize(),
+            OutputQueue::OverflowPolicy::DropOldest);
+    subject->orientations.resize(numSensors);
+    subject->coordinateValues.resize(coordinates.getSize());
+    subject->latencies.resize(m_latencyWindow);
+
+    m_subjects.push_back(std::move(subject));
+    return getNumSubjects() - 1;
+}
+
+const StreamingIMUInverseKinematics::Subject&
+StreamingIMUInverseKinematics::getSubject(int subject) const {
+    OPENSIM_THROW_IF(subject < 0 || subject >= getNumSubjects(),
+            IndexOutOfRange, (size_t)subject, 0, (size_t)getNumSubjects() - 1);
+    return *m_subjects[subject];
+}
+
+void StreamingIMUInverseKinematics::throwIfRunning(
+        const std::string& action) const {
+    OPENSIM_THROW_IF(isRunning(), Exception,
+            "Cannot {} while the service is running; call stop() first.",
+            action);
+}
+
+void StreamingIMUInverseKinematics::start() {
+    throwIfRunning("start");
+    OPENSIM_THROW_IF(m_subjects.empty(), Exception,
+            "Expected at least one subject; call addSubject() first.");
+    m_running.store(true);
+    for (int i = 0; i < m_numThreads; ++i) {
+        m_threads.emplace_back(
+                &StreamingIMUInverseKinematics::runWorker, this, i);
+    }
+    log_info("Solving inverse kinematics of {} subject(s) on {} thread(s).",
+            getNumSubjects(), m_numThreads);
+}
+
+void StreamingIMUInverseKinematics::stop() {
+    m_running.store(false);
+    for (auto& thread : m_threads) thread.join();
+    m_threads.clear();
+}
+
+void StreamingIMUInverseKinematics::waitUntilIdle() const {
+    OPENSIM_THROW_IF(!isRunning(), Exception,
+            "Cannot wait for the samples to be solved if the service is not "
+            "running.");
+    // A thread claims a subject before it takes samples out of its input
+    // queue, so the samples were solved if the queue is empty and the
+    // subject is not claimed.
+    for (const auto& subject : m_subjects) {
+        while (!subject->input.isEmpty() || subject->busy.load()) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+void StreamingIMUInverseKinematics::pushOrientations(int subjectIndex,
+        double time, const SimTK::RowVectorView_<SimTK::Rotation>& orientations) {
+    Subject& subject = updSubject(subjectIndex);
+    const int numSensors = static_cast<int>(subject.sensorNames.size());
+    OPENSIM_THROW_IF(orientations.size() != numSensors, Exception,
+            "Expected orientations of {} sensors, but got {}.", numSensors,
+            orientations.size());
+
+    // Each thread reuses its own row, so that pushing does not allocate
+    // memory after the first sample.
+    thread_local std::vector<double> row;
+    row.resize(1 + NumElementsPerRotation * numSensors);
+    row[0] = SimTK::realTime();
+    double* elements = &row[1];
+    for (int i = 0; i < numSensors; ++i) {
+        const SimTK::Rotation& R = orientations[i];
+        for (int r = 0; r < 3; ++r) {
+            for (int c = 0; c < 3; ++c) *elements++ = R[r][c];
+        }
+    }
+    ++subject.numFramesReceived;
+    subject.input.push_back(time, row.data());
+}
+
+void StreamingIMUInverseKinematics::pushOrientations(int subject, double time,
+        const SimTK::RowVector_<SimTK::Rotation>& orientations) {
+    pushOrientations(subject, time, orientations.getAsRowVectorView());
+}
+
+void StreamingIMUInverseKinematics::runWorker(int worker) {
+    // The threads start looking for samples at different subjects so that
+    // they rarely compete for the same subject.
+    const int numSubjects = getNumSubjects();
+    int first = worker % numSubjects;
+    int numIdlePasses = 0;
+    while (m_running.load()) {
+        bool solvedAny = false;
+        for (int i = 0; i < numSubjects; ++i) {
+            Subject& subject = *m_subjects[(first + i) % numSubjects];
+            if (subject.input.isEmpty()) continue;
+            bool expected = false;
+            if (!subject.busy.compare_exchange_strong(expected, true)) {
+                continue;
+            }
+            if (solveFrames(subject, MaxFramesPerClaim) > 0) solvedAny = true;
+            subject.busy.store(false);
+        }
+        first = (first + 1) % numSubjects;
+
+        // Yield briefly in case samples are about to arrive, then sleep so
+        // that an idle service does not occupy the cores.
+        if (solvedAny) {
+            numIdlePasses = 0;
+        } else if (++numIdlePasses < 64) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+int StreamingIMUInverseKinematics::solveFrames(
+        Subject& subject, int maxFrames) {
+    const int numSensors = subject.orientations.size();
+    int numFrames = 0;
+    while (numFrames < maxFrames) {
+        // Copy the sample out of the input queue so that the queue is not
+        // held up while the sample is solved.
+        double time = SimTK::NaN;
+        double pushTime = SimTK::NaN;
+        const int numPopped = subject.input.drain(
+                [&](double rowTime, const double* row) {
+                    time = rowTime;
+                    pushTime = row[0];
+                    const double* elements = row + 1;
+                    SimTK::Mat33 R;
+                    for (int i = 0; i < numSensors; ++i) {
+                        for (int r = 0; r < 3; ++r) {
+                            for (int c = 0; c < 3; ++c) R(r, c) = *elements++;
+                        }
+                        subject.orientations[i].setRotationFromMat33TrustMe(R);
+                    }
+                }, 1);
+        if (numPopped == 0) break;
+        ++numFrames;
+
+        // The solver takes the sample out of the reference and sets the time
+        // of the state. The first sample, and the one after a failure, is
+        // assembled without the previous solution.
+        subject.reference->putValues(time, subject.orientations);
+        bool solved = true;
+        try {
+            if (subject.isAssembled) {
+                subject.solver->track(subject.state);
+            } else {
+                subject.state.setTime(time);
+                subject.solver->assemble(subject.state);
+                subject.isAssembled = true;
+            }
+        } catch (const std::exception& e) {
+            log_debug("Inverse kinematics failed at time {}: {}", time,
+                    e.what());
+            subject.isAssembled = false;
+            solved = false;
+        }
+
+        if (solved) {
+            for (int i = 0; i < (int)subject.coordinates.size(); ++i) {
+                subject.coordinateValues[i] =
+                        subject.coordinates[i]->getValue(subject.state);
+            }
+            subject.output.push_back(time, subject.coordinateValues.data());
+        }
+
+        const double latency = SimTK::realTime() - pushTime;
+        std::lock_guard<std::mutex> lock(subject.statisticsMutex);
+        if (solved) {
+            ++subject.numFramesSolved;
+            const int window = static_cast<int>(subject.latencies.size());
+            subject.latencies[subject.nextLatency] = latency;
+            subject.nextLatency = (subject.nextLatency + 1) % window;
+            subject.numLatencies = std::min(subject.numLatencies + 1, window);
+        } else {
+            ++subject.numFramesFailed;
+        }
+    }
+    return numFrames;
+}
+
+StreamingIMUInverseKinematics::Statistics
+StreamingIMUInverseKinematics::getStatistics(int subjectIndex) const {
+    const Subject& subject = getSubject(subjectIndex);
+    Statistics statistics;
+    std::vector<double> latencies;
+    {
+        std::lock_guard<std::mutex> lock(subject.statisticsMutex);
+        statistics.numFramesSolved = subject.numFramesSolved;
+        statistics.numFramesFailed = subject.numFramesFailed;
+        latencies.assign(subject.latencies.begin(),
+                subject.latencies.begin() + subject.numLatencies);
+    }
+    statistics.numFramesReceived = subject.numFramesReceived.load();
+    statistics.numFramesDropped =
+            subject.input.getNumDropped() + subject.output.getNumDropped();
+    if (!latencies.empty()) {
+        statistics.latencyMax =
+                *std::max_element(latencies.begin(), latencies.end());
+        statistics.latencyMedian = calcPercentile(latencies, 0.5);
+        statistics.latencyPercentile90 = calcPercentile(latencies, 0.9);
+        statistics.latencyPercentile99 = calcPercentile(latencies, 0.99);
+    }
+    return statistics;
+}
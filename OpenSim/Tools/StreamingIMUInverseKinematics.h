@@ -0,0 +1,233 @@
+#ifndef OPENSIM_STREAMING_IMU_INVERSE_KINEMATICS_H_
+#define OPENSIM_STREAMING_IMU_INVERSE_KINEMATICS_H_
+/* -------------------------------------------------------------------------- *
+ *                OpenSim:  StreamingIMUInverseKinematics.h                   *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimToolsDLL.h"
+#include <OpenSim/Common/DataRingBuffer.h>
+#include <OpenSim/Common/Set.h>
+#include <OpenSim/Simulation/BufferedOrientationsReference.h>
+#include <OpenSim/Simulation/InverseKinematicsSolver.h>
+#include <OpenSim/Simulation/Model/Model.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace OpenSim {
+
+/** Solve inverse kinematics in real time for one or more subjects whose
+orientation sensor (IMU) data arrive as a stream, as IMUInverseKinematicsTool
+does for data in a file.
+
+Add each subject with addSubject() and start() the service. Then, for each
+sample of a subject's sensors, call pushOrientations() from any thread (for
+example, the thread that receives the data). The service solves for the
+coordinates of the subject's model with InverseKinematicsSolver::track(),
+starting from the solution for the previous sample, and pushes the values of
+the coordinates to the subject's output queue (see updOutputQueue()), which
+can be read from any thread.
+
+The samples of all subjects are solved by a fixed number of threads (see the
+constructor), so that the service can serve more subjects than there are
+cores. The samples of a subject are solved in order by one thread at a time.
+If the samples of a subject arrive faster than they are solved, the input
+queue of the subject fills up and its oldest samples are discarded, so that
+the latency does not grow; likewise, the oldest values in the output queue are
+discarded if it is not read. getStatistics() reports the number of samples
+solved and discarded, and percentiles of the latency from
+pushOrientations() to the values being in the output queue.
+
+As in IMUInverseKinematicsTool, the translational coordinates of the models
+are locked. The orientations must be expressed in the OpenSim ground frame;
+OrientationsFileReplay can play back the data of a file at the rate at which
+it was recorded, to test the service. */
+class OSIMTOOLS_API StreamingIMUInverseKinematics {
+public:
+    /** Statistics for one subject. Latencies are in seconds, over the most
+    recent solved samples (see setLatencyWindow()). */
+    struct Statistics {
+        /// Samples passed to pushOrientations().
+        long long numFramesReceived = 0;
+        /// Samples whose coordinates were pushed to the output queue.
+        long long numFramesSolved = 0;
+        /// Samples discarded because the input queue was full, plus solved
+        /// samples whose coordinates were discarded from the output queue
+        /// because it was full.
+        long long numFramesDropped = 0;
+        /// Samples for which the solver failed.
+        long long numFramesFailed = 0;
+        double latencyMedian = SimTK::NaN;
+        double latencyPercentile90 = SimTK::NaN;
+        double latencyPercentile99 = SimTK::NaN;
+        double latencyMax = SimTK::NaN;
+    };
+    typedef DataRingBuffer_<double> OutputQueue;
+
+    /** The samples are solved by `numThreads` threads; if `numThreads` is
+    less than 1, the number of cores is used. */
+    explicit StreamingIMUInverseKinematics(int numThreads = 1);
+    StreamingIMUInverseKinematics(const StreamingIMUInverseKinematics&) =
+            delete;
+    StreamingIMUInverseKinematics& operator=(
+            const StreamingIMUInverseKinematics&) = delete;
+    /** Calls stop(). */
+    ~StreamingIMUInverseKinematics();
+
+    int getNumThreads() const { return m_numThreads; }
+
+    /// @name Settings
+    /// These must be set before adding subjects.
+    /// @{
+    /** The accuracy of the solver (see AssemblySolver::setAccuracy()).
+    The default is 1e-4, as in IMUInverseKinematicsTool. */
+    void setAccuracy(double accuracy);
+    double getAccuracy() const { return m_accuracy; }
+    /** The number of samples of a subject that can wait to be solved
+    (default: 64). The queue is allocated with this capacity rounded up to a
+    power of 2 (see DataRingBuffer_::allocate()), so it can hold more
+    samples than this before discarding any. */
+    void setInputCapacity(int capacity);
+    int getInputCapacity() const { return m_inputCapacity; }
+    /** The number of solutions of a subject that can wait to be read from
+    its output queue (default: 1024). As for the input capacity, this is
+    rounded up to a power of 2; see OutputQueue::getCapacity(). */
+    void setOutputCapacity(int capacity);
+    int getOutputCapacity() const { return m_outputCapacity; }
+    /** The number of recent samples of a subject over which the latency
+    percentiles are computed (default: 1000). */
+    void setLatencyWindow(int numFrames);
+    int getLatencyWindow() const { return m_latencyWindow; }
+    /// @}
+
+    /** Add a subject whose sensors have the given names, which are the names
+    of frames in the model (as in the columns of the orientations file of
+    IMUInverseKinematicsTool); sensors that are not in the model are ignored.
+    The service uses its own copy of the model. This must be called before
+    start().
+    @returns The index of the subject, to use in the other methods.
+    @throws Exception if none of the sensors are frames of the model. */
+    int addSubject(const Model& model,
+            const std::vector<std::string>& sensorNames,
+            const Set<OrientationWeight>* weights = nullptr);
+    int getNumSubjects() const { return static_cast<int>(m_subjects.size()); }
+    const std::vector<std::string>& getSensorNames(int subject) const {
+        return getSubject(subject).sensorNames;
+    }
+    /** The names of the coordinates whose values are in the rows of the
+    output queue of the subject, in order. */
+    const std::vector<std::string>& getCoordinateNames(int subject) const {
+        return getSubject(subject).coordinateNames;
+    }
+
+    /** Start the threads that solve the samples.
+    @throws Exception if there are no subjects or the service is running. */
+    void start();
+    /** Stop the threads once they have solved the samples they are working
+    on. Samples that are waiting in the input queues are solved if the
+    service is started again. */
+    void stop();
+    bool isRunning() const { return !m_threads.empty(); }
+    /** Wait until the samples pushed so far have been solved.
+    @throws Exception if the service is not running. */
+    void waitUntilIdle() const;
+
+    /** Push the orientations of the sensors of a subject at the given time,
+    in the order of getSensorNames(). This does not wait for the sample to be
+    solved, does not allocate memory after the first call from a thread and
+    can be called from any thread, but the samples of a subject must be
+    pushed in order of time.
+    @throws Exception if the number of orientations is not the number of
+        sensors. */
+    void pushOrientations(int subject, double time,
+            const SimTK::RowVectorView_<SimTK::Rotation>& orientations);
+    /** Same as above. */
+    void pushOrientations(int subject, double time,
+            const SimTK::RowVector_<SimTK::Rotation>& orientations);
+
+    /** The queue in which the coordinate values of the subject are pushed,
+    with the time of the sample, in the order of getCoordinateNames(). Use
+    the consumer interface of the queue (e.g., `pop_front()` or `drain()`)
+    from any thread to read the values. */
+    OutputQueue& updOutputQueue(int subject) {
+        return updSubject(subject).output;
+    }
+
+    Statistics getStatistics(int subject) const;
+
+private:
+    struct Subject {
+        std::unique_ptr<Model> model;
+        SimTK::State state;
+        std::shared_ptr<BufferedOrientationsReference> reference;
+        std::unique_ptr<InverseKinematicsSolver> solver;
+        bool isAssembled = false;
+        std::vector<std::string> sensorNames;
+        std::vector<std::string> coordinateNames;
+        std::vector<SimTK::ReferencePtr<const Coordinate>> coordinates;
+
+        // The rows hold the time at which the sample was pushed followed by
+        // the 9 elements of each rotation.
+        DataRingBuffer_<double> input;
+        OutputQueue output;
+        // Set while a thread solves the samples of this subject.
+        std::atomic<bool> busy{false};
+
+        // Work space of the thread that solves the samples.
+        SimTK::RowVector_<SimTK::Rotation> orientations;
+        std::vector<double> coordinateValues;
+
+        std::atomic<long long> numFramesReceived{0};
+        mutable std::mutex statisticsMutex;
+        long long numFramesSolved = 0;
+        long long numFramesFailed = 0;
+        // Ring of the most recent latencies.
+        std::vector<double> latencies;
+        int numLatencies = 0;
+        int nextLatency = 0;
+    };
+
+    const Subject& getSubject(int subject) const;
+    Subject& updSubject(int subject) {
+        return const_cast<Subject&>(getSubject(subject));
+    }
+    void throwIfRunning(const std::string& action) const;
+    // Solve the samples of subjects until stop() is called.
+    void runWorker(int worker);
+    // Solve up to maxFrames samples of a subject that this thread claimed.
+    // Returns the number of samples taken from the input queue.
+    int solveFrames(Subject& subject, int maxFrames);
+
+    int m_numThreads;
+    double m_accuracy = 1e-4;
+    int m_inputCapacity = 64;
+    int m_outputCapacity = 1024;
+    int m_latencyWindow = 1000;
+    std::vector<std::unique_ptr<Subject>> m_subjects;
+    std::vector<std::thread> m_threads;
+    std::atomic<bool> m_running{false};
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_STREAMING_IMU_INVERSE_KINEMATICS_H_
@@ -0,0 +1,220 @@
+/* -------------------------------------------------------------------------- *
+ *             OpenSim:  testCMCAccelerationSensitivities.cpp                 *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+// Tests:
+// 1. CMC_TaskSet::computeAccelerationSensitivities() gives the change in the
+//    task accelerations per unit force of each actuator that is obtained by
+//    realizing the model with the actuator forces overridden, with and
+//    without a locked coordinate (a constraint).
+// 2. Unsupported actuators are reported.
+// 3. Coordinates of a BallJoint are supported with Euler angles but not with
+//    quaternions, for which the coordinates are not the generalized speeds.
+
+#include <OpenSim/Tools/CMC_Joint.h>
+#include <OpenSim/Tools/CMC_TaskSet.h>
+#include <OpenSim/Actuators/CoordinateActuator.h>
+#include <OpenSim/Actuators/TorqueActuator.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/SimbodyEngine/BallJoint.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+namespace {
+const std::vector<std::string> CoordinateNames{
+        "r_shoulder_elev", "r_elbow_flex"};
+
+// arm26 with a reserve actuator for each coordinate.
+Model* createArmModel() {
+    std::unique_ptr<Model> model{new Model("arm26.osim")};
+    for (const auto& name : CoordinateNames) {
+        auto* reserve = new CoordinateActuator(name);
+        reserve->setName(name + "_reserve");
+        reserve->setOptimalForce(10.0);
+        model->addForce(reserve);
+    }
+    return model.release();
+}
+
+void addJointTasks(Model& model, CMC_TaskSet& tasks) {
+    for (const auto& name : CoordinateNames) {
+        auto* task = new CMC_Joint(name);
+        task->setName(name);
+        task->setActive(true);
+        tasks.adoptAndAppend(task);
+    }
+    tasks.setModel(model);
+}
+
+// The task accelerations with the actuator forces overridden.
+SimTK::Vector calcTaskAccelerations(const Model& model, SimTK::State& s,
+        const Set<const Actuator>& actuators, CMC_TaskSet& tasks,
+        const SimTK::Vector& forces) {
+    for (int j = 0; j < actuators.getSize(); ++j) {
+        const auto& actuator =
+                dynamic_cast<const ScalarActuator&>(actuators[j]);
+        actuator.overrideActuation(s, true);
+        actuator.setOverrideActuation(s, forces[j]);
+    }
+    model.realizeAcceleration(s);
+    tasks.computeAccelerations(s);
+    const Array<double>& a = tasks.getAccelerations();
+    SimTK::Vector accelerations(a.getSize());
+    for (int i = 0; i < a.getSize(); ++i) accelerations[i] = a[i];
+    return accelerations;
+}
+} // anonymous namespace
+
+void testSensitivities(bool lockShoulder) {
+    std::unique_ptr<Model> model{createArmModel()};
+    SimTK::State& s = model->initSystem();
+    const auto& coordinates = model->getCoordinateSet();
+    coordinates.get("r_shoulder_elev").setValue(s, 0.3);
+    coordinates.get("r_elbow_flex").setValue(s, 0.8);
+    coordinates.get("r_shoulder_elev").setSpeedValue(s, -0.2);
+    coordinates.get("r_elbow_flex").setSpeedValue(s, 0.5);
+    if (lockShoulder) {
+        coordinates.get("r_shoulder_elev").setSpeedValue(s, 0);
+        coordinates.get("r_shoulder_elev").setLocked(s, true);
+    }
+
+    Set<const Actuator> actuators;
+    actuators.setMemoryOwner(false);
+    for (const auto& actuator : model->getComponentList<Actuator>()) {
+        actuators.adoptAndAppend(&actuator);
+    }
+    const int na = actuators.getSize();
+    CMC_TaskSet tasks;
+    addJointTasks(*model, tasks);
+
+    SimTK::Vector forces(na, 0.0);
+    const SimTK::Vector baseline =
+            calcTaskAccelerations(*model, s, actuators, tasks, forces);
+    if (lockShoulder) ASSERT(s.getNMultipliers() > 0);
+
+    SimTK::Matrix sensitivities;
+    ASSERT(tasks.computeAccelerationSensitivities(s, actuators,
+            sensitivities));
+    ASSERT(sensitivities.nrow() == 2);
+    ASSERT(sensitivities.ncol() == na);
+
+    for (int j = 0; j < na; ++j) {
+        forces[j] = 1;
+        const SimTK::Vector change =
+                calcTaskAccelerations(*model, s, actuators, tasks, forces) -
+                baseline;
+        forces[j] = 0;
+        for (int i = 0; i < 2; ++i) {
+            ASSERT_EQUAL(change[i], sensitivities(i, j),
+                    1e-8 * (1 + std::abs(change[i])), __FILE__, __LINE__,
+                    "Sensitivity of task " + CoordinateNames[i] +
+                            " to actuator " + actuators[j].getName() +
+                            " is wrong.");
+        }
+        if (lockShoulder) {
+            ASSERT_EQUAL(0.0, sensitivities(0, j), 1e-8);
+        }
+    }
+}
+
+void testUnsupportedActuator() {
+    std::unique_ptr<Model> model{createArmModel()};
+    model->addForce(new TorqueActuator(model->getGround(),
+            model->getBodySet().get("r_humerus"), SimTK::Vec3(0, 0, 1)));
+    SimTK::State& s = model->initSystem();
+    Set<const Actuator> actuators;
+    actuators.setMemoryOwner(false);
+    for (const auto& actuator : model->getComponentList<Actuator>()) {
+        actuators.adoptAndAppend(&actuator);
+    }
+    CMC_TaskSet tasks;
+    addJointTasks(*model, tasks);
+    SimTK::Matrix sensitivities;
+    ASSERT(!tasks.computeAccelerationSensitivities(s, actuators,
+            sensitivities));
+    ASSERT(sensitivities.nrow() == 0);
+}
+
+void testBallJoint() {
+    Model model;
+    auto* body = new OpenSim::Body("body", 2.0, SimTK::Vec3(0, -0.2, 0),
+            SimTK::Inertia(0.1, 0.2, 0.3));
+    model.addBody(body);
+    auto* ball = new BallJoint("ball", model.getGround(), SimTK::Vec3(0),
+            SimTK::Vec3(0), *body, SimTK::Vec3(0), SimTK::Vec3(0));
+    const std::string coordName = "ball_rx";
+    ball->updCoordinate(BallJoint::Coord::Rotation1X).setName(coordName);
+    model.addJoint(ball);
+    auto* actuator = new CoordinateActuator(coordName);
+    actuator->setName("ball_rx_actuator");
+    model.addForce(actuator);
+
+    Set<const Actuator> actuators;
+    actuators.setMemoryOwner(false);
+    actuators.adoptAndAppend(actuator);
+    CMC_TaskSet tasks;
+    auto* task = new CMC_Joint(coordName);
+    task->setName(coordName);
+    task->setActive(true);
+    tasks.adoptAndAppend(task);
+    tasks.setModel(model);
+
+    SimTK::State& s = model.initSystem();
+    ASSERT(s.getNQ() == 4 && s.getNU() == 3);
+    SimTK::Matrix sensitivities;
+    ASSERT(!tasks.computeAccelerationSensitivities(s, actuators,
+            sensitivities));
+    ASSERT(sensitivities.nrow() == 0);
+
+    model.updMatterSubsystem().setUseEulerAngles(s, true);
+    model.getMultibodySystem().realizeModel(s);
+    ASSERT(s.getNQ() == 3);
+    model.getCoordinateSet().get(coordName).setValue(s, 0.4);
+    model.getCoordinateSet().get(coordName).setSpeedValue(s, 0.3);
+    SimTK::Vector forces(1, 0.0);
+    const SimTK::Vector baseline =
+            calcTaskAccelerations(model, s, actuators, tasks, forces);
+    ASSERT(tasks.computeAccelerationSensitivities(s, actuators,
+            sensitivities));
+    forces[0] = 1;
+    const SimTK::Vector change =
+            calcTaskAccelerations(model, s, actuators, tasks, forces) -
+            baseline;
+    ASSERT_EQUAL(change[0], sensitivities(0, 0),
+            1e-8 * (1 + std::abs(change[0])));
+}
+
+int main() {
+    try {
+        testSensitivities(false);
+        testSensitivities(true);
+        testUnsupportedActuator();
+        testBallJoint();
+    } catch (const std::exception& e) {
+        log_error("testCMCAccelerationSensitivities failed: {}", e.what());
+        return 1;
+    }
+    log_info("testCMCAccelerationSensitivities passed.");
+    return 0;
+}
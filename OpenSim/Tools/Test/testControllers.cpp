@@ -26,7 +26,8 @@
 //  that controllers behave as described.
 //
 //  Tests Include:
-//  1. Test a ControlSetController on a block with an ideal actuator
+//  1. Test a ControlSetController on a block with an ideal actuator, and
+//     the CompiledControlSet it evaluates the controls with
 //  2. Test a PrescribedController on a block with an ideal actuator
 //  3. Test a CorrectionController tracking a block with an ideal actuator
 //  4. Test a PrescribedController on the arm26 model with reserves.
@@ -41,6 +42,7 @@ using namespace OpenSim;
 using namespace std;
 
 void testControlSetControllerOnBlock();
+void testCompiledControlSet();
 void testPrescribedControllerOnBlock(bool enabled);
 void testCorrectionControllerOnBlock();
 void testPrescribedControllerFromFile(const std::string& modelFile,
@@ -52,6 +54,7 @@ int main()
     try {
         log_info("Testing ControlSetController"); 
         testControlSetControllerOnBlock();
+        testCompiledControlSet();
         log_info("Testing PrescribedController"); 
         testPrescribedControllerOnBlock(true);
         testPrescribedControllerOnBlock(false);
@@ -165,6 +168,77 @@ void testControlSetControllerOnBlock()
 }// end of testControlSetControllerOnBlock()
 
 
+//==========================================================================================================
+void testCompiledControlSet()
+{
+    ControlSet controlSet;
+    auto addLinear = [&](const std::string& name,
+            const std::vector<std::pair<double, double>>& nodes,
+            bool useSteps, bool extrapolate) {
+        auto* control = new ControlLinear();
+        control->setName(name);
+        control->setUseSteps(useSteps);
+        control->setExtrapolate(extrapolate);
+        for (const auto& node : nodes)
+            control->setControlValue(node.first, node.second);
+        controlSet.adoptAndAppend(control);
+    };
+    addLinear("linear", {{0.0, 1.0}, {0.1, -2.0}, {0.35, 0.5}, {1.0, 3.0}},
+            false, false);
+    addLinear("extrapolated", {{0.05, 0.2}, {0.2, 0.4}, {0.9, -0.1}},
+            false, true);
+    addLinear("steps", {{0.0, 0.3}, {0.25, 0.7}, {0.5, 0.1}, {0.75, 0.9}},
+            true, false);
+    addLinear("single", {{0.4, 2.5}}, false, true);
+    addLinear("empty", {}, false, false);
+    controlSet.adoptAndAppend(new ControlConstant(0.6, "constant"));
+
+    CompiledControlSet compiled(controlSet, false);
+    const int numControls = controlSet.getSize(false);
+    ASSERT(compiled.getNumControls() == numControls);
+
+    // Evaluate at the node times and between them, before the first and
+    // after the last, in increasing and then in random order.
+    std::vector<double> times;
+    for (double t = -0.2; t <= 1.2; t += 0.0125) times.push_back(t);
+    for (double t : {0.0, 0.05, 0.1, 0.2, 0.25, 0.35, 0.4, 0.5, 0.75, 0.9,
+                 1.0}) {
+        times.push_back(t);
+    }
+    std::sort(times.begin(), times.end());
+    SimTK::Random::Uniform random(0.0, 1.0);
+    random.setSeed(0);
+    std::vector<double> shuffled = times;
+    for (int i = (int)shuffled.size() - 1; i > 0; --i) {
+        std::swap(shuffled[i], shuffled[(int)(random.getValue() * (i + 1))]);
+    }
+    times.insert(times.end(), shuffled.begin(), shuffled.end());
+
+    std::vector<double> values(numControls);
+    Array<double> expected;
+    int interval = 0;
+    for (double t : times) {
+        compiled.calcValues(t, values.data(), interval);
+        controlSet.getControlValues(t, expected, false);
+        for (int c = 0; c < numControls; ++c) {
+            if (SimTK::isNaN(expected[c])) {
+                ASSERT(SimTK::isNaN(values[c]), __FILE__, __LINE__,
+                        "Expected NaN for an empty control.");
+            } else {
+                ASSERT_EQUAL(expected[c], values[c], 1e-12, __FILE__,
+                        __LINE__, "CompiledControlSet value of '" +
+                        controlSet[c].getName() + "' differs at time " +
+                        std::to_string(t) + ".");
+            }
+        }
+    }
+
+    // Only model controls.
+    controlSet[0].setIsModelControl(false);
+    CompiledControlSet compiledModelControls(controlSet);
+    ASSERT(compiledModelControls.getNumControls() == numControls - 1);
+}
+
 //==========================================================================================================
 void testPrescribedControllerOnBlock(bool enabled)
 {
@@ -0,0 +1,240 @@
+/* -------------------------------------------------------------------------- *
+ *             OpenSim:  testStreamingIMUInverseKinematics.cpp                *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Tests:
+// 1. StreamingIMUInverseKinematics recovers the coordinates of a model from
+//    the orientations of its sensors, played back from a file at the rate at
+//    which they were recorded, for several subjects at once.
+// 2. Samples that arrive faster than they are solved are dropped and counted.
+// 3. Invalid use of the service throws.
+
+#include <OpenSim/Tools/StreamingIMUInverseKinematics.h>
+#include <OpenSim/Tools/OrientationsFileReplay.h>
+#include <OpenSim/Common/STOFileAdapter.h>
+#include <OpenSim/Simulation/Model/PhysicalOffsetFrame.h>
+#include <OpenSim/Simulation/SimbodyEngine/PinJoint.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+namespace {
+const std::vector<std::string> SensorNames{"thigh_imu", "shank_imu",
+                                           "foot_imu"};
+const std::vector<std::string> BodyNames{"thigh", "shank", "foot"};
+const std::string OrientationsFile = "streaming_leg_orientations.sto";
+
+Model* constructLegWithIMUs() {
+    std::unique_ptr<Model> leg{new Model()};
+    leg->setName("leg");
+    auto* thigh = new Body("thigh", 5.0, SimTK::Vec3(0),
+            SimTK::Inertia::cylinderAlongY(0.1, 0.5));
+    leg->addBody(thigh);
+    auto* shank = new Body("shank", 2.0, SimTK::Vec3(0),
+            SimTK::Inertia::cylinderAlongY(0.04, 0.4));
+    leg->addBody(shank);
+    auto* foot = new Body("foot", 1.0, SimTK::Vec3(0),
+            SimTK::Inertia::cylinderAlongY(0.02, 0.1));
+    leg->addBody(foot);
+
+    auto* hip = new PinJoint("hip", leg->getGround(), SimTK::Vec3(0, 1.0, 0),
+            SimTK::Vec3(0), *thigh, SimTK::Vec3(0, 0.25, 0), SimTK::Vec3(0));
+    hip->updCoordinate().setName("hip_flexion");
+    leg->addJoint(hip);
+    auto* knee = new PinJoint("knee", *thigh, SimTK::Vec3(0, -0.25, 0),
+            SimTK::Vec3(0), *shank, SimTK::Vec3(0, 0.2, 0), SimTK::Vec3(0));
+    knee->updCoordinate().setName("knee_flexion");
+    leg->addJoint(knee);
+    auto* ankle = new PinJoint("ankle", *shank, SimTK::Vec3(0, -0.2, 0),
+            SimTK::Vec3(0), *foot, SimTK::Vec3(0, 0.1, 0), SimTK::Vec3(0));
+    ankle->updCoordinate().setName("ankle_flexion");
+    leg->addJoint(ankle);
+
+    const SimTK::Transform offset(SimTK::Rotation(0.378, SimTK::YAxis));
+    thigh->addComponent(new PhysicalOffsetFrame("thigh_imu", *thigh, offset));
+    shank->addComponent(new PhysicalOffsetFrame("shank_imu", *shank, offset));
+    foot->addComponent(new PhysicalOffsetFrame("foot_imu", *foot, offset));
+    return leg.release();
+}
+
+// The coordinates of the leg at a time.
+SimTK::Vec3 calcCoordinateValues(double time) {
+    return SimTK::Vec3(0.5 * std::sin(2 * SimTK::Pi * time),
+            -0.8 * (1 - std::cos(2 * SimTK::Pi * time)),
+            0.3 * std::sin(4 * SimTK::Pi * time));
+}
+
+// Write the orientations of the sensors of the leg, sampled at 100 Hz for
+// `duration` seconds, to OrientationsFile.
+TimeSeriesTable_<SimTK::Rotation> writeOrientationsFile(
+        Model& leg, double duration) {
+    SimTK::State state = leg.initSystem();
+    const auto& coordinates = leg.getCoordinateSet();
+    TimeSeriesTable_<SimTK::Rotation> orientations;
+    orientations.setColumnLabels(SensorNames);
+    TimeSeriesTable_<SimTK::Quaternion> quaternions;
+    quaternions.setColumnLabels(SensorNames);
+    const int numSamples = static_cast<int>(std::round(100 * duration)) + 1;
+    for (int i = 0; i < numSamples; ++i) {
+        const double time = 0.01 * i;
+        const SimTK::Vec3 q = calcCoordinateValues(time);
+        for (int j = 0; j < 3; ++j) coordinates[j].setValue(state, q[j]);
+        leg.realizePosition(state);
+        SimTK::RowVector_<SimTK::Rotation> rotations(3);
+        SimTK::RowVector_<SimTK::Quaternion> quats(3);
+        for (int j = 0; j < 3; ++j) {
+            rotations[j] = leg.getComponent<PhysicalFrame>(
+                    "/bodyset/" + BodyNames[j] + "/" + SensorNames[j])
+                    .getTransformInGround(state).R();
+            quats[j] = rotations[j].convertRotationToQuaternion();
+        }
+        orientations.appendRow(time, rotations);
+        quaternions.appendRow(time, quats);
+    }
+    quaternions.updTableMetaData().setValueForKey<std::string>(
+            "DataRate", "100");
+    STOFileAdapter_<SimTK::Quaternion>::write(quaternions, OrientationsFile);
+    return orientations;
+}
+
+// Check that the rows of the output queue hold the coordinates of the leg.
+int checkOutputQueue(StreamingIMUInverseKinematics::OutputQueue& output) {
+    int numRows = 0;
+    output.drain([&](double time, const double* values) {
+        const SimTK::Vec3 expected = calcCoordinateValues(time);
+        for (int j = 0; j < 3; ++j) {
+            ASSERT_EQUAL(expected[j], values[j], 1e-3, __FILE__, __LINE__,
+                    "Coordinate " + std::to_string(j) + " is wrong at time " +
+                            std::to_string(time) + ".");
+        }
+        ++numRows;
+    });
+    return numRows;
+}
+} // anonymous namespace
+
+void testReplayForSeveralSubjects() {
+    std::unique_ptr<Model> leg{constructLegWithIMUs()};
+    const double duration = 0.5;
+    writeOrientationsFile(*leg, duration);
+
+    const int numSubjects = 3;
+    StreamingIMUInverseKinematics service(2);
+    std::vector<std::unique_ptr<OrientationsFileReplay>> replays;
+    for (int i = 0; i < numSubjects; ++i) {
+        replays.emplace_back(new OrientationsFileReplay(OrientationsFile));
+        ASSERT(replays.back()->getSensorNames() == SensorNames);
+        ASSERT(service.addSubject(*leg, SensorNames) == i);
+    }
+    ASSERT(service.getCoordinateNames(0) ==
+            std::vector<std::string>({"hip_flexion", "knee_flexion",
+                    "ankle_flexion"}));
+
+    service.start();
+    for (int i = 0; i < numSubjects; ++i) replays[i]->start(service, i);
+    for (auto& replay : replays) replay->wait();
+    service.waitUntilIdle();
+    service.stop();
+
+    const int numSamples = replays[0]->getNumRowsPlayed();
+    ASSERT(numSamples == (int)replays[0]->getOrientations().getNumRows());
+    for (int i = 0; i < numSubjects; ++i) {
+        const auto statistics = service.getStatistics(i);
+        log_info("Subject {}: {} samples solved, {} dropped, latency median "
+                 "{:.2e} s, 90% {:.2e} s, 99% {:.2e} s, max {:.2e} s.",
+                i, statistics.numFramesSolved, statistics.numFramesDropped,
+                statistics.latencyMedian, statistics.latencyPercentile90,
+                statistics.latencyPercentile99, statistics.latencyMax);
+        ASSERT(statistics.numFramesReceived == numSamples);
+        ASSERT(statistics.numFramesFailed == 0);
+        ASSERT(statistics.numFramesSolved + statistics.numFramesDropped ==
+                numSamples);
+        ASSERT(statistics.latencyMedian > 0);
+        ASSERT(statistics.latencyMedian <= statistics.latencyPercentile90);
+        ASSERT(statistics.latencyPercentile90 <=
+                statistics.latencyPercentile99);
+        ASSERT(statistics.latencyPercentile99 <= statistics.latencyMax);
+        ASSERT(checkOutputQueue(service.updOutputQueue(i)) ==
+                statistics.numFramesSolved);
+    }
+}
+
+void testDroppedFrames() {
+    std::unique_ptr<Model> leg{constructLegWithIMUs()};
+    const auto orientations = writeOrientationsFile(*leg, 1.0);
+
+    StreamingIMUInverseKinematics service(1);
+    service.setInputCapacity(4);
+    service.setOutputCapacity(2);
+    service.addSubject(*leg, SensorNames);
+    ASSERT(service.updOutputQueue(0).getCapacity() == 2);
+    // Only the 4 most recent samples wait to be solved, and the solutions of
+    // the 2 most recent ones wait to be read.
+    const int numSamples = (int)orientations.getNumRows();
+    for (int i = 0; i < numSamples; ++i) {
+        service.pushOrientations(0, orientations.getIndependentColumn()[i],
+                orientations.getRowAtIndex(i));
+    }
+    service.start();
+    service.waitUntilIdle();
+    service.stop();
+
+    const auto statistics = service.getStatistics(0);
+    ASSERT(statistics.numFramesReceived == numSamples);
+    ASSERT(statistics.numFramesDropped == numSamples - 4 + 2);
+    ASSERT(statistics.numFramesSolved == 4);
+    double firstTime = SimTK::NaN;
+    service.updOutputQueue(0).drain([&](double time, const double*) {
+        if (SimTK::isNaN(firstTime)) firstTime = time;
+    });
+    ASSERT_EQUAL(orientations.getIndependentColumn()[numSamples - 2],
+            firstTime, 1e-12);
+}
+
+void testInvalidUse() {
+    std::unique_ptr<Model> leg{constructLegWithIMUs()};
+    StreamingIMUInverseKinematics service;
+    ASSERT_THROW(Exception, service.start());
+    ASSERT_THROW(Exception, service.addSubject(*leg, {"pelvis_imu"}));
+    service.addSubject(*leg, SensorNames);
+    ASSERT_THROW(Exception, service.setAccuracy(1e-5));
+    ASSERT_THROW(Exception, service.pushOrientations(0, 0.0,
+            SimTK::RowVector_<SimTK::Rotation>(2)));
+    ASSERT_THROW(IndexOutOfRange, service.getStatistics(1));
+    service.start();
+    ASSERT_THROW(Exception, service.addSubject(*leg, SensorNames));
+    service.stop();
+    ASSERT(!service.isRunning());
+}
+
+int main() {
+    try {
+        testReplayForSeveralSubjects();
+        testDroppedFrames();
+        testInvalidUse();
+    } catch (const std::exception& e) {
+        log_error("testStreamingIMUInverseKinematics failed: {}", e.what());
+        return 1;
+    }
+    log_info("testStreamingIMUInverseKinematics passed.");
+    return 0;
+}
@@ -0,0 +1,268 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testToolPipeline.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Tests:
+// 1. ToolPipeline runs inverse kinematics, inverse dynamics and static
+//    optimization for several trials on several threads, with the file names
+//    of the setup files relative to the setup files, and the results are
+//    those of the tools run one at a time from their setup files.
+// 2. A stage that fails stops the pipeline, and invalid trials are rejected.
+
+#include <OpenSim/Tools/ToolPipeline.h>
+#include <OpenSim/Tools/AnalyzeTool.h>
+#include <OpenSim/Tools/IKMarkerTask.h>
+#include <OpenSim/Tools/InverseDynamicsTool.h>
+#include <OpenSim/Tools/InverseKinematicsTool.h>
+#include <OpenSim/Actuators/CoordinateActuator.h>
+#include <OpenSim/Analyses/StaticOptimization.h>
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/TRCFileAdapter.h>
+#include <OpenSim/Simulation/SimbodyEngine/PinJoint.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+namespace {
+const std::string TrialDir = "pipeline_trials";
+const std::string ModelFile = "pipeline_arm.osim";
+const std::vector<std::string> MarkerNames{"upper_arm_1", "upper_arm_2",
+                                           "forearm_1", "forearm_2"};
+
+Model* constructArm() {
+    std::unique_ptr<Model> arm{new Model()};
+    arm->setName("arm");
+    auto* upperArm = new Body("upper_arm", 2.0, SimTK::Vec3(0, -0.15, 0),
+            SimTK::Inertia::cylinderAlongY(0.04, 0.15));
+    arm->addBody(upperArm);
+    auto* forearm = new Body("forearm", 1.0, SimTK::Vec3(0, -0.125, 0),
+            SimTK::Inertia::cylinderAlongY(0.03, 0.125));
+    arm->addBody(forearm);
+
+    auto* shoulder = new PinJoint("shoulder", arm->getGround(),
+            SimTK::Vec3(0, 1.5, 0), SimTK::Vec3(0), *upperArm,
+            SimTK::Vec3(0), SimTK::Vec3(0));
+    shoulder->updCoordinate().setName("shoulder_flexion");
+    arm->addJoint(shoulder);
+    auto* elbow = new PinJoint("elbow", *upperArm, SimTK::Vec3(0, -0.3, 0),
+            SimTK::Vec3(0), *forearm, SimTK::Vec3(0), SimTK::Vec3(0));
+    elbow->updCoordinate().setName("elbow_flexion");
+    arm->addJoint(elbow);
+
+    arm->addMarker(new Marker(MarkerNames[0], *upperArm,
+            SimTK::Vec3(0.03, -0.1, 0)));
+    arm->addMarker(new Marker(MarkerNames[1], *upperArm,
+            SimTK::Vec3(-0.03, -0.25, 0)));
+    arm->addMarker(new Marker(MarkerNames[2], *forearm,
+            SimTK::Vec3(0.02, -0.08, 0)));
+    arm->addMarker(new Marker(MarkerNames[3], *forearm,
+            SimTK::Vec3(-0.02, -0.22, 0)));
+
+    for (const std::string coordinate : {"shoulder_flexion", "elbow_flexion"}) {
+        auto* actuator = new CoordinateActuator(coordinate);
+        actuator->setName(coordinate + "_actuator");
+        actuator->setOptimalForce(100);
+        arm->addForce(actuator);
+    }
+    return arm.release();
+}
+
+// The coordinates of the arm in trial `trial` at a time.
+SimTK::Vec2 calcCoordinateValues(int trial, double time) {
+    return SimTK::Vec2((0.3 + 0.1 * trial) * std::sin(2 * SimTK::Pi * time),
+            (0.5 + 0.1 * trial) * (1 - std::cos(2 * SimTK::Pi * time)));
+}
+
+// Write the markers of the arm in a trial, sampled at 100 Hz for one second,
+// and the setup files of the tools of the trial, which refer to the files
+// relative to TrialDir.
+ToolPipeline::Trial writeTrial(Model& arm, int trial) {
+    const std::string name = "trial" + std::to_string(trial);
+    SimTK::State state = arm.initSystem();
+    const auto& coordinates = arm.getCoordinateSet();
+    TimeSeriesTableVec3 markers;
+    markers.setColumnLabels(MarkerNames);
+    for (int i = 0; i <= 100; ++i) {
+        const double time = 0.01 * i;
+        const SimTK::Vec2 q = calcCoordinateValues(trial, time);
+        for (int j = 0; j < 2; ++j) coordinates[j].setValue(state, q[j]);
+        arm.realizePosition(state);
+        SimTK::RowVector_<SimTK::Vec3> locations(4);
+        for (int j = 0; j < 4; ++j) {
+            locations[j] = arm.getMarkerSet().get(MarkerNames[j])
+                    .getLocationInGround(state);
+        }
+        markers.appendRow(time, locations);
+    }
+    markers.updTableMetaData().setValueForKey<std::string>("DataRate", "100");
+    markers.updTableMetaData().setValueForKey<std::string>("Units", "m");
+    TRCFileAdapter::write(markers, TrialDir + "/" + name + ".trc");
+
+    InverseKinematicsTool ik;
+    ik.setName(name);
+    ik.set_model_file("../" + ModelFile);
+    ik.setMarkerDataFileName(name + ".trc");
+    for (const auto& marker : MarkerNames) {
+        auto* task = new IKMarkerTask();
+        task->setName(marker);
+        task->setWeight(1.0);
+        ik.getIKTaskSet().adoptAndAppend(task);
+    }
+    ik.set_report_errors(false);
+    ik.setOutputMotionFileName(name + "_ik.mot");
+    ik.setResultsDir("results");
+    ik.print(TrialDir + "/" + name + "_ik.xml");
+
+    InverseDynamicsTool id;
+    id.setName(name);
+    id.setModelFileName("../" + ModelFile);
+    id.setStartTime(0);
+    id.setEndTime(1);
+    id.setResultsDir("results");
+    id.setOutputGenForceFileName(name + "_id.sto");
+    id.print(TrialDir + "/" + name + "_id.xml");
+
+    AnalyzeTool so;
+    so.setName(name);
+    so.setModelFilename("../" + ModelFile);
+    so.setInitialTime(0);
+    so.setFinalTime(1);
+    so.setResultsDir("results");
+    so.updAnalysisSet().adoptAndAppend(new StaticOptimization());
+    so.print(TrialDir + "/" + name + "_so.xml");
+
+    return {TrialDir + "/" + name + "_ik.xml", TrialDir + "/" + name + "_id.xml",
+            TrialDir + "/" + name + "_so.xml"};
+}
+} // anonymous namespace
+
+void testPipelineForSeveralTrials() {
+    std::unique_ptr<Model> arm{constructArm()};
+    arm->print(ModelFile);
+    IO::makeDir(TrialDir);
+
+    const int numTrials = 3;
+    ToolPipeline pipeline(2);
+    for (int i = 0; i < numTrials; ++i) {
+        ASSERT(pipeline.addTrial(writeTrial(*arm, i)) == i);
+    }
+    pipeline.run();
+    pipeline.printTimingReport();
+
+    const auto& timings = pipeline.getStageTimings();
+    ASSERT(timings.size() == ToolPipeline::NumStages);
+    for (const auto& timing : timings) {
+        ASSERT(timing.numTrials == numTrials);
+        ASSERT(timing.totalTime > 0);
+        ASSERT(timing.maxTime <= timing.totalTime);
+    }
+    ASSERT(pipeline.getWallTime() > 0);
+
+    // Inverse kinematics recovers the coordinates.
+    for (int trial = 0; trial < numTrials; ++trial) {
+        Storage motion(TrialDir + "/trial" + std::to_string(trial) + "_ik.mot");
+        Array<double> times, shoulder, elbow;
+        motion.getTimeColumn(times);
+        motion.getDataColumn("shoulder_flexion", shoulder);
+        motion.getDataColumn("elbow_flexion", elbow);
+        ASSERT(times.getSize() == 101);
+        for (int i = 0; i < times.getSize(); ++i) {
+            const SimTK::Vec2 q = calcCoordinateValues(trial, times[i]);
+            ASSERT_EQUAL(SimTK::convertRadiansToDegrees(q[0]), shoulder[i],
+                    1e-2);
+            ASSERT_EQUAL(SimTK::convertRadiansToDegrees(q[1]), elbow[i],
+                    1e-2);
+        }
+    }
+
+    // Inverse dynamics and static optimization give the same results as when
+    // they read the output motion file of inverse kinematics.
+    InverseDynamicsTool id(TrialDir + "/trial0_id.xml");
+    id.setCoordinatesFileName("trial0_ik.mot");
+    id.setOutputGenForceFileName("serial_trial0_id.sto");
+    ASSERT(id.run());
+    Storage pipelineForces(TrialDir + "/results/trial0_id.sto");
+    Storage serialForces(TrialDir + "/results/serial_trial0_id.sto");
+    ASSERT(pipelineForces.getSize() == serialForces.getSize());
+    CHECK_STORAGE_AGAINST_STANDARD(pipelineForces, serialForces,
+            std::vector<double>(serialForces.getSmallestNumberOfStates(), 1e-3),
+            __FILE__, __LINE__, "Inverse dynamics differs.");
+
+    // The number of threads of inverse dynamics is read from the setup file.
+    id.setNumThreads(3);
+    id.setOutputGenForceFileName("threads_trial0_id.sto");
+    id.print(TrialDir + "/threads_trial0_id.xml");
+    InverseDynamicsTool threadsId(TrialDir + "/threads_trial0_id.xml");
+    ASSERT(threadsId.getNumThreads() == 3);
+    ASSERT(threadsId.run());
+    Storage threadsForces(TrialDir + "/results/threads_trial0_id.sto");
+    CHECK_STORAGE_AGAINST_STANDARD(threadsForces, serialForces,
+            std::vector<double>(serialForces.getSmallestNumberOfStates(), 1e-12),
+            __FILE__, __LINE__, "Inverse dynamics on threads differs.");
+
+    AnalyzeTool so(TrialDir + "/trial0_so.xml");
+    so.setName("serial_trial0");
+    so.setCoordinatesFileName("trial0_ik.mot");
+    ASSERT(so.run());
+    Storage pipelineActivations(
+            TrialDir + "/results/trial0_StaticOptimization_activation.sto");
+    Storage serialActivations(TrialDir +
+            "/results/serial_trial0_StaticOptimization_activation.sto");
+    ASSERT(pipelineActivations.getSize() == serialActivations.getSize());
+    CHECK_STORAGE_AGAINST_STANDARD(pipelineActivations, serialActivations,
+            std::vector<double>(
+                    serialActivations.getSmallestNumberOfStates(), 1e-3),
+            __FILE__, __LINE__, "Static optimization differs.");
+}
+
+void testFailures() {
+    ToolPipeline pipeline;
+    ASSERT_THROW(Exception, pipeline.run());
+    ASSERT_THROW(Exception, pipeline.addTrial({"", "", ""}));
+    ASSERT_THROW(Exception,
+            pipeline.addTrial({TrialDir + "/missing_ik.xml", "", ""}));
+    ASSERT_THROW(Exception, pipeline.getTrial(0));
+
+    // The inverse dynamics setup file refers to a model that does not exist.
+    InverseDynamicsTool id(TrialDir + "/trial0_id.xml");
+    id.setModelFileName("missing.osim");
+    id.print(TrialDir + "/missing_model_id.xml");
+    pipeline.addTrial({TrialDir + "/trial1_ik.xml",
+            TrialDir + "/missing_model_id.xml", TrialDir + "/trial1_so.xml"});
+    ASSERT_THROW(Exception, pipeline.run());
+    const auto& timings = pipeline.getStageTimings();
+    ASSERT(timings[ToolPipeline::InverseKinematics].numTrials == 1);
+    ASSERT(timings[ToolPipeline::InverseDynamics].numTrials == 0);
+    ASSERT(timings[ToolPipeline::Analyze].numTrials == 0);
+}
+
+int main() {
+    try {
+        testPipelineForSeveralTrials();
+        testFailures();
+    } catch (const std::exception& e) {
+        log_error("testToolPipeline failed: {}", e.what());
+        return 1;
+    }
+    log_info("testToolPipeline passed.");
+    return 0;
+}
@@ -0,0 +1,288 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  ToolPipeline.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ToolPipeline.h"
+
+#include "AnalyzeTool.h"
+#include "InverseDynamicsTool.h"
+#include "InverseKinematicsTool.h"
+#include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Simulation/Control/ControlSetController.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include <SimTKcommon/internal/Pathname.h>
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+using namespace OpenSim;
+
+namespace {
+// The absolute path of a file name in a setup file, which is relative to the
+// directory of the setup file.
+std::string resolvePath(
+        const std::string& setupFile, const std::string& fileName) {
+    if (fileName.empty() || fileName == "Unassigned") return fileName;
+    return SimTK::Pathname::getAbsolutePathnameUsingSpecifiedWorkingDirectory(
+            IO::getParentDirectory(setupFile), fileName);
+}
+
+// The tools are copied from the tools read from the setup files, so that they
+// are not associated with the setup files and do not change the working
+// directory while they run; the file names are made absolute instead.
+std::unique_ptr<Storage> runInverseKinematics(const std::string& setupFile) {
+    std::unique_ptr<InverseKinematicsTool> tool(
+            InverseKinematicsTool(setupFile, false).clone());
+    tool->set_model_file(resolvePath(setupFile, tool->get_model_file()));
+    tool->setMarkerDataFileName(
+            resolvePath(setupFile, tool->getMarkerDataFileName()));
+    tool->setCoordinateFileName(
+            resolvePath(setupFile, tool->getCoordinateFileName()));
+    tool->setOutputMotionFileName(
+            resolvePath(setupFile, tool->getOutputMotionFileName()));
+    tool->setResultsDir(resolvePath(setupFile, tool->getResultsDir()));
+    tool->setKeepOutputMotion(true);
+    OPENSIM_THROW_IF(!tool->run(), Exception,
+            "InverseKinematicsTool '{}' failed.", tool->getName());
+    OPENSIM_THROW_IF(!tool->getOutputMotion(), Exception,
+            "InverseKinematicsTool '{}' did not produce a motion.",
+            tool->getName());
+    return tool->releaseOutputMotion();
+}
+
+void runInverseDynamics(const std::string& setupFile, const Storage& motion) {
+    std::unique_ptr<InverseDynamicsTool> tool(
+            InverseDynamicsTool(setupFile, false).clone());
+    tool->setModelFileName(resolvePath(setupFile, tool->getModelFileName()));
+    tool->setExternalLoadsFileName(
+            resolvePath(setupFile, tool->getExternalLoadsFileName()));
+    tool->setResultsDir(resolvePath(setupFile, tool->getResultsDir()));
+    tool->setCoordinateValues(motion);
+    OPENSIM_THROW_IF(!tool->run(), Exception,
+            "InverseDynamicsTool '{}' failed.", tool->getName());
+}
+
+void runAnalyze(const std::string& setupFile, const Storage& motion) {
+    std::unique_ptr<AnalyzeTool> tool(AnalyzeTool(setupFile, false).clone());
+    tool->setExternalLoadsFileName(
+            resolvePath(setupFile, tool->getExternalLoadsFileName()));
+    tool->setResultsDir(resolvePath(setupFile, tool->getResultsDir()));
+    auto& controllers = tool->updControllerSet();
+    for (int i = 0; i < controllers.getSize(); ++i) {
+        if (auto* controller =
+                        dynamic_cast<ControlSetController*>(&controllers[i])) {
+            controller->setControlSetFileName(resolvePath(
+                    setupFile, controller->getControlSetFileName()));
+        }
+    }
+
+    // As in the constructor of AnalyzeTool that loads the model, but the
+    // pipeline owns the model.
+    OPENSIM_THROW_IF(tool->getModelFilename().empty(), Exception,
+            "No model file was specified in '{}'.", setupFile);
+    std::unique_ptr<Model> model(
+            new Model(resolvePath(setupFile, tool->getModelFilename())));
+    model->finalizeFromProperties();
+    tool->updateModelForces(*model, setupFile);
+    tool->setModel(*model);
+
+    SimTK::State& s = model->initSystem();
+    tool->setStatesFromMotion(s, motion, motion.isInDegrees());
+    OPENSIM_THROW_IF(!tool->run(), Exception,
+            "AnalyzeTool '{}' failed.", tool->getName());
+}
+} // anonymous namespace
+
+ToolPipeline::ToolPipeline(int numThreads) : m_numThreads(numThreads) {
+    if (m_numThreads < 1) {
+        m_numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+}
+
+int ToolPipeline::addTrial(const Trial& trial) {
+    OPENSIM_THROW_IF(trial.inverseKinematicsSetupFile.empty(), Exception,
+            "Expected an inverse kinematics setup file for each trial.");
+    Trial absoluteTrial;
+    auto makeAbsolute = [](const std::string& setupFile) -> std::string {
+        if (setupFile.empty()) return setupFile;
+        OPENSIM_THROW_IF(!IO::FileExists(setupFile), Exception,
+                "Setup file '{}' does not exist.", setupFile);
+        return SimTK::Pathname::getAbsolutePathname(setupFile);
+    };
+    absoluteTrial.inverseKinematicsSetupFile =
+            makeAbsolute(trial.inverseKinematicsSetupFile);
+    absoluteTrial.inverseDynamicsSetupFile =
+            makeAbsolute(trial.inverseDynamicsSetupFile);
+    absoluteTrial.analyzeSetupFile = makeAbsolute(trial.analyzeSetupFile);
+    m_trials.push_back(absoluteTrial);
+    return getNumTrials() - 1;
+}
+
+const ToolPipeline::Trial& ToolPipeline::getTrial(int trial) const {
+    OPENSIM_THROW_IF(trial < 0 || trial >= getNumTrials(), IndexOutOfRange,
+            (size_t)trial, 0, (size_t)getNumTrials() - 1);
+    return m_trials[trial];
+}
+
+std::string ToolPipeline::getStageName(Stage stage) {
+    switch (stage) {
+    case InverseKinematics: return "inverse kinematics";
+    case InverseDynamics: return "inverse dynamics";
+    case Analyze: return "analyze";
+    default: OPENSIM_THROW(Exception, "Unknown stage {}.", (int)stage);
+    }
+}
+
+const std::string& ToolPipeline::getSetupFile(int trial, int stage) const {
+    const Trial& t = m_trials[trial];
+    if (stage == InverseKinematics) return t.inverseKinematicsSetupFile;
+    if (stage == InverseDynamics) return t.inverseDynamicsSetupFile;
+    return t.analyzeSetupFile;
+}
+
+int ToolPipeline::findNextStage(int trial, int stage) const {
+    ++stage;
+    while (stage < NumStages && getSetupFile(trial, stage).empty()) ++stage;
+    return stage;
+}
+
+void ToolPipeline::runStage(
+        int trial, int stage, std::unique_ptr<Storage>& motion) {
+    const std::string& setupFile = getSetupFile(trial, stage);
+    log_info("Running the {} stage of trial {} ('{}').",
+            getStageName(Stage(stage)), trial, setupFile);
+    switch (stage) {
+    case InverseKinematics: motion = runInverseKinematics(setupFile); break;
+    case InverseDynamics: runInverseDynamics(setupFile, *motion); break;
+    case Analyze: runAnalyze(setupFile, *motion); break;
+    }
+}
+
+void ToolPipeline::run() {
+    typedef std::chrono::steady_clock Clock;
+    OPENSIM_THROW_IF(m_trials.empty(), Exception, "No trials were added.");
+    const int numTrials = getNumTrials();
+    // The stages of a trial run in order, so each thread needs a trial.
+    const int numThreads = std::min(m_numThreads, numTrials);
+
+    m_stageTimings.assign(NumStages, StageTiming());
+    for (int stage = 0; stage < NumStages; ++stage) {
+        m_stageTimings[stage].name = getStageName(Stage(stage));
+    }
+
+    struct Progress {
+        int nextStage = InverseKinematics;
+        bool running = false;
+        std::unique_ptr<Storage> motion;
+    };
+    std::vector<Progress> progress(numTrials);
+    std::mutex mutex;
+    bool failed = false;
+    std::vector<std::exception_ptr> errors(numThreads);
+
+    // A thread starts the latest stage that is ready, so that the motions
+    // are released early. When no stage is ready, the stages that are
+    // running are followed by the threads that run them, so the thread is
+    // done.
+    auto runStages = [&](int ithread) {
+        while (true) {
+            int trial = -1;
+            int stage = -1;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (failed) return;
+                for (int i = 0; i < numTrials; ++i) {
+                    if (progress[i].running ||
+                            progress[i].nextStage == NumStages) {
+                        continue;
+                    }
+                    if (progress[i].nextStage > stage) {
+                        trial = i;
+                        stage = progress[i].nextStage;
+                    }
+                }
+                if (trial < 0) return;
+                progress[trial].running = true;
+            }
+            try {
+                const Clock::time_point start = Clock::now();
+                runStage(trial, stage, progress[trial].motion);
+                const double time =
+                        std::chrono::duration<double>(Clock::now() - start)
+                                .count();
+
+                std::lock_guard<std::mutex> lock(mutex);
+                StageTiming& timing = m_stageTimings[stage];
+                ++timing.numTrials;
+                timing.totalTime += time;
+                timing.maxTime = std::max(timing.maxTime, time);
+                Progress& p = progress[trial];
+                p.nextStage = findNextStage(trial, stage);
+                if (p.nextStage == NumStages) p.motion.reset();
+                p.running = false;
+            } catch (...) {
+                log_error("The {} stage of trial {} ('{}') failed.",
+                        getStageName(Stage(stage)), trial,
+                        getSetupFile(trial, stage));
+                errors[ithread] = std::current_exception();
+                std::lock_guard<std::mutex> lock(mutex);
+                // Stop the other threads early.
+                failed = true;
+                return;
+            }
+        }
+    };
+
+    log_info("Running {} stages of {} trial(s) on {} thread(s)...",
+            NumStages, numTrials, numThreads);
+    const Clock::time_point start = Clock::now();
+    std::vector<std::thread> threads;
+    for (int ithread = 1; ithread < numThreads; ++ithread) {
+        threads.emplace_back(runStages, ithread);
+    }
+    runStages(0);
+    for (auto& thread : threads) thread.join();
+    m_wallTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+void ToolPipeline::printTimingReport() const {
+    double totalTime = 0;
+    for (const auto& timing : m_stageTimings) {
+        const double meanTime =
+                timing.numTrials > 0 ? timing.totalTime / timing.numTrials : 0;
+        log_info("Stage '{}': {} trial(s), total {:.3f} s, mean {:.3f} s, "
+                 "max {:.3f} s.",
+                timing.name, timing.numTrials, timing.totalTime, meanTime,
+                timing.maxTime);
+        totalTime += timing.totalTime;
+    }
+    log_info("The pipeline took {:.3f} s for {:.3f} s of stages ({:.2f}x).",
+            m_wallTime, totalTime, m_wallTime > 0 ? totalTime / m_wallTime : 0);
+}
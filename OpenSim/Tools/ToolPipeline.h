@@ -0,0 +1,137 @@
+#ifndef OPENSIM_TOOL_PIPELINE_H_
+#define OPENSIM_TOOL_PIPELINE_H_
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  ToolPipeline.h                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2023 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimToolsDLL.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+class Storage;
+
+/** Run inverse kinematics, inverse dynamics and an analysis (e.g., static
+optimization) for a batch of trials in one process, as `opensim-cmd run-tool`
+would with the setup files of InverseKinematicsTool, InverseDynamicsTool and
+AnalyzeTool, one after the other, for each trial.
+
+The coordinates solved by inverse kinematics are passed to the other tools in
+memory, so the coordinates_file (and states_file) of the inverse dynamics and
+analyze setup files are not read; the inverse kinematics tool still writes
+its output_motion_file if it is set. The other file names in the setup files
+are relative to the setup file, and the tools write their result files as
+they do when they are run from their setup files.
+
+The stages of a trial run in order, but the stages of different trials
+overlap: while inverse dynamics runs for one trial, inverse kinematics can
+run for the next. The stages are run by a fixed number of threads (see the
+constructor); a thread that is free starts the latest stage that is ready,
+so that few motions wait in memory for the next stage, and the earliest trial
+among those. getStageTimings() reports the time spent in each stage.
+
+The tools change the working directory only while they read setup and model
+files (see IO::CwdChanger), and the pipeline passes them absolute file
+names. Tools that run in parallel themselves (e.g., the num_threads of
+AnalyzeTool) use threads in addition to those of the pipeline. */
+class OSIMTOOLS_API ToolPipeline {
+public:
+    /** The setup files of the tools of a trial. The inverse dynamics and
+    analyze setup files may be empty to skip those stages. */
+    struct Trial {
+        std::string inverseKinematicsSetupFile;
+        std::string inverseDynamicsSetupFile;
+        std::string analyzeSetupFile;
+    };
+    /** The stages of each trial, in the order in which they run. */
+    enum Stage {
+        InverseKinematics = 0,
+        InverseDynamics,
+        Analyze,
+        NumStages
+    };
+    /** The wall-clock time, in seconds, that a stage took over the trials
+    that ran it in the last call to run(). */
+    struct StageTiming {
+        std::string name;
+        int numTrials = 0;
+        double totalTime = 0;
+        double maxTime = 0;
+    };
+
+    /** The stages are run by up to `numThreads` threads; if `numThreads` is
+    less than 1, the number of cores is used. */
+    explicit ToolPipeline(int numThreads = 1);
+    ToolPipeline(const ToolPipeline&) = delete;
+    ToolPipeline& operator=(const ToolPipeline&) = delete;
+
+    int getNumThreads() const { return m_numThreads; }
+
+    /** Add a trial. File names are relative to the current working
+    directory.
+    @returns The index of the trial.
+    @throws Exception if there is no inverse kinematics setup file or one of
+        the setup files does not exist. */
+    int addTrial(const Trial& trial);
+    int getNumTrials() const { return static_cast<int>(m_trials.size()); }
+    /** The trial with absolute file names. */
+    const Trial& getTrial(int trial) const;
+
+    /** Run the stages of all trials. If a stage fails, no more stages are
+    started, and its exception is rethrown once the stages that are running
+    are done.
+    @throws Exception if there are no trials. */
+    void run();
+
+    /** The timings of the stages of the last call to run(), in the order of
+    Stage. */
+    const std::vector<StageTiming>& getStageTimings() const {
+        return m_stageTimings;
+    }
+    /** The wall-clock time of the last call to run(), in seconds. */
+    double getWallTime() const { return m_wallTime; }
+    /** Log the timings of the stages and the wall-clock time of the last call
+    to run(). */
+    void printTimingReport() const;
+
+    static std::string getStageName(Stage stage);
+
+private:
+    // The setup file of the stage of the trial; empty if it is skipped.
+    const std::string& getSetupFile(int trial, int stage) const;
+    // The first stage after `stage` that the trial runs, or NumStages.
+    int findNextStage(int trial, int stage) const;
+    // Run a stage of a trial. Inverse kinematics sets the motion, which the
+    // later stages use.
+    void runStage(int trial, int stage, std::unique_ptr<Storage>& motion);
+
+    int m_numThreads;
+    std::vector<Trial> m_trials;
+    std::vector<StageTiming> m_stageTimings;
+    double m_wallTime = 0;
+};
+
+} // namespace OpenSim
+
+#endif // OPENSIM_TOOL_PIPELINE_H_
@@ -49,6 +49,9 @@
 #include "SMC_Joint.h"
 #include "CMC_TaskSet.h"
 #include "CorrectionController.h"
+#include "StreamingIMUInverseKinematics.h"
+#include "OrientationsFileReplay.h"
+#include "ToolPipeline.h"
 #include "RegisterTypes_osimTools.h"    // to expose RegisterTypes_osimTools
 
 #endif // OPENSIM_OSIMTOOLS_H_